@@ -14,6 +14,16 @@
  * @note Available characters from " " (ASCII: 32) to "~" (ASCII: 126)
  * 
  * @note Created with http://www.eran.io/the-dot-factory-an-lcd-font-and-image-generator/
+ *
+ * @note Fonts can also be stored run-length encoded (FONT_RLE), tools/font_rle.py converts
+ * a font array to that format. Glyph rows are read the same way for both formats
+ * with FontGlyphStart() and FontGlyphRow().
+ *
+ * @note Expanded glyphs are kept in a cache, keyed by font, character and colors.
+ *
+ * @note Anti-aliased fonts (FONT_4BPP) store 16 coverage levels per pixel,
+ * tools/font_4bpp.py converts TTF and BDF fonts to that format. Levels are
+ * turned into colors with a 16 color ramp computed once per glyph.
  * 
  * @author Albano Peñalva
  *
@@ -22,14 +32,30 @@
  * |   Date	    | Description                                    						|
  * |:----------:|:----------------------------------------------------------------------|
  * | 05/04/2024 | Document creation		                         						|
+ * | 19/10/2026 | Run-length encoded fonts and expanded glyph cache						|
+ * | 19/10/2026 | 4 bits per pixel anti-aliased fonts									|
  * 
  **/
 
 /*==================[inclusions]=============================================*/
+#include <stdbool.h>
 #include <stdint.h>
 /*==================[macros]=================================================*/
-
+#define FONT_CACHE_SIZE		8192	/*!< Bytes of RAM for expanded glyphs */
+#define FONT_CACHE_ENTRIES	64		/*!< Maximum number of expanded glyphs */
+#define FONT_ALPHA_MAX		15		/*!< Coverage of a glyph pixel completely inside the glyph */
 /*==================[typedef]================================================*/
+/**
+ * @brief Font data encoding
+ */
+typedef enum {
+	FONT_1BPP = 0,		/*!< 1 bit per pixel, each row starts on a new byte, MSB first */
+	FONT_RLE,			/*!< 4 bit run lengths, high nibble first, starting with background.
+							 Run of 15 continues on the next nibble with the same color */
+	FONT_4BPP,			/*!< 4 bit coverage (0 background to 15 foreground) per pixel, high nibble
+							 first, each row starts on a new byte */
+} font_encoding_t;
+
 /**
  * @brief Character information
  */
@@ -44,8 +70,22 @@ typedef struct{
 	uint8_t 		font_height;   	/*!< Font height in pixels */
 	char_info_t 	*info;			/*!< Character info array */
 	const uint8_t 	*data; 			/*!< Font array */
+	font_encoding_t encoding;		/*!< Font array encoding */
 } Font_t;
 
+/**
+ * @brief  Reads the rows of a glyph, whatever the font encoding
+ */
+typedef struct{
+	const uint8_t	*data;			/*!< Next byte of glyph data */
+	uint8_t			width;			/*!< Glyph width in pixels */
+	font_encoding_t encoding;		/*!< Font array encoding */
+	bool			low_nibble;		/*!< RLE: next run is in the low nibble */
+	uint16_t		run;			/*!< RLE: pixels left in current run */
+	bool			ink;			/*!< RLE: current run is foreground */
+	uint16_t		ramp[FONT_ALPHA_MAX + 1];	/*!< Color of each coverage level, high byte first */
+} glyph_reader_t;
+
 /*==================[external data declaration]==============================*/
 /**
  * @brief  11 pixels font height structure
@@ -78,6 +118,65 @@ extern Font_t font_59;
 extern Font_t font_89;
 
 /*==================[external functions declaration]=========================*/
+/**
+ * @brief  		Checks if a character is available on fonts
+ * @param[in]  	c: Character
+ * @retval 		true if c is between ' ' and '~'
+ */
+bool FontHasChar(char c);
+
+/**
+ * @brief  		Mixes two colors
+ * @param[in]  	foreground: Color (RGB565)
+ * @param[in]  	background: Color (RGB565)
+ * @param[in]  	alpha: Foreground coverage, 0 to FONT_ALPHA_MAX
+ * @retval 		Mixed color (RGB565)
+ */
+uint16_t FontBlend(uint16_t foreground, uint16_t background, uint8_t alpha);
+
+/**
+ * @brief  		Starts reading the rows of a glyph
+ * @param[out] 	reader: Glyph reader
+ * @param[in]  	font: Pointer to font
+ * @param[in]  	c: Character
+ * @param[in]  	foreground: Color for glyph pixels (RGB565)
+ * @param[in]  	background: Color for background pixels (RGB565)
+ * @retval 		None
+ */
+void FontGlyphStart(glyph_reader_t *reader, const Font_t *font, char c, uint16_t foreground, uint16_t background);
+
+/**
+ * @brief  		Expands the next row of a glyph to RGB565
+ * @param[in]  	reader: Glyph reader
+ * @param[out] 	row: Width pixels, high byte first (LCD byte order)
+ * @retval 		None
+ */
+void FontGlyphRow(glyph_reader_t *reader, uint16_t *row);
+
+/**
+ * @brief  		Reads the next row of a glyph as coverage levels
+ * @param[in]  	reader: Glyph reader
+ * @param[out] 	alpha: Width levels, 0 (background) to FONT_ALPHA_MAX (foreground)
+ * @retval 		None
+ */
+void FontGlyphAlphaRow(glyph_reader_t *reader, uint8_t *alpha);
+
+/**
+ * @brief  		Gets a glyph expanded to RGB565, expanding it only the first time
+ * @note		Pointer is valid until the cache is full and restarts, FontGlyphCacheGeneration() changes then
+ * @param[in]  	font: Pointer to font
+ * @param[in]  	c: Character
+ * @param[in]  	foreground: Color for glyph pixels (RGB565)
+ * @param[in]  	background: Color for background pixels (RGB565)
+ * @retval 		Width * font_height pixels, high byte first. NULL when the glyph is bigger than the cache allows
+ */
+const uint16_t * FontGlyphCacheGet(const Font_t *font, char c, uint16_t foreground, uint16_t background);
+
+/**
+ * @brief  		Gets a number that changes each time the glyph cache restarts
+ * @retval 		Cache generation
+ */
+uint32_t FontGlyphCacheGeneration(void);
 
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
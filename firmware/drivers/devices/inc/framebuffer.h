@@ -0,0 +1,187 @@
+#ifndef FRAMEBUFFER_H_
+#define FRAMEBUFFER_H_
+/** \addtogroup Drivers_Programable Drivers Programable
+ ** @{ */
+/** \addtogroup Drivers_Devices Drivers devices
+ ** @{ */
+/** \addtogroup Framebuffer Framebuffer
+ ** @{
+ * @brief  RGB565 off-screen framebuffer with dirty-rectangle tracking
+ *
+ * @note The framebuffer covers a rectangular area of the screen (the whole screen
+ * or a strip of it). Drawing functions take screen coordinates, clip to that area
+ * and record the modified region. A display driver takes the merged dirty
+ * rectangles and only transmits those.
+ *
+ * @note Pixels are stored in the byte order the LCD expects (high byte first),
+ * so rows can be copied straight to the transmit buffers.
+ *
+ * @note This module doesn't depend on the hardware, it can be compiled and tested
+ * on a host computer (see devices/test_host, drawings are compared with golden images).
+ *
+ * @section changelog
+ *
+ * |   Date	    | Description                                    |
+ * |:----------:|:-----------------------------------------------|
+ * | 19/10/2026 | Document creation		                         |
+ * | 19/10/2026 | Lines, used by widgets                         |
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdbool.h>
+#include <stdint.h>
+/*==================[macros]=================================================*/
+#define FB_MAX_DIRTY		8		/*!< Maximum number of dirty rectangles kept between flushes */
+#define FB_MERGE_PIXELS		128		/*!< Extra pixels accepted when merging two rectangles, cost of a new LCD window */
+/*==================[typedef]================================================*/
+/**
+ * @brief  Rectangle, limits included
+ */
+typedef struct {
+	int16_t x0;		/*!< Left column */
+	int16_t y0;		/*!< Top row */
+	int16_t x1;		/*!< Right column */
+	int16_t y1;		/*!< Bottom row */
+} fb_rect_t;
+
+/**
+ * @brief  Framebuffer
+ */
+typedef struct {
+	uint16_t *pixels;					/*!< RGB565 pixels, high byte first */
+	int16_t x;							/*!< Screen column of the first pixel */
+	int16_t y;							/*!< Screen row of the first pixel */
+	uint16_t width;						/*!< Width in pixels */
+	uint16_t height;					/*!< Height in pixels */
+	fb_rect_t dirty[FB_MAX_DIRTY];		/*!< Modified areas, in screen coordinates */
+	uint8_t dirty_count;				/*!< Number of modified areas */
+} framebuffer_t;
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/**
+ * @brief  		Initializes a framebuffer over a memory area
+ * @param[in]  	fb: Framebuffer
+ * @param[in]  	pixels: Memory for width * height pixels
+ * @param[in]  	x: Screen column of top left corner
+ * @param[in]  	y: Screen row of top left corner
+ * @param[in]  	width: Width in pixels
+ * @param[in]  	height: Height in pixels
+ * @retval 		None
+ */
+void FramebufferInit(framebuffer_t *fb, uint16_t *pixels, int16_t x, int16_t y, uint16_t width, uint16_t height);
+
+/**
+ * @brief  		Clips a rectangle to the framebuffer area
+ * @param[in]  	fb: Framebuffer
+ * @param[inout] rect: Rectangle in screen coordinates, ordered limits
+ * @retval 		true if some part of the rectangle is inside the framebuffer
+ */
+bool FramebufferClip(const framebuffer_t *fb, fb_rect_t *rect);
+
+/**
+ * @brief  		Checks if a rectangle is completely inside the framebuffer area
+ * @param[in]  	fb: Framebuffer
+ * @param[in]  	rect: Rectangle in screen coordinates, ordered limits
+ * @retval 		true if inside
+ */
+bool FramebufferContains(const framebuffer_t *fb, const fb_rect_t *rect);
+
+/**
+ * @brief  		Adds an area to the dirty list, merging it with near ones
+ * @param[in]  	fb: Framebuffer
+ * @param[in]  	rect: Modified area, already clipped to the framebuffer
+ * @retval 		None
+ */
+void FramebufferInvalidate(framebuffer_t *fb, const fb_rect_t *rect);
+
+/**
+ * @brief  		Takes the next dirty area out of the list
+ * @param[in]  	fb: Framebuffer
+ * @param[out] 	rect: Dirty area in screen coordinates
+ * @retval 		true if there was a dirty area
+ */
+bool FramebufferTakeDirty(framebuffer_t *fb, fb_rect_t *rect);
+
+/**
+ * @brief  		Gets a pointer to a pixel of the framebuffer
+ * @param[in]  	fb: Framebuffer
+ * @param[in]  	x: Screen column, inside the framebuffer
+ * @param[in]  	y: Screen row, inside the framebuffer
+ * @retval 		Pointer to the pixel, following pixels of the row are contiguous
+ */
+uint16_t * FramebufferPixel(const framebuffer_t *fb, int16_t x, int16_t y);
+
+/**
+ * @brief  		Reads a pixel color
+ * @param[in]  	fb: Framebuffer
+ * @param[in]  	x: Screen column, inside the framebuffer
+ * @param[in]  	y: Screen row, inside the framebuffer
+ * @retval 		Color (RGB565)
+ */
+uint16_t FramebufferGetPixel(const framebuffer_t *fb, int16_t x, int16_t y);
+
+/**
+ * @brief  		Draws a single pixel
+ * @param[in]  	fb: Framebuffer
+ * @param[in]  	x: Screen column
+ * @param[in]  	y: Screen row
+ * @param[in]  	color: Color (RGB565)
+ * @retval 		None
+ */
+void FramebufferDrawPixel(framebuffer_t *fb, int16_t x, int16_t y, uint16_t color);
+
+/**
+ * @brief  		Fills a rectangle with a color
+ * @param[in]  	fb: Framebuffer
+ * @param[in]  	rect: Rectangle in screen coordinates, ordered limits
+ * @param[in]  	color: Color (RGB565)
+ * @retval 		None
+ */
+void FramebufferFill(framebuffer_t *fb, const fb_rect_t *rect, uint16_t color);
+
+/**
+ * @brief  		Draws a line
+ * @param[in]  	fb: Framebuffer
+ * @param[in]  	x0: Screen column of starting point
+ * @param[in]  	y0: Screen row of starting point
+ * @param[in]  	x1: Screen column of ending point
+ * @param[in]  	y1: Screen row of ending point
+ * @param[in]  	color: Color (RGB565)
+ * @retval 		None
+ */
+void FramebufferDrawLine(framebuffer_t *fb, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+
+/**
+ * @brief  		Draws a 1 bit per pixel bitmap
+ * @param[in]  	fb: Framebuffer
+ * @param[in]  	x: Screen column of top left corner
+ * @param[in]  	y: Screen row of top left corner
+ * @param[in]  	width: Bitmap width in pixels
+ * @param[in]  	height: Bitmap height in pixels
+ * @param[in]  	bitmap: Pointer to first row, each row starts on a new byte, MSB first
+ * @param[in]  	foreground: Color for bits set (RGB565)
+ * @param[in]  	background: Color for bits cleared (RGB565)
+ * @retval 		None
+ */
+void FramebufferDrawBitmap(framebuffer_t *fb, int16_t x, int16_t y, uint16_t width, uint16_t height, const uint8_t *bitmap, uint16_t foreground, uint16_t background);
+
+/**
+ * @brief  		Draws a picture
+ * @param[in]  	fb: Framebuffer
+ * @param[in]  	x: Screen column of top left corner
+ * @param[in]  	y: Screen row of top left corner
+ * @param[in]  	width: Picture width in pixels
+ * @param[in]  	height: Picture height in pixels
+ * @param[in]  	pic: RGB565 pixels, 2 bytes per pixel, high byte first
+ * @retval 		None
+ */
+void FramebufferDrawPicture(framebuffer_t *fb, int16_t x, int16_t y, uint16_t width, uint16_t height, const uint8_t *pic);
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+#endif /* FRAMEBUFFER_H_ */
+
+/*==================[end of file]============================================*/
@@ -14,6 +14,30 @@
  * 
  * @note When disconnected return 0.
  * 
+ * @note Initialized with HcSr04InitCapture(), the echo edges interrupt and are
+ * timestamped with TimerNow() (1 us resolution). HcSr04Trigger() starts a
+ * measurement and returns, the callback is called from an ISR when the echo ends
+ * or times out. The reading functions block the task until then, without polling,
+ * on a binary semaphore in its stack: task notifications are left to the task.
+ * @code
+ * void EchoEnd(const hc_sr04_echo_t *echo, void *param){
+ *     distance = HcSr04EchoMillimeters(echo);
+ * }
+ * HcSr04InitCapture(GPIO_3, GPIO_2);
+ * HcSr04Trigger(EchoEnd, NULL);
+ * @endcode
+ * 
+ * @note Up to HC_SR04_SCAN_MAX sensors are measured in turn, from ISRs, with
+ * HcSr04ScanInit() and HcSr04ScanStart() (see hc_sr04_schedule.h). Tasks read the
+ * latest distance of each one, with its timestamp, without waiting.
+ * @code
+ * const hc_sr04_pins_t sensors[] = {{GPIO_3, GPIO_2}, {GPIO_19, GPIO_18}, {GPIO_21, GPIO_20}};
+ * hc_sr04_reading_t readings[3];
+ * HcSr04ScanInit(sensors, 3, 5000, 200);	// 5 ms guard, 2 m range
+ * HcSr04ScanStart();
+ * HcSr04ScanRead(readings);
+ * @endcode
+ * 
  * @note When ussing dedicated connector in ESP-EDU:
  * |   HC_SR04      |   EDU-CIAA	|
  * |:--------------:|:-------------:|
@@ -29,6 +53,9 @@
  * |   Date	    | Description                                    						|
  * |:----------:|:----------------------------------------------------------------------|
  * | 23/10/2023 | Document creation		                         						|
+ * | 19/10/2026 | Edge capture mode, non-blocking measurement							|
+ * | 19/10/2026 | Several sensors measured in turn, with a guard time					|
+ * | 19/10/2026 | Reading functions wait on a semaphore, not on task notifications		|
  * 
  **/
 
@@ -36,9 +63,30 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include "gpio_mcu.h"
+#include "hc_sr04_echo.h"
+#include "hc_sr04_schedule.h"
 /*==================[macros]=================================================*/
+#define HC_SR04_SCAN_MAX	8		/*!< Maximun number of sensors measured in turn */
 
 /*==================[typedef]================================================*/
+/**
+ * @brief Function called from an ISR when a measurement ends
+ *
+ * @note It must be short, like timer functions, and can't start a new measurement:
+ * EventPostFromISR() passes the distance to a task.
+ *
+ * @param echo Measurement, see HcSr04EchoCentimeters()
+ * @param param Parameter given to HcSr04Trigger()
+ */
+typedef void (*hc_sr04_callback_t)(const hc_sr04_echo_t *echo, void *param);
+
+/**
+ * @brief Pins of a sensor
+ */
+typedef struct {
+	gpio_t echo;					/*!< GPIO number wher echo pin is connected */
+	gpio_t trigger;					/*!< GPIO number wher trigger pin is connected */
+} hc_sr04_pins_t;
 
 /*==================[external data declaration]==============================*/
 
@@ -52,6 +100,54 @@
  */
 bool HcSr04Init(gpio_t echo, gpio_t trigger);
 
+/**
+ * @brief HC_SR04 initialization in edge capture mode.
+ * 
+ * @param echo GPIO number wher echo pin is connected
+ * @param trigger GPIO number wher trigger pin is connected
+ * @return false if the timeout timer can't be created
+ */
+bool HcSr04InitCapture(gpio_t echo, gpio_t trigger);
+
+/**
+ * @brief Start a measurement, in edge capture mode
+ * 
+ * @param func Function called from an ISR when the measurement ends
+ * @param param Parameter of func
+ * @return false if a measurement is in course
+ */
+bool HcSr04Trigger(hc_sr04_callback_t func, void *param);
+
+/**
+ * @brief Initialization of several sensors measured in turn, in edge capture mode.
+ * 
+ * @param sensors Pins of each sensor
+ * @param count Number of sensors, up to HC_SR04_SCAN_MAX
+ * @param guard Time from the end of a measurement to the next trigger (us)
+ * @param max_cm Range, up to 300 cm
+ * @return false if the sensors can't be initialized
+ */
+bool HcSr04ScanInit(const hc_sr04_pins_t *sensors, uint8_t count, uint32_t guard, uint16_t max_cm);
+
+/**
+ * @brief Start measuring the sensors, one after the other
+ * 
+ */
+void HcSr04ScanStart(void);
+
+/**
+ * @brief Stop measuring the sensors, after the measurement in course
+ * 
+ */
+void HcSr04ScanStop(void);
+
+/**
+ * @brief Read the latest measurement of each sensor
+ * 
+ * @param readings Latest reading of each sensor given to HcSr04ScanInit()
+ */
+void HcSr04ScanRead(hc_sr04_reading_t *readings);
+
 /**
  * @brief Read distance
  * 
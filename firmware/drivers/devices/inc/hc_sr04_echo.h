@@ -0,0 +1,143 @@
+#ifndef HC_SR04_ECHO_H
+#define HC_SR04_ECHO_H
+/** \addtogroup Drivers_Programable Drivers Programable
+ ** @{ */
+/** \addtogroup Drivers_Devices Drivers devices
+ ** @{ */
+/** \addtogroup HC_SR04 HC SR04
+ ** @{ */
+/** \brief HC-SR04 echo measurement from the times of its edges.
+ *
+ * A measurement starts when the trigger is sent (HcSr04EchoStart()). Each edge of
+ * the echo pin is given with its level and the time it happened (HcSr04EchoEdge()):
+ * the echo width is the time from the rising edge to the falling one, so the
+ * resolution is the one of the time base, 1 us with TimerNow(). Edges that don't
+ * follow the expected order (glitches, an echo already started) are ignored.
+ *
+ * If the echo doesn't start in HC_SR04_WAIT_MAX the sensor is disconnected, if it
+ * lasts more than its limit (HC_SR04_MAX_US unless shortened after HcSr04EchoStart())
+ * there is no obstacle in range: HcSr04EchoDeadline() is the time to check it with
+ * HcSr04EchoTimeout().
+ *
+ * @note This module doesn't depend on the hardware, it can be compiled and tested
+ * on a host computer (see devices/test_host).
+ *
+ * @author Albano Peñalva
+ *
+ * @section changelog
+ *
+ * |   Date	    | Description                                    						|
+ * |:----------:|:----------------------------------------------------------------------|
+ * | 19/10/2026 | Document creation		                         						|
+ * | 19/10/2026 | Echo width limit, shorter range										|
+ * | 19/10/2026 | Out of range reported at the limit, not at the maximun distance		|
+ *
+ **/
+/*==================[inclusions]=============================================*/
+#include <stdbool.h>
+#include <stdint.h>
+/*==================[macros]=================================================*/
+#define HC_SR04_WAIT_MAX	5900	/*!< Maximun time from trigger to echo (us) */
+#define HC_SR04_MAX_US		17700	/*!< Maximun echo width (us), 300cm or 118inch */
+#define HC_SR04_MAX_CM		300		/*!< Maximun distance in cm */
+#define HC_SR04_MAX_INCH	118		/*!< Maximun distance in inch */
+#define HC_SR04_US2CM		59		/*!< Scale factor to convert echo width to cm */
+#define HC_SR04_US2INCH		150		/*!< Scale factor to convert echo width to inch */
+/*==================[typedef]================================================*/
+/**
+ * @brief Measurement state
+ */
+typedef enum {
+	HC_SR04_ECHO_IDLE,			/*!< Not started */
+	HC_SR04_ECHO_WAIT,			/*!< Trigger sent, waiting for the echo */
+	HC_SR04_ECHO_HIGH,			/*!< Echo started, waiting for its end */
+	HC_SR04_ECHO_DONE,			/*!< Echo measured */
+	HC_SR04_ECHO_MISSING,		/*!< No echo, sensor disconnected */
+	HC_SR04_ECHO_OUT_OF_RANGE,	/*!< Echo too long, no obstacle in range */
+} hc_sr04_echo_state_t;
+
+/**
+ * @brief Echo measurement
+ */
+typedef struct {
+	uint64_t start;					/*!< Time of the trigger, then of the echo rising edge (us) */
+	uint32_t width;					/*!< Echo width once done (us) */
+	uint32_t limit;					/*!< Longest echo in range (us) */
+	hc_sr04_echo_state_t state;		/*!< Measurement state */
+} hc_sr04_echo_t;
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/**
+ * @brief Starts a measurement, the trigger was sent
+ *
+ * @param echo Measurement
+ * @param now Current time (us)
+ */
+void HcSr04EchoStart(hc_sr04_echo_t *echo, uint64_t now);
+
+/**
+ * @brief Gives an edge of the echo pin
+ *
+ * @param echo Measurement
+ * @param level Echo pin level after the edge
+ * @param time Time of the edge (us)
+ * @return true if the edge ended the measurement
+ */
+bool HcSr04EchoEdge(hc_sr04_echo_t *echo, bool level, uint64_t time);
+
+/**
+ * @brief Ends the measurement if its deadline passed
+ *
+ * @param echo Measurement
+ * @param now Current time (us)
+ * @return true if the measurement ended now
+ */
+bool HcSr04EchoTimeout(hc_sr04_echo_t *echo, uint64_t now);
+
+/**
+ * @brief Time the measurement ends if no edge comes
+ *
+ * @param echo Measurement, waiting or high
+ * @return Deadline (us)
+ */
+uint64_t HcSr04EchoDeadline(const hc_sr04_echo_t *echo);
+
+/**
+ * @brief Tells if the measurement is in course
+ *
+ * @param echo Measurement
+ * @return true while waiting for an edge
+ */
+bool HcSr04EchoBusy(const hc_sr04_echo_t *echo);
+
+/**
+ * @brief Measured distance
+ *
+ * @param echo Measurement
+ * @return Distance in mm, the limit if out of range, 0 if there was no echo
+ */
+uint16_t HcSr04EchoMillimeters(const hc_sr04_echo_t *echo);
+
+/**
+ * @brief Measured distance
+ *
+ * @param echo Measurement
+ * @return Distance in cm, the limit if out of range, 0 if there was no echo
+ */
+uint16_t HcSr04EchoCentimeters(const hc_sr04_echo_t *echo);
+
+/**
+ * @brief Measured distance
+ *
+ * @param echo Measurement
+ * @return Distance in inches, the limit if out of range, 0 if there was no echo
+ */
+uint16_t HcSr04EchoInches(const hc_sr04_echo_t *echo);
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+#endif /* #ifndef HC_SR04_ECHO_H */
+
+/*==================[end of file]============================================*/
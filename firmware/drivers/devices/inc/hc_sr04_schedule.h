@@ -0,0 +1,143 @@
+#ifndef HC_SR04_SCHEDULE_H
+#define HC_SR04_SCHEDULE_H
+/** \addtogroup Drivers_Programable Drivers Programable
+ ** @{ */
+/** \addtogroup Drivers_Devices Drivers devices
+ ** @{ */
+/** \addtogroup HC_SR04 HC SR04
+ ** @{ */
+/** \brief Round-robin measurement of several HC-SR04 sensors.
+ *
+ * Only one sensor measures at a time, in turn: the next one is triggered a guard
+ * time after the measurement of the previous one ended, so its burst doesn't reach
+ * a sensor that is listening (crosstalk) and the echoes of the previous burst fade
+ * out. Edges of the other sensors are ignored. Each ended measurement is published
+ * as the latest reading of its sensor, with the time it ended.
+ *
+ * The echo level of every sensor is kept: a sensor isn't triggered while its echo
+ * is high (it would ignore the trigger), as after a measurement cut at the limit,
+ * since with no obstacle the HC-SR04 holds it high up to HC_SR04_NO_ECHO_US. A
+ * sensor whose echo stays high longer is skipped, its reading is missing.
+ *
+ * A limit shorter than HC_SR04_MAX_US makes the range and the measurement of an
+ * obstacle out of range shorter. A round takes the sum, for each sensor, of the
+ * time to the echo (about 0.5 ms), the echo width and the guard time: with 4 sensors,
+ * obstacles up to 1 m and 5 ms of guard it is below 50 ms (20 Hz). With nothing in
+ * a range of 2 m it is 70 ms.
+ *
+ * @note This module doesn't depend on the hardware, it can be compiled and tested
+ * on a host computer (see devices/test_host).
+ *
+ * @author Albano Peñalva
+ *
+ * @section changelog
+ *
+ * |   Date	    | Description                                    						|
+ * |:----------:|:----------------------------------------------------------------------|
+ * | 19/10/2026 | Document creation		                         						|
+ * | 19/10/2026 | Trigger delayed until the echo of the sensor is low					|
+ *
+ **/
+/*==================[inclusions]=============================================*/
+#include <stdbool.h>
+#include <stdint.h>
+#include "hc_sr04_echo.h"
+/*==================[macros]=================================================*/
+#define HC_SR04_SCHEDULE_MAX	32		/*!< Maximun number of sensors */
+#define HC_SR04_NO_ECHO_US		38000	/*!< Echo width of the HC-SR04 when there is no obstacle (us) */
+
+/*==================[typedef]================================================*/
+/**
+ * @brief Latest measurement of a sensor
+ */
+typedef struct {
+	uint64_t timestamp;				/*!< Time the measurement ended (us), 0 if none yet */
+	uint16_t distance;				/*!< Distance (mm), the limit if out of range, 0 if there was no echo */
+	hc_sr04_echo_state_t state;		/*!< Done, missing or out of range */
+} hc_sr04_reading_t;
+
+/**
+ * @brief Schedule of the measurements
+ */
+typedef struct {
+	hc_sr04_echo_t echo;			/*!< Measurement of the current sensor */
+	hc_sr04_reading_t *readings;	/*!< Latest reading of each sensor */
+	uint8_t sensors;				/*!< Number of sensors */
+	uint8_t current;				/*!< Sensor measuring, or the next one */
+	uint32_t guard;					/*!< Time from the end of a measurement to the next trigger (us) */
+	uint32_t limit;					/*!< Longest echo in range (us) */
+	uint64_t next;					/*!< Time of the next trigger (us) */
+	uint32_t echo_high;				/*!< Echo level of each sensor, one bit per sensor */
+} hc_sr04_schedule_t;
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/**
+ * @brief Initializes the schedule, the first sensor can be triggered at once
+ *
+ * @param schedule Schedule
+ * @param readings Latest reading of each sensor, cleared
+ * @param sensors Number of sensors, up to HC_SR04_SCHEDULE_MAX
+ * @param guard Time from the end of a measurement to the next trigger (us)
+ * @param limit Longest echo in range (us), up to HC_SR04_MAX_US
+ */
+void HcSr04ScheduleInit(hc_sr04_schedule_t *schedule, hc_sr04_reading_t *readings, uint8_t sensors,
+	uint32_t guard, uint32_t limit);
+
+/**
+ * @brief Starts the measurement of the next sensor, if it is time and its echo is low
+ *
+ * @param schedule Schedule
+ * @param now Current time (us)
+ * @param sensor Sensor to trigger
+ * @return true if the sensor has to be triggered now
+ */
+bool HcSr04ScheduleTrigger(hc_sr04_schedule_t *schedule, uint64_t now, uint8_t *sensor);
+
+/**
+ * @brief Gives an edge of the echo pin of a sensor
+ *
+ * @note Edges of every sensor must be given, their levels are kept.
+ *
+ * @param schedule Schedule
+ * @param sensor Sensor
+ * @param level Echo pin level after the edge
+ * @param time Time of the edge (us)
+ * @return true if the deadline changed: the echo started, the measurement ended or
+ * the echo of the next sensor changed
+ */
+bool HcSr04ScheduleEdge(hc_sr04_schedule_t *schedule, uint8_t sensor, bool level, uint64_t time);
+
+/**
+ * @brief Ends the measurement if its deadline passed, or skips the next sensor if
+ * its echo is still high HC_SR04_NO_ECHO_US after it was due
+ *
+ * @param schedule Schedule
+ * @param now Current time (us)
+ * @return true if the measurement ended now
+ */
+bool HcSr04ScheduleTimeout(hc_sr04_schedule_t *schedule, uint64_t now);
+
+/**
+ * @brief Time of the next step: end of the measurement if no edge comes, next trigger,
+ * or time to skip the next sensor while its echo is high
+ *
+ * @param schedule Schedule
+ * @return Deadline (us)
+ */
+uint64_t HcSr04ScheduleDeadline(const hc_sr04_schedule_t *schedule);
+
+/**
+ * @brief Tells if a measurement is in course
+ *
+ * @param schedule Schedule
+ * @return true while waiting for an edge
+ */
+bool HcSr04ScheduleBusy(const hc_sr04_schedule_t *schedule);
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+#endif /* #ifndef HC_SR04_SCHEDULE_H */
+
+/*==================[end of file]============================================*/
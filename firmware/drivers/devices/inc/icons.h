@@ -12,6 +12,10 @@
  * @note Available sizes: 22x22 pixels, 30x30 pixels, 59x59 pixels, 89x89 pixels.
  * 
  * @note Created with http://www.eran.io/the-dot-factory-an-lcd-font-and-image-generator/
+ *
+ * @note Icons drawn often are expanded once per icon and colors to runs of RGB565
+ * pixels (sprites), kept in a cache like the font glyphs. Runs never cross a row,
+ * so a sprite can also be drawn skipping its background runs.
  * 
  * @author Albano Peñalva
  *
@@ -20,12 +24,15 @@
  * |   Date	    | Description                                    						|
  * |:----------:|:----------------------------------------------------------------------|
  * | 05/04/2024 | Document creation		                         						|
+ * | 19/10/2026 | Icon sprites expanded to RGB565 runs, kept in a cache					|
  * 
  **/
 
 /*==================[inclusions]=============================================*/
 #include <stdint.h>
 /*==================[macros]=================================================*/
+#define ICON_CACHE_RUNS		2048	/*!< Runs of RAM for icon sprites (4 bytes each) */
+#define ICON_CACHE_ENTRIES	16		/*!< Maximum number of icon sprites */
 
 /*==================[typedef]================================================*/
 /**
@@ -108,6 +115,26 @@ typedef struct{
 	const uint8_t 	*data; 			/*!< Icon data array */
 } icon_font_t;
 
+/**
+ * @brief  Pixels of the same color in an icon row
+ */
+typedef struct{
+	uint16_t 		color;			/*!< Color (RGB565), high byte first */
+	uint16_t 		length;			/*!< Number of pixels */
+} icon_run_t;
+
+/**
+ * @brief  Icon expanded to runs of pixels, row by row
+ */
+typedef struct{
+	const icon_font_t *icon_font;	/*!< Icon font */
+	icon_t 			icon;			/*!< Icon */
+	uint16_t 		foreground;		/*!< Icon color (RGB565) */
+	uint16_t 		background;		/*!< Background color (RGB565) */
+	uint16_t 		count;			/*!< Number of runs */
+	const icon_run_t *runs;			/*!< Runs, the ones of each row add up to the icon width */
+} icon_sprite_t;
+
 /*==================[external data declaration]==============================*/
 /**
  * @brief  22x22 pixels icon structure
@@ -130,6 +157,17 @@ extern icon_font_t icon_59;
 extern icon_font_t icon_89;
 
 /*==================[external functions declaration]=========================*/
+/**
+ * @brief  		Gets an icon expanded to runs of RGB565 pixels, expanding it only the first time
+ * @note		Pointer is valid until the cache is full and restarts
+ * @param[in]  	icon_font: Pointer to icon font
+ * @param[in]  	icon: Icon
+ * @param[in]  	foreground: Color for icon pixels (RGB565)
+ * @param[in]  	background: Color for background pixels (RGB565)
+ * @retval 		Sprite, NULL when the icon needs more runs than the cache allows
+ */
+const icon_sprite_t * IconSpriteGet(const icon_font_t *icon_font, icon_t icon, uint16_t foreground, uint16_t background);
+
 
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
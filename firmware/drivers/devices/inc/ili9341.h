@@ -12,6 +12,17 @@
  * TFT color display connected to the ESP-EDU. It uses a SPI port and 3 GPIOs to 
  * communicate with the ILI9341 LCD driver chip.
  *
+ * @note Pixels are sent in the background: drawing functions return as soon as
+ * the last pixels are queued. Use ILI9341WaitTransfer() or ILI9341SetTransferCallback()
+ * to know when they have reached the LCD.
+ *
+ * @note After ILI9341FramebufferInit() drawing inside the framebuffer area is done in
+ * memory and only reaches the LCD on ILI9341Flush(), which sends just the modified
+ * areas. Drawing outside that area still goes straight to the LCD.
+ *
+ * @note The SPI transactions sent by each function are tested on a host computer,
+ * with a mock of the SPI driver that emulates the LCD memory (see devices/test_host).
+ *
  * @author Albano Peñalva
  *
  * @note Hardware connections:
@@ -33,6 +44,15 @@
  * |   Date	    | Description                                    |
  * |:----------:|:-----------------------------------------------|
  * | 18/01/2024 | Document creation		                         |
+ * | 19/10/2026 | Pixels are sent by DMA while the CPU prepares  |
+ * |            | the next chunk                                 |
+ * | 19/10/2026 | Optional framebuffer with partial flush        |
+ * | 19/10/2026 | Cached glyphs, strings sent one line at a time |
+ * | 19/10/2026 | Anti-aliased strings blended over framebuffer  |
+ * | 19/10/2026 | Hardware vertical scroll and strip chart       |
+ * | 19/10/2026 | Compressed images decoded while they are sent  |
+ * | 19/10/2026 | Output function for retained widgets           |
+ * | 19/10/2026 | Cached icon sprites, transparent icons         |
  *
  */
 
@@ -41,6 +61,8 @@
 #include "spi_mcu.h"
 #include "fonts.h"
 #include "icons.h"
+#include "framebuffer.h"
+#include "image.h"
 /*==================[macros]=================================================*/
 /* LCD settings */
 #define ILI9341_WIDTH       240			/*!< LCD width in pixels */
@@ -71,6 +93,18 @@
 #define ILI9341_PINK           	0xF81F
 #define ILI9341_BROWN			0xBBCA
 /*==================[typedef]================================================*/
+/**
+ * @brief  Strip chart scrolled by the LCD
+ */
+typedef struct {
+	uint16_t start;			/*!< First frame memory line of the chart */
+	uint16_t length;		/*!< Number of lines (samples shown) */
+	uint16_t next;			/*!< Line for the next sample, the oldest one shown */
+	int16_t last;			/*!< Previous sample, -1 if none */
+	uint16_t color;			/*!< Trace color (RGB565) */
+	uint16_t background;	/*!< Background color (RGB565) */
+} ili9341_chart_t;
+
 /**
  * @brief  Possible orientations for LCD
  */
@@ -128,7 +162,9 @@ void ILI9341Rotate(ili9341_orientation_t orientation);
 void ILI9341DrawChar(uint16_t x, uint16_t y, char data, Font_t* font, uint16_t foreground, uint16_t background);
 
 /**
- * @brief  		Draw a single character on the LCD
+ * @brief  		Draw an icon on the LCD
+ * @note		The icon is expanded to a sprite of RGB565 runs the first time it is
+ * 				drawn with these colors, later it is sent from the icon cache
  * @param[in]  	x: X position of top left corner
  * @param[in]  	y: Y position of top left corner
  * @param[in] 	icon: Icon to be displayed
@@ -139,6 +175,18 @@ void ILI9341DrawChar(uint16_t x, uint16_t y, char data, Font_t* font, uint16_t f
  */
 void ILI9341DrawIcon(uint16_t x, uint16_t y, icon_t icon, icon_font_t* icon_font, uint16_t foreground, uint16_t background);
 
+/**
+ * @brief  		Draw an icon over the framebuffer content, without background
+ * @note		Needs ILI9341FramebufferInit(), parts outside the framebuffer are not drawn
+ * @param[in]  	x: X position of top left corner
+ * @param[in]  	y: Y position of top left corner
+ * @param[in] 	icon: Icon to be displayed
+ * @param[in]  	icon_font: Pointer to icon font
+ * @param[in]  	foreground: Color for icon (RGB565)
+ * @retval		None
+ */
+void ILI9341DrawIconTransparent(uint16_t x, uint16_t y, icon_t icon, icon_font_t* icon_font, uint16_t foreground);
+
 /**
  * @brief  		Draw an integer on the LCD
  * @param[in]  	x: X position of top left corner
@@ -154,6 +202,8 @@ void ILI9341DrawInt(uint16_t x, uint16_t y, uint32_t num, uint8_t dig, Font_t* f
 
 /**
  * @brief  		Draw a string on the LCD
+ * @note		Each line is sent as a single window, the column between characters
+ * 				is painted with the background color
  * @param[in] 	x: X position of top left corner of first character in string
  * @param[in]  	y: Y position of top left corner of first character in string
  * @param[in]  	str: Pointer to first character
@@ -164,6 +214,20 @@ void ILI9341DrawInt(uint16_t x, uint16_t y, uint32_t num, uint8_t dig, Font_t* f
  */
 void ILI9341DrawString(uint16_t x, uint16_t y, char* str, Font_t *font, uint16_t foreground, uint16_t background);
 
+/**
+ * @brief  		Draw a string over the framebuffer content, without background
+ * @note		Anti-aliased (FONT_4BPP) edges are mixed with the pixels below, only
+ * 				pixels covered by the glyphs change. Needs ILI9341FramebufferInit(),
+ * 				parts outside the framebuffer are not drawn.
+ * @param[in] 	x: X position of top left corner of first character in string
+ * @param[in]  	y: Y position of top left corner of first character in string
+ * @param[in]  	str: Pointer to first character
+ * @param[in]  	font: Pointer to used font
+ * @param[in]  	foreground: Color for string (RGB565)
+ * @retval 		None
+ */
+void ILI9341DrawStringBlend(uint16_t x, uint16_t y, char* str, Font_t *font, uint16_t foreground);
+
 /**
  * @brief  		Gets width and height of box with text
  * @param[in]  	str: Pointer to first character
@@ -267,6 +331,123 @@ void ILI9341DrawFilledTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, i
  */
 void ILI9341DrawPicture(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t* pic);
 
+/**
+ * @brief  		Draws an image, compressed or not
+ * @note		Compressed images (tools/image_565.py) are decoded in pieces straight
+ * 				into the DMA buffers, there is no copy of the whole image in RAM
+ * @param[in]  	x: X position of top left corner
+ * @param[in]  	y: Y position of top left corner
+ * @param[in]  	image: Image, up to ILI9341_HEIGHT pixels wide
+ * @retval 		None
+ */
+void ILI9341DrawImage(uint16_t x, uint16_t y, const image_t *image);
+
+/**
+ * @brief  		Sends an area rendered by WidgetRender(), to be used as widget_output_t
+ * @param[in]  	rect: Area, limits included
+ * @param[in]  	pixels: Area pixels row by row, RGB565 high byte first
+ * @param[in]  	param: Not used
+ * @retval 		None
+ */
+void ILI9341WidgetOutput(const fb_rect_t *rect, const uint16_t *pixels, void *param);
+
+/**
+ * @brief  		Defines the area moved by hardware scrolling
+ * @note		Scrolling moves lines along the LCD long side (ILI9341_HEIGHT pixels):
+ * 				rows in portrait, columns in landscape. Line 0 is the first line the
+ * 				LCD refreshes, the area always covers whole lines.
+ * 				ILI9341SetScrollArea(0, ILI9341_HEIGHT) and ILI9341SetScrollStart(0) restore the display.
+ * @param[in]  	start: First line of the scrolling area
+ * @param[in]  	length: Number of lines of the scrolling area
+ * @retval 		None
+ */
+void ILI9341SetScrollArea(uint16_t start, uint16_t length);
+
+/**
+ * @brief  		Scrolls the area defined with ILI9341SetScrollArea()
+ * @param[in]  	line: Frame memory line shown at the start of the area, lines after it
+ * 				follow and wrap around to the start of the area
+ * @retval 		None
+ */
+void ILI9341SetScrollStart(uint16_t line);
+
+/**
+ * @brief  		Starts a strip chart over a scrolling area and clears it
+ * @note		Each sample takes one line of the area, so in landscape time runs
+ * 				along x and values along y. Drawing on the area while the chart is
+ * 				used (or through the framebuffer) shows displaced by the scroll.
+ * @param[out] 	chart: Chart
+ * @param[in]  	start: First line of the chart, see ILI9341SetScrollArea()
+ * @param[in]  	length: Number of lines, samples shown at the same time
+ * @param[in]  	color: Trace color (RGB565)
+ * @param[in]  	background: Background color (RGB565)
+ * @retval 		None
+ */
+void ILI9341ChartInit(ili9341_chart_t *chart, uint16_t start, uint16_t length, uint16_t color, uint16_t background);
+
+/**
+ * @brief  		Adds a sample to a strip chart
+ * @note		Only the line of the new sample is sent, then the area scrolls one line
+ * @param[in]  	chart: Chart
+ * @param[in]  	value: Position of the sample across the line, 0 to ILI9341_WIDTH - 1
+ * @retval 		None
+ */
+void ILI9341ChartAdd(ili9341_chart_t *chart, uint16_t value);
+
+/**
+ * @brief  		Stops a strip chart and restores the display without scrolling
+ * @param[in]  	chart: Chart
+ * @retval 		None
+ */
+void ILI9341ChartDeInit(ili9341_chart_t *chart);
+
+/**
+ * @brief  		Sets a function to be called each time the pixels of a fill, rectangle,
+ * 				character, icon or picture have been sent to the LCD
+ * @note		Function is called from SPI interrupt
+ * @param[in]  	func_p: Pointer to function, NULL to disable
+ * @param[in]  	param_p: Parameter passed to the function
+ * @retval 		None
+ */
+void ILI9341SetTransferCallback(void (*func_p)(void*), void *param_p);
+
+/**
+ * @brief  		Waits until every pixel queued to the LCD has been sent
+ * @retval 		None
+ */
+void ILI9341WaitTransfer(void);
+
+/**
+ * @brief  		Starts drawing on an off-screen framebuffer
+ * @note		Whole screen needs 150 KB, taken from external RAM when available.
+ * 				A strip (e.g. a plot area) fits in internal RAM. Initialize it after
+ * 				ILI9341Rotate(), coordinates follow the current orientation.
+ * @param[in]  	x: X position of top left corner of framebuffer area
+ * @param[in]  	y: Y position of top left corner of framebuffer area
+ * @param[in]  	width: Framebuffer width in pixels
+ * @param[in]  	height: Framebuffer height in pixels
+ * @retval 		1 when success, 0 when there is not enough memory
+ */
+uint8_t ILI9341FramebufferInit(uint16_t x, uint16_t y, uint16_t width, uint16_t height);
+
+/**
+ * @brief  		Sends pending changes and stops using the framebuffer
+ * @retval 		None
+ */
+void ILI9341FramebufferDeInit(void);
+
+/**
+ * @brief  		Gets the framebuffer in use
+ * @retval 		Pointer to framebuffer, NULL when drawing goes straight to the LCD
+ */
+framebuffer_t* ILI9341GetFramebuffer(void);
+
+/**
+ * @brief  		Sends the areas of the framebuffer modified since the last flush
+ * @retval 		None
+ */
+void ILI9341Flush(void);
+
 /**
  * @brief  	De-initializes ILI9341 LCD
  * @param	None
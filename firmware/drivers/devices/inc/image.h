@@ -0,0 +1,95 @@
+#ifndef IMAGE_H_
+#define IMAGE_H_
+/** \addtogroup Drivers_Programable Drivers Programable
+ ** @{ */
+/** \addtogroup Drivers_Devices Drivers devices
+ ** @{ */
+/** \addtogroup Image Image
+ ** @{
+ * @brief  RGB565 images stored compressed, decoded while they are sent
+ *
+ * @note IMAGE_QOI565 is a byte oriented format adapted from QOI to RGB565. Each
+ * pixel is one of:
+ * | Code                    | Pixel                                                     |
+ * |:-----------------------:|:----------------------------------------------------------|
+ * | 00iiiiii                | Color at position i of the last 64 colors (hash table)    |
+ * | 01rrggbb                | Previous color + r, g, b (-2 to 1)                        |
+ * | 10gggggg aaaabbbb       | Previous color + g (-32 to 31) on green, a + g/2 on red and b + g/2 on blue (-8 to 7) |
+ * | 11nnnnnn (n < 62)       | Previous color repeated n + 1 times                       |
+ * | 11111110 hhhhhhhh llllllll | Color, high byte first                                |
+ *
+ * Previous color starts as black and the table as all black. Position of a color c
+ * in the table is (3 * red + 5 * green + 7 * blue) % 64.
+ *
+ * @note tools/image_565.py converts images (PNG, BMP, JPG) and raw RGB565 arrays.
+ *
+ * @note This module doesn't depend on the hardware, it can be compiled and tested
+ * on a host computer.
+ *
+ * @section changelog
+ *
+ * |   Date	    | Description                                    |
+ * |:----------:|:-----------------------------------------------|
+ * | 19/10/2026 | Document creation		                         |
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdint.h>
+/*==================[macros]=================================================*/
+#define IMAGE_INDEX_SIZE	64		/*!< Colors kept by the QOI565 hash table */
+/*==================[typedef]================================================*/
+/**
+ * @brief Image data encoding
+ */
+typedef enum {
+	IMAGE_RGB565 = 0,	/*!< 2 bytes per pixel, high byte first, as ILI9341DrawPicture() */
+	IMAGE_QOI565,		/*!< Compressed, see the table above */
+} image_encoding_t;
+
+/**
+ * @brief  Image
+ */
+typedef struct {
+	uint16_t width;					/*!< Width in pixels */
+	uint16_t height;				/*!< Height in pixels */
+	image_encoding_t encoding;		/*!< Data encoding */
+	const uint8_t *data;			/*!< Pixels, row by row */
+} image_t;
+
+/**
+ * @brief  Decoding state, pixels are decoded in pieces of any size
+ */
+typedef struct {
+	const uint8_t *data;						/*!< Next byte to decode */
+	image_encoding_t encoding;					/*!< Data encoding */
+	uint16_t previous;							/*!< Last decoded color */
+	uint8_t run;								/*!< Repetitions of previous color left */
+	uint16_t index[IMAGE_INDEX_SIZE];			/*!< Recently decoded colors */
+} image_decoder_t;
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/**
+ * @brief  		Starts decoding an image from its first pixel
+ * @param[out] 	decoder: Decoding state
+ * @param[in]  	image: Image
+ * @retval 		None
+ */
+void ImageDecodeStart(image_decoder_t *decoder, const image_t *image);
+
+/**
+ * @brief  		Decodes the next pixels of an image
+ * @param[in]  	decoder: Decoding state
+ * @param[out] 	pixels: RGB565 pixels, high byte first (LCD byte order)
+ * @param[in]  	count: Number of pixels to decode
+ * @retval 		None
+ */
+void ImageDecode(image_decoder_t *decoder, uint16_t *pixels, uint32_t count);
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+#endif /* IMAGE_H_ */
+
+/*==================[end of file]============================================*/
@@ -0,0 +1,124 @@
+#ifndef LED_EFFECTS_H
+#define LED_EFFECTS_H
+/** \addtogroup Drivers_Programable Drivers Programable
+ ** @{ */
+/** \addtogroup Drivers_Devices Drivers devices
+ ** @{ */
+/** \addtogroup LED_Effects LED_Effects
+ ** @{ */
+/** \brief Animated effects for RGB LED stripes, rendered from color palettes.
+ *
+ * Colors are computed once, when a palette of LED_PALETTE_SIZE colors is built
+ * (LedPaletteHue(), LedPaletteGradient()). Each frame of an effect only adds a
+ * fixed point step to a palette index and looks up the colors, with no color math
+ * per LED. Positions are 8.8 fixed point: 256 is one palette entry (or one LED
+ * for LED_EFFECT_COMET).
+ *
+ * LedEffectRender() advances the effect by a number of frames and writes the colors
+ * of every LED, so the speed of the animation doesn't depend on how often it is
+ * called. With a NeoPixel stripe use NeoPixelEffect(), the effect is rendered in
+ * the stripe colors once per refresh period:
+ * @code
+ * static uint32_t rainbow[LED_PALETTE_SIZE];
+ * led_effect_t effect;
+ * LedPaletteHue(rainbow, 255, 255);
+ * LedEffectInit(&effect, LED_EFFECT_SCROLL, rainbow, 0x0100, 0x0400);
+ * NeoPixelEffect(&effect);
+ * NeoPixelAutoShow(true);
+ * @endcode
+ *
+ * @note This module doesn't depend on the hardware, it can be compiled and tested
+ * on a host computer (see devices/test_host).
+ *
+ * @section changelog
+ *
+ * |   Date	    | Description                                    						|
+ * |:----------:|:----------------------------------------------------------------------|
+ * | 19/10/2026 | Document creation		                         						|
+ *
+ **/
+/*==================[inclusions]=============================================*/
+#include <stdint.h>
+/*==================[macros]=================================================*/
+#define LED_PALETTE_SIZE	256		/*!< Colors of a palette, indexed by one byte */
+#define LED_EFFECT_ONE		256		/*!< One palette entry (or LED) in 8.8 fixed point */
+/*==================[typedef]================================================*/
+/**
+ * @brief Effects
+ */
+typedef enum {
+	LED_EFFECT_SCROLL,		/*!< Palette spread along the stripe, moving speed entries per frame */
+	LED_EFFECT_PULSE,		/*!< All LEDs of the same color, going through the palette */
+	LED_EFFECT_COMET,		/*!< Head moving speed LEDs per frame, tail of the palette colors down to entry 0 */
+} led_effect_type_t;
+
+/**
+ * @brief Effect state
+ */
+typedef struct {
+	led_effect_type_t type;		/*!< Effect */
+	const uint32_t *palette;	/*!< LED_PALETTE_SIZE colors (0x00RRGGBB) */
+	uint16_t speed;				/*!< Palette entries (LEDs for a comet) advanced per frame, 8.8 fixed point */
+	uint16_t spread;			/*!< Palette entries between neighbour LEDs (tail LEDs for a comet), 8.8 fixed point */
+	uint32_t phase;				/*!< Current position, 8.8 fixed point */
+} led_effect_t;
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/**
+ * @brief Convert hue, saturation and value to a 24 bits color (0x00RRGGBB)
+ *
+ * @param hue 16 bits hue, 0 and 65536 are red
+ * @param sat Saturation
+ * @param val Value or brightness
+ * @return uint32_t 24 bits color
+ */
+uint32_t LedEffectHSV(uint16_t hue, uint8_t sat, uint8_t val);
+
+/**
+ * @brief Build a palette with the whole hue circle, from red back to red
+ *
+ * @param palette Memory for LED_PALETTE_SIZE colors
+ * @param sat Saturation of all the colors
+ * @param val Value or brightness of all the colors
+ */
+void LedPaletteHue(uint32_t *palette, uint8_t sat, uint8_t val);
+
+/**
+ * @brief Build a palette fading between colors, evenly spaced, the last one back to the first
+ *
+ * @note Colors {0, color} give a pulse for LED_EFFECT_PULSE and a fading tail for LED_EFFECT_COMET.
+ *
+ * @param palette Memory for LED_PALETTE_SIZE colors
+ * @param colors 24 bits colors (0x00RRGGBB)
+ * @param count Number of colors, at least 1
+ */
+void LedPaletteGradient(uint32_t *palette, const uint32_t *colors, uint8_t count);
+
+/**
+ * @brief Initialize an effect
+ *
+ * @param effect Effect
+ * @param type Effect type
+ * @param palette LED_PALETTE_SIZE colors, used while the effect runs
+ * @param speed Advance per frame, 8.8 fixed point (LED_EFFECT_ONE is one entry or LED)
+ * @param spread Entries between LEDs or comet tail length, 8.8 fixed point
+ */
+void LedEffectInit(led_effect_t *effect, led_effect_type_t type, const uint32_t *palette, uint16_t speed, uint16_t spread);
+
+/**
+ * @brief Advance an effect and write the colors of all the LEDs
+ *
+ * @param effect Effect
+ * @param colors Colors of the stripe (0x00RRGGBB)
+ * @param len Number of LEDs
+ * @param frames Frames elapsed since the last render, 0 to draw the same frame again
+ */
+void LedEffectRender(led_effect_t *effect, uint32_t *colors, uint16_t len, uint32_t frames);
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+#endif
+
+/*==================[end of file]============================================*/
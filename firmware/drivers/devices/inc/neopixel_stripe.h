@@ -13,6 +13,18 @@
  * (with no limits in the qty of leds in the array).
  * 
  * @note ESP-EDU have one individual NeoPixel connected to GPIO_8, that can be used with this driver.
+ *
+ * @note Functions only change the colors in memory (color_array, the back buffer).
+ * NeoPixelShow() converts them to a frame that is sent in background (about 30 us
+ * per NeoPixel) while the next one is composed. At most one frame is sent per
+ * refresh period, NeoPixelAutoShow() calls NeoPixelShow() every period from a task.
+ * @code
+ * NeoPixelInit(BUILT_IN_RGB_LED_PIN, 60, colors);
+ * for (i = 0; i < 60; i++){
+ *     NeoPixelSetPixel(i, NEOPIXEL_COLOR_RED);
+ * }
+ * NeoPixelShow();     // One frame for the 60 changes
+ * @endcode
  * 
  * @author Albano Peñalva
  *
@@ -21,17 +33,24 @@
  * |   Date	    | Description                                    						|
  * |:----------:|:----------------------------------------------------------------------|
  * | 23/10/2023 | Document creation		                         						|
+ * | 19/10/2026 | Stripe sent as one frame by RMT, the CPU doesn't wait for it			|
+ * | 19/10/2026 | Changes kept in memory until NeoPixelShow(), limited frame rate		|
+ * | 19/10/2026 | Effects rendered from palettes (led_effects.h), fixed point rainbow	|
+ * | 19/10/2026 | NeoPixelShow() reentrant, frame rate kept with tick slack				|
  * 
  **/
 
 /*==================[inclusions]=============================================*/
+#include <stdbool.h>
 #include <stdint.h>
 #include "sdkconfig.h"
 #include "esp_err.h"
 #include "gpio_mcu.h"
+#include "led_effects.h"
 /*==================[macros]=================================================*/
 #define BUILT_IN_RGB_LED_PIN          GPIO_8        /*> ESP32-C6-DevKitC-1 NeoPixel it's connected at GPIO_8 */
 #define BUILT_IN_RGB_LED_LENGTH       1             /*> ESP32-C6-DevKitC-1 NeoPixel has one pixel */
+#define NEOPIXEL_REFRESH_RATE         50            /*> Default maximum frames per second */
 
 #define NEOPIXEL_COLOR_WHITE          0x00FFFFFF  /*> Color white */
 #define NEOPIXEL_COLOR_RED            0x00FF0000  /*> Color red */
@@ -83,7 +102,7 @@ typedef uint32_t neopixel_color_t;
 void NeoPixelInit(gpio_t pin, uint16_t len, neopixel_color_t *color_array);
 
 /**
- * @brief Turn off all NeoPixels.
+ * @brief Turn off all NeoPixels (sets all colors to 0).
  * 
  */
 void NeoPixelAllOff(void);
@@ -106,10 +125,46 @@ void NeoPixelSetPixel(uint16_t pixel, neopixel_color_t color);
 /**
  * @brief Set all NeoPixels in the array with the color stored in an array.
  * 
- * @param color_array Array of 24 bits color
+ * @param color_array Array of 24 bits color, copied unless it is the one given to NeoPixelInit()
  */
 void NeoPixelSetArray(neopixel_color_t *color_array);
 
+/**
+ * @brief Send the colors to the stripe, if they changed and the refresh period has passed.
+ * 
+ * @note Colors are converted before returning, the frame is sent in background.
+ * Changes made meanwhile are sent by the next call.
+ * @note Can be called from several tasks and along with NeoPixelAutoShow(). Frames
+ * are kept on a grid of refresh periods, a frame may be sent up to one tick early.
+ * @return true if a frame was sent, false if there were no changes or it was too soon
+ */
+bool NeoPixelShow(void);
+
+/**
+ * @brief Change the maximum number of frames per second sent by NeoPixelShow().
+ * 
+ * @param fps Frames per second, NEOPIXEL_REFRESH_RATE by default. 0 for no limit.
+ */
+void NeoPixelSetRefreshRate(uint8_t fps);
+
+/**
+ * @brief Start or stop a task that calls NeoPixelShow() once every refresh period.
+ * 
+ * @note Changes made while a frame is converted may appear partially in it,
+ * call NeoPixelShow() explicitly when several changes must be shown together.
+ * @param enable true to start, false to stop
+ */
+void NeoPixelAutoShow(bool enable);
+
+/**
+ * @brief Render an effect in the stripe colors before each frame sent by NeoPixelShow().
+ * 
+ * @note The effect advances one frame per refresh period (see led_effects.h), with
+ * NeoPixelAutoShow() it runs without further calls.
+ * @param effect Effect, used while it runs. NULL to stop it, the colors keep the last frame.
+ */
+void NeoPixelEffect(led_effect_t *effect);
+
 /**
  * @brief Shift the all NeoPixel colors in the array 1 position (up or down)
  * 
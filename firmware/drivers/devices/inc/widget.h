@@ -0,0 +1,216 @@
+#ifndef WIDGET_H_
+#define WIDGET_H_
+/** \addtogroup Drivers_Programable Drivers Programable
+ ** @{ */
+/** \addtogroup Drivers_Devices Drivers devices
+ ** @{ */
+/** \addtogroup Widget Widget
+ ** @{
+ * @brief  Retained widgets (labels, bars, gauges and plots) redrawn only where they change
+ *
+ * @note Widgets keep their bounds and value. Changing a value marks only the
+ * affected area of the screen (the part of a bar between the old and the new
+ * value, the old and new needle of a gauge, the new column of a plot). The
+ * areas are merged like in the framebuffer and WidgetRender() draws each one
+ * in RAM, in bands of up to WIDGET_BAND_PIXELS, handing them to an output
+ * function that sends them to the display.
+ *
+ * @note With an ILI9341 LCD use ILI9341WidgetOutput() as output function:
+ * @code
+ * widget_screen_t screen;
+ * widget_t speed;
+ * WidgetScreenInit(&screen, ILI9341_WIDTH, ILI9341_HEIGHT, ILI9341_WHITE, ILI9341WidgetOutput, NULL);
+ * WidgetBarInit(&speed, 10, 10, 200, 20, 0, 100, ILI9341_BLUE, ILI9341_LIGHTGREY);
+ * WidgetAdd(&screen, &speed);
+ * WidgetSetValue(&speed, 42);
+ * WidgetRender(&screen);
+ * @endcode
+ *
+ * @note This module doesn't depend on the hardware, it can be compiled and tested
+ * on a host computer (see devices/test_host).
+ *
+ * @section changelog
+ *
+ * |   Date	    | Description                                    |
+ * |:----------:|:-----------------------------------------------|
+ * | 19/10/2026 | Document creation		                         |
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdint.h>
+#include "framebuffer.h"
+#include "fonts.h"
+/*==================[macros]=================================================*/
+#define WIDGET_TEXT_SIZE	24		/*!< Maximum label length, including '\0' */
+#define WIDGET_BAND_PIXELS	2046	/*!< Pixels rendered at a time, 2 bytes each (one ILI9341 DMA buffer) */
+#define WIDGET_NO_SAMPLE	0xFF	/*!< Plot column without sample */
+/*==================[typedef]================================================*/
+/**
+ * @brief  Function that sends a rendered area to the display
+ * @param[in]  	rect: Area, limits included
+ * @param[in]  	pixels: Area pixels row by row, RGB565 high byte first
+ * @param[in]  	param: Parameter given to WidgetScreenInit()
+ */
+typedef void (*widget_output_t)(const fb_rect_t *rect, const uint16_t *pixels, void *param);
+
+/**
+ * @brief  Widget types
+ */
+typedef enum {
+	WIDGET_LABEL,		/*!< Text */
+	WIDGET_BAR,			/*!< Horizontal bar filled from the left */
+	WIDGET_GAUGE,		/*!< Needle over half a turn, pivot at the bottom center */
+	WIDGET_PLOT,		/*!< Sweeping plot, new samples overwrite the oldest ones */
+} widget_type_t;
+
+struct widget_screen_s;
+
+/**
+ * @brief  Widget
+ */
+typedef struct widget_s {
+	widget_type_t type;					/*!< Widget type */
+	fb_rect_t bounds;					/*!< Area on screen, limits included */
+	uint16_t color;						/*!< Text, bar, needle or trace color (RGB565) */
+	uint16_t background;				/*!< Background color (RGB565) */
+	int32_t value;						/*!< Current value */
+	int32_t min;						/*!< Value at the left or bottom */
+	int32_t max;						/*!< Value at the right or top */
+	char text[WIDGET_TEXT_SIZE];		/*!< Label text */
+	const Font_t *font;					/*!< Label font */
+	uint8_t *samples;					/*!< Plot row of each column from the top, WIDGET_NO_SAMPLE if none */
+	uint16_t cursor;					/*!< Plot column of the next sample */
+	struct widget_s *next;				/*!< Next widget on the screen */
+	struct widget_screen_s *screen;		/*!< Screen the widget was added to */
+} widget_t;
+
+/**
+ * @brief  Screen, list of widgets drawn over a background
+ */
+typedef struct widget_screen_s {
+	widget_t *first;					/*!< First widget, drawn first */
+	uint16_t background;				/*!< Color where there are no widgets (RGB565) */
+	framebuffer_t area;					/*!< Screen area and dirty list, without pixels */
+	widget_output_t output;				/*!< Sends rendered areas */
+	void *param;						/*!< Parameter of output */
+} widget_screen_t;
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/**
+ * @brief  		Initializes an empty screen
+ * @param[out] 	screen: Screen
+ * @param[in]  	width: Screen width in pixels
+ * @param[in]  	height: Screen height in pixels
+ * @param[in]  	background: Color where there are no widgets (RGB565)
+ * @param[in]  	output: Function that sends rendered areas to the display
+ * @param[in]  	param: Parameter passed to output
+ * @retval 		None
+ */
+void WidgetScreenInit(widget_screen_t *screen, uint16_t width, uint16_t height, uint16_t background, widget_output_t output, void *param);
+
+/**
+ * @brief  		Initializes a label
+ * @param[out] 	widget: Widget
+ * @param[in]  	x: X position of top left corner
+ * @param[in]  	y: Y position of top left corner
+ * @param[in]  	width: Width in pixels, longer text is cut
+ * @param[in]  	height: Height in pixels
+ * @param[in]  	font: Font
+ * @param[in]  	color: Text color (RGB565)
+ * @param[in]  	background: Background color (RGB565)
+ * @retval 		None
+ */
+void WidgetLabelInit(widget_t *widget, int16_t x, int16_t y, uint16_t width, uint16_t height, const Font_t *font, uint16_t color, uint16_t background);
+
+/**
+ * @brief  		Initializes a horizontal bar
+ * @param[out] 	widget: Widget
+ * @param[in]  	x: X position of top left corner
+ * @param[in]  	y: Y position of top left corner
+ * @param[in]  	width: Width in pixels
+ * @param[in]  	height: Height in pixels
+ * @param[in]  	min: Value of an empty bar
+ * @param[in]  	max: Value of a full bar
+ * @param[in]  	color: Bar color (RGB565)
+ * @param[in]  	background: Background color (RGB565)
+ * @retval 		None
+ */
+void WidgetBarInit(widget_t *widget, int16_t x, int16_t y, uint16_t width, uint16_t height, int32_t min, int32_t max, uint16_t color, uint16_t background);
+
+/**
+ * @brief  		Initializes a gauge
+ * @param[out] 	widget: Widget
+ * @param[in]  	x: X position of top left corner
+ * @param[in]  	y: Y position of top left corner
+ * @param[in]  	width: Width in pixels
+ * @param[in]  	height: Height in pixels
+ * @param[in]  	min: Value with the needle to the left
+ * @param[in]  	max: Value with the needle to the right
+ * @param[in]  	color: Needle color (RGB565)
+ * @param[in]  	background: Background color (RGB565)
+ * @retval 		None
+ */
+void WidgetGaugeInit(widget_t *widget, int16_t x, int16_t y, uint16_t width, uint16_t height, int32_t min, int32_t max, uint16_t color, uint16_t background);
+
+/**
+ * @brief  		Initializes a sweeping plot
+ * @param[out] 	widget: Widget
+ * @param[in]  	x: X position of top left corner
+ * @param[in]  	y: Y position of top left corner
+ * @param[in]  	width: Width in pixels, one sample per column
+ * @param[in]  	height: Height in pixels, up to 255
+ * @param[in]  	samples: Memory for width samples
+ * @param[in]  	min: Value at the bottom
+ * @param[in]  	max: Value at the top
+ * @param[in]  	color: Trace color (RGB565)
+ * @param[in]  	background: Background color (RGB565)
+ * @retval 		None
+ */
+void WidgetPlotInit(widget_t *widget, int16_t x, int16_t y, uint16_t width, uint16_t height, uint8_t *samples, int32_t min, int32_t max, uint16_t color, uint16_t background);
+
+/**
+ * @brief  		Adds a widget on top of the others of a screen
+ * @param[in]  	screen: Screen
+ * @param[in]  	widget: Initialized widget
+ * @retval 		None
+ */
+void WidgetAdd(widget_screen_t *screen, widget_t *widget);
+
+/**
+ * @brief  		Changes the value of a bar or gauge, or adds a sample to a plot
+ * @param[in]  	widget: Widget
+ * @param[in]  	value: Value, limited to min and max
+ * @retval 		None
+ */
+void WidgetSetValue(widget_t *widget, int32_t value);
+
+/**
+ * @brief  		Changes the text of a label
+ * @param[in]  	widget: Widget
+ * @param[in]  	text: Text, up to WIDGET_TEXT_SIZE - 1 characters
+ * @retval 		None
+ */
+void WidgetSetText(widget_t *widget, const char *text);
+
+/**
+ * @brief  		Marks a whole widget to be drawn again
+ * @param[in]  	widget: Widget
+ * @retval 		None
+ */
+void WidgetInvalidate(widget_t *widget);
+
+/**
+ * @brief  		Draws and sends the areas changed since the last render
+ * @param[in]  	screen: Screen
+ * @retval 		Number of pixels sent
+ */
+uint32_t WidgetRender(widget_screen_t *screen);
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+#endif /* WIDGET_H_ */
+
+/*==================[end of file]============================================*/
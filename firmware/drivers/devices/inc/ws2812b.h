@@ -11,6 +11,23 @@
 /** \brief Driver for handling WS2812B RGB leds.
  *
  * @note For handling NeoPixels arrays use "neopixel_stripe.h".
+ *
+ * @note The bytes of a whole frame are prepared in RAM, with brightness and gamma
+ * correction applied, and sent by the RMT peripheral: its bytes encoder expands
+ * each bit to the WS2812B waveform (see ws2812b_encoder.h). Timing doesn't depend
+ * on the CPU, which is free while the frame is sent.
+ *
+ * @note There are two frame buffers (3 bytes per NeoPixel each): the next frame is
+ * converted while the previous one is being sent.
+ *
+ * @note Up to WS2812B_PARALLEL_STRIPS stripes can be refreshed at the same time, in
+ * the time of one, from the pins of a dedicated GPIO bundle (see gpio_fast_out_mcu.h):
+ * ws2812bParallelInit() and ws2812bParallelSendColors(). The frame is prepared in
+ * RAM (1 byte per bit, 24 bytes per NeoPixel) and sent by the CPU, 28.8 us per
+ * NeoPixel. Interrupts are disabled while each NeoPixel is sent and run between
+ * them, with the outputs low. The scheduler is suspended for the whole frame, so
+ * tasks woken by those interrupts run after it. Only an ISR longer than the reset
+ * time (50 us on older LEDs) would latch part of the frame.
  * 
  * @author Albano Peñalva
  *
@@ -19,20 +36,31 @@
  * |   Date	    | Description                                    						|
  * |:----------:|:----------------------------------------------------------------------|
  * | 23/10/2023 | Document creation		                         						|
+ * | 19/10/2026 | Frames sent by RMT instead of bit-banging								|
+ * | 19/10/2026 | Brightness merged with gamma correction, 24 bits color frames			|
+ * | 19/10/2026 | Two frame buffers, a frame is converted while the previous one is sent	|
+ * | 19/10/2026 | Up to 8 stripes sent at the same time from a GPIO bundle				|
+ * | 19/10/2026 | Frames kept as 3 bytes per NeoPixel, expanded by the RMT				|
+ * | 19/10/2026 | Parallel frames sent with interrupts disabled one NeoPixel at a time	|
+ * | 19/10/2026 | No task switch in the middle of a parallel frame						|
  * 
  **/
 
 /*==================[inclusions]=============================================*/
+#include <stdbool.h>
 #include <stdint.h>
 #include "sdkconfig.h"
 #include "esp_err.h"
 #include "gpio_mcu.h"
+#include "ws2812b_encoder.h"
 /*==================[macros]=================================================*/
+#define WS2812B_PARALLEL_MAX_LEDS	256		/*!< NeoPixels of each parallel stripe, the CPU is busy 7.4 ms per frame */
 
 /*==================[typedef]================================================*/
 /**
  * @brief NeoPixel color
  * 
+ * @note Fields follow the order the bytes are sent to the LEDs.
  */
 typedef struct rgb_led{
 	 uint8_t green;  		// Green
@@ -47,21 +75,83 @@ typedef struct rgb_led{
  * @brief NeoPixel initialization.
  * 
  * @param pin GPIO number where NeoPixel data pin (DIN) will be connected
+ * @param len Maximum number of NeoPixels sent in a frame
+ */
+void ws2812bInit(gpio_t pin, uint16_t len);
+
+/**
+ * @brief Parallel stripes initialization.
+ * 
+ * @param pins GPIO number of the data pin (DIN) of each stripe
+ * @param strips Number of stripes, up to WS2812B_PARALLEL_STRIPS
+ * @param len Maximum number of NeoPixels of each stripe, up to WS2812B_PARALLEL_MAX_LEDS
+ */
+void ws2812bParallelInit(gpio_t *pins, uint8_t strips, uint16_t len);
+
+/**
+ * @brief Change the brightness applied to the colors of the next frames.
+ * 
+ * @note Applies to single and parallel stripes.
+ * 
+ * @note Brightness and gamma correction are merged in a single table, built here.
+ * 
+ * @param bright Brightness level (0 to 255), 255 by default
+ */
+void ws2812bSetBrightness(uint8_t bright);
+
+/**
+ * @brief Send the colors of a frame, with brightness and gamma correction, without waiting for the transfer.
+ * 
+ * @note Only waits when two frames are still being sent. The colors are converted
+ * before returning, the array can be changed right away.
+ * 
+ * @param leds NeoPixel colors, from the first NeoPixel of the stripe
+ * @param len Number of NeoPixels
+ */
+void ws2812bSendArray(const rgb_led_t *leds, uint16_t len);
+
+/**
+ * @brief Send a frame of 24 bits colors (0x00RRGGBB), without waiting for the transfer.
+ * 
+ * @note Like ws2812bSendArray(), colors are converted before returning.
+ * 
+ * @param colors 24 bits colors, from the first NeoPixel of the stripe
+ * @param len Number of NeoPixels
+ */
+void ws2812bSendColors(const uint32_t *colors, uint16_t len);
+
+/**
+ * @brief Send a frame with all NeoPixels of the same color, without waiting for the transfer.
+ * 
+ * @param color 24 bits color (0x00RRGGBB)
+ * @param len Number of NeoPixels
+ */
+void ws2812bSendColor(uint32_t color, uint16_t len);
+
+/**
+ * @brief Send a frame of 24 bits colors (0x00RRGGBB) to each parallel stripe, waiting for the transfer.
+ * 
+ * @note The CPU sends the frame (len * 28.8 us), with interrupts disabled for one
+ * NeoPixel (28.8 us) at a time and the scheduler suspended until the frame ends.
+ * Must not be called from an ISR.
+ * 
+ * @param colors 24 bits colors of each stripe, NULL for a stripe turned off
+ * @param len Number of NeoPixels of each stripe, up to WS2812B_PARALLEL_MAX_LEDS
  */
-void ws2812bInit(gpio_t pin);
+void ws2812bParallelSendColors(const uint32_t *const *colors, uint16_t len);
 
 /**
- * @brief Send color information to NeoPixel.
+ * @brief Check if a frame is being sent.
  * 
- * @param data NeoPixel color
+ * @return true while frames are being sent
  */
-void ws2812bSend(rgb_led_t led_color);
+bool ws2812bBusy(void);
 
 /**
- * @brief Send a ret command to NeoPixel.
+ * @brief Wait until the last frame has been sent.
  * 
  */
-void ws2812bSendRet(void);
+void ws2812bWait(void);
 
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
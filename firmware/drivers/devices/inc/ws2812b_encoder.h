@@ -0,0 +1,129 @@
+#ifndef WS2812B_ENCODER_H
+#define WS2812B_ENCODER_H
+/** \addtogroup Drivers_Programable Drivers Programable
+ ** @{ */
+/** \addtogroup Drivers_Devices Drivers devices
+ ** @{ */
+/** \addtogroup WS2812B WS2812B
+ ** @{ */
+/** \brief WS2812B waveform as RMT symbols.
+ *
+ * Each bit sent to the LEDs is one symbol (high, then low) at WS2812B_RESOLUTION
+ * ticks per second, most significant bit first. A frame ends with a low symbol
+ * longer than the reset time, so the LEDs latch the new colors.
+ *
+ * |  Bit  | High           | Low            |
+ * |:-----:|:--------------:|:--------------:|
+ * |   0   | 0.4 us         | 0.8 us         |
+ * |   1   | 0.8 us         | 0.4 us         |
+ *
+ * The driver keeps only the bytes of each frame (ws2812bPackColors()) and the RMT
+ * bytes encoder expands them into these symbols while they are sent, followed by
+ * WS2812B_RESET_SYMBOL.
+ *
+ * Brightness and gamma correction are merged in a single 256 entries table,
+ * built with ws2812bBuildLut() when one of them changes, so each color byte
+ * costs one lookup.
+ *
+ * Up to WS2812B_PARALLEL_STRIPS stripes can be sent at the same time from the pins of
+ * a GPIO bundle: bit s of each word is the level of stripe s. ws2812bEncodeParallel()
+ * transposes the bytes of the stripes, 8 at a time, into one word per bit.
+ *
+ * @note This module doesn't depend on the hardware, it can be compiled and tested
+ * on a host computer (see devices/test_host).
+ *
+ * @section changelog
+ *
+ * |   Date	    | Description                                    						|
+ * |:----------:|:----------------------------------------------------------------------|
+ * | 19/10/2026 | Document creation		                         						|
+ * | 19/10/2026 | 24 bits colors encoded in one pass, brightness and gamma table		|
+ * | 19/10/2026 | Parallel stripes, bytes transposed to one word per bit				|
+ * | 19/10/2026 | Frames packed as bytes for the RMT bytes encoder						|
+ * | 19/10/2026 | Symbols only expanded by the RMT bytes encoder						|
+ * 
+ **/
+/*==================[inclusions]=============================================*/
+#include <stdint.h>
+#include "rmt_mcu.h"
+/*==================[macros]=================================================*/
+#define WS2812B_RESOLUTION		10000000	/*!< Symbol ticks per second (0.1 us) */
+#define WS2812B_T0H				4			/*!< Ticks high of a 0 bit */
+#define WS2812B_T0L				8			/*!< Ticks low of a 0 bit */
+#define WS2812B_T1H				8			/*!< Ticks high of a 1 bit */
+#define WS2812B_T1L				4			/*!< Ticks low of a 1 bit */
+#define WS2812B_RESET			2800		/*!< Ticks low at the end of a frame (280 us, newer LEDs need more than 50 us) */
+#define WS2812B_LED_BYTES		3			/*!< Bytes per LED: green, red, blue */
+#define WS2812B_MAX_BRIGHT		255			/*!< Brightness that keeps the colors */
+#define WS2812B_PARALLEL_STRIPS	8			/*!< Stripes sent at the same time, one bit of each word */
+
+#define WS2812B_BIT_0_SYMBOL	RMT_SYMBOL(1, WS2812B_T0H, 0, WS2812B_T0L)				/*!< Waveform of a 0 bit */
+#define WS2812B_BIT_1_SYMBOL	RMT_SYMBOL(1, WS2812B_T1H, 0, WS2812B_T1L)				/*!< Waveform of a 1 bit */
+#define WS2812B_RESET_SYMBOL	RMT_SYMBOL(0, WS2812B_RESET / 2, 0, WS2812B_RESET / 2)	/*!< Low for the reset time */
+
+/**
+ * @brief Words needed to send a frame of leds LEDs to parallel stripes, one per bit
+ */
+#define WS2812B_PARALLEL_WORDS(leds)	((uint32_t)(leds) * WS2812B_LED_BYTES * 8)
+/*==================[typedef]================================================*/
+
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/**
+ * @brief Applies the table to the bytes of a frame, for the RMT bytes encoder.
+ * 
+ * @param bytes Bytes in the order they are sent (green, red, blue of each LED)
+ * @param count Number of bytes
+ * @param lut Table applied to each byte (brightness and gamma correction)
+ * @param frame Memory for count bytes
+ * @return uint32_t Number of bytes written
+ */
+uint32_t ws2812bPackBytes(const uint8_t *bytes, uint32_t count, const uint8_t *lut, uint8_t *frame);
+
+/**
+ * @brief Converts 24 bits colors (0x00RRGGBB) to the bytes sent to the LEDs, for the RMT bytes encoder.
+ * 
+ * @param colors Colors, from the first LED of the stripe
+ * @param leds Number of LEDs
+ * @param lut Table applied to each color byte (brightness and gamma correction)
+ * @param frame Memory for leds * WS2812B_LED_BYTES bytes
+ * @return uint32_t Number of bytes written
+ */
+uint32_t ws2812bPackColors(const uint32_t *colors, uint32_t leds, const uint8_t *lut, uint8_t *frame);
+
+/**
+ * @brief Transposes 8 bytes into 8 words, one per bit.
+ * 
+ * @param bytes Byte of each stripe
+ * @param words Word of each bit, most significant bit first: bit s of words[k] is bit 7 - k of bytes[s]
+ */
+void ws2812bTranspose(const uint8_t *bytes, uint8_t *words);
+
+/**
+ * @brief Converts the 24 bits colors (0x00RRGGBB) of up to 8 stripes to one word per bit.
+ * 
+ * @param colors Colors of each stripe, NULL for a stripe kept off
+ * @param strips Number of stripes, up to WS2812B_PARALLEL_STRIPS
+ * @param leds Number of LEDs of each stripe
+ * @param lut Table applied to each color byte (brightness and gamma correction)
+ * @param words Memory for WS2812B_PARALLEL_WORDS(leds) words
+ * @return uint32_t Number of words written
+ */
+uint32_t ws2812bEncodeParallel(const uint32_t *const *colors, uint8_t strips, uint32_t leds, const uint8_t *lut, uint8_t *words);
+
+/**
+ * @brief Builds the table that applies brightness and then gamma correction to a color byte.
+ * 
+ * @param gamma Gamma correction table, NULL for none
+ * @param bright Brightness, 0 to WS2812B_MAX_BRIGHT
+ * @param lut Table of 256 entries
+ */
+void ws2812bBuildLut(const uint8_t *gamma, uint8_t bright, uint8_t *lut);
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+#endif
+
+/*==================[end of file]============================================*/
@@ -1,5 +1,5 @@
 /**
- * @file icons.c
+ * @file fonts.c
  * @author Albano Peñalva (albano.penalva@uner.edu.ar)
  * @brief 
  * @version 0.1
@@ -11,13 +11,41 @@
 
 /*==================[inclusions]=============================================*/
 #include "fonts.h"
+#include <stddef.h>
 /*==================[macros and definitions]=================================*/
-
+#define MSK_BIT8 0x80							/*!< 8th bit mask */
+#define RLE_CONTINUE 15							/*!< Run length that continues on the next nibble */
+#define SWAP(c) ((uint16_t)((c) >> 8 | (c) << 8))	/*!< RGB565 color to LCD byte order */
+#define FIRST_CHAR ' '							/*!< First character of fonts */
+#define LAST_CHAR '~'							/*!< Last character of fonts */
+#define RGB565_SPREAD 0x07E0F81F				/*!< Green moved to the high half, leaves room to multiply every channel */
 /*==================[internal data declaration]==============================*/
+/**
+ * @brief Expanded glyph in cache
+ */
+typedef struct{
+	const Font_t *font;		/*!< Font */
+	char c;					/*!< Character */
+	uint16_t foreground;	/*!< Glyph color */
+	uint16_t background;	/*!< Background color */
+	uint16_t offset;		/*!< First pixel in font_cache */
+} glyph_entry_t;
 
 /*==================[internal functions declaration]=========================*/
+/**
+ * @brief  		Reads the next run length of a RLE glyph
+ * @param[in]  	reader: Glyph reader
+ * @retval 		Run length, RLE_CONTINUE if the run continues
+ */
+static uint8_t NextRun(glyph_reader_t *reader);
 
 /*==================[internal data definition]===============================*/
+static uint16_t font_cache[FONT_CACHE_SIZE / 2];					/*!< Expanded glyphs */
+static glyph_entry_t font_cache_entry[FONT_CACHE_ENTRIES];			/*!< Glyphs in cache */
+static uint16_t font_cache_used = 0;								/*!< Pixels of font_cache in use */
+static uint8_t font_cache_count = 0;								/*!< Number of glyphs in cache */
+static uint32_t font_cache_generation = 0;							/*!< Incremented when cache restarts */
+
 /**
  * @brief 11 pixels height data array. 
  */
@@ -23687,7 +23715,136 @@ Font_t font_89 = {
 };
 
 /*==================[internal functions definition]==========================*/
+static uint8_t NextRun(glyph_reader_t *reader){
+	uint8_t run;
+	if (reader->low_nibble){
+		run = *reader->data++ & 0x0F;
+	}
+	else{
+		run = *reader->data >> 4;
+	}
+	reader->low_nibble = !reader->low_nibble;
+	return run;
+}
 
 /*==================[external functions definition]==========================*/
+bool FontHasChar(char c){
+	return (c >= FIRST_CHAR) && (c <= LAST_CHAR);
+}
+
+uint16_t FontBlend(uint16_t foreground, uint16_t background, uint8_t alpha){
+	uint32_t fg = (foreground | (uint32_t)foreground << 16) & RGB565_SPREAD;
+	uint32_t bg = (background | (uint32_t)background << 16) & RGB565_SPREAD;
+	uint32_t mix;
+
+	/* 0 to 15 coverage as 0 to 16 weight, all channels mixed with one multiply each */
+	alpha += alpha >> 3;
+	mix = ((fg * alpha + bg * (16 - alpha)) >> 4) & RGB565_SPREAD;
+	return (uint16_t)(mix | mix >> 16);
+}
+
+void FontGlyphStart(glyph_reader_t *reader, const Font_t *font, char c, uint16_t foreground, uint16_t background){
+	uint8_t i;
+
+	reader->data = &font->data[font->info[c - FIRST_CHAR].offset];
+	reader->width = font->info[c - FIRST_CHAR].width;
+	reader->encoding = font->encoding;
+	reader->low_nibble = false;
+	reader->run = 0;
+	/* First run is background, ink toggles before reading it */
+	reader->ink = true;
+	/* Colors of the glyph are computed once, pixels only look them up */
+	if (font->encoding == FONT_4BPP){
+		for (i = 0; i <= FONT_ALPHA_MAX; i++){
+			reader->ramp[i] = SWAP(FontBlend(foreground, background, i));
+		}
+	}
+	else{
+		reader->ramp[0] = SWAP(background);
+		reader->ramp[FONT_ALPHA_MAX] = SWAP(foreground);
+	}
+}
+
+void FontGlyphAlphaRow(glyph_reader_t *reader, uint8_t *alpha){
+	uint8_t j, run;
+
+	if (reader->encoding == FONT_RLE){
+		for (j = 0; j < reader->width; j++){
+			/* Runs can end on any pixel, also across rows */
+			while (reader->run == 0){
+				reader->ink = !reader->ink;
+				do{
+					run = NextRun(reader);
+					reader->run += run;
+				} while (run == RLE_CONTINUE);
+			}
+			alpha[j] = reader->ink ? FONT_ALPHA_MAX : 0;
+			reader->run--;
+		}
+	}
+	else if (reader->encoding == FONT_4BPP){
+		for (j = 0; j < reader->width; j++){
+			alpha[j] = (j & 1) ? (reader->data[j / 2] & 0x0F) : (reader->data[j / 2] >> 4);
+		}
+		reader->data += (reader->width + 1) / 2;
+	}
+	else{
+		for (j = 0; j < reader->width; j++){
+			alpha[j] = (reader->data[j / 8] & (MSK_BIT8 >> (j % 8))) ? FONT_ALPHA_MAX : 0;
+		}
+		reader->data += (reader->width + 7) / 8;
+	}
+}
+
+void FontGlyphRow(glyph_reader_t *reader, uint16_t *row){
+	uint8_t alpha[UINT8_MAX];
+	uint8_t j;
+
+	FontGlyphAlphaRow(reader, alpha);
+	for (j = 0; j < reader->width; j++){
+		row[j] = reader->ramp[alpha[j]];
+	}
+}
+
+const uint16_t * FontGlyphCacheGet(const Font_t *font, char c, uint16_t foreground, uint16_t background){
+	glyph_reader_t reader;
+	glyph_entry_t *entry;
+	uint16_t i, pixels;
+
+	for (i = 0; i < font_cache_count; i++){
+		entry = &font_cache_entry[i];
+		if (entry->font == font && entry->c == c && entry->foreground == foreground && entry->background == background){
+			return &font_cache[entry->offset];
+		}
+	}
+	pixels = font->info[c - FIRST_CHAR].width * font->font_height;
+	/* Big glyphs would empty the cache too often */
+	if (pixels > sizeof(font_cache) / sizeof(font_cache[0]) / 4){
+		return NULL;
+	}
+	/* Cache full, start again */
+	if (font_cache_count == FONT_CACHE_ENTRIES || font_cache_used + pixels > sizeof(font_cache) / sizeof(font_cache[0])){
+		font_cache_count = 0;
+		font_cache_used = 0;
+		font_cache_generation++;
+	}
+	entry = &font_cache_entry[font_cache_count++];
+	entry->font = font;
+	entry->c = c;
+	entry->foreground = foreground;
+	entry->background = background;
+	entry->offset = font_cache_used;
+	font_cache_used += pixels;
+
+	FontGlyphStart(&reader, font, c, foreground, background);
+	for (i = 0; i < font->font_height; i++){
+		FontGlyphRow(&reader, &font_cache[entry->offset + i * reader.width]);
+	}
+	return &font_cache[entry->offset];
+}
+
+uint32_t FontGlyphCacheGeneration(void){
+	return font_cache_generation;
+}
 
 /*==================[end of file]============================================*/
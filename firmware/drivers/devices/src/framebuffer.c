@@ -0,0 +1,247 @@
+/**
+ * @file framebuffer.c
+ * @brief RGB565 off-screen framebuffer with dirty-rectangle tracking
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include "framebuffer.h"
+#include <string.h>
+/*==================[macros and definitions]=================================*/
+#define MSK_BIT8 0x80							/*!< 8th bit mask */
+#define SWAP(c) ((uint16_t)((c) >> 8 | (c) << 8))	/*!< RGB565 color to LCD byte order */
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+/**
+ * @brief  		Number of pixels of a rectangle
+ * @param[in]  	rect: Rectangle
+ * @retval 		Area in pixels
+ */
+static int32_t RectArea(const fb_rect_t *rect);
+
+/**
+ * @brief  		Smallest rectangle containing two rectangles
+ * @param[in]  	a: First rectangle
+ * @param[in]  	b: Second rectangle
+ * @param[out] 	result: Union
+ * @retval 		None
+ */
+static void RectUnion(const fb_rect_t *a, const fb_rect_t *b, fb_rect_t *result);
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static int32_t RectArea(const fb_rect_t *rect){
+	return (int32_t)(rect->x1 - rect->x0 + 1) * (rect->y1 - rect->y0 + 1);
+}
+
+static void RectUnion(const fb_rect_t *a, const fb_rect_t *b, fb_rect_t *result){
+	result->x0 = (a->x0 < b->x0) ? a->x0 : b->x0;
+	result->y0 = (a->y0 < b->y0) ? a->y0 : b->y0;
+	result->x1 = (a->x1 > b->x1) ? a->x1 : b->x1;
+	result->y1 = (a->y1 > b->y1) ? a->y1 : b->y1;
+}
+
+/*==================[external functions definition]==========================*/
+void FramebufferInit(framebuffer_t *fb, uint16_t *pixels, int16_t x, int16_t y, uint16_t width, uint16_t height){
+	fb->pixels = pixels;
+	fb->x = x;
+	fb->y = y;
+	fb->width = width;
+	fb->height = height;
+	fb->dirty_count = 0;
+}
+
+bool FramebufferClip(const framebuffer_t *fb, fb_rect_t *rect){
+	if (rect->x0 < fb->x){
+		rect->x0 = fb->x;
+	}
+	if (rect->y0 < fb->y){
+		rect->y0 = fb->y;
+	}
+	if (rect->x1 > fb->x + fb->width - 1){
+		rect->x1 = fb->x + fb->width - 1;
+	}
+	if (rect->y1 > fb->y + fb->height - 1){
+		rect->y1 = fb->y + fb->height - 1;
+	}
+	return (rect->x0 <= rect->x1) && (rect->y0 <= rect->y1);
+}
+
+bool FramebufferContains(const framebuffer_t *fb, const fb_rect_t *rect){
+	return (rect->x0 >= fb->x) && (rect->y0 >= fb->y) &&
+		(rect->x1 < fb->x + fb->width) && (rect->y1 < fb->y + fb->height);
+}
+
+void FramebufferInvalidate(framebuffer_t *fb, const fb_rect_t *rect){
+	fb_rect_t merged = *rect;
+	fb_rect_t aux;
+	uint8_t i, best;
+	int32_t growth, best_growth;
+
+	while (1){
+		/* Merge with every area that costs less than sending a new window.
+		The union may now reach other areas, so the search starts again */
+		i = 0;
+		while (i < fb->dirty_count){
+			RectUnion(&fb->dirty[i], &merged, &aux);
+			if (RectArea(&aux) - RectArea(&fb->dirty[i]) - RectArea(&merged) <= FB_MERGE_PIXELS){
+				merged = aux;
+				fb->dirty[i] = fb->dirty[--fb->dirty_count];
+				i = 0;
+			}
+			else{
+				i++;
+			}
+		}
+		if (fb->dirty_count < FB_MAX_DIRTY){
+			fb->dirty[fb->dirty_count++] = merged;
+			return;
+		}
+		/* List is full, merge with the area that grows less */
+		best = 0;
+		best_growth = INT32_MAX;
+		for (i = 0; i < fb->dirty_count; i++){
+			RectUnion(&fb->dirty[i], &merged, &aux);
+			growth = RectArea(&aux) - RectArea(&fb->dirty[i]);
+			if (growth < best_growth){
+				best_growth = growth;
+				best = i;
+			}
+		}
+		RectUnion(&fb->dirty[best], &merged, &merged);
+		fb->dirty[best] = fb->dirty[--fb->dirty_count];
+	}
+}
+
+bool FramebufferTakeDirty(framebuffer_t *fb, fb_rect_t *rect){
+	if (fb->dirty_count == 0){
+		return false;
+	}
+	*rect = fb->dirty[--fb->dirty_count];
+	return true;
+}
+
+uint16_t * FramebufferPixel(const framebuffer_t *fb, int16_t x, int16_t y){
+	return &fb->pixels[(int32_t)(y - fb->y) * fb->width + (x - fb->x)];
+}
+
+uint16_t FramebufferGetPixel(const framebuffer_t *fb, int16_t x, int16_t y){
+	uint16_t pixel = *FramebufferPixel(fb, x, y);
+	return SWAP(pixel);
+}
+
+void FramebufferDrawPixel(framebuffer_t *fb, int16_t x, int16_t y, uint16_t color){
+	fb_rect_t rect = {x, y, x, y};
+	if (!FramebufferClip(fb, &rect)){
+		return;
+	}
+	*FramebufferPixel(fb, x, y) = SWAP(color);
+	FramebufferInvalidate(fb, &rect);
+}
+
+void FramebufferFill(framebuffer_t *fb, const fb_rect_t *rect, uint16_t color){
+	fb_rect_t clip = *rect;
+	uint16_t *row;
+	int16_t i, j;
+
+	if (!FramebufferClip(fb, &clip)){
+		return;
+	}
+	color = SWAP(color);
+	for (i = clip.y0; i <= clip.y1; i++){
+		row = FramebufferPixel(fb, clip.x0, i);
+		for (j = 0; j <= clip.x1 - clip.x0; j++){
+			row[j] = color;
+		}
+	}
+	FramebufferInvalidate(fb, &clip);
+}
+
+void FramebufferDrawLine(framebuffer_t *fb, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color){
+	fb_rect_t clip = {x0, y0, x1, y1};
+	int16_t x_dist, y_dist, x_grow, y_grow, error, error_2;
+
+	if (x0 > x1){
+		clip.x0 = x1;
+		clip.x1 = x0;
+	}
+	if (y0 > y1){
+		clip.y0 = y1;
+		clip.y1 = y0;
+	}
+	if (!FramebufferClip(fb, &clip)){
+		return;
+	}
+	color = SWAP(color);
+	x_dist = (x1 > x0) ? x1 - x0 : x0 - x1;
+	y_dist = (y1 > y0) ? y1 - y0 : y0 - y1;
+	x_grow = (x0 < x1) ? 1 : -1;
+	y_grow = (y0 < y1) ? 1 : -1;
+	error = x_dist - y_dist;
+	while (1){
+		/* Pixels outside the framebuffer are skipped, the line goes on */
+		if (x0 >= clip.x0 && x0 <= clip.x1 && y0 >= clip.y0 && y0 <= clip.y1){
+			*FramebufferPixel(fb, x0, y0) = color;
+		}
+		if (x0 == x1 && y0 == y1){
+			break;
+		}
+		error_2 = 2 * error;
+		if (error_2 > -y_dist){
+			error -= y_dist;
+			x0 += x_grow;
+		}
+		if (error_2 < x_dist){
+			error += x_dist;
+			y0 += y_grow;
+		}
+	}
+	/* Whole bounding box is marked once, not each pixel */
+	FramebufferInvalidate(fb, &clip);
+}
+
+void FramebufferDrawBitmap(framebuffer_t *fb, int16_t x, int16_t y, uint16_t width, uint16_t height, const uint8_t *bitmap, uint16_t foreground, uint16_t background){
+	fb_rect_t clip = {x, y, x + width - 1, y + height - 1};
+	uint32_t row_bytes = (width + 7) / 8;
+	const uint8_t *bits;
+	uint16_t *row;
+	int16_t i, j;
+
+	if (!FramebufferClip(fb, &clip)){
+		return;
+	}
+	foreground = SWAP(foreground);
+	background = SWAP(background);
+	for (i = clip.y0; i <= clip.y1; i++){
+		bits = &bitmap[(i - y) * row_bytes];
+		row = FramebufferPixel(fb, clip.x0, i);
+		for (j = clip.x0; j <= clip.x1; j++){
+			*row++ = (bits[(j - x) / 8] & (MSK_BIT8 >> ((j - x) % 8))) ? foreground : background;
+		}
+	}
+	FramebufferInvalidate(fb, &clip);
+}
+
+void FramebufferDrawPicture(framebuffer_t *fb, int16_t x, int16_t y, uint16_t width, uint16_t height, const uint8_t *pic){
+	fb_rect_t clip = {x, y, x + width - 1, y + height - 1};
+	int16_t i;
+
+	if (!FramebufferClip(fb, &clip)){
+		return;
+	}
+	/* Picture and framebuffer share the LCD byte order, rows are copied */
+	for (i = clip.y0; i <= clip.y1; i++){
+		memcpy(FramebufferPixel(fb, clip.x0, i), &pic[((int32_t)(i - y) * width + (clip.x0 - x)) * 2], (clip.x1 - clip.x0 + 1) * 2);
+	}
+	FramebufferInvalidate(fb, &clip);
+}
+
+/*==================[end of file]============================================*/
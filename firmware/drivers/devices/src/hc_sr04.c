@@ -1,33 +1,282 @@
 /**
  * @file hc_sr04.c
  * @author Albano Peñalva (albano.penalva@uner.edu.ar)
- * @brief 
+ * @brief
  * @version 0.1
  * @date 2023-10-20
- * 
+ *
  * @copyright Copyright (c) 2023
- * 
+ *
  */
 
 /*==================[inclusions]=============================================*/
 #include "hc_sr04.h"
+#include <stddef.h>
 #include "delay_mcu.h"
+#include "timer_mcu.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_attr.h"
 /*==================[macros and definitions]=================================*/
-#define MAX_US		17700	/* maximun distance time in us (300cm or 118inch) */
-#define MAX_CM		300		/* maximun distance time in cm */
-#define MAX_INCH	118		/* maximun distance time in inch */
-#define US2CM		59		/* scale factor to conver pulse width to cm */
-#define US2INCH		150		/* scale factor to conver pulse width to inch */
-#define WAIT_MAX	5900	/* maximun time to wait for echo signal */
+#define TRIGGER_US	10		/* trigger pulse width in us */
+#define POLL_US		10		/* echo pin reading period in us, without edge capture */
 /*==================[internal data declaration]==============================*/
+/**
+ * @brief Edge capture state
+ */
+typedef struct {
+	hc_sr04_echo_t echo;			/*!< Measurement in course */
+	soft_timer_t timeout;			/*!< Expires at the measurement deadline */
+	hc_sr04_callback_t func;		/*!< Called when the measurement ends */
+	void *param;					/*!< Parameter of func */
+	bool enabled;					/*!< Edge capture initialized */
+} hc_sr04_capture_t;
+
+/**
+ * @brief Task waiting for a measurement, on its stack
+ */
+typedef struct {
+	SemaphoreHandle_t done;			/*!< Given when the measurement ends */
+	hc_sr04_echo_t echo;			/*!< Ended measurement */
+} hc_sr04_wait_t;
+
+/**
+ * @brief Sensors measured in turn
+ */
+typedef struct {
+	hc_sr04_schedule_t schedule;					/*!< Measurement order and readings */
+	hc_sr04_reading_t readings[HC_SR04_SCAN_MAX];	/*!< Latest reading of each sensor */
+	hc_sr04_pins_t pins[HC_SR04_SCAN_MAX];			/*!< Pins of each sensor */
+	soft_timer_t timer;								/*!< End of the trigger pulse, deadline or next trigger */
+	bool pulse;										/*!< Trigger of the current sensor high */
+	bool running;									/*!< Sensors being measured */
+	bool enabled;									/*!< Initialized */
+} hc_sr04_scan_t;
+
 static gpio_t echo_st, trigger_st; /**<  Stores the pin inicilization*/
+static hc_sr04_capture_t capture;
+static portMUX_TYPE capture_lock = portMUX_INITIALIZER_UNLOCKED;
+static hc_sr04_scan_t scan;
+static portMUX_TYPE scan_lock = portMUX_INITIALIZER_UNLOCKED;
 /*==================[internal functions declaration]=========================*/
+/**
+ * @brief Sends the trigger pulse
+ */
+static void HcSr04Pulse(void);
+
+/**
+ * @brief Starts the timeout timer at the measurement deadline
+ *
+ * @param now Current time (us)
+ */
+static void IRAM_ATTR HcSr04Arm(uint64_t now);
+
+/**
+ * @brief Calls the function of an ended measurement
+ */
+static void IRAM_ATTR HcSr04End(void);
+
+/**
+ * @brief Echo pin ISR, on both edges
+ *
+ * @param param Not used
+ */
+static void IRAM_ATTR HcSr04EdgeIsr(void *param);
+
+/**
+ * @brief Timeout timer function
+ *
+ * @param param Not used
+ */
+static void IRAM_ATTR HcSr04TimeoutIsr(void *param);
+
+/**
+ * @brief Wakes the task waiting for a measurement
+ *
+ * @param echo Measurement
+ * @param param Wait
+ */
+static void IRAM_ATTR HcSr04Wake(const hc_sr04_echo_t *echo, void *param);
+
+/**
+ * @brief Measures an echo, blocking the calling task
+ *
+ * @param echo Ended measurement
+ */
+static void HcSr04Measure(hc_sr04_echo_t *echo);
+
+/**
+ * @brief Starts the scan timer at a time
+ *
+ * @param deadline Expiration time (us)
+ * @param now Current time (us)
+ */
+static void IRAM_ATTR HcSr04ScanArm(uint64_t deadline, uint64_t now);
+
+/**
+ * @brief Echo pin ISR of the sensors measured in turn, on both edges
+ *
+ * @param param Sensor index
+ */
+static void IRAM_ATTR HcSr04ScanEdgeIsr(void *param);
+
+/**
+ * @brief Scan timer function: ends the trigger pulse, the measurement or the guard time
+ *
+ * @param param Not used
+ */
+static void IRAM_ATTR HcSr04ScanIsr(void *param);
 
 /*==================[internal data definition]===============================*/
 
 /*==================[external data definition]===============================*/
 
 /*==================[internal functions definition]==========================*/
+static void HcSr04Pulse(void){
+	GPIOOn(trigger_st);
+	DelayUs(TRIGGER_US);
+	GPIOOff(trigger_st);
+}
+
+static void IRAM_ATTR HcSr04Arm(uint64_t now){
+	uint64_t deadline = HcSr04EchoDeadline(&capture.echo);
+
+	TimerSoftStart(&capture.timeout, (deadline > now) ? deadline - now : 0, 0);
+}
+
+static void IRAM_ATTR HcSr04End(void){
+	if (capture.func != NULL){
+		capture.func(&capture.echo, capture.param);
+	}
+}
+
+static void IRAM_ATTR HcSr04EdgeIsr(void *param){
+	uint64_t now = TimerNow();
+	bool level = GPIORead(echo_st);
+	bool ended, started;
+
+	portENTER_CRITICAL_ISR(&capture_lock);
+	ended = HcSr04EchoEdge(&capture.echo, level, now);
+	started = !ended && capture.echo.state == HC_SR04_ECHO_HIGH && capture.echo.start == now;
+	portEXIT_CRITICAL_ISR(&capture_lock);
+	/* Timer functions take the timer lock, never inside the capture one */
+	if (ended){
+		TimerSoftStop(&capture.timeout);
+		HcSr04End();
+	}
+	else if (started){
+		/* Echo started, its deadline is counted from now */
+		HcSr04Arm(now);
+	}
+}
+
+static void IRAM_ATTR HcSr04TimeoutIsr(void *param){
+	uint64_t now = TimerNow();
+	bool ended, busy;
+
+	portENTER_CRITICAL_ISR(&capture_lock);
+	ended = HcSr04EchoTimeout(&capture.echo, now);
+	busy = HcSr04EchoBusy(&capture.echo);
+	portEXIT_CRITICAL_ISR(&capture_lock);
+	if (ended){
+		HcSr04End();
+	}
+	else if (busy){
+		/* Set before the echo started, the deadline moved meanwhile */
+		HcSr04Arm(now);
+	}
+}
+
+static void IRAM_ATTR HcSr04Wake(const hc_sr04_echo_t *echo, void *param){
+	hc_sr04_wait_t *wait = param;
+	BaseType_t task_woken = pdFALSE;
+
+	wait->echo = *echo;
+	xSemaphoreGiveFromISR(wait->done, &task_woken);
+	portYIELD_FROM_ISR(task_woken);
+}
+
+static void HcSr04Measure(hc_sr04_echo_t *echo){
+	/* Binary semaphore of this measurement only, the task's notifications are left alone */
+	StaticSemaphore_t done_buffer;
+	hc_sr04_wait_t wait;
+	uint64_t time = 0;
+
+	if (!capture.enabled){
+		/* Echo pin read every POLL_US, time counted by the loop */
+		HcSr04Pulse();
+		HcSr04EchoStart(echo, time);
+		while (HcSr04EchoBusy(echo)){
+			DelayUs(POLL_US);
+			time += POLL_US;
+			if (!HcSr04EchoEdge(echo, GPIORead(echo_st), time)){
+				HcSr04EchoTimeout(echo, time);
+			}
+		}
+		return;
+	}
+	wait.done = xSemaphoreCreateBinaryStatic(&done_buffer);
+	while (!HcSr04Trigger(HcSr04Wake, &wait)){
+		/* Measurement of another caller in course */
+		vTaskDelay(1);
+	}
+	xSemaphoreTake(wait.done, portMAX_DELAY);
+	vSemaphoreDelete(wait.done);
+	*echo = wait.echo;
+}
+
+static void IRAM_ATTR HcSr04ScanArm(uint64_t deadline, uint64_t now){
+	TimerSoftStart(&scan.timer, (deadline > now) ? deadline - now : 0, 0);
+}
+
+static void IRAM_ATTR HcSr04ScanEdgeIsr(void *param){
+	uint8_t sensor = (uint8_t)(uintptr_t)param;
+	uint64_t now = TimerNow(), deadline;
+	bool level = GPIORead(scan.pins[sensor].echo);
+	bool changed, arm;
+
+	portENTER_CRITICAL_ISR(&scan_lock);
+	/* While the trigger is high the timer ends the pulse, it arms the deadline later */
+	changed = HcSr04ScheduleEdge(&scan.schedule, sensor, level, now) && !scan.pulse;
+	deadline = HcSr04ScheduleDeadline(&scan.schedule);
+	arm = scan.running || HcSr04ScheduleBusy(&scan.schedule);
+	portEXIT_CRITICAL_ISR(&scan_lock);
+	if (changed){
+		if (arm){
+			HcSr04ScanArm(deadline, now);
+		}
+		else{
+			TimerSoftStop(&scan.timer);
+		}
+	}
+}
+
+static void IRAM_ATTR HcSr04ScanIsr(void *param){
+	uint64_t now = TimerNow(), deadline;
+	uint8_t sensor;
+	bool arm;
+
+	portENTER_CRITICAL_ISR(&scan_lock);
+	if (scan.pulse){
+		GPIOOff(scan.pins[scan.schedule.current].trigger);
+		scan.pulse = false;
+	}
+	else{
+		HcSr04ScheduleTimeout(&scan.schedule, now);
+		if (scan.running && HcSr04ScheduleTrigger(&scan.schedule, now, &sensor)){
+			GPIOOn(scan.pins[sensor].trigger);
+			scan.pulse = true;
+		}
+	}
+	/* Early expirations (deadline moved meanwhile) only set the timer again */
+	deadline = scan.pulse ? now + TRIGGER_US : HcSr04ScheduleDeadline(&scan.schedule);
+	arm = scan.running || HcSr04ScheduleBusy(&scan.schedule);
+	portEXIT_CRITICAL_ISR(&scan_lock);
+	if (arm){
+		HcSr04ScanArm(deadline, now);
+	}
+}
 
 /*==================[external functions definition]==========================*/
 
@@ -42,51 +291,114 @@ bool HcSr04Init(gpio_t echo, gpio_t trigger){
 	return true;
 }
 
-uint16_t HcSr04ReadDistanceInCentimeters(void){
-	uint16_t distance = 0, waiting = 0;
-	GPIOOn(trigger_st);
-	DelayUs(10);
-	GPIOOff(trigger_st);
-	while(!GPIORead(echo_st)){
-		DelayUs(10);
-		waiting += 10;
-		if(waiting > WAIT_MAX){
-			return 0;
-		}
+bool HcSr04InitCapture(gpio_t echo, gpio_t trigger){
+	if (capture.enabled){
+		return true;
 	}
-	do{
-		DelayUs(10);
-		distance += 10;
-		if(distance > MAX_US)
-			return MAX_CM;
+	if (!TimerSoftInit(&capture.timeout, HcSr04TimeoutIsr, NULL)){
+		return false;
 	}
-	while(GPIORead(echo_st));
-	return (distance/US2CM);
+	HcSr04Init(echo, trigger);
+	capture.echo.state = HC_SR04_ECHO_IDLE;
+	capture.enabled = true;
+	GPIOActivIntAnyEdge(echo, HcSr04EdgeIsr, NULL);
+	return true;
 }
 
-uint16_t HcSr04ReadDistanceInInches(void){
-	uint16_t distance = 0, waiting = 0;
-	GPIOOn(trigger_st);
-	DelayUs(10);
-	GPIOOff(trigger_st);
-	while(!GPIORead(echo_st)){
-		DelayUs(10);
-		waiting += 10;
-		if(waiting > WAIT_MAX){
-			return 0;
-		}
+bool HcSr04Trigger(hc_sr04_callback_t func, void *param){
+	portENTER_CRITICAL(&capture_lock);
+	if (!capture.enabled || HcSr04EchoBusy(&capture.echo)){
+		portEXIT_CRITICAL(&capture_lock);
+		return false;
+	}
+	capture.func = func;
+	capture.param = param;
+	/* Deadline counted from the pulse start, the echo can't start earlier */
+	HcSr04EchoStart(&capture.echo, TimerNow());
+	portEXIT_CRITICAL(&capture_lock);
+	HcSr04Pulse();
+	HcSr04Arm(TimerNow());
+	return true;
+}
+
+bool HcSr04ScanInit(const hc_sr04_pins_t *sensors, uint8_t count, uint32_t guard, uint16_t max_cm){
+	uint8_t i;
+
+	if (scan.enabled || count == 0 || count > HC_SR04_SCAN_MAX){
+		return false;
+	}
+	if (!TimerSoftInit(&scan.timer, HcSr04ScanIsr, NULL)){
+		return false;
 	}
-	do{
-		DelayUs(10);
-		distance += 10;
-		if(distance > MAX_US)
-			return MAX_INCH;
+	HcSr04ScheduleInit(&scan.schedule, scan.readings, count, guard, (uint32_t)max_cm * HC_SR04_US2CM);
+	scan.pulse = false;
+	scan.running = false;
+	for (i = 0; i < count; i++){
+		scan.pins[i] = sensors[i];
+		GPIOInit(sensors[i].echo, GPIO_INPUT);
+		GPIOInit(sensors[i].trigger, GPIO_OUTPUT);
+		GPIOOff(sensors[i].trigger);
+		/* Echo already high, the sensor is triggered once it ends */
+		HcSr04ScheduleEdge(&scan.schedule, i, GPIORead(sensors[i].echo), TimerNow());
+		GPIOActivIntAnyEdge(sensors[i].echo, HcSr04ScanEdgeIsr, (void *)(uintptr_t)i);
 	}
-	while(GPIORead(echo_st));
-	return (distance/US2INCH);
+	scan.enabled = true;
+	return true;
+}
+
+void HcSr04ScanStart(void){
+	bool idle;
+
+	portENTER_CRITICAL(&scan_lock);
+	idle = scan.enabled && !scan.running && !scan.pulse && !HcSr04ScheduleBusy(&scan.schedule);
+	scan.running = scan.enabled;
+	portEXIT_CRITICAL(&scan_lock);
+	/* With a measurement in course the timer is already set, the guard time is kept */
+	if (idle){
+		TimerSoftStart(&scan.timer, 0, 0);
+	}
+}
+
+void HcSr04ScanStop(void){
+	portENTER_CRITICAL(&scan_lock);
+	scan.running = false;
+	portEXIT_CRITICAL(&scan_lock);
+}
+
+void HcSr04ScanRead(hc_sr04_reading_t *readings){
+	uint8_t i;
+
+	portENTER_CRITICAL(&scan_lock);
+	for (i = 0; i < scan.schedule.sensors; i++){
+		readings[i] = scan.readings[i];
+	}
+	portEXIT_CRITICAL(&scan_lock);
+}
+
+uint16_t HcSr04ReadDistanceInCentimeters(void){
+	hc_sr04_echo_t echo;
+
+	HcSr04Measure(&echo);
+	return HcSr04EchoCentimeters(&echo);
+}
+
+uint16_t HcSr04ReadDistanceInInches(void){
+	hc_sr04_echo_t echo;
+
+	HcSr04Measure(&echo);
+	return HcSr04EchoInches(&echo);
 }
 
 bool HcSr04Deinit(void){
+	if (capture.enabled){
+		TimerSoftDeInit(&capture.timeout);
+		capture.enabled = false;
+	}
+	if (scan.enabled){
+		HcSr04ScanStop();
+		TimerSoftDeInit(&scan.timer);
+		scan.enabled = false;
+	}
 	GPIODeinit();
 	return true;
 }
@@ -0,0 +1,103 @@
+/**
+ * @file hc_sr04_echo.c
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include "hc_sr04_echo.h"
+/*==================[macros and definitions]=================================*/
+#define MM_PER_CM	10
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+
+/*==================[external functions definition]==========================*/
+void HcSr04EchoStart(hc_sr04_echo_t *echo, uint64_t now){
+	echo->start = now;
+	echo->width = 0;
+	echo->limit = HC_SR04_MAX_US;
+	echo->state = HC_SR04_ECHO_WAIT;
+}
+
+bool HcSr04EchoEdge(hc_sr04_echo_t *echo, bool level, uint64_t time){
+	if (echo->state == HC_SR04_ECHO_WAIT && level){
+		echo->start = time;
+		echo->state = HC_SR04_ECHO_HIGH;
+	}
+	else if (echo->state == HC_SR04_ECHO_HIGH && !level){
+		echo->width = time - echo->start;
+		echo->state = (echo->width > echo->limit) ? HC_SR04_ECHO_OUT_OF_RANGE : HC_SR04_ECHO_DONE;
+		return true;
+	}
+	return false;
+}
+
+bool HcSr04EchoTimeout(hc_sr04_echo_t *echo, uint64_t now){
+	if (!HcSr04EchoBusy(echo) || now < HcSr04EchoDeadline(echo)){
+		return false;
+	}
+	if (echo->state == HC_SR04_ECHO_WAIT){
+		echo->state = HC_SR04_ECHO_MISSING;
+	}
+	else{
+		echo->width = now - echo->start;
+		echo->state = HC_SR04_ECHO_OUT_OF_RANGE;
+	}
+	return true;
+}
+
+uint64_t HcSr04EchoDeadline(const hc_sr04_echo_t *echo){
+	/* Echo is out of range once it is longer than the maximun */
+	return echo->start + ((echo->state == HC_SR04_ECHO_WAIT) ? HC_SR04_WAIT_MAX : echo->limit + 1);
+}
+
+bool HcSr04EchoBusy(const hc_sr04_echo_t *echo){
+	return echo->state == HC_SR04_ECHO_WAIT || echo->state == HC_SR04_ECHO_HIGH;
+}
+
+uint16_t HcSr04EchoMillimeters(const hc_sr04_echo_t *echo){
+	switch (echo->state){
+	case HC_SR04_ECHO_DONE:
+		return echo->width * MM_PER_CM / HC_SR04_US2CM;
+	case HC_SR04_ECHO_OUT_OF_RANGE:
+		return echo->limit * MM_PER_CM / HC_SR04_US2CM;
+	default:
+		return 0;
+	}
+}
+
+uint16_t HcSr04EchoCentimeters(const hc_sr04_echo_t *echo){
+	switch (echo->state){
+	case HC_SR04_ECHO_DONE:
+		return echo->width / HC_SR04_US2CM;
+	case HC_SR04_ECHO_OUT_OF_RANGE:
+		return echo->limit / HC_SR04_US2CM;
+	default:
+		return 0;
+	}
+}
+
+uint16_t HcSr04EchoInches(const hc_sr04_echo_t *echo){
+	switch (echo->state){
+	case HC_SR04_ECHO_DONE:
+		return echo->width / HC_SR04_US2INCH;
+	case HC_SR04_ECHO_OUT_OF_RANGE:
+		return echo->limit / HC_SR04_US2INCH;
+	default:
+		return 0;
+	}
+}
+
+/*==================[end of file]============================================*/
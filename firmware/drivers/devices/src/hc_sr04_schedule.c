@@ -0,0 +1,143 @@
+/**
+ * @file hc_sr04_schedule.c
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include "hc_sr04_schedule.h"
+/*==================[macros and definitions]=================================*/
+#define SENSOR_BIT(sensor)	((uint32_t)1 << (sensor))	/*!< Bit of a sensor in echo_high */
+
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+/**
+ * @brief Publishes the ended measurement and moves to the next sensor
+ *
+ * @param schedule Schedule
+ * @param end Time the measurement ended (us)
+ */
+static void HcSr04ScheduleEnd(hc_sr04_schedule_t *schedule, uint64_t end);
+
+/**
+ * @brief Tells if the next sensor can't be triggered yet because its echo is high
+ *
+ * @param schedule Schedule
+ * @return true if the echo of the sensor to trigger is high
+ */
+static bool HcSr04ScheduleBlocked(const hc_sr04_schedule_t *schedule);
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static void HcSr04ScheduleEnd(hc_sr04_schedule_t *schedule, uint64_t end){
+	hc_sr04_reading_t *reading = &schedule->readings[schedule->current];
+
+	reading->timestamp = end;
+	reading->distance = HcSr04EchoMillimeters(&schedule->echo);
+	reading->state = schedule->echo.state;
+	schedule->next = end + schedule->guard;
+	schedule->current = (schedule->current + 1) % schedule->sensors;
+}
+
+static bool HcSr04ScheduleBlocked(const hc_sr04_schedule_t *schedule){
+	return !HcSr04ScheduleBusy(schedule) && (schedule->echo_high & SENSOR_BIT(schedule->current));
+}
+
+/*==================[external functions definition]==========================*/
+void HcSr04ScheduleInit(hc_sr04_schedule_t *schedule, hc_sr04_reading_t *readings, uint8_t sensors,
+	uint32_t guard, uint32_t limit){
+	uint8_t i;
+
+	if (sensors > HC_SR04_SCHEDULE_MAX){
+		sensors = HC_SR04_SCHEDULE_MAX;
+	}
+	for (i = 0; i < sensors; i++){
+		readings[i].timestamp = 0;
+		readings[i].distance = 0;
+		readings[i].state = HC_SR04_ECHO_IDLE;
+	}
+	schedule->echo.state = HC_SR04_ECHO_IDLE;
+	schedule->readings = readings;
+	schedule->sensors = sensors;
+	schedule->current = 0;
+	schedule->guard = guard;
+	schedule->limit = (limit < HC_SR04_MAX_US) ? limit : HC_SR04_MAX_US;
+	schedule->next = 0;
+	schedule->echo_high = 0;
+}
+
+bool HcSr04ScheduleTrigger(hc_sr04_schedule_t *schedule, uint64_t now, uint8_t *sensor){
+	/* A sensor ignores the trigger while its echo is high */
+	if (HcSr04ScheduleBusy(schedule) || now < schedule->next || HcSr04ScheduleBlocked(schedule)){
+		return false;
+	}
+	HcSr04EchoStart(&schedule->echo, now);
+	schedule->echo.limit = schedule->limit;
+	*sensor = schedule->current;
+	return true;
+}
+
+bool HcSr04ScheduleEdge(hc_sr04_schedule_t *schedule, uint8_t sensor, bool level, uint64_t time){
+	hc_sr04_echo_state_t previous = schedule->echo.state;
+	bool blocked = HcSr04ScheduleBlocked(schedule);
+
+	if (sensor >= schedule->sensors){
+		return false;
+	}
+	if (level){
+		schedule->echo_high |= SENSOR_BIT(sensor);
+	}
+	else{
+		schedule->echo_high &= ~SENSOR_BIT(sensor);
+	}
+	/* Edges of the sensors not measuring may come from the burst being measured */
+	if (sensor != schedule->current){
+		return false;
+	}
+	if (!HcSr04ScheduleBusy(schedule)){
+		/* Next sensor can be triggered, or has to wait for its echo to end */
+		return HcSr04ScheduleBlocked(schedule) != blocked;
+	}
+	if (HcSr04EchoEdge(&schedule->echo, level, time)){
+		HcSr04ScheduleEnd(schedule, time);
+		return true;
+	}
+	return schedule->echo.state != previous;
+}
+
+bool HcSr04ScheduleTimeout(hc_sr04_schedule_t *schedule, uint64_t now){
+	if (HcSr04ScheduleBlocked(schedule) && now >= HcSr04ScheduleDeadline(schedule)){
+		/* Echo high longer than the sensor can hold it: skipped as missing */
+		schedule->echo.state = HC_SR04_ECHO_MISSING;
+		HcSr04ScheduleEnd(schedule, now);
+		return true;
+	}
+	if (!HcSr04EchoTimeout(&schedule->echo, now)){
+		return false;
+	}
+	HcSr04ScheduleEnd(schedule, now);
+	return true;
+}
+
+uint64_t HcSr04ScheduleDeadline(const hc_sr04_schedule_t *schedule){
+	if (HcSr04ScheduleBusy(schedule)){
+		return HcSr04EchoDeadline(&schedule->echo);
+	}
+	/* The falling edge of the echo comes before, unless the sensor is stuck */
+	return HcSr04ScheduleBlocked(schedule) ? schedule->next + HC_SR04_NO_ECHO_US : schedule->next;
+}
+
+bool HcSr04ScheduleBusy(const hc_sr04_schedule_t *schedule){
+	return HcSr04EchoBusy(&schedule->echo);
+}
+
+/*==================[end of file]============================================*/
@@ -11,13 +11,30 @@
 
 /*==================[inclusions]=============================================*/
 #include "icons.h"
+#include <stddef.h>
 /*==================[macros and definitions]=================================*/
-
+#define MSK_BIT8 0x80							/*!< 8th bit mask */
+#define SWAP(c) ((uint16_t)((c) >> 8 | (c) << 8))	/*!< RGB565 color to LCD byte order */
 /*==================[internal data declaration]==============================*/
 
 /*==================[internal functions declaration]=========================*/
+/**
+ * @brief  		Splits the rows of an icon in runs of pixels of the same color
+ * @param[in]  	icon_font: Pointer to icon font
+ * @param[in]  	bitmap: First byte of the icon
+ * @param[in]  	foreground: Color for bits set (RGB565)
+ * @param[in]  	background: Color for bits cleared (RGB565)
+ * @param[out] 	runs: Runs, NULL to count them only
+ * @retval 		Number of runs
+ */
+static uint16_t ExpandRuns(const icon_font_t *icon_font, const uint8_t *bitmap, uint16_t foreground, uint16_t background, icon_run_t *runs);
 
 /*==================[internal data definition]===============================*/
+static icon_run_t icon_cache[ICON_CACHE_RUNS];					/*!< Runs of the icons in cache */
+static icon_sprite_t icon_cache_entry[ICON_CACHE_ENTRIES];		/*!< Icons in cache */
+static uint16_t icon_cache_used = 0;							/*!< Runs of icon_cache in use */
+static uint8_t icon_cache_count = 0;							/*!< Number of icons in cache */
+
 /**
  * @brief 22x22 icon data array. 
  */
@@ -12873,7 +12890,63 @@ icon_font_t icon_89 = {
 };
 
 /*==================[internal functions definition]==========================*/
+static uint16_t ExpandRuns(const icon_font_t *icon_font, const uint8_t *bitmap, uint16_t foreground, uint16_t background, icon_run_t *runs){
+	uint16_t row_bytes = (icon_font->width + 7) / 8;
+	uint16_t count = 0;
+	uint8_t i, j, bit, last;
+
+	for (i = 0; i < icon_font->height; i++){
+		last = 2;
+		for (j = 0; j < icon_font->width; j++){
+			bit = (bitmap[i * row_bytes + j / 8] & (MSK_BIT8 >> (j % 8))) != 0;
+			/* Each row starts a new run */
+			if (bit != last){
+				if (runs != NULL){
+					runs[count].color = bit ? SWAP(foreground) : SWAP(background);
+					runs[count].length = 0;
+				}
+				count++;
+				last = bit;
+			}
+			if (runs != NULL){
+				runs[count - 1].length++;
+			}
+		}
+	}
+	return count;
+}
 
 /*==================[external functions definition]==========================*/
+const icon_sprite_t * IconSpriteGet(const icon_font_t *icon_font, icon_t icon, uint16_t foreground, uint16_t background){
+	const uint8_t *bitmap = &icon_font->data[icon * icon_font->offset];
+	icon_sprite_t *entry;
+	uint16_t i, count;
+
+	for (i = 0; i < icon_cache_count; i++){
+		entry = &icon_cache_entry[i];
+		if (entry->icon_font == icon_font && entry->icon == icon && entry->foreground == foreground && entry->background == background){
+			return entry;
+		}
+	}
+	count = ExpandRuns(icon_font, bitmap, foreground, background, NULL);
+	/* Big icons would empty the cache too often */
+	if (count > ICON_CACHE_RUNS / 4){
+		return NULL;
+	}
+	/* Cache full, start again */
+	if (icon_cache_count == ICON_CACHE_ENTRIES || icon_cache_used + count > ICON_CACHE_RUNS){
+		icon_cache_count = 0;
+		icon_cache_used = 0;
+	}
+	entry = &icon_cache_entry[icon_cache_count++];
+	entry->icon_font = icon_font;
+	entry->icon = icon;
+	entry->foreground = foreground;
+	entry->background = background;
+	entry->count = ExpandRuns(icon_font, bitmap, foreground, background, &icon_cache[icon_cache_used]);
+	entry->runs = &icon_cache[icon_cache_used];
+	icon_cache_used += count;
+	return entry;
+}
 
 /*==================[end of file]============================================*/
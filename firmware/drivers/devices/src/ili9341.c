@@ -11,22 +11,30 @@
 
 /*==================[inclusions]=============================================*/
 #include "ili9341.h"
+#include <string.h>
 #include "fonts.h"
 #include "spi_mcu.h"
 #include "gpio_mcu.h"
 #include "delay_mcu.h"
+#include "framebuffer.h"
+#include "image.h"
+#include "esp_attr.h"
+#include "esp_heap_caps.h"
 /*==================[macros and definitions]=================================*/
-#define NULL 0
-
 #define SPI_BR 20000000				/*!< Frequency of sck for SPI communication */
 #define MAX_PIXEL 320*240*2			/*!< Maximum number of bytes to write on LCD */
 #define MSK_BIT16 0x8000			/*!< 16th bit mask */
 #define MSK_BIT8 0x80				/*!< 8th bit mask */
-#define MAX_VALUE_SIZE 256			/*!< Maximum length of a data array to prevent excessive use of memory */
+#define MAX_VALUE_SIZE 4092			/*!< Maximum length of a pixel buffer, limited by SPI DMA max_transfer_sz */
 #define LEFT -1						/*!< Horizontal grow direction */
 #define RIGHT 1						/*!< Horizontal grow direction */
 #define DOWN 1						/*!< Vertical grow direction */
 #define UP -1						/*!< Vertical grow direction */
+#define LCD_COMMAND (void*)0		/*!< D/C level for command transactions */
+#define LCD_DATA (void*)1			/*!< D/C level for parameter or data transactions */
+#define LCD_DATA_END (void*)3		/*!< D/C level for the last pixels of a drawing, signals its end */
+#define NO_ADDR 0xFFFFFFFF			/*!< Address window not known */
+#define MAX_LINE_CHARS 128			/*!< Maximum characters of a line drawn as a single window */
 
 /* Command List */
 #define RESET				0x01 	/*!< Resets the commands and parameters to their S/W Reset default values */
@@ -40,6 +48,8 @@
 #define COLUMN_ADDR_SET		0x2A 	/*!< Define columns of frame memory where MCU can access */
 #define PAGE_ADDR_SET		0x2B 	/*!< Define rows of frame memory where MCU can access */
 #define MEM_WRITE			0x2C 	/*!< Transfer data from MCU to frame memory */
+#define VERT_SCROLL_DEF		0x33 	/*!< Defines the vertical scrolling area of the display */
+#define VERT_SCROLL_ADDR	0x37 	/*!< Frame memory line written at the top of the vertical scrolling area */
 #define MEM_ACC_CTRL		0x36 	/*!< Defines read/write scanning direction of frame memory */
 #define PIXEL_FORMAT_SET	0x3A 	/*!< Sets the pixel format for the RGB image data used by the interface */
 #define WRITE_DISP_BRIGHT	0x51 	/*!< Adjust the brightness value of the display */
@@ -64,6 +74,7 @@
 
 #define HighByte(x) x >> 8			/*!< High byte of a 16 bits data */
 #define LowByte(x) x & 0xFF			/*!< Low byte of a 16 bits data */
+#define SWAP(c) ((uint16_t)((c) >> 8 | (c) << 8))	/*!< RGB565 color to LCD byte order and back */
 /*==================[typedef]================================================*/
 /**
  * @brief  Structure with LCD orientation properties
@@ -86,6 +97,153 @@ typedef struct {
 
 /*==================[internal functions declaration]=========================*/
 
+/**
+ * @brief  		Sets D/C pin before each SPI transaction, called from SPI ISR
+ * @param[in]  	dc: LCD_COMMAND, LCD_DATA or LCD_DATA_END (transaction user data)
+ * @retval 		None
+ */
+static void IRAM_ATTR LcdPreTransfer(void *dc);
+
+/**
+ * @brief  		Signals the end of a drawing after its last transaction, called from SPI ISR
+ * @param[in]  	dc: LCD_COMMAND, LCD_DATA or LCD_DATA_END (transaction user data)
+ * @retval 		None
+ */
+static void IRAM_ATTR LcdPostTransfer(void *dc);
+
+/**
+ * @brief  		Queue a command and its parameters/data, without waiting for the transfer
+ * @note		Parameters longer than 4 bytes must remain unchanged until StreamEnd()
+ * @param[in]  	cmd: Command
+ * @param[in]  	data: Pointer to parameters or data, NULL if none
+ * @param[in]  	databytes: Number of bytes of parameters or data
+ * @retval 		None
+ */
+static void StreamCommand(uint8_t cmd, const uint8_t *data, uint32_t databytes);
+
+/**
+ * @brief  		Queue data following a previous command, without waiting for the transfer
+ * @param[in]  	data: Pointer to data, must remain unchanged until StreamEnd()
+ * @param[in]  	databytes: Number of bytes of data
+ * @retval 		None
+ */
+static void StreamData(const uint8_t *data, uint32_t databytes);
+
+/**
+ * @brief  		Wait until every queued command and data is sent
+ * @retval 		None
+ */
+static void StreamEnd(void);
+
+/**
+ * @brief  		Gets the pixel buffer the CPU can fill, waiting for its previous transfer
+ * @retval 		Pointer to DMA capable buffer of MAX_VALUE_SIZE bytes
+ */
+static uint8_t * BufferGet(void);
+
+/**
+ * @brief  		Queue the buffer returned by BufferGet() and switch to the other one
+ * @param[in]  	bytes: Number of bytes of pixel data
+ * @param[in]  	last: true if these are the last pixels of the drawing
+ * @retval 		None
+ */
+static void BufferSend(uint32_t bytes, bool last);
+
+/**
+ * @brief  		Draw a 1 bit per pixel bitmap (characters and icons)
+ * @param[in]  	x: X position of top left corner
+ * @param[in]  	y: Y position of top left corner
+ * @param[in]  	width: Bitmap width in pixels
+ * @param[in]  	height: Bitmap height in pixels
+ * @param[in]  	bitmap: Pointer to first row, each row starts on a new byte
+ * @param[in]  	foreground: Color for bits set (RGB565)
+ * @param[in]  	background: Color for bits cleared (RGB565)
+ * @retval 		None
+ */
+static void DrawBitmap(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t *bitmap, uint16_t foreground, uint16_t background);
+
+/**
+ * @brief  		Draw an icon sprite as a single window, filling the DMA buffers run by run
+ * @param[in]  	x: X position of top left corner
+ * @param[in]  	y: Y position of top left corner
+ * @param[in]  	sprite: Icon expanded to runs
+ * @retval 		None
+ */
+static void DrawSprite(uint16_t x, uint16_t y, const icon_sprite_t *sprite);
+
+/**
+ * @brief  		Copy an icon sprite into the framebuffer
+ * @param[in]  	x: X position of top left corner
+ * @param[in]  	y: Y position of top left corner
+ * @param[in]  	sprite: Icon expanded to runs
+ * @param[in]  	transparent: true to skip the background runs, keeping the pixels below
+ * @retval 		None
+ */
+static void BlitSprite(uint16_t x, uint16_t y, const icon_sprite_t *sprite, bool transparent);
+
+/**
+ * @brief  		Draw a single character from the glyph cache, or expanding its rows when it doesn't fit
+ * @param[in]  	x: X position of top left corner
+ * @param[in]  	y: Y position of top left corner
+ * @param[in] 	c: Character to be displayed
+ * @param[in]  	font: Pointer to used font
+ * @param[in]  	foreground: Color for char (RGB565)
+ * @param[in]  	background: Color for char background (RGB565)
+ * @retval		None
+ */
+static void DrawGlyph(uint16_t x, uint16_t y, char c, Font_t *font, uint16_t foreground, uint16_t background);
+
+/**
+ * @brief  		Draw a line of characters as a single window
+ * @note		Falls back to one window per character when the line doesn't fit on
+ * 				the LCD, its glyphs don't fit together in the glyph cache or drawing
+ * 				goes to the framebuffer
+ * @param[in]  	x: X position of top left corner of first character
+ * @param[in]  	y: Y position of top left corner of first character
+ * @param[in] 	str: Characters, between ' ' and '~'
+ * @param[in] 	len: Number of characters
+ * @param[in]  	font: Pointer to used font
+ * @param[in]  	foreground: Color for chars (RGB565)
+ * @param[in]  	background: Color for background and spacing (RGB565)
+ * @param[in]  	spacing: Background columns between characters
+ * @retval		X position after the last character and its spacing
+ */
+static uint16_t DrawText(uint16_t x, uint16_t y, const char *str, uint16_t len, Font_t *font, uint16_t foreground, uint16_t background, uint8_t spacing);
+
+/**
+ * @brief  		Blend a line of characters over the framebuffer content
+ * @param[in]  	x: X position of top left corner of first character
+ * @param[in]  	y: Y position of top left corner of first character
+ * @param[in] 	str: Characters, between ' ' and '~'
+ * @param[in] 	len: Number of characters
+ * @param[in]  	font: Pointer to used font
+ * @param[in]  	foreground: Color for chars (RGB565)
+ * @retval		X position after the last character and its spacing
+ */
+static uint16_t BlendText(uint16_t x, uint16_t y, const char *str, uint16_t len, Font_t *font, uint16_t foreground);
+
+/**
+ * @brief  		Draw a string line by line, following \n and \r
+ * @param[in] 	x: X position of top left corner of first character in string
+ * @param[in]  	y: Y position of top left corner of first character in string
+ * @param[in]  	str: Pointer to first character
+ * @param[in]  	font: Pointer to used font
+ * @param[in]  	foreground: Color for string (RGB565)
+ * @param[in]  	background: Color for string background (RGB565)
+ * @param[in]  	blend: true to blend over the framebuffer instead of painting the background
+ * @retval 		None
+ */
+static void DrawLines(uint16_t x, uint16_t y, const char *str, Font_t *font, uint16_t foreground, uint16_t background, bool blend);
+
+/**
+ * @brief  		Gets the LCD area covered by scroll lines
+ * @param[in]  	first: First frame memory line, 0 to ILI9341_HEIGHT - 1
+ * @param[in]  	last: Last frame memory line, not less than first
+ * @param[out] 	rect: Area in LCD coordinates for the current orientation
+ * @retval 		None
+ */
+static void ScrollLinesArea(uint16_t first, uint16_t last, fb_rect_t *rect);
+
 /**
  * @brief  		Send command and parameters/data to LCD
  * @param[in]  	data: Structure with the command and parameters/data to send
@@ -114,6 +272,40 @@ void SetCursorPosition(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
  */
 void Fill(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color);
 
+/**
+ * @brief  		Fill a run of pixels (or any rectangle) clipped to the LCD, as a single window
+ * @param[in]  	x0: Start column, may be outside the LCD
+ * @param[in]  	y0: Start row, may be outside the LCD
+ * @param[in]  	x1: End column, may be outside the LCD
+ * @param[in]  	y1: End row, may be outside the LCD
+ * @param[in]	color: color
+ * @retval 		None
+ */
+static void FillRun(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+
+/**
+ * @brief  		Draw the runs of a circle outline for a group of points sharing y
+ * @note		Points (x, y) with x from xa to xb of the first octant, they give
+ * 				horizontal runs in rows y0 +- y and vertical runs in columns x0 +- y
+ * @param[in]  	x0: X coordinate of center circle point
+ * @param[in]  	y0: Y coordinate of center circle point
+ * @param[in]  	xa: First x of the group
+ * @param[in]  	xb: Last x of the group
+ * @param[in]  	y: y of the group
+ * @param[in]  	color: Circle color (RGB565)
+ * @retval 		None
+ */
+static void CircleRuns(int16_t x0, int16_t y0, int16_t xa, int16_t xb, int16_t y, uint16_t color);
+
+/**
+ * @brief  		x of a triangle edge in a row, rounded down
+ * @param[in]  	x: x of the vertex the edge starts at
+ * @param[in]  	num: Offset from x times den
+ * @param[in]  	den: Rows of the edge, greater than 0
+ * @retval 		x + num / den, rounded down
+ */
+static int16_t EdgeX(int16_t x, int32_t num, int32_t den);
+
 /*==================[internal data definition]===============================*/
 /**
  * @brief Initial LCD configuration parameters
@@ -167,23 +359,36 @@ lcd_cmd_t lcd_init[] = {
 	{NEG_GAMMA, 15, neg_gamma},
 };
 
-lcd_cmd_t lcd_reset = {RESET, NULL, NULL};			/*!< SW reset */
-lcd_cmd_t lcd_sleep_out = {SLEEP_OUT, NULL, NULL};	/*!< Exit sleep mode */
-lcd_cmd_t lcd_on = {DISPLAY_ON, NULL, NULL};		/*!< Exit sleep mode */
+lcd_cmd_t lcd_reset = {RESET, 0, NULL};			/*!< SW reset */
+lcd_cmd_t lcd_sleep_out = {SLEEP_OUT, 0, NULL};	/*!< Exit sleep mode */
+lcd_cmd_t lcd_on = {DISPLAY_ON, 0, NULL};		/*!< Exit sleep mode */
 
 /*
  * @brief: SPI port configuration compatible with LCD interface
  */
 spi_mcu_config_t spi_conf = {
-	.device = NULL, 
+	.device = SPI_1, 
 	.clk_mode = MODE0, 
 	.bitrate = SPI_BR, 
 	.transfer_mode = SPI_POLLING, 
 	.func_p = NULL,
-	.param_p = NULL };
+	.param_p = NULL,
+	.pre_func_p = LcdPreTransfer,
+	.post_func_p = LcdPostTransfer };
 
 static spi_dev_t ili9341_spi;				/*!< uC SPI port */
 static gpio_t ili9341_dc, ili9341_rst;		/*!< uC GPIO ports to use as CS, DC and RST */
+static uint32_t lcd_columns = NO_ADDR;		/*!< Last column window sent, to skip repeated COLUMN_ADDR_SET */
+static uint32_t lcd_rows = NO_ADDR;			/*!< Last row window sent, to skip repeated PAGE_ADDR_SET */
+DMA_ATTR static uint8_t lcd_buffer[2][MAX_VALUE_SIZE];	/*!< Ping-pong pixel buffers */
+static uint32_t lcd_buffer_trans[2];		/*!< Last SPI transaction sending each buffer */
+static uint8_t lcd_buffer_idx;				/*!< Buffer being filled by the CPU */
+static void (*lcd_done_func)(void*);		/*!< Function called at the end of a drawing */
+static void *lcd_done_param;				/*!< Parameter of lcd_done_func */
+static framebuffer_t lcd_fb;				/*!< Off-screen framebuffer */
+static bool lcd_fb_on = false;				/*!< Drawing goes to the framebuffer */
+static const uint16_t *lcd_line[MAX_LINE_CHARS];	/*!< Cached glyphs of the line being composed */
+static uint16_t lcd_row[ILI9341_HEIGHT];	/*!< Glyph or image row expanded into the framebuffer */
 
 static orientation_properties_t lcd_orientation = {
 		ILI9341_WIDTH,
@@ -193,20 +398,372 @@ static orientation_properties_t lcd_orientation = {
 
 /*==================[internal functions definition]==========================*/
 
+static void IRAM_ATTR LcdPreTransfer(void *dc){
+	GPIOState(ili9341_dc, (uintptr_t)dc & 1);
+}
+
+static void IRAM_ATTR LcdPostTransfer(void *dc){
+	if (dc == LCD_DATA_END && lcd_done_func != NULL){
+		lcd_done_func(lcd_done_param);
+	}
+}
+
+static void StreamCommand(uint8_t cmd, const uint8_t *data, uint32_t databytes){
+	SpiQueueWrite(ili9341_spi, &cmd, 1, LCD_COMMAND);
+	if (databytes != 0){
+		SpiQueueWrite(ili9341_spi, data, databytes, LCD_DATA);
+	}
+}
+
+static void StreamData(const uint8_t *data, uint32_t databytes){
+	if (databytes != 0){
+		SpiQueueWrite(ili9341_spi, data, databytes, LCD_DATA);
+	}
+}
+
+static void StreamEnd(void){
+	SpiWaitQueue(ili9341_spi);
+}
+
+static uint8_t * BufferGet(void){
+	SpiWaitTransaction(ili9341_spi, lcd_buffer_trans[lcd_buffer_idx]);
+	return lcd_buffer[lcd_buffer_idx];
+}
+
+static void BufferSend(uint32_t bytes, bool last){
+	lcd_buffer_trans[lcd_buffer_idx] = SpiQueueWrite(ili9341_spi, lcd_buffer[lcd_buffer_idx], bytes, last ? LCD_DATA_END : LCD_DATA);
+	/* CPU fills the other buffer while this one is sent */
+	lcd_buffer_idx ^= 1;
+}
+
+static void DrawBitmap(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t *bitmap, uint16_t foreground, uint16_t background){
+	uint16_t i, j;
+	uint32_t bytes = 0;
+	uint32_t row_bytes = (width + 7) / 8;
+	uint8_t *pixel;
+
+	if (lcd_fb_on){
+		fb_rect_t rect = {x, y, x + width - 1, y + height - 1};
+		FramebufferDrawBitmap(&lcd_fb, x, y, width, height, bitmap, foreground, background);
+		/* Parts outside the framebuffer are drawn on the LCD */
+		if (FramebufferContains(&lcd_fb, &rect)){
+			return;
+		}
+	}
+
+	SetCursorPosition(x, y, x + width - 1, y + height - 1);
+	/* Start writing LCD memory */
+	StreamCommand(MEM_WRITE, NULL, 0);
+	pixel = BufferGet();
+	/* go through bitmap rows */
+	for (i = 0; i < height; i++){
+		/* If the row doesn't fit, send buffer and continue on the other one */
+		if (bytes + 2 * width > MAX_VALUE_SIZE){
+			BufferSend(bytes, false);
+			pixel = BufferGet();
+			bytes = 0;
+		}
+		/* go through bitmap columns */
+		for (j = 0; j < width; j++){
+			if (bitmap[i * row_bytes + j / 8] & (MSK_BIT8 >> (j % 8))){
+				/* if bit = 1, draw put foreground color */
+				pixel[bytes++] = HighByte(foreground);
+				pixel[bytes++] = LowByte(foreground);
+			}
+			else{
+				pixel[bytes++] = HighByte(background);
+				pixel[bytes++] = LowByte(background);
+			}
+		}
+	}
+	BufferSend(bytes, true);
+}
+
+static void DrawSprite(uint16_t x, uint16_t y, const icon_sprite_t *sprite){
+	const icon_run_t *run = sprite->runs;
+	uint16_t *pixel;
+	uint16_t i, length, count = 0;
+
+	SetCursorPosition(x, y, x + sprite->icon_font->width - 1, y + sprite->icon_font->height - 1);
+	StreamCommand(MEM_WRITE, NULL, 0);
+	pixel = (uint16_t *)BufferGet();
+	for (i = 0; i < sprite->count; i++, run++){
+		length = run->length;
+		while (length > 0){
+			/* Buffer full, send it and continue on the other one */
+			if (count == MAX_VALUE_SIZE / 2){
+				BufferSend(MAX_VALUE_SIZE, false);
+				pixel = (uint16_t *)BufferGet();
+				count = 0;
+			}
+			/* Run colors are already in LCD byte order */
+			for (; length > 0 && count < MAX_VALUE_SIZE / 2; length--){
+				pixel[count++] = run->color;
+			}
+		}
+	}
+	BufferSend(count * 2, true);
+}
+
+static void BlitSprite(uint16_t x, uint16_t y, const icon_sprite_t *sprite, bool transparent){
+	fb_rect_t rect = {x, y, x + sprite->icon_font->width - 1, y + sprite->icon_font->height - 1};
+	const icon_run_t *run = sprite->runs;
+	uint16_t key = SWAP(sprite->background);
+	int16_t row = y, column = x, start, end;
+	uint16_t i;
+	uint16_t *pixel;
+
+	if (!FramebufferClip(&lcd_fb, &rect)){
+		return;
+	}
+	for (i = 0; i < sprite->count; i++, run++){
+		if (!(transparent && run->color == key) && row >= rect.y0 && row <= rect.y1){
+			start = (column > rect.x0) ? column : rect.x0;
+			end = (column + run->length - 1 < rect.x1) ? column + run->length - 1 : rect.x1;
+			pixel = FramebufferPixel(&lcd_fb, start, row);
+			for (; start <= end; start++){
+				*pixel++ = run->color;
+			}
+		}
+		/* Runs end at the end of each row */
+		column += run->length;
+		if (column > x + sprite->icon_font->width - 1){
+			column = x;
+			row++;
+		}
+	}
+	FramebufferInvalidate(&lcd_fb, &rect);
+}
+
+static void DrawGlyph(uint16_t x, uint16_t y, char c, Font_t *font, uint16_t foreground, uint16_t background){
+	const uint16_t *glyph;
+	glyph_reader_t reader;
+	uint16_t i, width;
+	uint32_t bytes = 0;
+	uint8_t *pixel;
+
+	width = font->info[c - ' '].width;
+	glyph = FontGlyphCacheGet(font, c, foreground, background);
+	if (glyph != NULL){
+		/* Cached glyph is already in LCD byte order */
+		ILI9341DrawPicture(x, y, width, font->font_height, (const uint8_t *)glyph);
+		return;
+	}
+
+	/* Too big for the cache, rows are expanded where they are needed */
+	if (lcd_fb_on){
+		fb_rect_t rect = {x, y, x + width - 1, y + font->font_height - 1};
+		FontGlyphStart(&reader, font, c, foreground, background);
+		for (i = 0; i < font->font_height; i++){
+			FontGlyphRow(&reader, lcd_row);
+			FramebufferDrawPicture(&lcd_fb, x, y + i, width, 1, (const uint8_t *)lcd_row);
+		}
+		/* Parts outside the framebuffer are drawn on the LCD */
+		if (FramebufferContains(&lcd_fb, &rect)){
+			return;
+		}
+	}
+
+	SetCursorPosition(x, y, x + width - 1, y + font->font_height - 1);
+	StreamCommand(MEM_WRITE, NULL, 0);
+	FontGlyphStart(&reader, font, c, foreground, background);
+	pixel = BufferGet();
+	for (i = 0; i < font->font_height; i++){
+		/* If the row doesn't fit, send buffer and continue on the other one */
+		if (bytes + 2 * width > MAX_VALUE_SIZE){
+			BufferSend(bytes, false);
+			pixel = BufferGet();
+			bytes = 0;
+		}
+		FontGlyphRow(&reader, (uint16_t *)&pixel[bytes]);
+		bytes += 2 * width;
+	}
+	BufferSend(bytes, true);
+}
+
+static uint16_t DrawText(uint16_t x, uint16_t y, const char *str, uint16_t len, Font_t *font, uint16_t foreground, uint16_t background, uint8_t spacing){
+	uint16_t i, k, j, width = 0;
+	uint32_t generation, bytes = 0, row_bytes;
+	uint8_t *pixel, retry;
+
+	if (len == 0){
+		return x;
+	}
+	for (k = 0; k < len; k++){
+		width += font->info[str[k] - ' '].width + spacing;
+	}
+	/* Last character has no spacing after it */
+	width -= spacing;
+
+	/* Every glyph of the line must be in the cache at the same time. If the cache
+	restarts while getting them, they are got again from the empty cache */
+	for (retry = 0; retry < 2; retry++){
+		generation = FontGlyphCacheGeneration();
+		for (k = 0; k < len && k < MAX_LINE_CHARS; k++){
+			lcd_line[k] = FontGlyphCacheGet(font, str[k], foreground, background);
+			if (lcd_line[k] == NULL){
+				break;
+			}
+		}
+		if (generation == FontGlyphCacheGeneration()){
+			break;
+		}
+	}
+	if (lcd_fb_on || k < len || generation != FontGlyphCacheGeneration() || x + width > lcd_orientation.width){
+		/* One character at a time, ILI9341DrawChar() moves to a new line at the end of the LCD */
+		for (k = 0; k < len; k++){
+			ILI9341DrawChar(x, y, str[k], font, foreground, background);
+			x += font->info[str[k] - ' '].width;
+			if (spacing != 0 && k < len - 1){
+				Fill(x, y, x + spacing - 1, y + font->font_height - 1, background);
+			}
+			x += spacing;
+		}
+		return x;
+	}
+
+	SetCursorPosition(x, y, x + width - 1, y + font->font_height - 1);
+	StreamCommand(MEM_WRITE, NULL, 0);
+	row_bytes = 2 * width;
+	pixel = BufferGet();
+	for (i = 0; i < font->font_height; i++){
+		/* If the row doesn't fit, send buffer and continue on the other one */
+		if (bytes + row_bytes > MAX_VALUE_SIZE){
+			BufferSend(bytes, false);
+			pixel = BufferGet();
+			bytes = 0;
+		}
+		/* Glyph rows are copied one after the other, spacing is background */
+		for (k = 0; k < len; k++){
+			j = font->info[str[k] - ' '].width;
+			memcpy(&pixel[bytes], &lcd_line[k][i * j], 2 * j);
+			bytes += 2 * j;
+			if (k < len - 1){
+				for (j = 0; j < spacing; j++){
+					pixel[bytes++] = HighByte(background);
+					pixel[bytes++] = LowByte(background);
+				}
+			}
+		}
+	}
+	BufferSend(bytes, true);
+	return x + width + spacing;
+}
+
+static uint16_t BlendText(uint16_t x, uint16_t y, const char *str, uint16_t len, Font_t *font, uint16_t foreground){
+	glyph_reader_t reader;
+	fb_rect_t ink;
+	uint8_t alpha[UINT8_MAX];
+	uint16_t i, j, k, color, *pixel;
+	int16_t px, py;
+
+	for (k = 0; k < len; k++){
+		FontGlyphStart(&reader, font, str[k], foreground, foreground);
+		/* Only the pixels covered by the glyph change and are sent on flush */
+		ink.x0 = INT16_MAX;
+		ink.y0 = INT16_MAX;
+		ink.x1 = INT16_MIN;
+		ink.y1 = INT16_MIN;
+		for (i = 0; i < font->font_height; i++){
+			FontGlyphAlphaRow(&reader, alpha);
+			py = y + i;
+			for (j = 0; j < reader.width; j++){
+				px = x + j;
+				if (alpha[j] == 0 || px < lcd_fb.x || px >= lcd_fb.x + lcd_fb.width || py < lcd_fb.y || py >= lcd_fb.y + lcd_fb.height){
+					continue;
+				}
+				pixel = FramebufferPixel(&lcd_fb, px, py);
+				if (alpha[j] == FONT_ALPHA_MAX){
+					*pixel = SWAP(foreground);
+				}
+				else{
+					/* Edges are mixed with what is below them */
+					color = FontBlend(foreground, FramebufferGetPixel(&lcd_fb, px, py), alpha[j]);
+					*pixel = SWAP(color);
+				}
+				ink.x0 = (px < ink.x0) ? px : ink.x0;
+				ink.x1 = (px > ink.x1) ? px : ink.x1;
+				ink.y0 = (py < ink.y0) ? py : ink.y0;
+				ink.y1 = py;
+			}
+		}
+		if (ink.x0 <= ink.x1){
+			FramebufferInvalidate(&lcd_fb, &ink);
+		}
+		x += reader.width + 1;
+	}
+	return x;
+}
+
+static void DrawLines(uint16_t x, uint16_t y, const char *str, Font_t *font, uint16_t foreground, uint16_t background, bool blend){
+	static uint16_t lcd_x, lcd_y, len;
+
+	/* Set coordinates */
+	lcd_x = x;
+	lcd_y = y;
+
+	while (*str != '\0'){	/* End of string */
+		/* Characters up to the end of the line are drawn together */
+		len = 0;
+		while (FontHasChar(str[len])){
+			len++;
+		}
+		if (blend){
+			lcd_x = BlendText(lcd_x, lcd_y, str, len, font, foreground);
+		}
+		else{
+			lcd_x = DrawText(lcd_x, lcd_y, str, len, font, foreground, background, 1);
+		}
+		str += len;
+
+		/* New line */
+		if (*str == '\n'){
+			lcd_y += font->font_height + 1;
+			/* if after \n is also \r, than go to the left of the screen */
+			if (*(str + 1) == '\r'){
+				lcd_x = 0;
+				str++;
+			}
+			else{
+				lcd_x = x;
+			}
+			str++;
+		}
+		/* \r alone and characters not in fonts are skipped */
+		else if (*str != '\0'){
+			str++;
+		}
+	}
+}
+
+static void ScrollLinesArea(uint16_t first, uint16_t last, fb_rect_t *rect){
+	/* Lines follow the LCD long side, it is y in portrait and x in landscape.
+	Mirrored orientations (MY = 1) count lines from the other end */
+	switch(lcd_orientation.orientation){
+	case ILI9341_Portrait_1:
+		*rect = (fb_rect_t){0, first, ILI9341_WIDTH - 1, last};
+		break;
+	case ILI9341_Portrait_2:
+		*rect = (fb_rect_t){0, ILI9341_HEIGHT - 1 - last, ILI9341_WIDTH - 1, ILI9341_HEIGHT - 1 - first};
+		break;
+	case ILI9341_Landscape_1:
+		*rect = (fb_rect_t){first, 0, last, ILI9341_WIDTH - 1};
+		break;
+	case ILI9341_Landscape_2:
+		*rect = (fb_rect_t){ILI9341_HEIGHT - 1 - last, 0, ILI9341_HEIGHT - 1 - first, ILI9341_WIDTH - 1};
+		break;
+	}
+}
+
 void WriteLCD(lcd_cmd_t * data){
-	SpiInit(&spi_conf);
-	/* If command is NULL don't send command */
-	if (data->cmd != NULL){
-		/* Send command */
-		GPIOOff(ili9341_dc);
-		SpiWrite(ili9341_spi, &data->cmd, 1);
+	/* If command is 0 don't send command */
+	if (data->cmd != 0){
+		StreamCommand(data->cmd, data->data, data->databytes);
 	}
-	/* If there are parameters or data to send */
-	if (data->databytes != NULL){
-		/* Send parameters or data */
-		GPIOOn(ili9341_dc);
-		SpiWrite(ili9341_spi, data->data, data->databytes);
+	else{
+		StreamData(data->data, data->databytes);
 	}
+	StreamEnd();
 }
 
 void SetCursorPosition(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1){
@@ -223,19 +780,25 @@ void SetCursorPosition(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1){
 		y0 = y1;
 		y1 = aux;
 	}
-	uint8_t columns[] = {HighByte(x0), LowByte(x0), HighByte(x1), LowByte(x1)};
-	lcd_cmd_t lcd_columns = {COLUMN_ADDR_SET, 4, columns};
-	uint8_t rows[] = {HighByte(y0), LowByte(y0), HighByte(y1), LowByte(y1)};
-	lcd_cmd_t lcd_rows = {PAGE_ADDR_SET, 4, rows};
-	WriteLCD(&lcd_columns);
-	WriteLCD(&lcd_rows);
+	/* LCD keeps the last window, only the changed limits are sent */
+	if (lcd_columns != ((uint32_t)x0 << 16 | x1)){
+		uint8_t columns[] = {HighByte(x0), LowByte(x0), HighByte(x1), LowByte(x1)};
+		StreamCommand(COLUMN_ADDR_SET, columns, sizeof(columns));
+		lcd_columns = (uint32_t)x0 << 16 | x1;
+	}
+	if (lcd_rows != ((uint32_t)y0 << 16 | y1)){
+		uint8_t rows[] = {HighByte(y0), LowByte(y0), HighByte(y1), LowByte(y1)};
+		StreamCommand(PAGE_ADDR_SET, rows, sizeof(rows));
+		lcd_rows = (uint32_t)y0 << 16 | y1;
+	}
 }
 
 void Fill(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color){
 	static uint16_t i;
 	static int32_t bytes_count;
 	static int16_t x_dist, y_dist;
-	static uint8_t pixel[MAX_VALUE_SIZE];
+	uint32_t chunk;
+	uint8_t *pixel;
 
 	x_dist = x1 - x0;
 	y_dist = y1 - y0;
@@ -245,26 +808,100 @@ void Fill(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color){
 	if (y0 > y1){
 		y_dist = - y_dist;
 	}
+	if (lcd_fb_on){
+		fb_rect_t rect = {x0, y0, x1, y1};
+		if (x0 > x1){
+			rect.x0 = x1;
+			rect.x1 = x0;
+		}
+		if (y0 > y1){
+			rect.y0 = y1;
+			rect.y1 = y0;
+		}
+		FramebufferFill(&lcd_fb, &rect, color);
+		/* Parts outside the framebuffer are drawn on the LCD */
+		if (FramebufferContains(&lcd_fb, &rect)){
+			return;
+		}
+	}
 	/* Number of bytes to write. We have to write 2 bytes/pixel (16bits color) */
 	bytes_count = (x_dist + 1) * (y_dist + 1) * 2;
 	/* Define area to fill */
 	SetCursorPosition(x0, y0, x1, y1);
 
-	for (i = 0; i < MAX_VALUE_SIZE; i += 2){
+	chunk = (bytes_count < MAX_VALUE_SIZE) ? bytes_count : MAX_VALUE_SIZE;
+	pixel = BufferGet();
+	for (i = 0; i < chunk; i += 2){
 		pixel[i] = HighByte(color);
 		pixel[i + 1] = LowByte(color);
 	}
-	/* Start writing LCD memory */
-	lcd_cmd_t lcd_write = {MEM_WRITE, NULL, NULL};
-	WriteLCD(&lcd_write);
-
+	/* Start writing LCD memory, every chunk is queued from the same buffer */
+	StreamCommand(MEM_WRITE, NULL, 0);
 	while(bytes_count - MAX_VALUE_SIZE > 0){
-		lcd_cmd_t lcd_pixel = {NULL, MAX_VALUE_SIZE, pixel};
-		WriteLCD(&lcd_pixel);
+		StreamData(pixel, MAX_VALUE_SIZE);
 		bytes_count -= MAX_VALUE_SIZE;
 	}
-	lcd_cmd_t lcd_pixel = {NULL, bytes_count, pixel};
-	WriteLCD(&lcd_pixel);
+	BufferSend(bytes_count, true);
+}
+
+static int16_t EdgeX(int16_t x, int32_t num, int32_t den){
+	/* Division truncates toward 0, negative offsets are rounded down too */
+	if (num < 0){
+		num -= den - 1;
+	}
+	return x + num / den;
+}
+
+static void FillRun(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color){
+	static int16_t aux;
+
+	if (x0 > x1){
+		aux = x0;
+		x0 = x1;
+		x1 = aux;
+	}
+	if (y0 > y1){
+		aux = y0;
+		y0 = y1;
+		y1 = aux;
+	}
+	/* Clip to LCD */
+	if (x0 < 0){
+		x0 = 0;
+	}
+	if (y0 < 0){
+		y0 = 0;
+	}
+	if (x1 >= lcd_orientation.width){
+		x1 = lcd_orientation.width - 1;
+	}
+	if (y1 >= lcd_orientation.height){
+		y1 = lcd_orientation.height - 1;
+	}
+	if (x0 > x1 || y0 > y1){
+		return;
+	}
+	Fill(x0, y0, x1, y1, color);
+}
+
+static void CircleRuns(int16_t x0, int16_t y0, int16_t xa, int16_t xb, int16_t y, uint16_t color){
+	if (xa == 0){
+		/* Runs crossing the axes are a single run */
+		FillRun(x0 - xb, y0 + y, x0 + xb, y0 + y, color);
+		FillRun(x0 - xb, y0 - y, x0 + xb, y0 - y, color);
+		FillRun(x0 + y, y0 - xb, x0 + y, y0 + xb, color);
+		FillRun(x0 - y, y0 - xb, x0 - y, y0 + xb, color);
+	}
+	else{
+		FillRun(x0 + xa, y0 + y, x0 + xb, y0 + y, color);
+		FillRun(x0 - xb, y0 + y, x0 - xa, y0 + y, color);
+		FillRun(x0 + xa, y0 - y, x0 + xb, y0 - y, color);
+		FillRun(x0 - xb, y0 - y, x0 - xa, y0 - y, color);
+		FillRun(x0 + y, y0 + xa, x0 + y, y0 + xb, color);
+		FillRun(x0 + y, y0 - xb, x0 + y, y0 - xa, color);
+		FillRun(x0 - y, y0 + xa, x0 - y, y0 + xb, color);
+		FillRun(x0 - y, y0 - xb, x0 - y, y0 - xa, color);
+	}
 }
 
 /*==================[external functions definition]==========================*/
@@ -278,6 +915,10 @@ uint8_t ILI9341Init(spi_dev_t spi_dev, uint8_t gpio_dc, uint8_t gpio_rst){
 	ili9341_rst = gpio_rst;
 	GPIOInit(ili9341_dc, GPIO_OUTPUT);
 	GPIOInit(ili9341_rst, GPIO_OUTPUT);
+	/* SPI device is added once, D/C is driven by the pre transaction callback */
+	SpiInit(&spi_conf);
+	lcd_columns = NO_ADDR;
+	lcd_rows = NO_ADDR;
 
 	/* RST must be held low for minimum 10µsec after VCC have been applied */
 	DelayUs(10);
@@ -303,15 +944,22 @@ uint8_t ILI9341Init(spi_dev_t spi_dev, uint8_t gpio_dc, uint8_t gpio_rst){
 }
 
 void ILI9341DrawPixel(uint16_t x, uint16_t y, uint16_t color){
+	if (lcd_fb_on){
+		fb_rect_t rect = {x, y, x, y};
+		if (FramebufferContains(&lcd_fb, &rect)){
+			FramebufferDrawPixel(&lcd_fb, x, y, color);
+			return;
+		}
+	}
 	/* Define area (pixel) to fill */
 	SetCursorPosition(x, y, x, y);
+	/* Pixel data fits in the transaction, there is no need to wait for it */
 	uint8_t pixels[] = {HighByte(color), LowByte(color)};
-	lcd_cmd_t lcd_pixels = {MEM_WRITE, sizeof(pixels), pixels};
-	WriteLCD(&lcd_pixels);
+	StreamCommand(MEM_WRITE, pixels, sizeof(pixels));
 }
 
 void ILI9341Fill(uint16_t color){
-	Fill(0, 0, lcd_orientation.width, lcd_orientation.height, color);
+	Fill(0, 0, lcd_orientation.width - 1, lcd_orientation.height - 1, color);
 }
 
 void ILI9341Rotate(ili9341_orientation_t orientation){
@@ -347,76 +995,34 @@ void ILI9341Rotate(ili9341_orientation_t orientation){
 	}
 	lcd_cmd_t lcd_mem_acc = {MEM_ACC_CTRL, 1, mem_acc};
 	WriteLCD(&lcd_mem_acc);
+	/* Framebuffer content must be sent again with the new orientation */
+	if (lcd_fb_on){
+		fb_rect_t rect = {lcd_fb.x, lcd_fb.y, lcd_fb.x + lcd_fb.width - 1, lcd_fb.y + lcd_fb.height - 1};
+		FramebufferInvalidate(&lcd_fb, &rect);
+	}
 }
 
 void ILI9341DrawChar(uint16_t x, uint16_t y, char data, Font_t* font, uint16_t foreground, uint16_t background){
-	static uint32_t i, j, k;
-	static uint32_t char_row;
 	static uint16_t lcd_x, lcd_y;
-	static int32_t bytes_count, bytes_row;
-	static uint8_t pixel[MAX_VALUE_SIZE];
+	char_info_t *info = &font->info[data - ' '];
 
 	/* Set coordinates */
 	lcd_x = x;
 	lcd_y = y;
 
 	/* If at the end of a line of display, go to new line and set x to 0 position */
-	if ((lcd_x + font->info[data - ' '].width) > lcd_orientation.width)	{
+	if ((lcd_x + info->width) > lcd_orientation.width)	{
 		lcd_y += font->font_height;
 		lcd_x = 0;
 	}
 
-	SetCursorPosition(lcd_x, lcd_y, lcd_x + font->info[data - ' '].width - 1, lcd_y + font->font_height - 1);
-
-	/* Number of bytes to write. We have to write 2 bytes/pixel */
-	bytes_count = font->font_height * font->info[data - ' '].width * 2;
-
-	/* Start writing LCD memory */
-	lcd_cmd_t lcd_write = {MEM_WRITE, NULL, NULL};
-	WriteLCD(&lcd_write);
-
 	/* Draw font data */
-	/* go through character rows */
-	k = 0;
-	for (i = 0; i < font->font_height; i++)	{
-		/* */
-		char_row = font->info[data - ' '].offset + i * ((font->info[data - ' '].width + 7) / 8);
-		/* go through character columns */
-		bytes_row = -1;
-		for (j = 0; j < font->info[data - ' '].width; j++){
-			if(j % 8 == 0){
-				bytes_row++;
-			}
-			/* If exceed buffer size, send buffer */
-			if ((2 * j + i * font->info[data - ' '].width * 2 - k * MAX_VALUE_SIZE + 1) > MAX_VALUE_SIZE){
-				lcd_cmd_t lcd_pixels = {NULL, MAX_VALUE_SIZE, pixel};
-				WriteLCD(&lcd_pixels);
-				bytes_count -= MAX_VALUE_SIZE;
-				k++;
-			}
-			/* The n=FontWidth first bits of the 16bits row data draws the corresponding part of a character */
-			if (font->data[char_row + bytes_row] & (MSK_BIT8 >> (j % 8))){
-				/* if bit = 1, draw put foreground color */
-				pixel[2 * j + i * font->info[data - ' '].width * 2 - k * MAX_VALUE_SIZE] = HighByte(foreground);
-				pixel[2 * j + i * font->info[data - ' '].width * 2 - k * MAX_VALUE_SIZE + 1] = LowByte(foreground);
-			}
-			else{
-				pixel[2 * j + i * font->info[data - ' '].width * 2 - k * MAX_VALUE_SIZE] = HighByte(background);
-				pixel[2 * j + i * font->info[data - ' '].width * 2 - k * MAX_VALUE_SIZE + 1] = LowByte(background);
-			}
-		}
-	}
-	/* Send the rest of the buffer */
-	lcd_cmd_t lcd_pixels = {NULL, bytes_count, pixel};
-	WriteLCD(&lcd_pixels);
+	DrawGlyph(lcd_x, lcd_y, data, font, foreground, background);
 }
 
 void ILI9341DrawIcon(uint16_t x, uint16_t y, icon_t icon, icon_font_t* icon_font, uint16_t foreground, uint16_t background){
-	static uint32_t i, j, k;
-	static uint32_t char_row;
 	static uint16_t lcd_x, lcd_y;
-	static int32_t bytes_count, bytes_row;
-	static uint8_t pixel[MAX_VALUE_SIZE];
+	const icon_sprite_t *sprite;
 
 	/* Set coordinates */
 	lcd_x = x;
@@ -428,96 +1034,66 @@ void ILI9341DrawIcon(uint16_t x, uint16_t y, icon_t icon, icon_font_t* icon_font
 		lcd_x = 0;
 	}
 
-	SetCursorPosition(lcd_x, lcd_y, lcd_x + icon_font->width - 1, lcd_y + icon_font->height - 1);
-
-	/* Number of bytes to write. We have to write 2 bytes/pixel */
-	bytes_count = icon_font->height * icon_font->width * 2;
+	sprite = IconSpriteGet(icon_font, icon, foreground, background);
+	if (sprite == NULL){
+		/* Draw icon data */
+		DrawBitmap(lcd_x, lcd_y, icon_font->width, icon_font->height, &icon_font->data[icon * icon_font->offset], foreground, background);
+		return;
+	}
+	if (lcd_fb_on){
+		fb_rect_t rect = {lcd_x, lcd_y, lcd_x + icon_font->width - 1, lcd_y + icon_font->height - 1};
+		BlitSprite(lcd_x, lcd_y, sprite, false);
+		/* Parts outside the framebuffer are drawn on the LCD */
+		if (FramebufferContains(&lcd_fb, &rect)){
+			return;
+		}
+	}
+	DrawSprite(lcd_x, lcd_y, sprite);
+}
 
-	/* Start writing LCD memory */
-	lcd_cmd_t lcd_write = {MEM_WRITE, NULL, NULL};
-	WriteLCD(&lcd_write);
+void ILI9341DrawIconTransparent(uint16_t x, uint16_t y, icon_t icon, icon_font_t* icon_font, uint16_t foreground){
+	const icon_sprite_t *sprite;
+	const uint8_t *bitmap = &icon_font->data[icon * icon_font->offset];
+	uint16_t row_bytes = (icon_font->width + 7) / 8;
+	uint16_t i, j;
 
-	/* Draw font data */
-	/* go through character rows */
-	k = 0;
-	for (i = 0; i < icon_font->height; i++)	{
-		/*  */
-		char_row = icon * icon_font->offset + i * ((icon_font->width + 7) / 8);
-		/* go through character columns */
-		bytes_row = -1;
+	if (!lcd_fb_on){
+		return;
+	}
+	/* Background is the key color, any color other than foreground */
+	sprite = IconSpriteGet(icon_font, icon, foreground, ~foreground);
+	if (sprite != NULL){
+		BlitSprite(x, y, sprite, true);
+		return;
+	}
+	for (i = 0; i < icon_font->height; i++){
 		for (j = 0; j < icon_font->width; j++){
-			if(j % 8 == 0){
-				bytes_row++;
-			}
-			/* If exceed buffer size, send buffer */
-			if ((2 * j + i * icon_font->width * 2 - k * MAX_VALUE_SIZE + 1) > MAX_VALUE_SIZE){
-				lcd_cmd_t lcd_pixels = {NULL, MAX_VALUE_SIZE, pixel};
-				WriteLCD(&lcd_pixels);
-				bytes_count -= MAX_VALUE_SIZE;
-				k++;
-			}
-			/* The n=FontWidth first bits of the 16bits row data draws the corresponding part of a character */
-			if (icon_font->data[char_row + bytes_row] & (MSK_BIT8 >> (j % 8))){
-				/* if bit = 1, draw put foreground color */
-				pixel[2 * j + i * icon_font->width * 2 - k * MAX_VALUE_SIZE] = HighByte(foreground);
-				pixel[2 * j + i * icon_font->width * 2 - k * MAX_VALUE_SIZE + 1] = LowByte(foreground);
-			}
-			else{
-				pixel[2 * j + i * icon_font->width * 2 - k * MAX_VALUE_SIZE] = HighByte(background);
-				pixel[2 * j + i * icon_font->width * 2 - k * MAX_VALUE_SIZE + 1] = LowByte(background);
+			if (bitmap[i * row_bytes + j / 8] & (MSK_BIT8 >> (j % 8))){
+				FramebufferDrawPixel(&lcd_fb, x + j, y + i, foreground);
 			}
 		}
 	}
-	/* Send the rest of the buffer */
-	lcd_cmd_t lcd_pixels = {NULL, bytes_count, pixel};
-	WriteLCD(&lcd_pixels);
 }
 
 void ILI9341DrawInt(uint16_t x, uint16_t y, uint32_t num, uint8_t dig, Font_t* font, uint16_t foreground, uint16_t background){
+	static char digits[UINT8_MAX];
 	static uint16_t i;
-	static uint16_t lcd_x, lcd_y;
 
-	/* Set coordinates */
-	lcd_x = x;
-	lcd_y = y;
-
-	for (i=0; i<dig; i++){
-		lcd_x = x + font->info[num%10 + '0' - ' '].width * (dig-1-i) + 1;
-		ILI9341DrawChar(lcd_x, lcd_y, num%10 + '0', font, foreground, background);
+	/* Digits are drawn side by side, without spacing */
+	for (i = dig; i > 0; i--){
+		digits[i - 1] = num%10 + '0';
 		num = num/10;
 	}
+	DrawText(x + 1, y, digits, dig, font, foreground, background, 0);
 }
 
 void ILI9341DrawString(uint16_t x, uint16_t y, char* str, Font_t *font, uint16_t foreground, uint16_t background){
-	static uint16_t lcd_x, lcd_y;
-
-	/* Set coordinates */
-	lcd_x = x;
-	lcd_y = y;
-
-	while (*str != '\0'){	/* End of string */
-		/* New line */
-		if (*str == '\n'){
-			lcd_y += font->font_height + 1;
-			/* if after \n is also \r, than go to the left of the screen */
-			if (*(str + 1) == '\r'){
-				lcd_x = 0;
-				str++;
-			}
-			else{
-				lcd_x = x;
-			}
-			str++;
-		}
-		else if (*str == '\r'){
-				str++;
-			}
+	DrawLines(x, y, str, font, foreground, background, false);
+}
 
-		/* Put character to LCD */
-		ILI9341DrawChar(lcd_x, lcd_y, *str, font, foreground, background);
-		lcd_x += font->info[*str - ' '].width + 1;
-		/* Next character */
-		str++;
+void ILI9341DrawStringBlend(uint16_t x, uint16_t y, char* str, Font_t *font, uint16_t foreground){
+	if (lcd_fb_on){
+		DrawLines(x, y, str, font, foreground, 0, true);
 	}
 }
 
@@ -536,6 +1112,7 @@ void ILI9341GetStringSize(char* str, Font_t* font, uint16_t* width, uint16_t* he
 
 void ILI9341DrawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color){
 	static int16_t x_dist, y_dist, x_grow, y_grow, error, error_2;
+	static int16_t run_x, run_y, last_x, last_y;
 
 	/* Check for overflow */
 	if (x0 >= lcd_orientation.width){
@@ -576,14 +1153,17 @@ void ILI9341DrawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_
 	/* Diagonal line */
 	else{
 		error = x_dist - y_dist;
+		/* Consecutive pixels along the major axis are sent as one run */
+		run_x = x0;
+		run_y = y0;
 
 		while (1){
-			/* Draw start point */
-			ILI9341DrawPixel(x0, y0, color);
 			/* Loop ends when start point reaches end point */
 			if (x0 == x1 && y0 == y1){
 				break;
 			}
+			last_x = x0;
+			last_y = y0;
 			error_2 = 2 * error;
 			/* Determine if line must grow in x direction */
 			if (error_2 > -y_dist){
@@ -595,7 +1175,14 @@ void ILI9341DrawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_
 				error += x_dist;
 				y0 += y_grow;	/* Move start point */
 			}
+			/* Run ends when the line moves on the minor axis */
+			if ((x_dist >= y_dist && y0 != last_y) || (x_dist < y_dist && x0 != last_x)){
+				Fill(run_x, run_y, last_x, last_y, color);
+				run_x = x0;
+				run_y = y0;
+			}
 		}
+		Fill(run_x, run_y, x1, y1, color);
 	}
 }
 
@@ -611,21 +1198,20 @@ void ILI9341DrawFilledRectangle(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t
 }
 
 void ILI9341DrawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color){
-	static int16_t f, ddF_x, ddF_y, x, y;
+	static int16_t f, ddF_x, ddF_y, x, y, x_run;
 
 	f = 1 - r;
 	ddF_x = 1;
 	ddF_y = -2 * r;
 	x = 0;
 	y = r;
-
-	ILI9341DrawPixel(x0, y0 + r, color);
-	ILI9341DrawPixel(x0, y0 - r, color);
-	ILI9341DrawPixel(x0 + r, y0, color);
-	ILI9341DrawPixel(x0 - r, y0, color);
+	/* Points of the first octant with the same y form a run, mirrored to the other octants */
+	x_run = 0;
 
     while (x < y){
         if (f >= 0){
+            CircleRuns(x0, y0, x_run, x, y, color);
+            x_run = x + 1;
             y--;
             ddF_y += 2;
             f += ddF_y;
@@ -633,17 +1219,8 @@ void ILI9341DrawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color){
         x++;
         ddF_x += 2;
         f += ddF_x;
-
-        ILI9341DrawPixel(x0 + x, y0 + y, color);
-        ILI9341DrawPixel(x0 - x, y0 + y, color);
-        ILI9341DrawPixel(x0 + x, y0 - y, color);
-        ILI9341DrawPixel(x0 - x, y0 - y, color);
-
-        ILI9341DrawPixel(x0 + y, y0 + x, color);
-        ILI9341DrawPixel(x0 - y, y0 + x, color);
-        ILI9341DrawPixel(x0 + y, y0 - x, color);
-        ILI9341DrawPixel(x0 - y, y0 - x, color);
     }
+    CircleRuns(x0, y0, x_run, x, y, color);
 }
 
 void ILI9341DrawFilledCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color){
@@ -655,14 +1232,13 @@ void ILI9341DrawFilledCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color){
 	x = 0;
 	y = r;
 
-    ILI9341DrawPixel(x0, y0 + r, color);
-    ILI9341DrawPixel(x0, y0 - r, color);
-    ILI9341DrawPixel(x0 + r, y0, color);
-    ILI9341DrawPixel(x0 - r, y0, color);
-    ILI9341DrawLine(x0 - r, y0, x0 + r, y0, color);
+    FillRun(x0 - r, y0, x0 + r, y0, color);
 
     while (x < y){
         if (f >= 0){
+            /* Rows y0 +- y are drawn once, with their widest span */
+            FillRun(x0 - x, y0 + y, x0 + x, y0 + y, color);
+            FillRun(x0 - x, y0 - y, x0 + x, y0 - y, color);
             y--;
             ddF_y += 2;
             f += ddF_y;
@@ -671,12 +1247,11 @@ void ILI9341DrawFilledCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color){
         ddF_x += 2;
         f += ddF_x;
 
-        ILI9341DrawLine(x0 - x, y0 + y, x0 + x, y0 + y, color);
-        ILI9341DrawLine(x0 + x, y0 - y, x0 - x, y0 - y, color);
-
-        ILI9341DrawLine(x0 + y, y0 + x, x0 - y, y0 + x, color);
-        ILI9341DrawLine(x0 + y, y0 - x, x0 - y, y0 - x, color);
+        FillRun(x0 - y, y0 + x, x0 + y, y0 + x, color);
+        FillRun(x0 - y, y0 - x, x0 + y, y0 - x, color);
     }
+    FillRun(x0 - x, y0 + y, x0 + x, y0 + y, color);
+    FillRun(x0 - x, y0 - y, x0 + x, y0 - y, color);
 }
 
 void ILI9341DrawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color){
@@ -686,123 +1261,74 @@ void ILI9341DrawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t
 }
 
 void ILI9341DrawFilledTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color){
-	static int16_t x_0 = 0;
-	static int16_t y_0 = 0;
-	static int16_t x_1 = 0;
-	static int16_t y_1 = 0;
-	static int16_t x_2 = 0;
-	static int16_t y_2 = 0;
-	static int16_t x_aux = 0;
-	static int16_t y_aux = 0;
-	static int16_t scanline_y = 0;
-	float invslope1, invslope2, curx1, curx2;
-	if((y0 <= y1) && (y0 <= y2)){
-		x_0 = x0;
-		y_0 = y0;
-		if(y1 <= y2){
-			x_1 = x1;
-			y_1 = y1;
-			x_2 = x2;
-			y_2 = y2;
-		} else{
-			x_1 = x2;
-			y_1 = y2;
-			x_2 = x1;
-			y_2 = y1;
-		}
-	}else if((y1 <= y2) && (y1 <= y0)){
-		x_0 = x1;
-		y_0 = y1;
-		if(y0 <= y2){
-			x_1 = x0;
-			y_1 = y0;
-			x_2 = x2;
-			y_2 = y2;
-		} else{
-			x_1 = x2;
-			y_1 = y2;
-			x_2 = x0;
-			y_2 = y0;
-		}
-	}else if((y2 <= y1) && (y2 <= y0)){
-		x_0 = x2;
-		y_0 = y2;
-		if(y0 <= y1){
-			x_1 = x0;
-			y_1 = y0;
-			x_2 = x1;
-			y_2 = y1;
-		} else{
-			x_1 = x1;
-			y_1 = y1;
-			x_2 = x0;
-			y_2 = y0;
-		}
-	}
-	if(y_1 == y_2){
-		// Bottom flat triangle
-		invslope1 = (float)(x_1 - x_0) / (float)(y_1 - y_0);
-		invslope2 = (float)(x_2 - x_0) / (float)(y_2 - y_0);
-		curx1 = x_0;
-		curx2 = x_0;
-		scanline_y = y_0;
-		while(scanline_y < y_1){
-			ILI9341DrawLine((int)curx1, scanline_y, (int)curx2, scanline_y, color);
-			curx1 += invslope1;
-			curx2 += invslope2;
-			scanline_y++;
-		}
-  	}
-  	else if (y_0 == y_1){
-		// Top flat triangle
-		invslope1 = (float)(x_2 - x_0) / (float)(y_2 - y_0);
-		invslope2 = (float)(x_2 - x_1) / (float)(y_2 - y_1);
-		curx1 = x_2;
-		curx2 = x_2;
-		scanline_y = y_2;
-		while(scanline_y > y_0){
-			ILI9341DrawLine((int)curx1, scanline_y, (int)curx2, scanline_y, color);
-			curx1 -= invslope1;
-			curx2 -= invslope2;
-			scanline_y--;
-		}
-  	}
-  	else{
-		// Split in a flat top triangle and a bottom flat triangle
-		x_aux = (int)(x_0 + (float)(y_1 - y_0) / (float)(y_2 - y_0) * (x_2 - x_0));
-		y_aux = y_1;
-		// Bottom flat triangle
-		invslope1 = (float)(x_1 - x_0) / (float)(y_1 - y_0);
-		invslope2 = (float)(x_aux - x_0) / (float)(y_aux - y_0);
-		curx1 = x_0;
-		curx2 = x_0;
-		scanline_y = y_0;
-		while(scanline_y < y_1){
-			ILI9341DrawLine((int)curx1, scanline_y, (int)curx2, scanline_y, color);
-			curx1 += invslope1;
-			curx2 += invslope2;
-			scanline_y++;
-		}
-		// Top flat triangle
-		invslope1 = (float)(x_2 - x_1) / (float)(y_2 - y_1);
-		invslope2 = (float)(x_2 - x_aux) / (float)(y_2 - y_aux);
-		curx1 = x_2;
-		curx2 = x_2;
-		scanline_y = y_2;
-		while(scanline_y > y_1){
-			ILI9341DrawLine((int)curx1, scanline_y, (int)curx2, scanline_y, color);
-			curx1 -= invslope1;
-			curx2 -= invslope2;
-			scanline_y--;
-		}
-		ILI9341DrawLine(x_1, y_1, x_aux, y_aux, color);
-  	}
+	static int16_t aux, y, x_mid, xa, xb;
+	static int32_t dy01, dy02, dy12;
+
+	/* Sort vertices by row: y0 <= y1 <= y2 */
+	if (y0 > y1){
+		aux = y0; y0 = y1; y1 = aux;
+		aux = x0; x0 = x1; x1 = aux;
+	}
+	if (y1 > y2){
+		aux = y2; y2 = y1; y1 = aux;
+		aux = x2; x2 = x1; x1 = aux;
+	}
+	if (y0 > y1){
+		aux = y0; y0 = y1; y1 = aux;
+		aux = x0; x0 = x1; x1 = aux;
+	}
+
+	/* All vertices on the same row */
+	if (y0 == y2){
+		xa = xb = x0;
+		if (x1 < xa){
+			xa = x1;
+		}
+		else if (x1 > xb){
+			xb = x1;
+		}
+		if (x2 < xa){
+			xa = x2;
+		}
+		else if (x2 > xb){
+			xb = x2;
+		}
+		FillRun(xa, y0, xb, y0, color);
+		return;
+	}
+
+	dy01 = y1 - y0;
+	dy02 = y2 - y0;
+	dy12 = y2 - y1;
+	/* Edge 0-2 at row y1 splits the triangle. Edges are rounded down from the top
+	vertex above y1 and from the bottom one below, as the float slopes were */
+	x_mid = EdgeX(x0, dy01 * (x2 - x0), dy02);
+
+	/* Upper part: edges 0-1 and 0-mid */
+	for (y = y0; y < y1; y++){
+		FillRun(EdgeX(x0, (y - y0) * (x1 - x0), dy01), y,
+				EdgeX(x0, (y - y0) * (x_mid - x0), dy01), y, color);
+	}
+	FillRun(x1, y1, x_mid, y1, color);
+	/* Lower part: edges 2-1 and 2-mid */
+	for (y = y1 + 1; y <= y2; y++){
+		FillRun(EdgeX(x2, (y2 - y) * (x1 - x2), dy12), y,
+				EdgeX(x2, (y2 - y) * (x_mid - x2), dy12), y, color);
+	}
 }
 
 void ILI9341DrawPicture(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t* pic){
-	static uint16_t i, j;
 	static int32_t bytes_count;
-	static uint8_t pixel[MAX_VALUE_SIZE];
+	uint8_t *pixel;
+
+	if (lcd_fb_on){
+		fb_rect_t rect = {x, y, x + width - 1, y + height - 1};
+		FramebufferDrawPicture(&lcd_fb, x, y, width, height, pic);
+		/* Parts outside the framebuffer are drawn on the LCD */
+		if (FramebufferContains(&lcd_fb, &rect)){
+			return;
+		}
+	}
 
 	SetCursorPosition(x, y, x + width - 1, y + height - 1);
 
@@ -810,28 +1336,213 @@ void ILI9341DrawPicture(uint16_t x, uint16_t y, uint16_t width, uint16_t height,
 	bytes_count = width * height * 2;
 
 	/* Start writing LCD memory */
-	lcd_cmd_t lcd_write = {MEM_WRITE, NULL, NULL};
-	WriteLCD(&lcd_write);
+	StreamCommand(MEM_WRITE, NULL, 0);
 
-	j = 0;
+	/* Next chunk is copied while the previous one is sent */
 	while(bytes_count - MAX_VALUE_SIZE > 0){
-		for (i = 0; i < MAX_VALUE_SIZE; i++){
-			pixel[i] = pic[j * MAX_VALUE_SIZE + i];
-		}
-		lcd_cmd_t lcd_pixel = {NULL, MAX_VALUE_SIZE, pixel};
-		WriteLCD(&lcd_pixel);
+		pixel = BufferGet();
+		memcpy(pixel, pic, MAX_VALUE_SIZE);
+		BufferSend(MAX_VALUE_SIZE, false);
+		pic += MAX_VALUE_SIZE;
 		bytes_count -= MAX_VALUE_SIZE;
-		j++;
 	}
-	for (i = 0; i < bytes_count; i++){
-		pixel[i] = pic[j * MAX_VALUE_SIZE + i];
+	pixel = BufferGet();
+	memcpy(pixel, pic, bytes_count);
+	BufferSend(bytes_count, true);
+}
+
+void ILI9341DrawImage(uint16_t x, uint16_t y, const image_t *image){
+	image_decoder_t decoder;
+	uint32_t count, pixels_count;
+	uint16_t i;
+
+	if (image->width > ILI9341_HEIGHT){
+		return;
+	}
+	if (lcd_fb_on){
+		fb_rect_t rect = {x, y, x + image->width - 1, y + image->height - 1};
+		ImageDecodeStart(&decoder, image);
+		for (i = 0; i < image->height; i++){
+			ImageDecode(&decoder, lcd_row, image->width);
+			FramebufferDrawPicture(&lcd_fb, x, y + i, image->width, 1, (const uint8_t *)lcd_row);
+		}
+		/* Parts outside the framebuffer are drawn on the LCD */
+		if (FramebufferContains(&lcd_fb, &rect)){
+			return;
+		}
+	}
+
+	SetCursorPosition(x, y, x + image->width - 1, y + image->height - 1);
+	StreamCommand(MEM_WRITE, NULL, 0);
+	/* Pixels are decoded straight into the buffer the DMA sends next */
+	ImageDecodeStart(&decoder, image);
+	pixels_count = (uint32_t)image->width * image->height;
+	while (pixels_count > 0){
+		count = (pixels_count > MAX_VALUE_SIZE / 2) ? MAX_VALUE_SIZE / 2 : pixels_count;
+		ImageDecode(&decoder, (uint16_t *)BufferGet(), count);
+		pixels_count -= count;
+		BufferSend(count * 2, pixels_count == 0);
+	}
+}
+
+void ILI9341WidgetOutput(const fb_rect_t *rect, const uint16_t *pixels, void *param){
+	ILI9341DrawPicture(rect->x0, rect->y0, rect->x1 - rect->x0 + 1, rect->y1 - rect->y0 + 1, (const uint8_t *)pixels);
+}
+
+void ILI9341SetScrollArea(uint16_t start, uint16_t length){
+	uint16_t bottom = ILI9341_HEIGHT - start - length;
+	uint8_t scroll_def[] = {HighByte(start), LowByte(start), HighByte(length), LowByte(length), HighByte(bottom), LowByte(bottom)};
+	lcd_cmd_t lcd_scroll_def = {VERT_SCROLL_DEF, sizeof(scroll_def), scroll_def};
+
+	WriteLCD(&lcd_scroll_def);
+}
+
+void ILI9341SetScrollStart(uint16_t line){
+	uint8_t scroll_addr[] = {HighByte(line), LowByte(line)};
+
+	/* 2 bytes are copied into the transaction, no need to wait */
+	StreamCommand(VERT_SCROLL_ADDR, scroll_addr, sizeof(scroll_addr));
+}
+
+void ILI9341ChartInit(ili9341_chart_t *chart, uint16_t start, uint16_t length, uint16_t color, uint16_t background){
+	fb_rect_t area;
+
+	chart->start = start;
+	chart->length = length;
+	chart->next = start;
+	chart->last = -1;
+	chart->color = color;
+	chart->background = background;
+	ILI9341SetScrollArea(start, length);
+	ILI9341SetScrollStart(start);
+	ScrollLinesArea(start, start + length - 1, &area);
+	Fill(area.x0, area.y0, area.x1, area.y1, background);
+}
+
+void ILI9341ChartAdd(ili9341_chart_t *chart, uint16_t value){
+	uint16_t i, from, to;
+	uint8_t *pixel;
+	fb_rect_t line;
+
+	if (value >= ILI9341_WIDTH){
+		value = ILI9341_WIDTH - 1;
+	}
+	/* Trace joins the previous sample, so fast changes don't leave gaps */
+	from = value;
+	to = value;
+	if (chart->last >= 0){
+		from = (chart->last < value) ? chart->last : value;
+		to = (chart->last > value) ? chart->last : value;
+	}
+	/* Oldest line is replaced by the new sample */
+	ScrollLinesArea(chart->next, chart->next, &line);
+	SetCursorPosition(line.x0, line.y0, line.x1, line.y1);
+	StreamCommand(MEM_WRITE, NULL, 0);
+	pixel = BufferGet();
+	for (i = 0; i < ILI9341_WIDTH; i++){
+		if (i >= from && i <= to){
+			pixel[2 * i] = HighByte(chart->color);
+			pixel[2 * i + 1] = LowByte(chart->color);
+		}
+		else{
+			pixel[2 * i] = HighByte(chart->background);
+			pixel[2 * i + 1] = LowByte(chart->background);
+		}
+	}
+	BufferSend(2 * ILI9341_WIDTH, true);
+	chart->last = value;
+
+	/* Scrolling shows the new line at the end of the area, the rest move one line */
+	chart->next++;
+	if (chart->next == chart->start + chart->length){
+		chart->next = chart->start;
+	}
+	ILI9341SetScrollStart(chart->next);
+}
+
+void ILI9341ChartDeInit(ili9341_chart_t *chart){
+	ILI9341SetScrollArea(0, ILI9341_HEIGHT);
+	ILI9341SetScrollStart(0);
+	StreamEnd();
+}
+
+void ILI9341SetTransferCallback(void (*func_p)(void*), void *param_p){
+	lcd_done_func = func_p;
+	lcd_done_param = param_p;
+}
+
+void ILI9341WaitTransfer(void){
+	StreamEnd();
+}
+
+uint8_t ILI9341FramebufferInit(uint16_t x, uint16_t y, uint16_t width, uint16_t height){
+	uint16_t *pixels;
+	uint32_t i;
+
+	ILI9341FramebufferDeInit();
+	/* External RAM when available, internal RAM otherwise */
+	pixels = heap_caps_malloc(width * height * 2, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+	if (pixels == NULL){
+		pixels = heap_caps_malloc(width * height * 2, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+	}
+	if (pixels == NULL){
+		return false;
+	}
+	/* Same content as the LCD after ILI9341Init(), white is the same in LCD byte order */
+	for (i = 0; i < width * height; i++){
+		pixels[i] = ILI9341_WHITE;
+	}
+	FramebufferInit(&lcd_fb, pixels, x, y, width, height);
+	lcd_fb_on = true;
+	return true;
+}
+
+void ILI9341FramebufferDeInit(void){
+	if (lcd_fb_on){
+		ILI9341Flush();
+		StreamEnd();
+		heap_caps_free(lcd_fb.pixels);
+		lcd_fb_on = false;
+	}
+}
+
+framebuffer_t* ILI9341GetFramebuffer(void){
+	return lcd_fb_on ? &lcd_fb : NULL;
+}
+
+void ILI9341Flush(void){
+	fb_rect_t rect;
+	uint32_t row_bytes, bytes;
+	int16_t i;
+	uint8_t *pixel;
+
+	if (!lcd_fb_on){
+		return;
+	}
+	/* Only the merged dirty areas are sent */
+	while (FramebufferTakeDirty(&lcd_fb, &rect)){
+		SetCursorPosition(rect.x0, rect.y0, rect.x1, rect.y1);
+		StreamCommand(MEM_WRITE, NULL, 0);
+		row_bytes = (rect.x1 - rect.x0 + 1) * 2;
+		bytes = 0;
+		pixel = BufferGet();
+		for (i = rect.y0; i <= rect.y1; i++){
+			/* If the row doesn't fit, send buffer and continue on the other one */
+			if (bytes + row_bytes > MAX_VALUE_SIZE){
+				BufferSend(bytes, false);
+				pixel = BufferGet();
+				bytes = 0;
+			}
+			memcpy(&pixel[bytes], FramebufferPixel(&lcd_fb, rect.x0, i), row_bytes);
+			bytes += row_bytes;
+		}
+		BufferSend(bytes, lcd_fb.dirty_count == 0);
 	}
-	lcd_cmd_t lcd_pixel = {NULL, bytes_count, pixel};
-	WriteLCD(&lcd_pixel);
 }
 
 uint8_t ILI9341DeInit(void){
-	return 0;
+	StreamEnd();
+	return SpiDeInit(ili9341_spi);
 }
 
 /*==================[end of file]============================================*/
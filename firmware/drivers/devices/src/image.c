@@ -0,0 +1,97 @@
+/**
+ * @file image.c
+ * @brief RGB565 images stored compressed, decoded while they are sent
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include "image.h"
+#include <string.h>
+/*==================[macros and definitions]=================================*/
+#define OP_MASK		0xC0					/*!< 2 bit codes */
+#define OP_INDEX	0x00					/*!< Color from table */
+#define OP_DIFF		0x40					/*!< Small difference */
+#define OP_LUMA		0x80					/*!< Difference driven by green */
+#define OP_RUN		0xC0					/*!< Repeat previous color */
+#define OP_RGB		0xFE					/*!< Color follows */
+#define SWAP(c) ((uint16_t)((c) >> 8 | (c) << 8))	/*!< RGB565 color to LCD byte order */
+#define RED(c) ((c) >> 11)					/*!< Red of a RGB565 color, 0 to 31 */
+#define GREEN(c) (((c) >> 5) & 0x3F)		/*!< Green of a RGB565 color, 0 to 63 */
+#define BLUE(c) ((c) & 0x1F)				/*!< Blue of a RGB565 color, 0 to 31 */
+#define RGB565(r, g, b) ((uint16_t)(((r) & 0x1F) << 11 | ((g) & 0x3F) << 5 | ((b) & 0x1F)))	/*!< Channels to RGB565 color */
+#define HASH(c) ((3 * RED(c) + 5 * GREEN(c) + 7 * BLUE(c)) % IMAGE_INDEX_SIZE)				/*!< Table position of a color */
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+
+/*==================[external functions definition]==========================*/
+void ImageDecodeStart(image_decoder_t *decoder, const image_t *image){
+	decoder->data = image->data;
+	decoder->encoding = image->encoding;
+	decoder->previous = 0;
+	decoder->run = 0;
+	memset(decoder->index, 0, sizeof(decoder->index));
+}
+
+void ImageDecode(image_decoder_t *decoder, uint16_t *pixels, uint32_t count){
+	const uint8_t *data = decoder->data;
+	uint16_t color = decoder->previous;
+	uint8_t op;
+	int8_t green;
+
+	if (decoder->encoding == IMAGE_RGB565){
+		memcpy(pixels, data, count * 2);
+		decoder->data += count * 2;
+		return;
+	}
+	while (count > 0){
+		/* Repetitions go on across calls */
+		if (decoder->run > 0){
+			decoder->run--;
+			*pixels++ = SWAP(color);
+			count--;
+			continue;
+		}
+		op = *data++;
+		if (op == OP_RGB){
+			color = data[0] << 8 | data[1];
+			data += 2;
+		}
+		else{
+			switch (op & OP_MASK){
+			case OP_INDEX:
+				color = decoder->index[op];
+				break;
+			case OP_DIFF:
+				color = RGB565(RED(color) + ((op >> 4) & 0x03) - 2, GREEN(color) + ((op >> 2) & 0x03) - 2, BLUE(color) + (op & 0x03) - 2);
+				break;
+			case OP_LUMA:
+				green = (op & 0x3F) - 32;
+				color = RGB565(RED(color) + (*data >> 4) - 8 + (green >> 1), GREEN(color) + green, BLUE(color) + (*data & 0x0F) - 8 + (green >> 1));
+				data++;
+				break;
+			case OP_RUN:
+				/* This pixel and op & 0x3F more */
+				decoder->run = op & 0x3F;
+				break;
+			}
+		}
+		decoder->index[HASH(color)] = color;
+		*pixels++ = SWAP(color);
+		count--;
+	}
+	decoder->data = data;
+	decoder->previous = color;
+}
+
+/*==================[end of file]============================================*/
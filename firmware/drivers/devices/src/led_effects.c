@@ -0,0 +1,189 @@
+/**
+ * @file led_effects.c
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include "led_effects.h"
+#include <stddef.h>
+/*==================[macros and definitions]=================================*/
+#define RED_OFFSET		16
+#define GREEN_OFFSET	8
+#define BLUE_OFFSET		0
+#define INDEX_MASK		(LED_PALETTE_SIZE - 1)
+#define LAST_INDEX		((uint32_t)(LED_PALETTE_SIZE - 1) * LED_EFFECT_ONE)	/*!< Last palette entry, 8.8 fixed point */
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+/**
+ * @brief Mixes two colors, channel by channel
+ *
+ * @param from Color with frac 0
+ * @param to Color with frac 256
+ * @param frac Weight of to, 0 to 255
+ * @return uint32_t Mixed color
+ */
+static uint32_t Mix(uint32_t from, uint32_t to, uint8_t frac);
+
+/**
+ * @brief Writes a comet: head at phase, tail fading down to palette entry 0
+ *
+ * @param effect Comet
+ * @param colors Colors of the stripe
+ * @param len Number of LEDs
+ */
+static void RenderComet(const led_effect_t *effect, uint32_t *colors, uint16_t len);
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static uint32_t Mix(uint32_t from, uint32_t to, uint8_t frac){
+	uint32_t color = 0;
+	int32_t a, b;
+	uint8_t offset;
+
+	for (offset = BLUE_OFFSET; offset <= RED_OFFSET; offset += 8){
+		a = (from >> offset) & 0xFF;
+		b = (to >> offset) & 0xFF;
+		color |= (uint32_t)(a + (((b - a) * frac) >> 8)) << offset;
+	}
+	return color;
+}
+
+static void RenderComet(const led_effect_t *effect, uint32_t *colors, uint16_t len){
+	const uint32_t *palette = effect->palette;
+	uint32_t index = LAST_INDEX;
+	uint32_t step, i;
+	uint16_t led;
+
+	for (i = 0; i < len; i++){
+		colors[i] = palette[0];
+	}
+	/* Tail entries decrease by the same step from the head, no division per LED */
+	step = (effect->spread > 0) ? LAST_INDEX * LED_EFFECT_ONE / effect->spread : LAST_INDEX + 1;
+	led = (effect->phase / LED_EFFECT_ONE) % len;
+	for (i = 0; i < len && index > 0; i++){
+		colors[led] = palette[index / LED_EFFECT_ONE];
+		led = (led > 0) ? led - 1 : len - 1;
+		index = (index > step) ? index - step : 0;
+	}
+}
+
+/*==================[external functions definition]==========================*/
+uint32_t LedEffectHSV(uint16_t hue, uint8_t sat, uint8_t val){
+
+  uint8_t r, g, b;
+
+  hue = (hue * 1530L + 32768) / 65536;
+  // Convert hue to R,G,B (nested ifs faster than divide+mod+switch):
+  if (hue < 510) { // Red to Green-1
+    b = 0;
+    if (hue < 255) { //   Red to Yellow-1
+      r = 255;
+      g = hue;       //     g = 0 to 254
+    } else {         //   Yellow to Green-1
+      r = 510 - hue; //     r = 255 to 1
+      g = 255;
+    }
+  } else if (hue < 1020) { // Green to Blue-1
+    r = 0;
+    if (hue < 765) { //   Green to Cyan-1
+      g = 255;
+      b = hue - 510;  //     b = 0 to 254
+    } else {          //   Cyan to Blue-1
+      g = 1020 - hue; //     g = 255 to 1
+      b = 255;
+    }
+  } else if (hue < 1530) { // Blue to Red-1
+    g = 0;
+    if (hue < 1275) { //   Blue to Magenta-1
+      r = hue - 1020; //     r = 0 to 254
+      b = 255;
+    } else { //   Magenta to Red-1
+      r = 255;
+      b = 1530 - hue; //     b = 255 to 1
+    }
+  } else { // Last 0.5 Red (quicker than % operator)
+    r = 255;
+    g = b = 0;
+  }
+
+  // Apply saturation and value to R,G,B, pack into 32-bit result:
+  uint32_t v1 = 1 + val;  // 1 to 256; allows >>8 instead of /255
+  uint16_t s1 = 1 + sat;  // 1 to 256; same reason
+  uint8_t s2 = 255 - sat; // 255 to 0
+  return ((((((r * s1) >> 8) + s2) * v1) & 0xff00) << 8) |
+         (((((g * s1) >> 8) + s2) * v1) & 0xff00) |
+         (((((b * s1) >> 8) + s2) * v1) >> 8);
+}
+
+void LedPaletteHue(uint32_t *palette, uint8_t sat, uint8_t val){
+	uint16_t i;
+
+	for (i = 0; i < LED_PALETTE_SIZE; i++){
+		palette[i] = LedEffectHSV(i * (65536 / LED_PALETTE_SIZE), sat, val);
+	}
+}
+
+void LedPaletteGradient(uint32_t *palette, const uint32_t *colors, uint8_t count){
+	uint32_t position = 0;
+	uint16_t i, color;
+
+	if (count == 0){
+		return;
+	}
+	/* count colors in LED_PALETTE_SIZE entries: each entry advances count / 256 colors */
+	for (i = 0; i < LED_PALETTE_SIZE; i++){
+		color = position / LED_PALETTE_SIZE;
+		palette[i] = Mix(colors[color], colors[(color + 1) % count], position % LED_PALETTE_SIZE);
+		position += count;
+	}
+}
+
+void LedEffectInit(led_effect_t *effect, led_effect_type_t type, const uint32_t *palette, uint16_t speed, uint16_t spread){
+	effect->type = type;
+	effect->palette = palette;
+	effect->speed = speed;
+	effect->spread = spread;
+	effect->phase = 0;
+}
+
+void LedEffectRender(led_effect_t *effect, uint32_t *colors, uint16_t len, uint32_t frames){
+	const uint32_t *palette = effect->palette;
+	uint32_t index, color;
+	uint16_t i;
+
+	if (len == 0){
+		return;
+	}
+	effect->phase += frames * effect->speed;
+	switch (effect->type){
+	case LED_EFFECT_SCROLL:
+		/* Moving the effect only moves the first index */
+		index = effect->phase;
+		for (i = 0; i < len; i++){
+			colors[i] = palette[(index / LED_EFFECT_ONE) & INDEX_MASK];
+			index += effect->spread;
+		}
+		break;
+	case LED_EFFECT_PULSE:
+		color = palette[(effect->phase / LED_EFFECT_ONE) & INDEX_MASK];
+		for (i = 0; i < len; i++){
+			colors[i] = color;
+		}
+		break;
+	case LED_EFFECT_COMET:
+		RenderComet(effect, colors, len);
+		break;
+	}
+}
+
+/*==================[end of file]============================================*/
@@ -11,78 +11,149 @@
 
 /*==================[inclusions]=============================================*/
 #include "neopixel_stripe.h"
+#include <string.h>
 #include "ws2812b.h"
+#include "led_effects.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
 /*==================[macros and definitions]=================================*/
-#define RED_MSK         0x00FF0000
-#define GREEN_MSK       0x0000FF00
-#define BLUE_MSK        0x000000FF
 #define RED_OFFSET      16
 #define GREEN_OFFSET    8
 #define BLUE_OFFSET     0
+#define HUE_TURN		65536		/*!< Hue of a whole turn */
 #define MAX_BRIGHT  	255
-#define BRIGHT_OFFSET   8
+#define US_PER_S		1000000		/*!< Microseconds in a second */
+#define SHOW_TASK_STACK	2048		/*!< Stack of the task that calls NeoPixelShow() */
+#define SHOW_TASK_PRIO	5			/*!< Priority of the task that calls NeoPixelShow() */
+#define SHOW_SLACK_US	(portTICK_PERIOD_MS * 1000)	/*!< A frame may be sent up to one tick early */
 /*==================[internal data declaration]==============================*/
 uint16_t stripe_length;
 uint8_t stripe_bright = MAX_BRIGHT;
 neopixel_color_t *stripe_colors; 
+static volatile bool stripe_dirty = false;						/*!< Colors changed since the last frame */
+static uint32_t stripe_period = US_PER_S / NEOPIXEL_REFRESH_RATE;	/*!< Minimum time between frames (us) */
+static int64_t stripe_last_show = 0;							/*!< Time of the last frame (us) */
+static TaskHandle_t show_task_handle = NULL;					/*!< Task that calls NeoPixelShow() */
+static led_effect_t *stripe_effect = NULL;						/*!< Effect rendered before each frame */
+static SemaphoreHandle_t show_mutex = NULL;						/*!< NeoPixelShow() from ShowTask and other tasks */
+static StaticSemaphore_t show_mutex_buffer;						/*!< Memory of show_mutex */
 /*==================[internal functions declaration]=========================*/
+/**
+ * @brief Sends the stripe colors once every refresh period, if they changed.
+ * 
+ * @param param Not used
+ */
+static void ShowTask(void *param);
 
 /*==================[internal data definition]===============================*/
 
 /*==================[external data definition]===============================*/
 
 /*==================[internal functions definition]==========================*/
+static void ShowTask(void *param){
+	TickType_t last_wake = xTaskGetTickCount();
+	TickType_t period;
+
+	while (true){
+		period = pdMS_TO_TICKS(stripe_period / 1000);
+		vTaskDelayUntil(&last_wake, (period > 0) ? period : 1);
+		NeoPixelShow();
+	}
+}
 
 /*==================[external functions definition]==========================*/
 
 void NeoPixelInit(gpio_t pin, uint16_t len, neopixel_color_t *color_array){
     stripe_length = len;
 	stripe_colors = color_array;
-    ws2812bInit(pin);
+    ws2812bInit(pin, len);
+	ws2812bSetBrightness(stripe_bright);
+	if (show_mutex == NULL){
+		show_mutex = xSemaphoreCreateMutexStatic(&show_mutex_buffer);
+	}
 }
 
 void NeoPixelAllOff(void){
-    rgb_led_t led;
-	ws2812bSendRet();
-	ws2812bSendRet();
-	ws2812bSendRet();
-	for (uint16_t i = 0; i < stripe_length; i++){
-		led.red = 0;
-		led.green = 0;
-		led.blue = 0;
-		ws2812bSend(led);
-	}
-	ws2812bSendRet();
+	NeoPixelAllColor(0);
 }
 
 void NeoPixelAllColor(neopixel_color_t color){
 	for (uint16_t i = 0; i < stripe_length; i++){
 		stripe_colors[i] = color;
 	}
-	NeoPixelSetArray(stripe_colors);
+	stripe_dirty = true;
 }
 
 void NeoPixelSetPixel(uint16_t pixel, neopixel_color_t color){
 	stripe_colors[pixel] = color;
-	NeoPixelSetArray(stripe_colors);
+	stripe_dirty = true;
 }
 
 void NeoPixelSetArray(neopixel_color_t *color_array){
-    rgb_led_t led;
-	uint16_t red, green, blue;
-	ws2812bSendRet();
-	ws2812bSendRet();
-	ws2812bSendRet();
-	for (uint16_t i = 0; i < stripe_length; i++){
-		red = ((color_array[i] & RED_MSK) >> RED_OFFSET) * stripe_bright;
-		green = ((color_array[i] & GREEN_MSK) >> GREEN_OFFSET) * stripe_bright;
-		blue = ((color_array[i] & BLUE_MSK) >> BLUE_OFFSET) * stripe_bright;
-		led.red = red >> BRIGHT_OFFSET;
-		led.green = green >> BRIGHT_OFFSET;
-		led.blue = blue >> BRIGHT_OFFSET;
-		ws2812bSend(led);
+	if (color_array != stripe_colors){
+		memcpy(stripe_colors, color_array, stripe_length * sizeof(neopixel_color_t));
+	}
+	stripe_dirty = true;
+}
+
+bool NeoPixelShow(void){
+	int64_t now, elapsed;
+	led_effect_t *effect;
+	uint32_t periods = 1;
+
+	/* ShowTask and explicit calls share the frame buffers and the time of the last frame */
+	xSemaphoreTake(show_mutex, portMAX_DELAY);
+	now = esp_timer_get_time();
+	elapsed = now - stripe_last_show;
+	effect = stripe_effect;
+	/* ShowTask wakes up on ticks, it may be up to one tick early */
+	if ((!stripe_dirty && effect == NULL) || elapsed + SHOW_SLACK_US < stripe_period){
+		xSemaphoreGive(show_mutex);
+		return false;
+	}
+	if (stripe_period > 0 && stripe_last_show > 0){
+		periods = (elapsed + SHOW_SLACK_US) / stripe_period;
+		/* Frames stay on the period grid, the average rate is kept */
+		stripe_last_show += (int64_t)periods * stripe_period;
 	}
-	ws2812bSendRet();
+	else{
+		stripe_last_show = now;
+	}
+	if (effect != NULL){
+		/* Effects advance with the time, even if some periods were missed */
+		LedEffectRender(effect, stripe_colors, stripe_length, periods);
+	}
+	/* Changes made while the frame is converted go to the next one */
+	stripe_dirty = false;
+	/* Whole stripe in one frame, sent in background. Brightness is applied
+	with the gamma correction table */
+	ws2812bSendColors(stripe_colors, stripe_length);
+	xSemaphoreGive(show_mutex);
+	return true;
+}
+
+void NeoPixelSetRefreshRate(uint8_t fps){
+	stripe_period = (fps > 0) ? US_PER_S / fps : 0;
+}
+
+void NeoPixelAutoShow(bool enable){
+	if (enable && show_task_handle == NULL){
+		xTaskCreate(ShowTask, "neopixel_show", SHOW_TASK_STACK, NULL, SHOW_TASK_PRIO, &show_task_handle);
+	}
+	else if (!enable && show_task_handle != NULL){
+		/* Not deleted while it holds the mutex */
+		xSemaphoreTake(show_mutex, portMAX_DELAY);
+		vTaskDelete(show_task_handle);
+		show_task_handle = NULL;
+		xSemaphoreGive(show_mutex);
+	}
+}
+
+void NeoPixelEffect(led_effect_t *effect){
+	stripe_effect = effect;
+	stripe_dirty = true;
 }
 
 void NeoPixelShift(bool upwards){
@@ -101,21 +172,25 @@ void NeoPixelShift(bool upwards){
 		}
 		stripe_colors[stripe_length-1] = carry;
 	}
-	NeoPixelSetArray(stripe_colors);
+	stripe_dirty = true;
 }
 
 void NeoPixelBrightness(uint8_t bright){
 	stripe_bright = bright;
-	NeoPixelSetArray(stripe_colors);
+	ws2812bSetBrightness(bright);
+	stripe_dirty = true;
 }
 
 void NeoPixelRainbow(uint16_t first_hue, uint8_t sat, uint8_t val, uint8_t reps){
+	/* Hue in 16.16 fixed point, one division for the whole stripe */
+	uint32_t hue = (uint32_t)first_hue << 16;
+	uint32_t step = ((uint64_t)reps * HUE_TURN << 16) / stripe_length;
+
 	for (uint16_t i=0; i<stripe_length; i++) {
-		uint16_t hue = first_hue + (i * reps * 65536) / stripe_length;
-		neopixel_color_t color = NeoPixelHSV2Color(hue, sat, val);
-		stripe_colors[i] = color;
+		stripe_colors[i] = LedEffectHSV(hue >> 16, sat, val);
+		hue += step;
   	}
-	NeoPixelSetArray(stripe_colors);
+	stripe_dirty = true;
 }
 
 neopixel_color_t NeoPixelRgb2Color(uint8_t red, uint8_t green, uint8_t blue){
@@ -123,50 +198,7 @@ neopixel_color_t NeoPixelRgb2Color(uint8_t red, uint8_t green, uint8_t blue){
 }
 
 neopixel_color_t NeoPixelHSV2Color(uint16_t hue, uint8_t sat, uint8_t val){
-
-  uint8_t r, g, b;
-
-  hue = (hue * 1530L + 32768) / 65536;
-  // Convert hue to R,G,B (nested ifs faster than divide+mod+switch):
-  if (hue < 510) { // Red to Green-1
-    b = 0;
-    if (hue < 255) { //   Red to Yellow-1
-      r = 255;
-      g = hue;       //     g = 0 to 254
-    } else {         //   Yellow to Green-1
-      r = 510 - hue; //     r = 255 to 1
-      g = 255;
-    }
-  } else if (hue < 1020) { // Green to Blue-1
-    r = 0;
-    if (hue < 765) { //   Green to Cyan-1
-      g = 255;
-      b = hue - 510;  //     b = 0 to 254
-    } else {          //   Cyan to Blue-1
-      g = 1020 - hue; //     g = 255 to 1
-      b = 255;
-    }
-  } else if (hue < 1530) { // Blue to Red-1
-    g = 0;
-    if (hue < 1275) { //   Blue to Magenta-1
-      r = hue - 1020; //     r = 0 to 254
-      b = 255;
-    } else { //   Magenta to Red-1
-      r = 255;
-      b = 1530 - hue; //     b = 255 to 1
-    }
-  } else { // Last 0.5 Red (quicker than % operator)
-    r = 255;
-    g = b = 0;
-  }
-
-  // Apply saturation and value to R,G,B, pack into 32-bit result:
-  uint32_t v1 = 1 + val;  // 1 to 256; allows >>8 instead of /255
-  uint16_t s1 = 1 + sat;  // 1 to 256; same reason
-  uint8_t s2 = 255 - sat; // 255 to 0
-  return ((((((r * s1) >> 8) + s2) * v1) & 0xff00) << 8) |
-         (((((g * s1) >> 8) + s2) * v1) & 0xff00) |
-         (((((b * s1) >> 8) + s2) * v1) >> 8);
+	return LedEffectHSV(hue, sat, val);
 }
 
 /*==================[end of file]============================================*/
@@ -0,0 +1,366 @@
+/**
+ * @file widget.c
+ * @brief Retained widgets (labels, bars, gauges and plots) redrawn only where they change
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include "widget.h"
+#include <math.h>
+#include <string.h>
+/*==================[macros and definitions]=================================*/
+#define PI 3.14159265f		/*!< Half a turn in radians */
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+/**
+ * @brief  		Converts a value to a number of pixels
+ * @param[in]  	widget: Widget, with min and max
+ * @param[in]  	value: Value
+ * @param[in]  	pixels: Pixels for max
+ * @retval 		0 for min to pixels for max
+ */
+static int32_t Scale(const widget_t *widget, int32_t value, int32_t pixels);
+
+/**
+ * @brief  		Gets the end point of a gauge needle
+ * @param[in]  	widget: Gauge
+ * @param[in]  	value: Value
+ * @param[out] 	x: Screen column of the needle end
+ * @param[out] 	y: Screen row of the needle end
+ * @retval 		None
+ */
+static void GaugeNeedle(const widget_t *widget, int32_t value, int16_t *x, int16_t *y);
+
+/**
+ * @brief  		Adds an area of a widget to the dirty list of its screen
+ * @param[in]  	widget: Widget
+ * @param[in]  	rect: Area, ordered limits
+ * @retval 		None
+ */
+static void Invalidate(widget_t *widget, fb_rect_t rect);
+
+/**
+ * @brief  		Checks if two rectangles share pixels
+ * @param[in]  	a: First rectangle
+ * @param[in]  	b: Second rectangle
+ * @retval 		true if they overlap
+ */
+static bool Overlaps(const fb_rect_t *a, const fb_rect_t *b);
+
+/**
+ * @brief  		Draws the part of a widget inside a band
+ * @param[in]  	band: Framebuffer of the band being rendered
+ * @param[in]  	widget: Widget
+ * @retval 		None
+ */
+static void DrawWidget(framebuffer_t *band, const widget_t *widget);
+
+/**
+ * @brief  		Common initialization of widgets
+ * @param[out] 	widget: Widget
+ * @param[in]  	type: Widget type
+ * @param[in]  	x: X position of top left corner
+ * @param[in]  	y: Y position of top left corner
+ * @param[in]  	width: Width in pixels
+ * @param[in]  	height: Height in pixels
+ * @param[in]  	color: Foreground color (RGB565)
+ * @param[in]  	background: Background color (RGB565)
+ * @retval 		None
+ */
+static void WidgetInit(widget_t *widget, widget_type_t type, int16_t x, int16_t y, uint16_t width, uint16_t height, uint16_t color, uint16_t background);
+
+/*==================[internal data definition]===============================*/
+static uint16_t widget_band[WIDGET_BAND_PIXELS];	/*!< Pixels of the band being rendered */
+static uint16_t widget_row[UINT8_MAX];				/*!< Glyph row of a label */
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static int32_t Scale(const widget_t *widget, int32_t value, int32_t pixels){
+	if (widget->max == widget->min){
+		return 0;
+	}
+	return (int32_t)((int64_t)(value - widget->min) * pixels / (widget->max - widget->min));
+}
+
+static void GaugeNeedle(const widget_t *widget, int32_t value, int16_t *x, int16_t *y){
+	int16_t center = (widget->bounds.x0 + widget->bounds.x1) / 2;
+	int16_t radius = (widget->bounds.x1 - widget->bounds.x0) / 2;
+	float angle;
+
+	if (radius > widget->bounds.y1 - widget->bounds.y0){
+		radius = widget->bounds.y1 - widget->bounds.y0;
+	}
+	/* min points left, max points right */
+	angle = PI - PI * Scale(widget, value, 1000) / 1000;
+	*x = center + (int16_t)lroundf(radius * cosf(angle));
+	*y = widget->bounds.y1 - (int16_t)lroundf(radius * sinf(angle));
+}
+
+static void Invalidate(widget_t *widget, fb_rect_t rect){
+	if (widget->screen == NULL){
+		return;
+	}
+	if (FramebufferClip(&widget->screen->area, &rect)){
+		FramebufferInvalidate(&widget->screen->area, &rect);
+	}
+}
+
+static bool Overlaps(const fb_rect_t *a, const fb_rect_t *b){
+	return (a->x0 <= b->x1) && (b->x0 <= a->x1) && (a->y0 <= b->y1) && (b->y0 <= a->y1);
+}
+
+static void DrawWidget(framebuffer_t *band, const widget_t *widget){
+	const fb_rect_t *bounds = &widget->bounds;
+	fb_rect_t rect;
+	glyph_reader_t reader;
+	int16_t x, x_end, i, rows;
+	int16_t needle_x, needle_y;
+	uint8_t sample, previous;
+	const char *c;
+
+	FramebufferFill(band, bounds, widget->background);
+	switch (widget->type){
+	case WIDGET_LABEL:
+		rows = bounds->y1 - bounds->y0 + 1;
+		if (rows > widget->font->font_height){
+			rows = widget->font->font_height;
+		}
+		x = bounds->x0;
+		for (c = widget->text; *c != '\0'; c++){
+			if (!FontHasChar(*c)){
+				continue;
+			}
+			/* Characters that don't fit are cut */
+			if (x + widget->font->info[*c - ' '].width - 1 > bounds->x1){
+				break;
+			}
+			FontGlyphStart(&reader, widget->font, *c, widget->color, widget->background);
+			for (i = 0; i < rows && bounds->y0 + i < band->y + band->height; i++){
+				FontGlyphRow(&reader, widget_row);
+				if (bounds->y0 + i >= band->y){
+					FramebufferDrawPicture(band, x, bounds->y0 + i, reader.width, 1, (const uint8_t *)widget_row);
+				}
+			}
+			x += reader.width + 1;
+		}
+		break;
+
+	case WIDGET_BAR:
+		rect = *bounds;
+		rect.x1 = bounds->x0 + Scale(widget, widget->value, bounds->x1 - bounds->x0 + 1) - 1;
+		if (rect.x1 >= rect.x0){
+			FramebufferFill(band, &rect, widget->color);
+		}
+		break;
+
+	case WIDGET_GAUGE:
+		GaugeNeedle(widget, widget->value, &needle_x, &needle_y);
+		FramebufferDrawLine(band, (bounds->x0 + bounds->x1) / 2, bounds->y1, needle_x, needle_y, widget->color);
+		break;
+
+	case WIDGET_PLOT:
+		/* Only columns inside the band */
+		x = (band->x > bounds->x0) ? band->x : bounds->x0;
+		x_end = (band->x + band->width - 1 < bounds->x1) ? band->x + band->width - 1 : bounds->x1;
+		for (; x <= x_end; x++){
+			sample = widget->samples[x - bounds->x0];
+			if (sample == WIDGET_NO_SAMPLE){
+				continue;
+			}
+			/* Each column joins its sample with the one before */
+			previous = (x > bounds->x0) ? widget->samples[x - bounds->x0 - 1] : WIDGET_NO_SAMPLE;
+			if (previous == WIDGET_NO_SAMPLE){
+				previous = sample;
+			}
+			rect.x0 = x;
+			rect.x1 = x;
+			rect.y0 = bounds->y0 + ((previous < sample) ? previous : sample);
+			rect.y1 = bounds->y0 + ((previous > sample) ? previous : sample);
+			FramebufferFill(band, &rect, widget->color);
+		}
+		break;
+	}
+}
+
+static void WidgetInit(widget_t *widget, widget_type_t type, int16_t x, int16_t y, uint16_t width, uint16_t height, uint16_t color, uint16_t background){
+	memset(widget, 0, sizeof(widget_t));
+	widget->type = type;
+	widget->bounds.x0 = x;
+	widget->bounds.y0 = y;
+	widget->bounds.x1 = x + width - 1;
+	widget->bounds.y1 = y + height - 1;
+	widget->color = color;
+	widget->background = background;
+}
+
+/*==================[external functions definition]==========================*/
+void WidgetScreenInit(widget_screen_t *screen, uint16_t width, uint16_t height, uint16_t background, widget_output_t output, void *param){
+	screen->first = NULL;
+	screen->background = background;
+	screen->output = output;
+	screen->param = param;
+	/* Only the dirty list is used, there are no pixels */
+	FramebufferInit(&screen->area, NULL, 0, 0, width, height);
+}
+
+void WidgetLabelInit(widget_t *widget, int16_t x, int16_t y, uint16_t width, uint16_t height, const Font_t *font, uint16_t color, uint16_t background){
+	WidgetInit(widget, WIDGET_LABEL, x, y, width, height, color, background);
+	widget->font = font;
+}
+
+void WidgetBarInit(widget_t *widget, int16_t x, int16_t y, uint16_t width, uint16_t height, int32_t min, int32_t max, uint16_t color, uint16_t background){
+	WidgetInit(widget, WIDGET_BAR, x, y, width, height, color, background);
+	widget->min = min;
+	widget->max = max;
+	widget->value = min;
+}
+
+void WidgetGaugeInit(widget_t *widget, int16_t x, int16_t y, uint16_t width, uint16_t height, int32_t min, int32_t max, uint16_t color, uint16_t background){
+	WidgetInit(widget, WIDGET_GAUGE, x, y, width, height, color, background);
+	widget->min = min;
+	widget->max = max;
+	widget->value = min;
+}
+
+void WidgetPlotInit(widget_t *widget, int16_t x, int16_t y, uint16_t width, uint16_t height, uint8_t *samples, int32_t min, int32_t max, uint16_t color, uint16_t background){
+	WidgetInit(widget, WIDGET_PLOT, x, y, width, height, color, background);
+	widget->min = min;
+	widget->max = max;
+	widget->value = min;
+	widget->samples = samples;
+	memset(samples, WIDGET_NO_SAMPLE, width);
+}
+
+void WidgetAdd(widget_screen_t *screen, widget_t *widget){
+	widget_t **last = &screen->first;
+
+	while (*last != NULL){
+		last = &(*last)->next;
+	}
+	*last = widget;
+	widget->next = NULL;
+	widget->screen = screen;
+	WidgetInvalidate(widget);
+}
+
+void WidgetSetValue(widget_t *widget, int32_t value){
+	fb_rect_t rect;
+	int32_t old_pixels, new_pixels;
+	int16_t old_x, old_y, new_x, new_y;
+	uint16_t width, next;
+
+	if (widget->type == WIDGET_LABEL){
+		return;
+	}
+	if (value < widget->min){
+		value = widget->min;
+	}
+	if (value > widget->max){
+		value = widget->max;
+	}
+	switch (widget->type){
+	case WIDGET_BAR:
+		/* Only the columns between the old and the new end change */
+		old_pixels = Scale(widget, widget->value, widget->bounds.x1 - widget->bounds.x0 + 1);
+		new_pixels = Scale(widget, value, widget->bounds.x1 - widget->bounds.x0 + 1);
+		if (old_pixels != new_pixels){
+			rect = widget->bounds;
+			rect.x0 = widget->bounds.x0 + ((old_pixels < new_pixels) ? old_pixels : new_pixels);
+			rect.x1 = widget->bounds.x0 + ((old_pixels > new_pixels) ? old_pixels : new_pixels) - 1;
+			Invalidate(widget, rect);
+		}
+		break;
+
+	case WIDGET_GAUGE:
+		/* Box around both needles, they share the pivot */
+		GaugeNeedle(widget, widget->value, &old_x, &old_y);
+		GaugeNeedle(widget, value, &new_x, &new_y);
+		if (old_x != new_x || old_y != new_y){
+			rect.x0 = (widget->bounds.x0 + widget->bounds.x1) / 2;
+			rect.x1 = rect.x0;
+			rect.y0 = widget->bounds.y1;
+			rect.y1 = widget->bounds.y1;
+			rect.x0 = (old_x < rect.x0) ? old_x : rect.x0;
+			rect.x0 = (new_x < rect.x0) ? new_x : rect.x0;
+			rect.x1 = (old_x > rect.x1) ? old_x : rect.x1;
+			rect.x1 = (new_x > rect.x1) ? new_x : rect.x1;
+			rect.y0 = (old_y < new_y) ? old_y : new_y;
+			Invalidate(widget, rect);
+		}
+		break;
+
+	case WIDGET_PLOT:
+		/* New sample takes the cursor column, the next one is cleared to show where the sweep is */
+		width = widget->bounds.x1 - widget->bounds.x0 + 1;
+		next = (widget->cursor + 1 == width) ? 0 : widget->cursor + 1;
+		widget->samples[widget->cursor] = (widget->bounds.y1 - widget->bounds.y0) - Scale(widget, value, widget->bounds.y1 - widget->bounds.y0);
+		widget->samples[next] = WIDGET_NO_SAMPLE;
+		rect = widget->bounds;
+		rect.x0 = widget->bounds.x0 + widget->cursor;
+		rect.x1 = (next == 0) ? rect.x0 : rect.x0 + 1;
+		Invalidate(widget, rect);
+		if (next == 0){
+			rect.x0 = widget->bounds.x0;
+			rect.x1 = widget->bounds.x0;
+			Invalidate(widget, rect);
+		}
+		widget->cursor = next;
+		break;
+
+	default:
+		break;
+	}
+	widget->value = value;
+}
+
+void WidgetSetText(widget_t *widget, const char *text){
+	if (widget->type != WIDGET_LABEL || strncmp(widget->text, text, WIDGET_TEXT_SIZE - 1) == 0){
+		return;
+	}
+	strncpy(widget->text, text, WIDGET_TEXT_SIZE - 1);
+	widget->text[WIDGET_TEXT_SIZE - 1] = '\0';
+	WidgetInvalidate(widget);
+}
+
+void WidgetInvalidate(widget_t *widget){
+	Invalidate(widget, widget->bounds);
+}
+
+uint32_t WidgetRender(widget_screen_t *screen){
+	framebuffer_t band;
+	fb_rect_t rect, band_rect;
+	widget_t *widget;
+	uint32_t sent = 0;
+	uint16_t width, rows;
+
+	while (FramebufferTakeDirty(&screen->area, &rect)){
+		width = rect.x1 - rect.x0 + 1;
+		rows = WIDGET_BAND_PIXELS / width;
+		/* Area is drawn in RAM in bands of whole rows */
+		band_rect = rect;
+		for (band_rect.y0 = rect.y0; band_rect.y0 <= rect.y1; band_rect.y0 += rows){
+			band_rect.y1 = band_rect.y0 + rows - 1;
+			if (band_rect.y1 > rect.y1){
+				band_rect.y1 = rect.y1;
+			}
+			FramebufferInit(&band, widget_band, band_rect.x0, band_rect.y0, width, band_rect.y1 - band_rect.y0 + 1);
+			FramebufferFill(&band, &band_rect, screen->background);
+			for (widget = screen->first; widget != NULL; widget = widget->next){
+				if (Overlaps(&widget->bounds, &band_rect)){
+					DrawWidget(&band, widget);
+				}
+			}
+			screen->output(&band_rect, widget_band, screen->param);
+			sent += (uint32_t)width * (band_rect.y1 - band_rect.y0 + 1);
+		}
+	}
+	return sent;
+}
+
+/*==================[end of file]============================================*/
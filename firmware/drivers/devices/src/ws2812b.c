@@ -11,18 +11,70 @@
 
 /*==================[inclusions]=============================================*/
 #include "ws2812b.h"
+#include <stdlib.h>
+#include <string.h>
 #include "gpio_mcu.h"
+#include "rmt_mcu.h"
+#include "ws2812b_encoder.h"
+#include "gpio_fast_out_mcu.h"
+#include "esp_attr.h"
+#include "esp_cpu.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "gpio_fast_out_mcu.h"
-#include "delay_mcu.h"
 /*==================[macros and definitions]=================================*/
-#define RET_CMD (50)    // ret command 50us low
-#define BIT_0   (1)     // bit 0
-#define BIT_7   (1<<7)  // bit 0
+#define WS2812B_RMT     RMT_TX_0    /*!< RMT output used for the LEDs */
+#define FRAME_BUFFERS   2           /*!< One frame is converted while the other one is sent */
+#define FRAME_TRANSFERS 2           /*!< RMT transfers per frame: the bytes and the reset */
+#define TICKS_PER_US    (WS2812B_RESOLUTION / 1000000)
+#define CPU_CYCLES(ticks)   ((ticks) * CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ / TICKS_PER_US) /*!< CPU cycles of encoder ticks */
+#define T0H_CYCLES      CPU_CYCLES(WS2812B_T0H)                     /*!< All parallel outputs high */
+#define T1H_CYCLES      CPU_CYCLES(WS2812B_T1H)                     /*!< Outputs sending 1 high */
+#define BIT_CYCLES      CPU_CYCLES(WS2812B_T0H + WS2812B_T0L)       /*!< Bit period */
+#define RESET_US        (WS2812B_RESET / TICKS_PER_US)              /*!< Low time between frames */
+#define GROUP_WORDS     (WS2812B_LED_BYTES * 8)                     /*!< Words sent with interrupts disabled, one LED (28.8 us) */
 /*==================[internal data declaration]==============================*/
-gpio_t pin_number;
+static uint8_t *frame_bytes[FRAME_BUFFERS] = {NULL, NULL};  /*!< Bytes of the frames, green, red, blue of each LED */
+static uint16_t frame_length = 0;           /*!< Maximum number of LEDs per frame */
+static uint8_t frame_lut[256];              /*!< Brightness and gamma correction of each color byte */
+static uint32_t frames_sent = 0;            /*!< Frames started */
+static volatile uint32_t transfers_done = 0;    /*!< RMT transfers ended, counted from RMT ISR */
+static rmt_symbol_t reset_symbol = WS2812B_RESET_SYMBOL;   /*!< Sent after the bytes of each frame */
+static uint8_t *parallel_words = NULL;      /*!< Parallel frame, one word per bit */
+static uint16_t parallel_length = 0;        /*!< Maximum number of LEDs per parallel stripe */
+static uint8_t parallel_strips = 0;         /*!< Number of parallel stripes */
+static int64_t parallel_end = 0;            /*!< Time the last parallel frame ended (us) */
+static portMUX_TYPE parallel_lock = portMUX_INITIALIZER_UNLOCKED;
 /*==================[internal functions declaration]=========================*/
+/**
+ * @brief Counts the transfers sent, called from RMT ISR.
+ * 
+ * @param param Not used
+ */
+static void IRAM_ATTR FrameDone(void *param);
+
+/**
+ * @brief Gets the frame buffer not being sent, waiting if both are.
+ * 
+ * @return uint8_t* Buffer for frame_length * WS2812B_LED_BYTES bytes
+ */
+static uint8_t * FrameGet(void);
+
+/**
+ * @brief Starts sending the buffer returned by FrameGet(), followed by the reset.
+ * 
+ * @param count Number of bytes
+ */
+static void FrameSend(uint32_t count);
+
+/**
+ * @brief Sends the words of a parallel frame, timed by the CPU cycle counter.
+ * 
+ * @param words Word of each bit
+ * @param count Number of words
+ * @param mask Outputs of all the stripes
+ */
+static void IRAM_ATTR ParallelSend(const uint8_t *words, uint32_t count, uint8_t mask);
 
 /*==================[internal data definition]===============================*/
 static const uint8_t gamma_table[256] = {
@@ -44,333 +96,162 @@ static const uint8_t gamma_table[256] = {
     184, 186, 188, 191, 193, 195, 197, 199, 202, 204, 206, 209, 211, 213, 215,
     218, 220, 223, 225, 227, 230, 232, 235, 237, 240, 242, 245, 247, 250, 252,
     255};
+
 /*==================[external data definition]===============================*/
 
 /*==================[internal functions definition]==========================*/
-void IRAM_ATTR ws2812bSendHigh(gpio_t pin){
-    GPIOFastWrite(1);
-    //delay 0.8us
-    __asm__ __volatile__ ("nop");   // 1
-    __asm__ __volatile__ ("nop");   // 2
-    __asm__ __volatile__ ("nop");   // 3
-    __asm__ __volatile__ ("nop");   // 4
-    __asm__ __volatile__ ("nop");   // 5
-    __asm__ __volatile__ ("nop");   // 6
-    __asm__ __volatile__ ("nop");   // 7
-    __asm__ __volatile__ ("nop");   // 8
-    __asm__ __volatile__ ("nop");   // 9
-    __asm__ __volatile__ ("nop");   // 10
-    __asm__ __volatile__ ("nop");   // 11
-    __asm__ __volatile__ ("nop");   // 12
-    __asm__ __volatile__ ("nop");   // 13
-    __asm__ __volatile__ ("nop");   // 14
-    __asm__ __volatile__ ("nop");   // 15
-    __asm__ __volatile__ ("nop");   // 16
-    __asm__ __volatile__ ("nop");   // 17
-    __asm__ __volatile__ ("nop");   // 18
-    __asm__ __volatile__ ("nop");   // 19
-    __asm__ __volatile__ ("nop");   // 20
-    __asm__ __volatile__ ("nop");   // 21
-    __asm__ __volatile__ ("nop");   // 22
-    __asm__ __volatile__ ("nop");   // 23
-    __asm__ __volatile__ ("nop");   // 24  
-    __asm__ __volatile__ ("nop");   // 25
-    __asm__ __volatile__ ("nop");   // 26
-    __asm__ __volatile__ ("nop");   // 27
-    __asm__ __volatile__ ("nop");   // 28
-    __asm__ __volatile__ ("nop");   // 29
-    __asm__ __volatile__ ("nop");   // 30
-    __asm__ __volatile__ ("nop");   // 31
-    __asm__ __volatile__ ("nop");   // 32
-    __asm__ __volatile__ ("nop");   // 33
-    __asm__ __volatile__ ("nop");   // 34
-    __asm__ __volatile__ ("nop");   // 35
-    __asm__ __volatile__ ("nop");   // 36
-    __asm__ __volatile__ ("nop");   // 37
-    __asm__ __volatile__ ("nop");   // 38
-    __asm__ __volatile__ ("nop");   // 39
-    __asm__ __volatile__ ("nop");   // 40
-    __asm__ __volatile__ ("nop");   // 41
-    __asm__ __volatile__ ("nop");   // 42
-    __asm__ __volatile__ ("nop");   // 43
-    __asm__ __volatile__ ("nop");   // 44
-    __asm__ __volatile__ ("nop");   // 45
-    __asm__ __volatile__ ("nop");   // 46
-    __asm__ __volatile__ ("nop");   // 47
-    __asm__ __volatile__ ("nop");   // 48
-    __asm__ __volatile__ ("nop");   // 49
-    __asm__ __volatile__ ("nop");   // 50
-    __asm__ __volatile__ ("nop");   // 51
-    __asm__ __volatile__ ("nop");   // 52
-    __asm__ __volatile__ ("nop");   // 53
-    __asm__ __volatile__ ("nop");   // 54
-    __asm__ __volatile__ ("nop");   // 55
-    __asm__ __volatile__ ("nop");   // 56
-    __asm__ __volatile__ ("nop");   // 57
-    __asm__ __volatile__ ("nop");   // 58
-    __asm__ __volatile__ ("nop");   // 59
-    __asm__ __volatile__ ("nop");   // 47
-    __asm__ __volatile__ ("nop");   // 50
-    __asm__ __volatile__ ("nop");   // 51
-    __asm__ __volatile__ ("nop");   // 52
-    __asm__ __volatile__ ("nop");   // 53
-    __asm__ __volatile__ ("nop");   // 54
-    __asm__ __volatile__ ("nop");   // 55
-    __asm__ __volatile__ ("nop");   // 56
-    __asm__ __volatile__ ("nop");   // 57
-    __asm__ __volatile__ ("nop");   // 58
-    __asm__ __volatile__ ("nop");   // 59
-    __asm__ __volatile__ ("nop");   // 60
-    __asm__ __volatile__ ("nop");   // 61
-    __asm__ __volatile__ ("nop");   // 62
-    __asm__ __volatile__ ("nop");   // 63
-    __asm__ __volatile__ ("nop");   // 64
-    __asm__ __volatile__ ("nop");   // 65
-    __asm__ __volatile__ ("nop");   // 66
-    __asm__ __volatile__ ("nop");   // 67
-    __asm__ __volatile__ ("nop");   // 68
-    __asm__ __volatile__ ("nop");   // 69
-    __asm__ __volatile__ ("nop");   // 70
-    __asm__ __volatile__ ("nop");   // 71
-    __asm__ __volatile__ ("nop");   // 72
-    __asm__ __volatile__ ("nop");   // 73
-    __asm__ __volatile__ ("nop");   // 74
-    __asm__ __volatile__ ("nop");   // 75
-    __asm__ __volatile__ ("nop");   // 76
-    __asm__ __volatile__ ("nop");   // 77
-    __asm__ __volatile__ ("nop");   // 78
-    __asm__ __volatile__ ("nop");   // 79
-    __asm__ __volatile__ ("nop");   // 80
-    __asm__ __volatile__ ("nop");   // 81
-    __asm__ __volatile__ ("nop");   // 82
-    __asm__ __volatile__ ("nop");   // 83
-    __asm__ __volatile__ ("nop");   // 84
-    __asm__ __volatile__ ("nop");   // 85
-    __asm__ __volatile__ ("nop");   // 86
-    __asm__ __volatile__ ("nop");   // 87
-    __asm__ __volatile__ ("nop");   // 88
-    __asm__ __volatile__ ("nop");   // 89
-    __asm__ __volatile__ ("nop");   // 90
-    __asm__ __volatile__ ("nop");   // 91
-    
-    GPIOFastWrite(0);
-	//delay 0.45us
-    __asm__ __volatile__ ("nop");   // 1
-    __asm__ __volatile__ ("nop");   // 2
-    __asm__ __volatile__ ("nop");   // 3
-    __asm__ __volatile__ ("nop");   // 4
-    __asm__ __volatile__ ("nop");   // 5
-    __asm__ __volatile__ ("nop");   // 6
-    __asm__ __volatile__ ("nop");   // 7
-    __asm__ __volatile__ ("nop");   // 8
-    __asm__ __volatile__ ("nop");   // 9
-    __asm__ __volatile__ ("nop");   // 10
-    __asm__ __volatile__ ("nop");   // 11
-    __asm__ __volatile__ ("nop");   // 12
-    __asm__ __volatile__ ("nop");   // 13
-    __asm__ __volatile__ ("nop");   // 14
-    __asm__ __volatile__ ("nop");   // 15
-    __asm__ __volatile__ ("nop");   // 16
-    __asm__ __volatile__ ("nop");   // 17
-    __asm__ __volatile__ ("nop");   // 18
-    __asm__ __volatile__ ("nop");   // 19
-    __asm__ __volatile__ ("nop");   // 20
-    __asm__ __volatile__ ("nop");   // 21
-    __asm__ __volatile__ ("nop");   // 22
-    __asm__ __volatile__ ("nop");   // 23
-    __asm__ __volatile__ ("nop");   // 24  
-    __asm__ __volatile__ ("nop");   // 25
-    __asm__ __volatile__ ("nop");   // 26
-    __asm__ __volatile__ ("nop");   // 27
-    __asm__ __volatile__ ("nop");   // 28
-    __asm__ __volatile__ ("nop");   // 29
+static void IRAM_ATTR FrameDone(void *param){
+    transfers_done++;
 }
 
-void IRAM_ATTR ws2812bSendLow(gpio_t pin){
-    GPIOFastWrite(1);
-    //delay 0.4us
-    __asm__ __volatile__ ("nop");   // 1
-    __asm__ __volatile__ ("nop");   // 2
-    __asm__ __volatile__ ("nop");   // 3
-    __asm__ __volatile__ ("nop");   // 4
-    __asm__ __volatile__ ("nop");   // 5
-    __asm__ __volatile__ ("nop");   // 6
-    __asm__ __volatile__ ("nop");   // 7
-    __asm__ __volatile__ ("nop");   // 8
-    __asm__ __volatile__ ("nop");   // 9
-    __asm__ __volatile__ ("nop");   // 10
-    __asm__ __volatile__ ("nop");   // 11
-    __asm__ __volatile__ ("nop");   // 12
-    __asm__ __volatile__ ("nop");   // 13
-    __asm__ __volatile__ ("nop");   // 14
-    __asm__ __volatile__ ("nop");   // 15
-    __asm__ __volatile__ ("nop");   // 16
-    __asm__ __volatile__ ("nop");   // 17
-    __asm__ __volatile__ ("nop");   // 18
-    __asm__ __volatile__ ("nop");   // 19
-    __asm__ __volatile__ ("nop");   // 20
-    __asm__ __volatile__ ("nop");   // 21
-    __asm__ __volatile__ ("nop");   // 22
-    __asm__ __volatile__ ("nop");   // 23
-    __asm__ __volatile__ ("nop");   // 24  
-    __asm__ __volatile__ ("nop");   // 25
-    __asm__ __volatile__ ("nop");   // 26
-    __asm__ __volatile__ ("nop");   // 27
-
-    GPIOFastWrite(0);
-	//delay 0.85us
-    __asm__ __volatile__ ("nop");   // 1
-    __asm__ __volatile__ ("nop");   // 2
-    __asm__ __volatile__ ("nop");   // 3
-    __asm__ __volatile__ ("nop");   // 4
-    __asm__ __volatile__ ("nop");   // 5
-    __asm__ __volatile__ ("nop");   // 6
-    __asm__ __volatile__ ("nop");   // 7
-    __asm__ __volatile__ ("nop");   // 8
-    __asm__ __volatile__ ("nop");   // 9
-    __asm__ __volatile__ ("nop");   // 10
-    __asm__ __volatile__ ("nop");   // 11
-    __asm__ __volatile__ ("nop");   // 12
-    __asm__ __volatile__ ("nop");   // 13
-    __asm__ __volatile__ ("nop");   // 14
-    __asm__ __volatile__ ("nop");   // 15
-    __asm__ __volatile__ ("nop");   // 16
-    __asm__ __volatile__ ("nop");   // 17
-    __asm__ __volatile__ ("nop");   // 18
-    __asm__ __volatile__ ("nop");   // 19
-    __asm__ __volatile__ ("nop");   // 20
-    __asm__ __volatile__ ("nop");   // 21
-    __asm__ __volatile__ ("nop");   // 22
-    __asm__ __volatile__ ("nop");   // 23
-    __asm__ __volatile__ ("nop");   // 24  
-    __asm__ __volatile__ ("nop");   // 25
-    __asm__ __volatile__ ("nop");   // 26
-    __asm__ __volatile__ ("nop");   // 27
-    __asm__ __volatile__ ("nop");   // 28
-    __asm__ __volatile__ ("nop");   // 29
-    __asm__ __volatile__ ("nop");   // 30
-    __asm__ __volatile__ ("nop");   // 31
-    __asm__ __volatile__ ("nop");   // 32
-    __asm__ __volatile__ ("nop");   // 33
-    __asm__ __volatile__ ("nop");   // 34
-    __asm__ __volatile__ ("nop");   // 35
-    __asm__ __volatile__ ("nop");   // 36
-    __asm__ __volatile__ ("nop");   // 37
-    __asm__ __volatile__ ("nop");   // 38
-    __asm__ __volatile__ ("nop");   // 39
-    __asm__ __volatile__ ("nop");   // 40
-    __asm__ __volatile__ ("nop");   // 41
-    __asm__ __volatile__ ("nop");   // 42
-    __asm__ __volatile__ ("nop");   // 43
-    __asm__ __volatile__ ("nop");   // 44
-    __asm__ __volatile__ ("nop");   // 45
-    __asm__ __volatile__ ("nop");   // 46
-    __asm__ __volatile__ ("nop");   // 47
-    __asm__ __volatile__ ("nop");   // 48
-    __asm__ __volatile__ ("nop");   // 49
-    __asm__ __volatile__ ("nop");   // 50
-    __asm__ __volatile__ ("nop");   // 51
-    __asm__ __volatile__ ("nop");   // 52
-    __asm__ __volatile__ ("nop");   // 53
-    __asm__ __volatile__ ("nop");   // 54
-    __asm__ __volatile__ ("nop");   // 55
-    __asm__ __volatile__ ("nop");   // 56
-    __asm__ __volatile__ ("nop");   // 57
-    __asm__ __volatile__ ("nop");   // 58
-    __asm__ __volatile__ ("nop");   // 59
-    __asm__ __volatile__ ("nop");   // 47
-    __asm__ __volatile__ ("nop");   // 50
-    __asm__ __volatile__ ("nop");   // 51
-    __asm__ __volatile__ ("nop");   // 52
-    __asm__ __volatile__ ("nop");   // 53
-    __asm__ __volatile__ ("nop");   // 54
-    __asm__ __volatile__ ("nop");   // 55
-    __asm__ __volatile__ ("nop");   // 56
-    __asm__ __volatile__ ("nop");   // 57
-    __asm__ __volatile__ ("nop");   // 58
-    __asm__ __volatile__ ("nop");   // 59
-    __asm__ __volatile__ ("nop");   // 60
-    __asm__ __volatile__ ("nop");   // 61
-    __asm__ __volatile__ ("nop");   // 62
-    __asm__ __volatile__ ("nop");   // 63
-    __asm__ __volatile__ ("nop");   // 64
-    __asm__ __volatile__ ("nop");   // 65
-    __asm__ __volatile__ ("nop");   // 66
-    __asm__ __volatile__ ("nop");   // 67
-    __asm__ __volatile__ ("nop");   // 68
-    __asm__ __volatile__ ("nop");   // 69
-    __asm__ __volatile__ ("nop");   // 70
-    __asm__ __volatile__ ("nop");   // 71
-    __asm__ __volatile__ ("nop");   // 72
-    __asm__ __volatile__ ("nop");   // 73
-    __asm__ __volatile__ ("nop");   // 74
-    __asm__ __volatile__ ("nop");   // 75
-    __asm__ __volatile__ ("nop");   // 76
-    __asm__ __volatile__ ("nop");   // 77
-    __asm__ __volatile__ ("nop");   // 78
-    __asm__ __volatile__ ("nop");   // 79
-    __asm__ __volatile__ ("nop");   // 80
-    __asm__ __volatile__ ("nop");   // 81
-    __asm__ __volatile__ ("nop");   // 82
-    __asm__ __volatile__ ("nop");   // 83
-    __asm__ __volatile__ ("nop");   // 84
-    __asm__ __volatile__ ("nop");   // 85
-    __asm__ __volatile__ ("nop");   // 86
-    __asm__ __volatile__ ("nop");   // 87
-    __asm__ __volatile__ ("nop");   // 88
-    __asm__ __volatile__ ("nop");   // 89
-    __asm__ __volatile__ ("nop");   // 90
-    __asm__ __volatile__ ("nop");   // 91
-    __asm__ __volatile__ ("nop");   // 92
-    __asm__ __volatile__ ("nop");   // 93
-    __asm__ __volatile__ ("nop");   // 94
+static uint8_t * FrameGet(void){
+    /* The other buffer may still be sent, this one only if two frames are in flight */
+    if (frames_sent * FRAME_TRANSFERS - transfers_done >= FRAME_BUFFERS * FRAME_TRANSFERS){
+        RMTWait(WS2812B_RMT);
+    }
+    return frame_bytes[frames_sent % FRAME_BUFFERS];
 }
 
-uint8_t ws2812bGammaCorrection(uint8_t component){
-    return gamma_table[component];
+static void FrameSend(uint32_t count){
+    /* The bytes encoder expands each bit to its symbol while the frame is sent */
+    RMTWriteBytes(WS2812B_RMT, frame_bytes[frames_sent % FRAME_BUFFERS], count);
+    RMTWrite(WS2812B_RMT, &reset_symbol, 1);
+    frames_sent++;
 }
 
-/*==================[external functions definition]==========================*/
+static void IRAM_ATTR ParallelSend(const uint8_t *words, uint32_t count, uint8_t mask){
+    uint32_t bit_start = esp_cpu_get_cycle_count();
+    uint32_t i;
 
-void ws2812bInit(gpio_t pin){
-    pin_number = pin;
-    GPIOFastInit(&pin, 1);
+    for (i = 0; i < count; i++){
+        /* Every bit starts high, stripes sending 0 go low first */
+        GPIOFastWrite(mask);
+        while (esp_cpu_get_cycle_count() - bit_start < T0H_CYCLES);
+        GPIOFastWrite(words[i]);
+        while (esp_cpu_get_cycle_count() - bit_start < T1H_CYCLES);
+        GPIOFastWrite(0);
+        while (esp_cpu_get_cycle_count() - bit_start < BIT_CYCLES);
+        bit_start += BIT_CYCLES;
+    }
 }
 
-void ws2812bSend(rgb_led_t led_color){
+/*==================[external functions definition]==========================*/
+void ws2812bInit(gpio_t pin, uint16_t len){
+    rmt_mcu_config_t rmt = {
+        .out = WS2812B_RMT,
+        .pin = pin,
+        .resolution = WS2812B_RESOLUTION,
+        .func_p = FrameDone,
+        .param_p = NULL,
+        .bit0 = WS2812B_BIT_0_SYMBOL,
+        .bit1 = WS2812B_BIT_1_SYMBOL
+    };
     uint8_t i;
-	// Blue
-	for(i=0; i<=7; i++){
-        if(ws2812bGammaCorrection(led_color.green) & (BIT_7>>i)){
-            ws2812bSendHigh(pin_number);
-        }
-        else{
-            ws2812bSendLow(pin_number);
+
+    RMTInit(&rmt);
+    frames_sent = 0;
+    transfers_done = 0;
+    frame_length = len;
+    for (i = 0; i < FRAME_BUFFERS; i++){
+        free(frame_bytes[i]);
+        frame_bytes[i] = malloc(len * WS2812B_LED_BYTES);
+        if (frame_bytes[i] == NULL){
+            frame_length = 0;
         }
     }
-	// Red
-    for(i=0; i<=7; i++){
-        if(ws2812bGammaCorrection(led_color.red) & (BIT_7>>i)){
-            ws2812bSendHigh(pin_number);
-        }
-        else{
-            ws2812bSendLow(pin_number);
-        }
+    ws2812bBuildLut(gamma_table, WS2812B_MAX_BRIGHT, frame_lut);
+}
+
+void ws2812bParallelInit(gpio_t *pins, uint8_t strips, uint16_t len){
+    if (strips > WS2812B_PARALLEL_STRIPS){
+        strips = WS2812B_PARALLEL_STRIPS;
     }
-	// Green
-    for(i=0; i<=7; i++){
-        if(ws2812bGammaCorrection(led_color.blue) & (BIT_7>>i)){
-            ws2812bSendHigh(pin_number);
-        }
-        else{
-            ws2812bSendLow(pin_number);
-        }
+    if (len > WS2812B_PARALLEL_MAX_LEDS){
+        len = WS2812B_PARALLEL_MAX_LEDS;
     }
+    GPIOFastInit(pins, strips);
+    GPIOFastWrite(0);
+    parallel_strips = strips;
+    parallel_length = len;
+    parallel_end = esp_timer_get_time();
+    free(parallel_words);
+    parallel_words = malloc(WS2812B_PARALLEL_WORDS(len));
+    if (parallel_words == NULL){
+        parallel_length = 0;
+    }
+    ws2812bBuildLut(gamma_table, WS2812B_MAX_BRIGHT, frame_lut);
 }
 
-void ws2812bSendRet(void){
-    GPIOFastWrite(0);
-    DelayUs(RET_CMD);
+void ws2812bSetBrightness(uint8_t bright){
+    /* Frames already converted keep the old brightness */
+    ws2812bBuildLut(gamma_table, bright, frame_lut);
+}
+
+void ws2812bSendArray(const rgb_led_t *leds, uint16_t len){
+    if (len > frame_length){
+        len = frame_length;
+    }
+    /* rgb_led_t has the bytes in the order they are sent */
+    FrameSend(ws2812bPackBytes((const uint8_t *)leds, len * WS2812B_LED_BYTES, frame_lut, FrameGet()));
+}
+
+void ws2812bSendColors(const uint32_t *colors, uint16_t len){
+    if (len > frame_length){
+        len = frame_length;
+    }
+    FrameSend(ws2812bPackColors(colors, len, frame_lut, FrameGet()));
+}
+
+void ws2812bSendColor(uint32_t color, uint16_t len){
+    uint8_t *frame;
+    uint16_t i;
+
+    if (len > frame_length){
+        len = frame_length;
+    }
+    if (len == 0){
+        return;
+    }
+    frame = FrameGet();
+    /* First LED is converted, the rest are copies of it */
+    ws2812bPackColors(&color, 1, frame_lut, frame);
+    for (i = 1; i < len; i++){
+        memcpy(&frame[i * WS2812B_LED_BYTES], frame, WS2812B_LED_BYTES);
+    }
+    FrameSend(len * WS2812B_LED_BYTES);
+}
+
+void ws2812bParallelSendColors(const uint32_t *const *colors, uint16_t len){
+    uint32_t count, i;
+
+    if (len > parallel_length){
+        len = parallel_length;
+    }
+    if (len == 0){
+        return;
+    }
+    count = ws2812bEncodeParallel(colors, parallel_strips, len, frame_lut, parallel_words);
+    /* The LEDs latch the previous frame after the reset time */
+    while (esp_timer_get_time() - parallel_end < RESET_US);
+    /* Interrupts are disabled one LED at a time: the outputs stay low while the
+    pending ones run, far less than the reset time unless an ISR takes that long.
+    Tasks they wake don't run until the frame ends, the scheduler is suspended */
+    vTaskSuspendAll();
+    for (i = 0; i < count; i += GROUP_WORDS){
+        portENTER_CRITICAL(&parallel_lock);
+        ParallelSend(&parallel_words[i], (count - i < GROUP_WORDS) ? count - i : GROUP_WORDS, (1 << parallel_strips) - 1);
+        portEXIT_CRITICAL(&parallel_lock);
+    }
+    xTaskResumeAll();
+    parallel_end = esp_timer_get_time();
+}
+
+bool ws2812bBusy(void){
+    return frames_sent * FRAME_TRANSFERS != transfers_done;
+}
+
+void ws2812bWait(void){
+    RMTWait(WS2812B_RMT);
 }
 
 /*==================[end of file]============================================*/
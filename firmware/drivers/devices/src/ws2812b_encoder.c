@@ -0,0 +1,123 @@
+/**
+ * @file ws2812b_encoder.c
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief 
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+/*==================[inclusions]=============================================*/
+#include "ws2812b_encoder.h"
+#include <stddef.h>
+/*==================[macros and definitions]=================================*/
+#define RED_OFFSET		16													/*!< Red byte of a 24 bits color */
+#define GREEN_OFFSET	8													/*!< Green byte of a 24 bits color */
+#define BLUE_OFFSET		0													/*!< Blue byte of a 24 bits color */
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+/**
+ * @brief Converts the byte at offset of the color of LED led of each stripe and transposes them
+ * 
+ * @param colors Colors of each stripe
+ * @param strips Number of stripes
+ * @param led LED
+ * @param offset Offset of the byte in the color
+ * @param lut Brightness and gamma correction
+ * @param words Memory for 8 words
+ */
+static inline void EncodeParallelByte(const uint32_t *const *colors, uint8_t strips, uint32_t led, uint8_t offset, const uint8_t *lut, uint8_t *words);
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static inline void EncodeParallelByte(const uint32_t *const *colors, uint8_t strips, uint32_t led, uint8_t offset, const uint8_t *lut, uint8_t *words){
+	uint8_t bytes[WS2812B_PARALLEL_STRIPS] = {0};
+	uint8_t s;
+
+	for (s = 0; s < strips; s++){
+		if (colors[s] != NULL){
+			bytes[s] = lut[(uint8_t)(colors[s][led] >> offset)];
+		}
+	}
+	ws2812bTranspose(bytes, words);
+}
+
+/*==================[external functions definition]==========================*/
+uint32_t ws2812bPackBytes(const uint8_t *bytes, uint32_t count, const uint8_t *lut, uint8_t *frame){
+	uint32_t i;
+
+	for (i = 0; i < count; i++){
+		frame[i] = lut[bytes[i]];
+	}
+	return count;
+}
+
+uint32_t ws2812bPackColors(const uint32_t *colors, uint32_t leds, const uint8_t *lut, uint8_t *frame){
+	uint8_t *byte = frame;
+	uint32_t i, color;
+
+	for (i = 0; i < leds; i++){
+		color = colors[i];
+		/* LEDs take green first */
+		*byte++ = lut[(uint8_t)(color >> GREEN_OFFSET)];
+		*byte++ = lut[(uint8_t)(color >> RED_OFFSET)];
+		*byte++ = lut[(uint8_t)(color >> BLUE_OFFSET)];
+	}
+	return byte - frame;
+}
+
+void ws2812bTranspose(const uint8_t *bytes, uint8_t *words){
+	uint64_t x = 0, t;
+	uint8_t i;
+
+	/* 8x8 bit matrix, row s is the byte of stripe s */
+	for (i = 0; i < 8; i++){
+		x |= (uint64_t)bytes[i] << (8 * i);
+	}
+	/* Swaps 2x2, 4x4 and 8x8 blocks around the diagonal (Hacker's Delight, 7-3) */
+	t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+	x = x ^ t ^ (t << 7);
+	t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+	x = x ^ t ^ (t << 14);
+	t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+	x = x ^ t ^ (t << 28);
+	/* Row b is now bit b of every stripe, sent from the most significant bit */
+	for (i = 0; i < 8; i++){
+		words[i] = (uint8_t)(x >> (8 * (7 - i)));
+	}
+}
+
+uint32_t ws2812bEncodeParallel(const uint32_t *const *colors, uint8_t strips, uint32_t leds, const uint8_t *lut, uint8_t *words){
+	uint8_t *word = words;
+	uint32_t i;
+
+	if (strips > WS2812B_PARALLEL_STRIPS){
+		strips = WS2812B_PARALLEL_STRIPS;
+	}
+	for (i = 0; i < leds; i++){
+		/* LEDs take green first */
+		EncodeParallelByte(colors, strips, i, GREEN_OFFSET, lut, word);
+		EncodeParallelByte(colors, strips, i, RED_OFFSET, lut, word + 8);
+		EncodeParallelByte(colors, strips, i, BLUE_OFFSET, lut, word + 16);
+		word += WS2812B_LED_BYTES * 8;
+	}
+	return word - words;
+}
+
+void ws2812bBuildLut(const uint8_t *gamma, uint8_t bright, uint8_t *lut){
+	uint16_t i;
+	uint8_t value;
+
+	for (i = 0; i < 256; i++){
+		value = (i * bright + WS2812B_MAX_BRIGHT / 2) / WS2812B_MAX_BRIGHT;
+		lut[i] = (gamma != NULL) ? gamma[value] : value;
+	}
+}
+
+/*==================[end of file]============================================*/
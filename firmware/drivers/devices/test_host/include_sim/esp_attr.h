@@ -0,0 +1,17 @@
+/**
+ * @file esp_attr.h
+ * @brief Host build of the ESP-IDF memory placement attributes, they have no effect
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef ESP_ATTR_H
+#define ESP_ATTR_H
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define DMA_ATTR
+
+#endif /* #ifndef ESP_ATTR_H */
@@ -0,0 +1,23 @@
+/**
+ * @file esp_heap_caps.h
+ * @brief Host build of the ESP-IDF heap with capabilities, served by malloc
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef ESP_HEAP_CAPS_H
+#define ESP_HEAP_CAPS_H
+
+#include <stdlib.h>
+
+#define MALLOC_CAP_8BIT			(1 << 2)
+#define MALLOC_CAP_DMA			(1 << 3)
+#define MALLOC_CAP_SPIRAM		(1 << 10)
+#define MALLOC_CAP_INTERNAL		(1 << 11)
+
+#define heap_caps_malloc(size, caps)	malloc(size)
+#define heap_caps_free(ptr)				free(ptr)
+
+#endif /* #ifndef ESP_HEAP_CAPS_H */
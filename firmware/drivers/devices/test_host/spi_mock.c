@@ -0,0 +1,196 @@
+/**
+ * @file spi_mock.c
+ * @brief Host mock of the SPI, GPIO and delay drivers used by the ILI9341 driver
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <string.h>
+#include "spi_mock.h"
+#include "delay_mcu.h"
+/*==================[macros and definitions]=================================*/
+#define SPI_DEVICES		3
+#define GPIO_COUNT		(GPIO_23 + 1)
+#define COLUMN_ADDR_SET	0x2A
+#define PAGE_ADDR_SET	0x2B
+#define MEM_WRITE		0x2C
+/*==================[internal data definition]===============================*/
+static void (*pre_func[SPI_DEVICES])(void*);	/*!< Pre transaction callback of each device */
+static void (*post_func[SPI_DEVICES])(void*);	/*!< Post transaction callback of each device */
+static bool gpio_level[GPIO_COUNT];				/*!< Level of the output pins */
+static gpio_t lcd_dc;							/*!< D/C pin of the LCD */
+static spi_mock_count_t count;					/*!< Counts since the last reset */
+static uint16_t lcd_memory[SPI_MOCK_SIZE][SPI_MOCK_SIZE];	/*!< Emulated LCD memory, [row][column] */
+static uint8_t lcd_cmd;							/*!< Last command received */
+static uint8_t lcd_params[4];					/*!< Address window parameters */
+static uint8_t lcd_param_count;					/*!< Parameters received since the command */
+static uint16_t lcd_x0, lcd_x1, lcd_y0, lcd_y1;	/*!< Address window */
+static uint16_t lcd_x, lcd_y;					/*!< Next pixel written */
+static bool lcd_half;							/*!< First byte of a pixel received */
+static uint8_t lcd_high;						/*!< First byte of the pixel */
+
+/*==================[internal functions definition]==========================*/
+/*
+ * Decodes the bytes of a transaction as the ILI9341 does, using the D/C level
+ * set by the pre transaction callback.
+ */
+static void LcdReceive(const uint8_t *data, uint32_t bytes){
+	uint32_t i;
+
+	if (!gpio_level[lcd_dc]){
+		for (i = 0; i < bytes; i++){
+			lcd_cmd = data[i];
+			lcd_param_count = 0;
+			count.commands[lcd_cmd]++;
+		}
+		if (lcd_cmd == MEM_WRITE){
+			lcd_x = lcd_x0;
+			lcd_y = lcd_y0;
+			lcd_half = false;
+		}
+		return;
+	}
+	count.data_bytes += bytes;
+	for (i = 0; i < bytes; i++){
+		switch (lcd_cmd){
+		case COLUMN_ADDR_SET:
+		case PAGE_ADDR_SET:
+			if (lcd_param_count < sizeof(lcd_params)){
+				lcd_params[lcd_param_count++] = data[i];
+			}
+			if (lcd_param_count == sizeof(lcd_params)){
+				if (lcd_cmd == COLUMN_ADDR_SET){
+					lcd_x0 = lcd_params[0] << 8 | lcd_params[1];
+					lcd_x1 = lcd_params[2] << 8 | lcd_params[3];
+				}
+				else{
+					lcd_y0 = lcd_params[0] << 8 | lcd_params[1];
+					lcd_y1 = lcd_params[2] << 8 | lcd_params[3];
+				}
+			}
+			break;
+		case MEM_WRITE:
+			if (!lcd_half){
+				lcd_high = data[i];
+				lcd_half = true;
+				break;
+			}
+			lcd_half = false;
+			if (lcd_x < SPI_MOCK_SIZE && lcd_y < SPI_MOCK_SIZE){
+				lcd_memory[lcd_y][lcd_x] = lcd_high << 8 | data[i];
+			}
+			count.pixels++;
+			/* Pixels fill the window row by row */
+			if (++lcd_x > lcd_x1){
+				lcd_x = lcd_x0;
+				if (++lcd_y > lcd_y1){
+					lcd_y = lcd_y0;
+				}
+			}
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+/*
+ * Sends a write transaction at once: D/C is set by the pre transaction callback.
+ */
+static void Transaction(spi_dev_t device, const uint8_t *data, uint32_t bytes, void *user){
+	if (pre_func[device] != NULL){
+		pre_func[device](user);
+	}
+	count.transactions++;
+	count.bytes += bytes;
+	LcdReceive(data, bytes);
+	if (post_func[device] != NULL){
+		post_func[device](user);
+	}
+}
+
+/*==================[external functions definition]==========================*/
+void SpiMockInit(gpio_t dc){
+	lcd_dc = dc;
+	memset(lcd_memory, 0, sizeof(lcd_memory));
+	SpiMockReset();
+}
+
+void SpiMockReset(void){
+	memset(&count, 0, sizeof(count));
+}
+
+const spi_mock_count_t *SpiMockCount(void){
+	return &count;
+}
+
+uint16_t SpiMockPixel(uint16_t x, uint16_t y){
+	return lcd_memory[y][x];
+}
+
+uint8_t SpiInit(spi_mcu_config_t* spi){
+	pre_func[spi->device] = spi->pre_func_p;
+	post_func[spi->device] = spi->post_func_p;
+	count.inits++;
+	return true;
+}
+
+void SpiRead(spi_dev_t device, uint8_t * rx_buffer, uint32_t rx_buffer_size){
+	memset(rx_buffer, 0, rx_buffer_size);
+}
+
+void SpiWrite(spi_dev_t device, uint8_t * tx_buffer, uint32_t tx_buffer_size){
+	Transaction(device, tx_buffer, tx_buffer_size, NULL);
+}
+
+void SpiReadWrite(spi_dev_t device, uint8_t * tx_buffer, uint8_t * rx_buffer, uint32_t buffer_size){
+	Transaction(device, tx_buffer, buffer_size, NULL);
+	memset(rx_buffer, 0, buffer_size);
+}
+
+uint32_t SpiQueueWrite(spi_dev_t device, const uint8_t * tx_buffer, uint32_t tx_buffer_size, void * user){
+	Transaction(device, tx_buffer, tx_buffer_size, user);
+	return count.transactions;
+}
+
+void SpiWaitTransaction(spi_dev_t device, uint32_t transaction){
+	count.waits++;
+}
+
+void SpiWaitQueue(spi_dev_t device){
+	count.waits++;
+}
+
+uint8_t SpiDeInit(spi_dev_t device){
+	pre_func[device] = NULL;
+	post_func[device] = NULL;
+	return true;
+}
+
+void GPIOInit(gpio_t pin, io_t io){
+	gpio_level[pin] = false;
+}
+
+void GPIOOn(gpio_t pin){
+	gpio_level[pin] = true;
+}
+
+void GPIOOff(gpio_t pin){
+	gpio_level[pin] = false;
+}
+
+void GPIOState(gpio_t pin, bool state){
+	gpio_level[pin] = state;
+}
+
+void DelayMs(uint16_t msec){
+}
+
+void DelayUs(uint16_t usec){
+}
+
+/*==================[end of file]============================================*/
@@ -0,0 +1,71 @@
+/**
+ * @file spi_mock.h
+ * @brief Host mock of the SPI, GPIO and delay drivers used by the ILI9341 driver
+ *
+ * Write transactions are ended as soon as they are queued: the pre and post
+ * transaction callbacks are called, so the D/C pin is driven as on the board.
+ * The mock counts the transactions and bytes, and decodes the ILI9341 commands
+ * it receives (D/C low) and their parameters and pixels (D/C high) into an
+ * emulated LCD memory, so drawings can be checked pixel by pixel.
+ *
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef SPI_MOCK_H
+#define SPI_MOCK_H
+
+/*==================[inclusions]=============================================*/
+#include <stdint.h>
+#include "spi_mcu.h"
+#include "gpio_mcu.h"
+/*==================[macros and definitions]=================================*/
+#define SPI_MOCK_SIZE	320		/*!< Width and height of the emulated LCD memory */
+
+/**
+ * @brief Counts since the last SpiMockReset()
+ */
+typedef struct {
+	uint32_t inits;				/*!< SpiInit() calls */
+	uint32_t transactions;		/*!< Write transactions, queued or polled */
+	uint32_t bytes;				/*!< Bytes written, commands included */
+	uint32_t data_bytes;		/*!< Bytes of parameters and pixels (D/C high) */
+	uint32_t waits;				/*!< SpiWaitTransaction() and SpiWaitQueue() calls */
+	uint32_t pixels;			/*!< Pixels written to the LCD memory */
+	uint32_t commands[256];		/*!< Transactions of each command */
+} spi_mock_count_t;
+
+/*==================[external functions declaration]=========================*/
+/**
+ * @brief Clears the counts and the LCD memory, and sets the D/C pin
+ *
+ * @param dc GPIO driving the D/C pin of the LCD
+ */
+void SpiMockInit(gpio_t dc);
+
+/**
+ * @brief Clears the counts, the LCD memory is kept
+ */
+void SpiMockReset(void);
+
+/**
+ * @brief Counts since the last SpiMockReset()
+ *
+ * @return Counts
+ */
+const spi_mock_count_t *SpiMockCount(void);
+
+/**
+ * @brief Pixel of the emulated LCD memory
+ *
+ * @param x Column
+ * @param y Row
+ * @return Color (RGB565)
+ */
+uint16_t SpiMockPixel(uint16_t x, uint16_t y);
+
+#endif /* #ifndef SPI_MOCK_H */
+
+/*==================[end of file]============================================*/
@@ -0,0 +1,303 @@
+/**
+ * @file test_fonts.c
+ * @brief Host test of the glyph readers: run-length encoded and 4 bits per pixel fonts against 1 bit per pixel, color blending, glyph cache
+ *
+ * Every font is encoded as tools/font_rle.py does, and every row of every glyph
+ * read from it must be the row read from the 1 bit per pixel font. The same for
+ * 4 bits per pixel glyphs with levels 0 and 15, as tools/font_4bpp.py converts BDF
+ * fonts.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdio.h>
+#include <string.h>
+#include "fonts.h"
+/*==================[macros and definitions]=================================*/
+#define FIRST_CHAR		' '
+#define LAST_CHAR		'~'
+#define CHARS			(LAST_CHAR - FIRST_CHAR + 1)
+#define RLE_CONTINUE	15			/* Run length that continues on the next nibble */
+#define MAX_WIDTH		255
+#define WHITE			0xFFFF
+#define BLACK			0x0000
+#define BLUE			0x001F
+#define RED				0xF800
+#define GREEN			0x07E0
+#define RAMP_WIDTH		17			/* Glyph with every coverage level, odd to leave a nibble unused */
+#define SWAP(c)			((uint16_t)((c) >> 8 | (c) << 8))
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failed++; } } while (0)
+/*==================[internal data definition]===============================*/
+static int failed;
+static Font_t *const fonts[] = {&font_11, &font_19, &font_22, &font_30, &font_59, &font_89};
+static uint8_t rle_data[UINT16_MAX];		/* Font encoded as FONT_RLE */
+static char_info_t rle_info[CHARS];
+static uint8_t bpp4_data[(MAX_WIDTH + 1) / 2 * MAX_WIDTH];	/* Glyph encoded as FONT_4BPP */
+static char_info_t bpp4_info[CHARS];
+
+/*==================[internal functions definition]==========================*/
+/*
+ * Pixel of a 1 bit per pixel glyph, read from the font array
+ */
+static uint8_t GlyphBit(const Font_t *font, char c, uint16_t row, uint16_t col){
+	const char_info_t *info = &font->info[c - FIRST_CHAR];
+
+	return font->data[info->offset + row * ((info->width + 7) / 8) + col / 8] >> (7 - col % 8) & 1;
+}
+
+/*
+ * Appends a run of pixels of the same color as tools/font_rle.py does
+ */
+static void PutRun(uint32_t run, uint8_t *nibbles, uint32_t *count){
+	while (run >= RLE_CONTINUE){
+		nibbles[(*count)++] = RLE_CONTINUE;
+		run -= RLE_CONTINUE;
+	}
+	nibbles[(*count)++] = run;
+}
+
+/*
+ * Font encoded as tools/font_rle.py does: runs of the glyph pixels, row by row,
+ * starting with background. Each glyph starts on a new byte. Returns the bytes used
+ */
+static uint32_t EncodeRle(const Font_t *font, Font_t *rle){
+	static uint8_t nibbles[2 * UINT16_MAX];
+	uint32_t size = 0, count, run, i;
+	uint16_t row, col;
+	uint8_t color, pixel;
+	char c;
+
+	for (c = FIRST_CHAR; c <= LAST_CHAR; c++){
+		count = 0;
+		color = 0;
+		run = 0;
+		for (row = 0; row < font->font_height; row++){
+			for (col = 0; col < font->info[c - FIRST_CHAR].width; col++){
+				pixel = GlyphBit(font, c, row, col);
+				if (pixel != color){
+					PutRun(run, nibbles, &count);
+					color = pixel;
+					run = 0;
+				}
+				run++;
+			}
+		}
+		PutRun(run, nibbles, &count);
+		if (count % 2){
+			nibbles[count++] = 0;
+		}
+		rle_info[c - FIRST_CHAR].width = font->info[c - FIRST_CHAR].width;
+		rle_info[c - FIRST_CHAR].offset = size;
+		for (i = 0; i < count; i += 2){
+			rle_data[size++] = nibbles[i] << 4 | nibbles[i + 1];
+		}
+	}
+	rle->font_height = font->font_height;
+	rle->info = rle_info;
+	rle->data = rle_data;
+	rle->encoding = FONT_RLE;
+	return size;
+}
+
+/*
+ * Glyph c of a font as FONT_4BPP, levels 0 and FONT_ALPHA_MAX. Only that glyph is
+ * stored, at offset 0: big fonts don't fit 16 bits offsets at 4 bits per pixel
+ */
+static void EncodeGlyph4bpp(const Font_t *font, char c, Font_t *bpp4){
+	uint16_t row, col, row_bytes = (font->info[c - FIRST_CHAR].width + 1) / 2;
+	uint8_t level;
+
+	memset(bpp4_data, 0, row_bytes * font->font_height);
+	for (row = 0; row < font->font_height; row++){
+		for (col = 0; col < font->info[c - FIRST_CHAR].width; col++){
+			level = GlyphBit(font, c, row, col) ? FONT_ALPHA_MAX : 0;
+			bpp4_data[row * row_bytes + col / 2] |= (col & 1) ? level : level << 4;
+		}
+	}
+	bpp4_info[c - FIRST_CHAR].width = font->info[c - FIRST_CHAR].width;
+	bpp4_info[c - FIRST_CHAR].offset = 0;
+	bpp4->font_height = font->font_height;
+	bpp4->info = bpp4_info;
+	bpp4->data = bpp4_data;
+	bpp4->encoding = FONT_4BPP;
+}
+
+/*
+ * Channel of a RGB565 color, 0 to 31 (green to 63)
+ */
+static uint8_t Channel(uint16_t color, uint8_t channel){
+	return (channel == 0) ? color >> 11 : (channel == 1) ? (color >> 5) & 0x3F : color & 0x1F;
+}
+
+/*
+ * Tells if each channel of a blended color lies between background and foreground,
+ * not nearer to the background than the one of the previous coverage level
+ */
+static bool BlendBetween(uint16_t foreground, uint16_t background, uint16_t mix, uint16_t previous){
+	uint8_t ch, fg, bg, m, p;
+
+	for (ch = 0; ch < 3; ch++){
+		fg = Channel(foreground, ch);
+		bg = Channel(background, ch);
+		m = Channel(mix, ch);
+		p = Channel(previous, ch);
+		if ((fg >= bg) ? (m < p || m > fg) : (m > p || m < fg)){
+			return false;
+		}
+	}
+	return true;
+}
+
+/*==================[external functions definition]==========================*/
+int main(void){
+	const uint16_t colors[] = {BLACK, WHITE, RED, GREEN, BLUE, 0x7BEF, 0x8410, 0x0821, 0xF7DE, 0x1234, 0xFEDC};
+	const uint16_t count = sizeof(colors) / sizeof(colors[0]);
+	uint32_t seed = 1;
+	uint16_t fg, bg, mix, previous;
+	uint8_t level;
+	Font_t bpp4;
+	glyph_reader_t reader, rle_reader, bpp4_reader;
+	uint8_t alpha[MAX_WIDTH], rle_alpha[MAX_WIDTH];
+	uint16_t row[MAX_WIDTH];
+	const uint16_t *glyph, *again;
+	uint32_t f, generation, rows, size;
+	uint16_t i, j;
+	Font_t rle;
+	char c;
+
+	/* Every row of every glyph: 1 bit per pixel as stored, RLE as 1 bit per pixel */
+	for (f = 0; f < sizeof(fonts) / sizeof(fonts[0]); f++){
+		size = EncodeRle(fonts[f], &rle);
+		rows = 0;
+		for (c = FIRST_CHAR; c <= LAST_CHAR; c++){
+			FontGlyphStart(&reader, fonts[f], c, BLUE, WHITE);
+			FontGlyphStart(&rle_reader, &rle, c, BLUE, WHITE);
+			CHECK(reader.width == fonts[f]->info[c - FIRST_CHAR].width && rle_reader.width == reader.width);
+			for (i = 0; i < fonts[f]->font_height; i++){
+				FontGlyphAlphaRow(&reader, alpha);
+				FontGlyphAlphaRow(&rle_reader, rle_alpha);
+				for (j = 0; j < reader.width; j++){
+					CHECK(alpha[j] == (GlyphBit(fonts[f], c, i, j) ? FONT_ALPHA_MAX : 0));
+				}
+				rows += memcmp(alpha, rle_alpha, reader.width) == 0;
+			}
+			/* Runs end with the glyph */
+			CHECK(rle_reader.run == 0);
+		}
+		printf("Font %u: %u bytes RLE, %u rows of %u glyphs same as 1 bit per pixel\n", fonts[f]->font_height, size, rows, CHARS);
+		CHECK(rows == (uint32_t)CHARS * fonts[f]->font_height);
+	}
+
+	/* 4 bits per pixel glyphs of levels 0 and 15 read as 1 bit per pixel, every font */
+	for (f = 0; f < sizeof(fonts) / sizeof(fonts[0]); f++){
+		rows = 0;
+		for (c = FIRST_CHAR; c <= LAST_CHAR; c++){
+			EncodeGlyph4bpp(fonts[f], c, &bpp4);
+			FontGlyphStart(&reader, fonts[f], c, BLUE, WHITE);
+			FontGlyphStart(&bpp4_reader, &bpp4, c, BLUE, WHITE);
+			for (i = 0; i < fonts[f]->font_height; i++){
+				FontGlyphAlphaRow(&reader, alpha);
+				FontGlyphAlphaRow(&bpp4_reader, rle_alpha);
+				rows += memcmp(alpha, rle_alpha, reader.width) == 0;
+			}
+			/* Every row was read */
+			CHECK(bpp4_reader.data == bpp4_data + (reader.width + 1) / 2 * fonts[f]->font_height);
+		}
+		CHECK(rows == (uint32_t)CHARS * fonts[f]->font_height);
+	}
+
+	/* Coverage 0 is the background and FONT_ALPHA_MAX the foreground, levels between
+	them move each channel from one to the other */
+	for (i = 0; i < 1000; i++){
+		/* Every pair of the list, then random pairs */
+		if (i < count * count){
+			fg = colors[i % count];
+			bg = colors[i / count];
+		}
+		else{
+			seed = seed * 1103515245 + 12345;
+			fg = seed >> 16;
+			bg = seed;
+		}
+		CHECK(FontBlend(fg, bg, 0) == bg);
+		CHECK(FontBlend(fg, bg, FONT_ALPHA_MAX) == fg);
+		previous = bg;
+		for (level = 1; level <= FONT_ALPHA_MAX; level++){
+			mix = FontBlend(fg, bg, level);
+			CHECK(BlendBetween(fg, bg, mix, previous));
+			previous = mix;
+		}
+	}
+
+	/* Every coverage level of a 4 bits per pixel glyph, expanded to blended colors */
+	memset(bpp4_data, 0, (RAMP_WIDTH + 1) / 2 * (FONT_ALPHA_MAX + 1));
+	for (i = 0; i < FONT_ALPHA_MAX + 1; i++){
+		for (j = 0; j < RAMP_WIDTH; j++){
+			level = (i + j) % (FONT_ALPHA_MAX + 1);
+			bpp4_data[i * ((RAMP_WIDTH + 1) / 2) + j / 2] |= (j & 1) ? level : level << 4;
+		}
+	}
+	bpp4_info['A' - FIRST_CHAR].width = RAMP_WIDTH;
+	bpp4_info['A' - FIRST_CHAR].offset = 0;
+	bpp4.font_height = FONT_ALPHA_MAX + 1;
+	FontGlyphStart(&bpp4_reader, &bpp4, 'A', RED, GREEN);
+	for (i = 0; i < FONT_ALPHA_MAX + 1; i++){
+		FontGlyphRow(&bpp4_reader, row);
+		for (j = 0; j < RAMP_WIDTH; j++){
+			CHECK(row[j] == SWAP(FontBlend(RED, GREEN, (i + j) % (FONT_ALPHA_MAX + 1))));
+		}
+	}
+
+	/* RLE rows expanded to the glyph colors, high byte first */
+	EncodeRle(&font_22, &rle);
+	FontGlyphStart(&rle_reader, &rle, 'g', RED, BLACK);
+	FontGlyphStart(&reader, &font_22, 'g', RED, BLACK);
+	for (i = 0; i < font_22.font_height; i++){
+		FontGlyphRow(&rle_reader, row);
+		FontGlyphAlphaRow(&reader, alpha);
+		for (j = 0; j < reader.width; j++){
+			CHECK(row[j] == SWAP(alpha[j] ? RED : BLACK));
+		}
+	}
+
+	/* Cached glyph is the expanded one, expanded only the first time */
+	generation = FontGlyphCacheGeneration();
+	glyph = FontGlyphCacheGet(&font_22, 'A', BLUE, WHITE);
+	CHECK(glyph != NULL);
+	FontGlyphStart(&reader, &font_22, 'A', BLUE, WHITE);
+	for (i = 0; i < font_22.font_height; i++){
+		FontGlyphRow(&reader, row);
+		CHECK(memcmp(row, &glyph[i * reader.width], reader.width * 2) == 0);
+	}
+	CHECK(FontGlyphCacheGet(&font_22, 'A', BLUE, WHITE) == glyph);
+	/* Other colors and fonts are other entries */
+	again = FontGlyphCacheGet(&font_22, 'A', RED, WHITE);
+	CHECK(again != NULL && again != glyph && again[0] == glyph[0]);
+	CHECK(FontGlyphCacheGet(&rle, 'A', BLUE, WHITE) != glyph);
+	CHECK(FontGlyphCacheGeneration() == generation);
+
+	/* Big glyphs are not cached */
+	CHECK(FontGlyphCacheGet(&font_89, 'W', BLUE, WHITE) == NULL);
+
+	/* Full cache starts again, glyphs are expanded again */
+	for (c = FIRST_CHAR; c <= LAST_CHAR && FontGlyphCacheGeneration() == generation; c++){
+		CHECK(FontGlyphCacheGet(&font_30, c, BLUE, WHITE) != NULL);
+	}
+	CHECK(FontGlyphCacheGeneration() == generation + 1);
+	glyph = FontGlyphCacheGet(&font_22, 'A', BLUE, WHITE);
+	FontGlyphStart(&reader, &font_22, 'A', BLUE, WHITE);
+	for (i = 0; i < font_22.font_height; i++){
+		FontGlyphRow(&reader, row);
+		CHECK(memcmp(row, &glyph[i * reader.width], reader.width * 2) == 0);
+	}
+
+	printf(failed ? "%d checks failed\n" : "All checks passed\n", failed);
+	return failed ? 1 : 0;
+}
+
+/*==================[end of file]============================================*/
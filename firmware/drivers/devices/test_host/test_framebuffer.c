@@ -0,0 +1,263 @@
+/**
+ * @file test_framebuffer.c
+ * @brief Host test of the framebuffer: drawings against golden images, dirty areas merging
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdio.h>
+#include <string.h>
+#include "framebuffer.h"
+/*==================[macros and definitions]=================================*/
+#define WIDTH		24
+#define HEIGHT		16
+#define X			100			/* Screen column of the framebuffer */
+#define Y			50			/* Screen row of the framebuffer */
+#define WHITE		0xFFFF
+#define BLACK		0x0000
+#define BLUE		0x001F
+#define RED			0xF800
+#define GREEN		0x07E0
+#define LCD_WIDTH	240
+#define LCD_HEIGHT	320
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failed++; } } while (0)
+/*==================[internal data definition]===============================*/
+static int failed;
+static uint16_t pixels[WIDTH * HEIGHT];
+static uint16_t lcd_pixels[LCD_WIDTH * LCD_HEIGHT];
+
+/**
+ * @brief Colors of the golden images, one character per pixel
+ */
+static const struct {
+	char symbol;
+	uint16_t color;
+} palette[] = {
+	{'.', WHITE},
+	{'#', BLACK},
+	{'B', BLUE},
+	{'R', RED},
+	{'G', GREEN},
+};
+
+/* Fill, pixels and lines, some of them partly outside the framebuffer */
+static const char *golden_shapes[HEIGHT] = {
+	"#.........#.............",
+	".#........#.............",
+	"..BBBB....#.............",
+	"..BBBB....#.............",
+	"..BBBB...##.............",
+	"..........#.............",
+	"..........###...........",
+	"..........#..#..........",
+	"..........#...#.........",
+	"..........#....##.......",
+	"..........#......#......",
+	"..........#.......#.....",
+	"..........#........##...",
+	"RRRRRRRRRRRRRRRRRRRRRRRR",
+	"..........#...........#.",
+	"..........#............G",
+};
+
+/* Bitmap and picture clipped by the framebuffer limits */
+static const char *golden_images[HEIGHT] = {
+	".#.#.#....BR#...........",
+	".#.#.#....###...........",
+	"#######.................",
+	"........................",
+	"........................",
+	"........................",
+	"......................RG",
+	"......................BR",
+	"......................##",
+	"........................",
+	"........................",
+	"........................",
+	"........................",
+	"................RBRBRBRB",
+	"................RBRBRBRB",
+	"................RBRBRBRB",
+};
+
+/*==================[internal functions definition]==========================*/
+/*
+ * Compares the framebuffer with a golden image, prints it if they differ
+ */
+static bool CompareGolden(const framebuffer_t *fb, const char **golden){
+	char image[HEIGHT][WIDTH + 1];
+	uint16_t color, k;
+	int16_t x, y;
+	bool equal = true;
+
+	for (y = 0; y < HEIGHT; y++){
+		for (x = 0; x < WIDTH; x++){
+			color = FramebufferGetPixel(fb, X + x, Y + y);
+			image[y][x] = '?';
+			for (k = 0; k < sizeof(palette) / sizeof(palette[0]); k++){
+				if (palette[k].color == color){
+					image[y][x] = palette[k].symbol;
+				}
+			}
+		}
+		image[y][WIDTH] = '\0';
+		equal &= strcmp(image[y], golden[y]) == 0;
+	}
+	if (!equal){
+		printf("Framebuffer differs from the golden image:\n");
+		for (y = 0; y < HEIGHT; y++){
+			printf("\t\"%s\",\n", image[y]);
+		}
+	}
+	return equal;
+}
+
+/*
+ * Takes every dirty area and checks that they cover each pixel that isn't white
+ */
+static bool DirtyCoversDrawing(framebuffer_t *fb){
+	fb_rect_t dirty[FB_MAX_DIRTY];
+	uint8_t count = 0, i;
+	int16_t x, y;
+	bool covered;
+
+	while (FramebufferTakeDirty(fb, &dirty[count])){
+		/* Areas are always inside the framebuffer */
+		if (!FramebufferContains(fb, &dirty[count])){
+			return false;
+		}
+		count++;
+	}
+	for (y = Y; y < Y + HEIGHT; y++){
+		for (x = X; x < X + WIDTH; x++){
+			if (FramebufferGetPixel(fb, x, y) == WHITE){
+				continue;
+			}
+			covered = false;
+			for (i = 0; i < count; i++){
+				covered |= x >= dirty[i].x0 && x <= dirty[i].x1 && y >= dirty[i].y0 && y <= dirty[i].y1;
+			}
+			if (!covered){
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/*
+ * Starts a white framebuffer, without dirty areas
+ */
+static void Clear(framebuffer_t *fb){
+	uint16_t i;
+
+	for (i = 0; i < WIDTH * HEIGHT; i++){
+		pixels[i] = WHITE;
+	}
+	FramebufferInit(fb, pixels, X, Y, WIDTH, HEIGHT);
+}
+
+/*==================[external functions definition]==========================*/
+int main(void){
+	framebuffer_t fb, lcd;
+	fb_rect_t rect, taken[FB_MAX_DIRTY];
+	const uint8_t bitmap[] = {
+		0xAA, 0x80,		/* 1010101010 */
+		0xAA, 0x80,
+		0xAA, 0x80,
+		0xAA, 0x80,
+		0xFF, 0xC0,		/* 1111111111 */
+	};
+	/* 3x3 picture, high byte first */
+	const uint8_t picture[] = {
+		0xF8, 0x00, 0x07, 0xE0, 0x00, 0x00,
+		0x00, 0x1F, 0xF8, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	};
+	uint8_t i;
+
+	/* Shapes */
+	Clear(&fb);
+	FramebufferFill(&fb, &(fb_rect_t){X + 2, Y + 2, X + 5, Y + 4}, BLUE);
+	FramebufferDrawPixel(&fb, X, Y, BLACK);
+	FramebufferDrawPixel(&fb, X + 1, Y + 1, BLACK);
+	FramebufferDrawLine(&fb, X + 10, Y - 10, X + 10, Y + 30, BLACK);
+	FramebufferDrawLine(&fb, X + 9, Y + 4, X + 30, Y + 20, BLACK);
+	FramebufferDrawLine(&fb, X - 5, Y + 13, X + 40, Y + 13, RED);
+	FramebufferDrawPixel(&fb, X + WIDTH - 1, Y + HEIGHT - 1, GREEN);
+	FramebufferDrawPixel(&fb, X + WIDTH, Y + HEIGHT - 1, RED);
+	CHECK(CompareGolden(&fb, golden_shapes));
+	CHECK(fb.dirty_count > 0 && DirtyCoversDrawing(&fb));
+	CHECK(fb.dirty_count == 0 && !FramebufferTakeDirty(&fb, &rect));
+
+	/* Bitmap and picture partly outside: clipped at the left, top, right and bottom */
+	Clear(&fb);
+	FramebufferDrawBitmap(&fb, X - 3, Y - 2, 10, 5, bitmap, BLACK, WHITE);
+	FramebufferDrawBitmap(&fb, X + WIDTH - 8, Y + HEIGHT - 3, 10, 5, bitmap, RED, BLUE);
+	FramebufferDrawPicture(&fb, X + 10, Y - 1, 3, 3, picture);
+	FramebufferDrawPicture(&fb, X + WIDTH - 2, Y + 6, 3, 3, picture);
+	FramebufferDrawPicture(&fb, X - 10, Y - 10, 3, 3, picture);
+	CHECK(CompareGolden(&fb, golden_images));
+	CHECK(DirtyCoversDrawing(&fb));
+
+	/* Nothing drawn outside the framebuffer, nothing dirty */
+	Clear(&fb);
+	FramebufferFill(&fb, &(fb_rect_t){0, 0, X - 1, Y - 1}, BLACK);
+	FramebufferDrawLine(&fb, 0, 0, X - 1, Y + HEIGHT, BLACK);
+	FramebufferDrawPixel(&fb, X - 1, Y, BLACK);
+	CHECK(fb.dirty_count == 0);
+
+	/* Merge: the union costs up to FB_MERGE_PIXELS more than the two areas */
+	FramebufferInit(&lcd, lcd_pixels, 0, 0, LCD_WIDTH, LCD_HEIGHT);
+	FramebufferInvalidate(&lcd, &(fb_rect_t){0, 0, 9, 0});
+	FramebufferInvalidate(&lcd, &(fb_rect_t){0, 1, 9, 1});
+	CHECK(lcd.dirty_count == 1);
+	CHECK(lcd.dirty[0].x0 == 0 && lcd.dirty[0].y0 == 0 && lcd.dirty[0].x1 == 9 && lcd.dirty[0].y1 == 1);
+	FramebufferInit(&lcd, lcd_pixels, 0, 0, LCD_WIDTH, LCD_HEIGHT);
+	FramebufferInvalidate(&lcd, &(fb_rect_t){0, 0, 0, 0});
+	FramebufferInvalidate(&lcd, &(fb_rect_t){FB_MERGE_PIXELS + 1, 0, FB_MERGE_PIXELS + 1, 0});
+	CHECK(lcd.dirty_count == 1 && lcd.dirty[0].x1 == FB_MERGE_PIXELS + 1);
+	FramebufferInit(&lcd, lcd_pixels, 0, 0, LCD_WIDTH, LCD_HEIGHT);
+	FramebufferInvalidate(&lcd, &(fb_rect_t){0, 0, 0, 0});
+	FramebufferInvalidate(&lcd, &(fb_rect_t){FB_MERGE_PIXELS + 2, 0, FB_MERGE_PIXELS + 2, 0});
+	CHECK(lcd.dirty_count == 2);
+
+	/* An area reaching several others merges all of them */
+	FramebufferInit(&lcd, lcd_pixels, 0, 0, LCD_WIDTH, LCD_HEIGHT);
+	FramebufferInvalidate(&lcd, &(fb_rect_t){0, 0, 0, 0});
+	FramebufferInvalidate(&lcd, &(fb_rect_t){200, 0, 200, 0});
+	FramebufferInvalidate(&lcd, &(fb_rect_t){0, 200, 0, 200});
+	FramebufferInvalidate(&lcd, &(fb_rect_t){200, 200, 200, 200});
+	CHECK(lcd.dirty_count == 4);
+	FramebufferInvalidate(&lcd, &(fb_rect_t){0, 0, 200, 200});
+	CHECK(lcd.dirty_count == 1);
+
+	/* List full: the new area merges with the one that grows less */
+	FramebufferInit(&lcd, lcd_pixels, 0, 0, LCD_WIDTH, LCD_HEIGHT);
+	for (i = 0; i < FB_MAX_DIRTY; i++){
+		FramebufferInvalidate(&lcd, &(fb_rect_t){i * 25, i * 35, i * 25, i * 35});
+	}
+	CHECK(lcd.dirty_count == FB_MAX_DIRTY);
+	FramebufferInvalidate(&lcd, &(fb_rect_t){200, 280, 200, 280});
+	CHECK(lcd.dirty_count == FB_MAX_DIRTY);
+
+	/* Take: every area once, the merged one holds the last two points */
+	for (i = 0; i < FB_MAX_DIRTY; i++){
+		CHECK(FramebufferTakeDirty(&lcd, &taken[i]));
+	}
+	CHECK(!FramebufferTakeDirty(&lcd, &rect) && lcd.dirty_count == 0);
+	for (i = 0; i < FB_MAX_DIRTY - 1; i++){
+		CHECK(taken[FB_MAX_DIRTY - 1 - i].x0 == i * 25 && taken[FB_MAX_DIRTY - 1 - i].y0 == i * 35);
+	}
+	CHECK(taken[0].x0 == 175 && taken[0].y0 == 245 && taken[0].x1 == 200 && taken[0].y1 == 280);
+
+	printf(failed ? "%d checks failed\n" : "All checks passed\n", failed);
+	return failed ? 1 : 0;
+}
+
+/*==================[end of file]============================================*/
@@ -0,0 +1,126 @@
+/**
+ * @file test_hc_sr04.c
+ * @brief Host test of the HC-SR04 echo measurement, from edge times and from pin polling
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdio.h>
+#include "hc_sr04_echo.h"
+/*==================[macros and definitions]=================================*/
+#define TRIGGER		1000000ULL	/* Time of the trigger (us), far from 0 */
+#define ECHO_DELAY	450			/* Time from trigger to echo (us) */
+#define POLL_US		10			/* Reading period of the polling driver */
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failed++; } } while (0)
+/*==================[internal data definition]===============================*/
+static int failed;
+
+/*==================[internal functions definition]==========================*/
+/* Edge capture of an echo of width us, -1 if none: edges and the deadline like the driver */
+static void Capture(hc_sr04_echo_t *echo, int32_t width){
+	uint64_t rise = TRIGGER + ECHO_DELAY;
+
+	HcSr04EchoStart(echo, TRIGGER);
+	if (width >= 0 && rise < HcSr04EchoDeadline(echo)){
+		HcSr04EchoEdge(echo, true, rise);
+		if (rise + width < HcSr04EchoDeadline(echo)){
+			CHECK(HcSr04EchoEdge(echo, false, rise + width));
+			return;
+		}
+	}
+	CHECK(HcSr04EchoTimeout(echo, HcSr04EchoDeadline(echo)));
+}
+
+/* Echo read every POLL_US, like HcSr04ReadDistanceInCentimeters() without edge capture */
+static void Poll(hc_sr04_echo_t *echo, int32_t width){
+	uint64_t time = 0;
+	bool level;
+
+	HcSr04EchoStart(echo, time);
+	while (HcSr04EchoBusy(echo)){
+		time += POLL_US;
+		level = width >= 0 && time >= ECHO_DELAY && time < ECHO_DELAY + width;
+		if (!HcSr04EchoEdge(echo, level, time)){
+			HcSr04EchoTimeout(echo, time);
+		}
+	}
+}
+
+/*==================[external functions definition]==========================*/
+int main(void){
+	hc_sr04_echo_t echo, polled;
+	int32_t width;
+
+	/* 1 m: 5900 us echo */
+	Capture(&echo, 5900);
+	CHECK(echo.state == HC_SR04_ECHO_DONE && echo.width == 5900);
+	CHECK(HcSr04EchoCentimeters(&echo) == 100);
+	CHECK(HcSr04EchoMillimeters(&echo) == 1000);
+	CHECK(HcSr04EchoInches(&echo) == 39);
+
+	/* 1 us resolution: each us is visible in mm, not only each 10 us */
+	Capture(&echo, 5906);
+	CHECK(echo.width == 5906 && HcSr04EchoMillimeters(&echo) == 1001);
+
+	/* Glitches and repeated levels are ignored */
+	HcSr04EchoStart(&echo, TRIGGER);
+	CHECK(!HcSr04EchoEdge(&echo, false, TRIGGER + 100));
+	CHECK(!HcSr04EchoEdge(&echo, true, TRIGGER + 200));
+	CHECK(!HcSr04EchoEdge(&echo, true, TRIGGER + 300));
+	CHECK(echo.state == HC_SR04_ECHO_HIGH && echo.start == TRIGGER + 200);
+	CHECK(HcSr04EchoEdge(&echo, false, TRIGGER + 1380));
+	CHECK(!HcSr04EchoEdge(&echo, true, TRIGGER + 1400));
+	CHECK(echo.state == HC_SR04_ECHO_DONE && HcSr04EchoCentimeters(&echo) == 20);
+
+	/* No echo: sensor disconnected, timeout only once its deadline passed */
+	HcSr04EchoStart(&echo, TRIGGER);
+	CHECK(HcSr04EchoDeadline(&echo) == TRIGGER + HC_SR04_WAIT_MAX);
+	CHECK(!HcSr04EchoTimeout(&echo, TRIGGER + HC_SR04_WAIT_MAX - 1));
+	CHECK(HcSr04EchoTimeout(&echo, TRIGGER + HC_SR04_WAIT_MAX));
+	CHECK(!HcSr04EchoTimeout(&echo, TRIGGER + HC_SR04_WAIT_MAX + 1));
+	CHECK(echo.state == HC_SR04_ECHO_MISSING && !HcSr04EchoBusy(&echo));
+	CHECK(HcSr04EchoCentimeters(&echo) == 0 && HcSr04EchoInches(&echo) == 0);
+
+	/* Echo too long: deadline moves to its start, maximun distance */
+	HcSr04EchoStart(&echo, TRIGGER);
+	HcSr04EchoEdge(&echo, true, TRIGGER + 5000);
+	CHECK(HcSr04EchoDeadline(&echo) == TRIGGER + 5000 + HC_SR04_MAX_US + 1);
+	CHECK(!HcSr04EchoTimeout(&echo, TRIGGER + HC_SR04_WAIT_MAX));
+	CHECK(HcSr04EchoTimeout(&echo, HcSr04EchoDeadline(&echo)));
+	CHECK(echo.state == HC_SR04_ECHO_OUT_OF_RANGE);
+	CHECK(HcSr04EchoCentimeters(&echo) == HC_SR04_MAX_CM && HcSr04EchoInches(&echo) == HC_SR04_MAX_INCH);
+
+	/* Longest echo is in range, one more us isn't (edge handled late) */
+	Capture(&echo, HC_SR04_MAX_US);
+	CHECK(echo.state == HC_SR04_ECHO_DONE && HcSr04EchoCentimeters(&echo) == HC_SR04_MAX_US / HC_SR04_US2CM);
+	HcSr04EchoStart(&echo, TRIGGER);
+	HcSr04EchoEdge(&echo, true, TRIGGER + ECHO_DELAY);
+	CHECK(HcSr04EchoEdge(&echo, false, TRIGGER + ECHO_DELAY + HC_SR04_MAX_US + 1));
+	CHECK(echo.state == HC_SR04_ECHO_OUT_OF_RANGE);
+
+	/* Not started: nothing to wait for */
+	echo.state = HC_SR04_ECHO_IDLE;
+	CHECK(!HcSr04EchoBusy(&echo) && !HcSr04EchoEdge(&echo, true, 0) && !HcSr04EchoTimeout(&echo, ~0ULL));
+
+	/* Polling gives the same result within its period, edge capture the exact width */
+	for (width = -1; width <= HC_SR04_MAX_US + 100; width += 37){
+		Capture(&echo, width);
+		Poll(&polled, width);
+		CHECK(echo.state == polled.state);
+		if (echo.state == HC_SR04_ECHO_DONE){
+			CHECK(echo.width == (uint32_t)width);
+			CHECK(polled.width >= echo.width && polled.width - echo.width <= POLL_US);
+			CHECK(HcSr04EchoCentimeters(&echo) == width / HC_SR04_US2CM);
+		}
+	}
+
+	printf(failed ? "%d checks failed\n" : "All checks passed\n", failed);
+	return failed ? 1 : 0;
+}
+
+/*==================[end of file]============================================*/
@@ -0,0 +1,190 @@
+/**
+ * @file test_hc_sr04_schedule.c
+ * @brief Host test of the round-robin measurement of several HC-SR04 sensors, echoes longer than the limit
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdio.h>
+#include "hc_sr04_schedule.h"
+/*==================[macros and definitions]=================================*/
+#define SENSORS		4
+#define ECHO_DELAY	450						/* Time from trigger to echo (us) */
+#define GUARD		5000					/* Time between measurements (us) */
+#define RANGE_CM	200						/* Range of the scan */
+#define LIMIT		(RANGE_CM * HC_SR04_US2CM)
+#define ROUNDS		100
+#define NO_ECHO		-1						/* Sensor disconnected */
+#define FAR			(HC_SR04_MAX_US + 1000)	/* Obstacle beyond the maximun distance */
+#define STUCK		-2						/* Echo that never ends */
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failed++; } } while (0)
+/*==================[internal data definition]===============================*/
+static int failed;
+
+/*==================[internal functions definition]==========================*/
+/*
+ * Runs the schedule until the given number of measurements end, like the driver
+ * timer and echo ISRs would: an echo of widths[sensor] us starts ECHO_DELAY after
+ * the trigger and every other sensor sees the burst as an echo (crosstalk). Echoes
+ * cut at the limit still end later, before the deadline or not.
+ * Returns the time the last one ended.
+ */
+static uint64_t Run(hc_sr04_schedule_t *schedule, const int32_t *widths, uint32_t measurements,
+	uint64_t now, uint8_t *order){
+	uint64_t rise, fall, end = 0, triggered = 0, deadline;
+	uint64_t falls[SENSORS] = {0};		/* Falling edge of each echo still high, 0 if none, UINT64_MAX if stuck */
+	uint32_t ended = 0;
+	uint8_t sensor, other, first;
+	bool measuring;
+
+	while (ended < measurements){
+		deadline = HcSr04ScheduleDeadline(schedule);
+		/* Echoes that end first */
+		first = SENSORS;
+		for (other = 0; other < schedule->sensors; other++){
+			if (falls[other] != 0 && falls[other] <= deadline && (first == SENSORS || falls[other] < falls[first])){
+				first = other;
+			}
+		}
+		if (first != SENSORS){
+			now = falls[first];
+			falls[first] = 0;
+			/* The echo of the sensor measuring ends the measurement */
+			measuring = HcSr04ScheduleBusy(schedule) && first == schedule->current;
+			if (HcSr04ScheduleEdge(schedule, first, false, now) && measuring){
+				CHECK(!HcSr04ScheduleBusy(schedule));
+				order[ended++] = first;
+				end = now;
+			}
+			continue;
+		}
+		now = (deadline > now) ? deadline : now;
+		if (HcSr04ScheduleTimeout(schedule, now)){
+			order[ended++] = schedule->current ? schedule->current - 1 : schedule->sensors - 1;
+			CHECK(now >= triggered);
+			end = now;
+			continue;
+		}
+		if (!HcSr04ScheduleTrigger(schedule, now, &sensor)){
+			CHECK(0);
+			break;
+		}
+		/* Guard time respected since the end of the previous measurement, never with the echo high */
+		CHECK(ended == 0 || now >= end + schedule->guard);
+		CHECK(falls[sensor] == 0);
+		triggered = now;
+		if (widths[sensor] == NO_ECHO){
+			continue;
+		}
+		rise = now + ECHO_DELAY;
+		fall = rise + widths[sensor];
+		/* Crosstalk on the other sensors is ignored, echoes still high don't change */
+		for (other = 0; other < schedule->sensors; other++){
+			if (other != sensor && falls[other] == 0){
+				CHECK(!HcSr04ScheduleEdge(schedule, other, true, rise + 10));
+				CHECK(!HcSr04ScheduleEdge(schedule, other, false, rise + 200));
+			}
+		}
+		CHECK(HcSr04ScheduleEdge(schedule, sensor, true, rise));
+		falls[sensor] = (widths[sensor] == STUCK) ? UINT64_MAX : fall;
+	}
+	return end;
+}
+
+/*==================[external functions definition]==========================*/
+int main(void){
+	hc_sr04_schedule_t schedule;
+	hc_sr04_reading_t readings[SENSORS];
+	const int32_t widths[SENSORS] = {5900, 590, NO_ECHO, FAR};
+	const int32_t near[SENSORS] = {5900, 2950, 1180, 590};
+	const int32_t far[SENSORS] = {FAR, FAR, FAR, FAR};
+	uint8_t order[SENSORS * ROUNDS];
+	uint64_t end;
+	uint32_t i;
+	uint8_t sensor;
+
+	HcSr04ScheduleInit(&schedule, readings, SENSORS, GUARD, LIMIT);
+	CHECK(!HcSr04ScheduleBusy(&schedule) && HcSr04ScheduleDeadline(&schedule) == 0);
+	for (i = 0; i < SENSORS; i++){
+		CHECK(readings[i].timestamp == 0 && readings[i].state == HC_SR04_ECHO_IDLE);
+	}
+
+	/* One round: each sensor in turn, readings published with their end time */
+	end = Run(&schedule, widths, SENSORS, 0, order);
+	for (i = 0; i < SENSORS; i++){
+		CHECK(order[i] == i);
+	}
+	CHECK(readings[0].state == HC_SR04_ECHO_DONE && readings[0].distance == 1000);
+	CHECK(readings[1].state == HC_SR04_ECHO_DONE && readings[1].distance == 100);
+	CHECK(readings[2].state == HC_SR04_ECHO_MISSING && readings[2].distance == 0);
+	/* Out of range reported at the scan range */
+	CHECK(readings[3].state == HC_SR04_ECHO_OUT_OF_RANGE && readings[3].distance == RANGE_CM * 10);
+	CHECK(readings[3].timestamp == end);
+	CHECK(readings[0].timestamp < readings[1].timestamp && readings[1].timestamp < readings[2].timestamp);
+	/* Out of range cut at the scan range, not at the maximun distance */
+	CHECK(readings[3].timestamp - readings[2].timestamp == GUARD + ECHO_DELAY + LIMIT + 1);
+
+	/* Next trigger only once the guard time passed, never during a measurement */
+	CHECK(HcSr04ScheduleDeadline(&schedule) == end + GUARD);
+	CHECK(!HcSr04ScheduleTrigger(&schedule, end + GUARD - 1, &sensor));
+	CHECK(HcSr04ScheduleTrigger(&schedule, end + GUARD, &sensor) && sensor == 0);
+	CHECK(HcSr04ScheduleBusy(&schedule) && !HcSr04ScheduleTrigger(&schedule, end + GUARD, &sensor));
+	CHECK(HcSr04ScheduleEdge(&schedule, 0, true, end + GUARD + ECHO_DELAY));
+	CHECK(HcSr04ScheduleEdge(&schedule, 0, false, end + GUARD + ECHO_DELAY + 590));
+	CHECK(readings[0].distance == 100 && schedule.current == 1);
+
+	/* Worst case: all out of range, each one takes the echo delay, the range and the guard time */
+	HcSr04ScheduleInit(&schedule, readings, SENSORS, GUARD, LIMIT);
+	end = Run(&schedule, far, SENSORS * ROUNDS, 0, order);
+	printf("%d sensors out of range: %.1f Hz\n", SENSORS, ROUNDS * 1e6 / end);
+	CHECK(end == (uint64_t)SENSORS * ROUNDS * (ECHO_DELAY + LIMIT + 1 + GUARD) - GUARD);
+	for (i = 0; i < SENSORS * ROUNDS; i++){
+		CHECK(order[i] == i % SENSORS);
+	}
+
+	/* Obstacles up to 1 m: 4 sensors over 20 Hz */
+	HcSr04ScheduleInit(&schedule, readings, SENSORS, GUARD, LIMIT);
+	end = Run(&schedule, near, SENSORS * ROUNDS, 0, order);
+	printf("%d sensors in range: %.1f Hz\n", SENSORS, ROUNDS * 1e6 / end);
+	CHECK(end * 20 <= ROUNDS * 1000000ULL);
+	for (i = 0; i < SENSORS; i++){
+		CHECK(readings[i].state == HC_SR04_ECHO_DONE && readings[i].distance == near[i] * 10 / HC_SR04_US2CM);
+	}
+
+	/* One sensor: out of range cut at the limit, next trigger once the echo ends */
+	HcSr04ScheduleInit(&schedule, readings, 1, GUARD, LIMIT);
+	end = Run(&schedule, far, 1, 0, order);
+	CHECK(end == ECHO_DELAY + LIMIT + 1 && readings[0].distance == RANGE_CM * 10);
+	CHECK(HcSr04ScheduleDeadline(&schedule) == end + GUARD + HC_SR04_NO_ECHO_US);
+	CHECK(!HcSr04ScheduleTrigger(&schedule, end + GUARD, &sensor));
+	CHECK(HcSr04ScheduleEdge(&schedule, 0, false, ECHO_DELAY + FAR));
+	CHECK(HcSr04ScheduleDeadline(&schedule) == end + GUARD);
+	CHECK(HcSr04ScheduleTrigger(&schedule, ECHO_DELAY + FAR, &sensor) && sensor == 0);
+
+	/* Echoes longer than the guard time: each trigger waits for the end of the echo */
+	HcSr04ScheduleInit(&schedule, readings, 1, 1000, LIMIT);
+	end = Run(&schedule, far, ROUNDS, 0, order);
+	CHECK(end == ROUNDS * (uint64_t)(ECHO_DELAY + LIMIT + 1) + (ROUNDS - 1) * (uint64_t)(FAR - LIMIT - 1));
+	CHECK(readings[0].state == HC_SR04_ECHO_OUT_OF_RANGE);
+
+	/* Echo stuck high: the sensor is skipped as missing, the others go on */
+	HcSr04ScheduleInit(&schedule, readings, 2, GUARD, LIMIT);
+	end = Run(&schedule, (const int32_t[SENSORS]){STUCK, 590}, 4, 0, order);
+	CHECK(order[0] == 0 && order[1] == 1 && order[2] == 0 && order[3] == 1);
+	CHECK(readings[0].state == HC_SR04_ECHO_MISSING && readings[0].distance == 0);
+	CHECK(readings[1].state == HC_SR04_ECHO_DONE && readings[1].distance == 100);
+
+	/* Limit never above the maximun distance */
+	HcSr04ScheduleInit(&schedule, readings, 1, 0, 1000000);
+	CHECK(schedule.limit == HC_SR04_MAX_US);
+
+	printf(failed ? "%d checks failed\n" : "All checks passed\n", failed);
+	return failed ? 1 : 0;
+}
+
+/*==================[end of file]============================================*/
@@ -0,0 +1,166 @@
+/**
+ * @file test_icons.c
+ * @brief Host test of the icon sprites: runs against the icon bitmaps, sprite cache, icons drawn on the LCD and blitted with a key color
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdio.h>
+#include <string.h>
+#include "icons.h"
+#include "ili9341.h"
+#include "spi_mock.h"
+/*==================[macros and definitions]=================================*/
+#define LCD_DC		GPIO_2
+#define LCD_RST		GPIO_3
+#define ICONS		(ICON_RAIN + 1)
+#define X			30			/* Screen position of the icons */
+#define Y			50
+#define PATTERN(x, y)	((uint16_t)((x) * 31 + (y) * 2047))	/* Framebuffer content under transparent icons */
+#define SWAP(c)		((uint16_t)((c) >> 8 | (c) << 8))
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failed++; } } while (0)
+/*==================[internal data definition]===============================*/
+static int failed;
+static icon_font_t *const icon_fonts[] = {&icon_22, &icon_30, &icon_59, &icon_89};
+
+/*==================[internal functions definition]==========================*/
+/*
+ * Pixel of an icon, read from the icon array
+ */
+static uint8_t IconBit(const icon_font_t *icon_font, icon_t icon, uint16_t row, uint16_t col){
+	return icon_font->data[icon * icon_font->offset + row * ((icon_font->width + 7) / 8) + col / 8] >> (7 - col % 8) & 1;
+}
+
+/*
+ * Tells if the runs of a sprite give the icon: each row is whole, runs don't cross
+ * rows and the colors of a row alternate
+ */
+static bool SpriteIsIcon(const icon_sprite_t *sprite, uint16_t foreground, uint16_t background){
+	const icon_font_t *icon_font = sprite->icon_font;
+	const icon_run_t *run = sprite->runs;
+	uint16_t row, col, k, previous;
+
+	for (row = 0; row < icon_font->height; row++){
+		col = 0;
+		previous = 0;
+		while (col < icon_font->width){
+			if (run == sprite->runs + sprite->count || run->length == 0 ||
+				col + run->length > icon_font->width || (col > 0 && run->color == previous)){
+				return false;
+			}
+			for (k = 0; k < run->length; k++, col++){
+				if (run->color != SWAP(IconBit(icon_font, sprite->icon, row, col) ? foreground : background)){
+					return false;
+				}
+			}
+			previous = run->color;
+			run++;
+		}
+	}
+	return run == sprite->runs + sprite->count;
+}
+
+/*
+ * Tells if the LCD shows the icon at (X, Y)
+ */
+static bool LcdIsIcon(const icon_font_t *icon_font, icon_t icon, uint16_t foreground, uint16_t background){
+	uint16_t row, col;
+
+	for (row = 0; row < icon_font->height; row++){
+		for (col = 0; col < icon_font->width; col++){
+			if (SpiMockPixel(X + col, Y + row) != (IconBit(icon_font, icon, row, col) ? foreground : background)){
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/*==================[external functions definition]==========================*/
+int main(void){
+	const icon_sprite_t *sprite, *again;
+	uint32_t f, sprites, bitmaps, fitting[sizeof(icon_fonts) / sizeof(icon_fonts[0])];
+	uint16_t x, y;
+	framebuffer_t *fb;
+	icon_t icon;
+	bool same;
+
+	/* Every icon of every size: the sprite has the pixels of the bitmap */
+	for (f = 0; f < sizeof(icon_fonts) / sizeof(icon_fonts[0]); f++){
+		sprites = 0;
+		for (icon = 0; icon < ICONS; icon++){
+			sprite = IconSpriteGet(icon_fonts[f], icon, ILI9341_BLUE, ILI9341_WHITE);
+			if (sprite != NULL){
+				CHECK(sprite->icon_font == icon_fonts[f] && sprite->icon == icon);
+				CHECK(SpriteIsIcon(sprite, ILI9341_BLUE, ILI9341_WHITE));
+				sprites++;
+			}
+		}
+		printf("Icons %u: %u of %u as sprites\n", icon_fonts[f]->width, sprites, ICONS);
+		fitting[f] = sprites;
+	}
+	/* Small icons always fit, some of the biggest ones need too many runs */
+	CHECK(fitting[0] == ICONS && fitting[3] < ICONS);
+
+	/* Expanded only the first time, other colors are other sprites */
+	sprite = IconSpriteGet(&icon_30, ICON_SUN, ILI9341_BLUE, ILI9341_WHITE);
+	CHECK(IconSpriteGet(&icon_30, ICON_SUN, ILI9341_BLUE, ILI9341_WHITE) == sprite);
+	again = IconSpriteGet(&icon_30, ICON_SUN, ILI9341_RED, ILI9341_WHITE);
+	CHECK(again != NULL && again != sprite && again->count == sprite->count);
+	CHECK(SpriteIsIcon(again, ILI9341_RED, ILI9341_WHITE));
+
+	/* Drawn on the LCD from the sprite or, when too big, from the bitmap */
+	SpiMockInit(LCD_DC);
+	ILI9341Init(SPI_1, LCD_DC, LCD_RST);
+	for (f = 0; f < sizeof(icon_fonts) / sizeof(icon_fonts[0]); f++){
+		sprites = 0;
+		bitmaps = 0;
+		for (icon = 0; icon < ICONS; icon++){
+			ILI9341DrawIcon(X, Y, icon, icon_fonts[f], ILI9341_RED, ILI9341_BLACK);
+			CHECK(LcdIsIcon(icon_fonts[f], icon, ILI9341_RED, ILI9341_BLACK));
+			if (IconSpriteGet(icon_fonts[f], icon, ILI9341_RED, ILI9341_BLACK) != NULL){
+				sprites++;
+			}
+			else{
+				bitmaps++;
+			}
+		}
+		CHECK(sprites + bitmaps == ICONS);
+	}
+
+	/* Transparent icons only change the icon pixels of the framebuffer */
+	ILI9341Fill(ILI9341_WHITE);
+	CHECK(ILI9341FramebufferInit(X, Y, 89, 89) == 1);
+	fb = ILI9341GetFramebuffer();
+	for (f = 0; f < sizeof(icon_fonts) / sizeof(icon_fonts[0]); f++){
+		for (icon = 0; icon < ICONS; icon += 7){
+			for (y = 0; y < 89; y++){
+				for (x = 0; x < 89; x++){
+					FramebufferDrawPixel(fb, X + x, Y + y, PATTERN(x, y));
+				}
+			}
+			ILI9341DrawIconTransparent(X, Y, icon, icon_fonts[f], ILI9341_GREEN);
+			same = true;
+			for (y = 0; y < 89; y++){
+				for (x = 0; x < 89; x++){
+					same &= FramebufferGetPixel(fb, X + x, Y + y) ==
+						((x < icon_fonts[f]->width && y < icon_fonts[f]->height && IconBit(icon_fonts[f], icon, y, x)) ? ILI9341_GREEN : PATTERN(x, y));
+				}
+			}
+			CHECK(same);
+		}
+	}
+	ILI9341FramebufferDeInit();
+
+	ILI9341DeInit();
+
+	printf(failed ? "%d checks failed\n" : "All checks passed\n", failed);
+	return failed ? 1 : 0;
+}
+
+/*==================[end of file]============================================*/
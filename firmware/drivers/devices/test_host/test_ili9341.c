@@ -0,0 +1,272 @@
+/**
+ * @file test_ili9341.c
+ * @brief Host test of the ILI9341 driver: SPI transactions and bytes sent by each primitive
+ *
+ * Lines, circles and filled triangles are also drawn as they were before being
+ * sent as runs, one ILI9341DrawPixel() per pixel or one line per scanline: the
+ * SPI bytes of both are reported and the pixels of the LCD memory compared.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdio.h>
+#include "ili9341.h"
+#include "spi_mock.h"
+/*==================[macros and definitions]=================================*/
+#define LCD_DC			GPIO_2
+#define LCD_RST			GPIO_3
+#define MAX_VALUE_SIZE	4092			/* Longest pixel transaction of the driver */
+#define INIT_COMMANDS	20				/* Configuration commands with parameters */
+#define CASET			0x2A
+#define PASET			0x2B
+#define RAMWR			0x2C
+#define CHUNKS(bytes)	(((bytes) + MAX_VALUE_SIZE - 1) / MAX_VALUE_SIZE)
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failed++; } } while (0)
+/*==================[internal data definition]===============================*/
+static int failed;
+static uint16_t before[ILI9341_HEIGHT][ILI9341_WIDTH];	/*!< LCD memory drawn pixel by pixel */
+
+/*==================[internal functions definition]==========================*/
+/*
+ * Tells if every pixel of the area has the color
+ */
+static bool AreaIs(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color){
+	uint16_t x, y;
+
+	for (y = y0; y <= y1; y++){
+		for (x = x0; x <= x1; x++){
+			if (SpiMockPixel(x, y) != color){
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/*
+ * Line drawn one pixel at a time (Bresenham), as ILI9341DrawLine() did
+ */
+static void PixelLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color){
+	int16_t x_dist = (x1 > x0) ? x1 - x0 : x0 - x1;
+	int16_t y_dist = (y1 > y0) ? y1 - y0 : y0 - y1;
+	int16_t x_grow = (x0 < x1) ? 1 : -1;
+	int16_t y_grow = (y0 < y1) ? 1 : -1;
+	int16_t error = x_dist - y_dist, error_2;
+
+	while (1){
+		ILI9341DrawPixel(x0, y0, color);
+		if (x0 == x1 && y0 == y1){
+			break;
+		}
+		error_2 = 2 * error;
+		if (error_2 > -y_dist){
+			error -= y_dist;
+			x0 += x_grow;
+		}
+		if (error_2 < x_dist){
+			error += x_dist;
+			y0 += y_grow;
+		}
+	}
+}
+
+/*
+ * Circle drawn one pixel at a time, 8 per step, as ILI9341DrawCircle() did
+ */
+static void PixelCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color){
+	int16_t f = 1 - r, ddF_x = 1, ddF_y = -2 * r, x = 0, y = r;
+
+	ILI9341DrawPixel(x0, y0 + r, color);
+	ILI9341DrawPixel(x0, y0 - r, color);
+	ILI9341DrawPixel(x0 + r, y0, color);
+	ILI9341DrawPixel(x0 - r, y0, color);
+	while (x < y){
+		if (f >= 0){
+			y--;
+			ddF_y += 2;
+			f += ddF_y;
+		}
+		x++;
+		ddF_x += 2;
+		f += ddF_x;
+		ILI9341DrawPixel(x0 + x, y0 + y, color);
+		ILI9341DrawPixel(x0 - x, y0 + y, color);
+		ILI9341DrawPixel(x0 + x, y0 - y, color);
+		ILI9341DrawPixel(x0 - x, y0 - y, color);
+		ILI9341DrawPixel(x0 + y, y0 + x, color);
+		ILI9341DrawPixel(x0 - y, y0 + x, color);
+		ILI9341DrawPixel(x0 + y, y0 - x, color);
+		ILI9341DrawPixel(x0 - y, y0 - x, color);
+	}
+}
+
+/*
+ * Filled triangle drawn one line per scanline, with the floating point edge
+ * slopes ILI9341DrawFilledTriangle() used. Vertices sorted by row.
+ */
+static void ScanlineTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color){
+	int16_t x_aux = x0 + (float)(y1 - y0) / (y2 - y0) * (x2 - x0);
+	float slope1 = (float)(x1 - x0) / (y1 - y0);
+	float slope2 = (float)(x_aux - x0) / (y1 - y0);
+	float x_a = x0, x_b = x0;
+	int16_t y;
+
+	for (y = y0; y < y1; y++){
+		ILI9341DrawLine(x_a, y, x_b, y, color);
+		x_a += slope1;
+		x_b += slope2;
+	}
+	slope1 = (float)(x2 - x1) / (y2 - y1);
+	slope2 = (float)(x2 - x_aux) / (y2 - y1);
+	x_a = x2;
+	x_b = x2;
+	for (y = y2; y > y1; y--){
+		ILI9341DrawLine(x_a, y, x_b, y, color);
+		x_a -= slope1;
+		x_b -= slope2;
+	}
+	ILI9341DrawLine(x1, y1, x_aux, y1, color);
+}
+
+/*
+ * Keeps the LCD memory drawn pixel by pixel and clears the LCD
+ */
+static void KeepBefore(void){
+	uint16_t x, y;
+
+	for (y = 0; y < ILI9341_HEIGHT; y++){
+		for (x = 0; x < ILI9341_WIDTH; x++){
+			before[y][x] = SpiMockPixel(x, y);
+		}
+	}
+	ILI9341Fill(ILI9341_WHITE);
+	SpiMockReset();
+}
+
+/*
+ * Number of pixels that differ from the ones drawn pixel by pixel
+ */
+static uint32_t DiffBefore(void){
+	uint32_t diff = 0;
+	uint16_t x, y;
+
+	for (y = 0; y < ILI9341_HEIGHT; y++){
+		for (x = 0; x < ILI9341_WIDTH; x++){
+			diff += before[y][x] != SpiMockPixel(x, y);
+		}
+	}
+	return diff;
+}
+
+/*==================[external functions definition]==========================*/
+int main(void){
+	const spi_mock_count_t *count = SpiMockCount();
+	uint32_t bytes;
+
+	SpiMockInit(LCD_DC);
+
+	/* Init: the device is added once, each command and its parameters are 2 transactions */
+	ILI9341Init(SPI_1, LCD_DC, LCD_RST);
+	printf("Init: %u transactions, %u bytes\n", count->transactions, count->bytes);
+	CHECK(count->inits == 1);
+	CHECK(count->commands[0x01] == 1 && count->commands[0x11] == 1 && count->commands[0x29] == 1);
+	CHECK(count->commands[RAMWR] == 1 && count->pixels == ILI9341_WIDTH * ILI9341_HEIGHT);
+	CHECK(count->transactions == 3 + 2 * INIT_COMMANDS + 5 + CHUNKS(ILI9341_WIDTH * ILI9341_HEIGHT * 2));
+	CHECK(AreaIs(0, 0, ILI9341_WIDTH - 1, ILI9341_HEIGHT - 1, ILI9341_WHITE));
+
+	/* Pixel: window and data in 6 queued transactions, without waiting */
+	SpiMockReset();
+	ILI9341DrawPixel(10, 20, ILI9341_RED);
+	printf("DrawPixel: %u transactions, %u bytes\n", count->transactions, count->bytes);
+	CHECK(count->inits == 0 && count->waits == 0);
+	CHECK(count->transactions == 6 && count->bytes == 3 + 4 + 4 + 2);
+	CHECK(count->commands[CASET] == 1 && count->commands[PASET] == 1 && count->commands[RAMWR] == 1);
+	CHECK(SpiMockPixel(10, 20) == ILI9341_RED && SpiMockPixel(11, 20) == ILI9341_WHITE);
+
+	/* Same row: only the column window is sent again */
+	SpiMockReset();
+	ILI9341DrawPixel(11, 20, ILI9341_BLUE);
+	CHECK(count->transactions == 4 && count->commands[PASET] == 0);
+	CHECK(SpiMockPixel(11, 20) == ILI9341_BLUE);
+
+	/* Same pixel: the window is kept */
+	SpiMockReset();
+	ILI9341DrawPixel(11, 20, ILI9341_BLACK);
+	CHECK(count->transactions == 2 && count->bytes == 3 && count->commands[RAMWR] == 1);
+	CHECK(SpiMockPixel(11, 20) == ILI9341_BLACK);
+
+	/* Filled rectangle: one window, pixels in buffers of MAX_VALUE_SIZE, one wait for the buffer */
+	SpiMockReset();
+	ILI9341DrawFilledRectangle(0, 0, 99, 99, ILI9341_BLUE);
+	printf("DrawFilledRectangle 100x100: %u transactions, %u bytes\n", count->transactions, count->bytes);
+	CHECK(count->transactions == 5 + CHUNKS(100 * 100 * 2));
+	CHECK(count->bytes == 3 + 8 + 100 * 100 * 2 && count->pixels == 100 * 100);
+	CHECK(count->waits == 1);
+	CHECK(AreaIs(0, 0, 99, 99, ILI9341_BLUE) && SpiMockPixel(100, 0) == ILI9341_WHITE && SpiMockPixel(0, 100) == ILI9341_WHITE);
+
+	/* Scroll start: command and parameters queued, without waiting */
+	SpiMockReset();
+	ILI9341SetScrollStart(10);
+	CHECK(count->transactions == 2 && count->bytes == 3 && count->waits == 0);
+
+	/* Shapes: SPI bytes drawn pixel by pixel (before) and as runs (after), same pixels */
+	ILI9341Fill(ILI9341_WHITE);
+	SpiMockReset();
+	PixelLine(10, 10, 200, 60, ILI9341_RED);
+	bytes = count->bytes;
+	KeepBefore();
+	ILI9341DrawLine(10, 10, 200, 60, ILI9341_RED);
+	printf("DrawLine (10,10)-(200,60): %u bytes before, %u bytes after\n", bytes, count->bytes);
+	CHECK(DiffBefore() == 0 && count->pixels == 191);
+	CHECK(count->bytes * 10 < bytes * 6);
+
+	ILI9341Fill(ILI9341_WHITE);
+	SpiMockReset();
+	PixelLine(20, 300, 60, 20, ILI9341_RED);
+	bytes = count->bytes;
+	KeepBefore();
+	ILI9341DrawLine(20, 300, 60, 20, ILI9341_RED);
+	printf("DrawLine (20,300)-(60,20): %u bytes before, %u bytes after\n", bytes, count->bytes);
+	CHECK(DiffBefore() == 0 && count->pixels == 281);
+	CHECK(count->bytes * 10 < bytes * 6);
+
+	ILI9341Fill(ILI9341_WHITE);
+	SpiMockReset();
+	PixelCircle(120, 160, 50, ILI9341_BLUE);
+	bytes = count->bytes;
+	KeepBefore();
+	ILI9341DrawCircle(120, 160, 50, ILI9341_BLUE);
+	printf("DrawCircle r=50: %u bytes before, %u bytes after\n", bytes, count->bytes);
+	CHECK(DiffBefore() == 0);
+	CHECK(count->bytes * 10 < bytes * 6);
+
+	ILI9341Fill(ILI9341_WHITE);
+	SpiMockReset();
+	ScanlineTriangle(20, 40, 220, 100, 90, 300, ILI9341_BLUE);
+	bytes = count->bytes;
+	KeepBefore();
+	ILI9341DrawFilledTriangle(220, 100, 90, 300, 20, 40, ILI9341_BLUE);
+	printf("DrawFilledTriangle: %u bytes before, %u bytes after, %u pixels differ\n", bytes, count->bytes, DiffBefore());
+	/* One run per row: RAMWR and at most both window limits. Edges are rounded down
+	as the float slopes were, but the float sums fall just short of the edges that
+	land on an integer x: those edge pixels (fewer than one edge in ten) move by one,
+	so the bytes are not lower */
+	CHECK(count->commands[RAMWR] == 300 - 40 + 1);
+	CHECK(count->bytes - 2 * count->pixels <= (3 + 4 + 4) * (300 - 40 + 1));
+	CHECK(DiffBefore() <= 2 * (300 - 40 + 1) / 10);
+
+	/* DeInit waits for the queue */
+	SpiMockReset();
+	ILI9341DeInit();
+	CHECK(count->transactions == 0 && count->waits == 1);
+
+	printf(failed ? "%d checks failed\n" : "All checks passed\n", failed);
+	return failed ? 1 : 0;
+}
+
+/*==================[end of file]============================================*/
@@ -0,0 +1,291 @@
+/**
+ * @file test_image.c
+ * @brief Host test of the QOI565 image decoder: round trip of every code, decoded in pieces of any size
+ *
+ * Images are encoded as tools/image_565.py does and decoded again, whole and in
+ * pieces that split the runs of a color. ILI9341DrawImage() is compared with
+ * ILI9341DrawPicture() of the raw pixels, on the LCD and through the framebuffer.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdio.h>
+#include <string.h>
+#include "image.h"
+#include "ili9341.h"
+#include "spi_mock.h"
+/*==================[macros and definitions]=================================*/
+#define LCD_DC		GPIO_2
+#define LCD_RST		GPIO_3
+#define WIDTH		200
+#define HEIGHT		150
+#define PIXELS		(WIDTH * HEIGHT)
+#define BAND		30			/* Rows of each kind of pixels */
+#define X			20			/* Screen position of the image */
+#define Y			40
+#define MAX_RUN		62			/* Longest run of one code */
+#define OP_INDEX	0x00
+#define OP_DIFF		0x40
+#define OP_LUMA		0x80
+#define OP_RUN		0xC0
+#define OP_RGB		0xFE
+#define SWAP(c)		((uint16_t)((c) >> 8 | (c) << 8))
+#define RED(c)		((c) >> 11)
+#define GREEN(c)	(((c) >> 5) & 0x3F)
+#define BLUE(c)		((c) & 0x1F)
+#define RGB565(r, g, b)	((uint16_t)(((r) & 0x1F) << 11 | ((g) & 0x3F) << 5 | ((b) & 0x1F)))
+#define HASH(c)		((3 * RED(c) + 5 * GREEN(c) + 7 * BLUE(c)) % IMAGE_INDEX_SIZE)
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failed++; } } while (0)
+/*==================[internal data definition]===============================*/
+static int failed;
+static uint16_t colors[PIXELS];					/* Image, RGB565 */
+static uint8_t raw[PIXELS * 2];					/* Image, high byte first */
+static uint8_t data[PIXELS * 3];				/* Image, QOI565 */
+static uint16_t pixels[PIXELS];					/* Decoded pixels */
+static uint16_t drawn[HEIGHT][WIDTH];			/* LCD memory drawn from the raw pixels */
+static uint32_t ops[4];							/* Codes of each kind: index, diff, luma and run */
+static uint32_t rgb_ops;						/* Colors stored as they are */
+
+/*==================[internal functions definition]==========================*/
+/*
+ * Image with a band of pixels for each code: runs longer than MAX_RUN, small
+ * differences, green driven differences, colors of a small palette and any color.
+ * It starts with black, the previous color of the first pixel
+ */
+static void MakeImage(void){
+	const uint16_t palette[] = {0x0000, 0xF800, 0x07E0, 0x001F, 0xFFE0, 0xFFFF, 0x7BEF, 0xF81F};
+	uint32_t seed = 12345;
+	uint16_t x, y, g;
+
+	for (y = 0; y < HEIGHT; y++){
+		for (x = 0; x < WIDTH; x++){
+			seed = seed * 1103515245 + 12345;
+			switch (y / BAND){
+			case 0:
+				colors[y * WIDTH + x] = palette[(x / 70 + y / 10) % 4];
+				break;
+			case 1:
+				colors[y * WIDTH + x] = RGB565(x / 8 + y % 3, x / 4, 31 - x / 8);
+				break;
+			case 2:
+				g = (x * 7 + y) & 0x3F;
+				colors[y * WIDTH + x] = RGB565(g / 2 + x % 3, g, g / 2 + y % 5);
+				break;
+			case 3:
+				colors[y * WIDTH + x] = palette[(seed >> 16) % 8];
+				break;
+			default:
+				colors[y * WIDTH + x] = seed >> 8;
+				break;
+			}
+			raw[(y * WIDTH + x) * 2] = colors[y * WIDTH + x] >> 8;
+			raw[(y * WIDTH + x) * 2 + 1] = colors[y * WIDTH + x] & 0xFF;
+		}
+	}
+}
+
+/*
+ * Pixels encoded as tools/image_565.py does, counting the codes of each kind
+ */
+static uint32_t Encode(const uint16_t *colors, uint32_t count, uint8_t *data){
+	uint16_t index[IMAGE_INDEX_SIZE] = {0};
+	uint16_t previous = 0, color;
+	uint32_t i, size = 0, run = 0;
+	int red, green, blue, red_green, blue_green;
+
+	for (i = 0; i < count; i++){
+		color = colors[i];
+		if (color == previous){
+			run++;
+			if (run == MAX_RUN){
+				data[size++] = OP_RUN | (run - 1);
+				ops[OP_RUN >> 6]++;
+				run = 0;
+			}
+			continue;
+		}
+		if (run){
+			data[size++] = OP_RUN | (run - 1);
+			ops[OP_RUN >> 6]++;
+			run = 0;
+		}
+		if (index[HASH(color)] == color){
+			data[size++] = OP_INDEX | HASH(color);
+			ops[OP_INDEX >> 6]++;
+		}
+		else{
+			index[HASH(color)] = color;
+			red = RED(color) - RED(previous);
+			green = GREEN(color) - GREEN(previous);
+			blue = BLUE(color) - BLUE(previous);
+			red_green = red - (green >> 1);
+			blue_green = blue - (green >> 1);
+			if (red >= -2 && red <= 1 && green >= -2 && green <= 1 && blue >= -2 && blue <= 1){
+				data[size++] = OP_DIFF | (red + 2) << 4 | (green + 2) << 2 | (blue + 2);
+				ops[OP_DIFF >> 6]++;
+			}
+			else if (green >= -32 && green <= 31 && red_green >= -8 && red_green <= 7 && blue_green >= -8 && blue_green <= 7){
+				data[size++] = OP_LUMA | (green + 32);
+				data[size++] = (red_green + 8) << 4 | (blue_green + 8);
+				ops[OP_LUMA >> 6]++;
+			}
+			else{
+				data[size++] = OP_RGB;
+				data[size++] = color >> 8;
+				data[size++] = color & 0xFF;
+				rgb_ops++;
+			}
+		}
+		previous = color;
+	}
+	if (run){
+		data[size++] = OP_RUN | (run - 1);
+		ops[OP_RUN >> 6]++;
+	}
+	return size;
+}
+
+/*
+ * Decodes the whole image in pieces of piece pixels, or 1, 2, 3... pixels if piece
+ * is 0. Returns the byte after the last one decoded
+ */
+static const uint8_t * DecodeInPieces(const image_t *image, uint32_t piece){
+	image_decoder_t decoder;
+	uint32_t done = 0, count, next = 1;
+
+	memset(pixels, 0, sizeof(pixels));
+	ImageDecodeStart(&decoder, image);
+	while (done < PIXELS){
+		count = (piece != 0) ? piece : next++;
+		if (count > PIXELS - done){
+			count = PIXELS - done;
+		}
+		ImageDecode(&decoder, &pixels[done], count);
+		done += count;
+	}
+	return decoder.data;
+}
+
+/*
+ * Tells if the decoded pixels are the image, high byte first
+ */
+static bool DecodedIsImage(void){
+	uint32_t i;
+
+	for (i = 0; i < PIXELS; i++){
+		if (pixels[i] != SWAP(colors[i])){
+			printf("Pixel %u: %04X instead of %04X\n", i, SWAP(pixels[i]), colors[i]);
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+ * Keeps the image drawn on the LCD and clears the LCD
+ */
+static void KeepDrawn(void){
+	uint16_t x, y;
+
+	for (y = 0; y < HEIGHT; y++){
+		for (x = 0; x < WIDTH; x++){
+			drawn[y][x] = SpiMockPixel(X + x, Y + y);
+		}
+	}
+	ILI9341Fill(ILI9341_WHITE);
+	SpiMockReset();
+}
+
+/*
+ * Tells if the LCD shows the image drawn from the raw pixels
+ */
+static bool SameAsDrawn(void){
+	uint16_t x, y;
+
+	for (y = 0; y < HEIGHT; y++){
+		for (x = 0; x < WIDTH; x++){
+			if (SpiMockPixel(X + x, Y + y) != drawn[y][x]){
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/*==================[external functions definition]==========================*/
+int main(void){
+	const uint32_t pieces[] = {1, 7, 61, 62, 63, 64, 1000, PIXELS, 0};
+	const spi_mock_count_t *count = SpiMockCount();
+	image_t image = {WIDTH, HEIGHT, IMAGE_QOI565, data};
+	image_decoder_t decoder;
+	uint32_t size, i;
+
+	MakeImage();
+	size = Encode(colors, PIXELS, data);
+	printf("QOI565: %u bytes, %u as RGB565\n", size, PIXELS * 2);
+	CHECK(size < PIXELS * 2);
+	/* Every code is used, and runs longer than a code */
+	CHECK(ops[OP_INDEX >> 6] > 0 && ops[OP_DIFF >> 6] > 0 && ops[OP_LUMA >> 6] > 0 && rgb_ops > 0);
+	CHECK(ops[OP_RUN >> 6] > 0 && data[0] == (OP_RUN | (MAX_RUN - 1)));
+
+	/* Same pixels whatever the pieces, runs go on across them. Every byte is used,
+	none is read past the end */
+	for (i = 0; i < sizeof(pieces) / sizeof(pieces[0]); i++){
+		CHECK(DecodeInPieces(&image, pieces[i]) == data + size);
+		CHECK(DecodedIsImage());
+	}
+
+	/* Run left over at the end of a piece */
+	ImageDecodeStart(&decoder, &image);
+	ImageDecode(&decoder, pixels, 1);
+	CHECK(decoder.run == MAX_RUN - 1 && pixels[0] == SWAP(colors[0]));
+
+	/* Raw pixels are copied */
+	image.encoding = IMAGE_RGB565;
+	image.data = raw;
+	for (i = 0; i < sizeof(pieces) / sizeof(pieces[0]); i++){
+		CHECK(DecodeInPieces(&image, pieces[i]) == raw + sizeof(raw));
+		CHECK(DecodedIsImage());
+	}
+	image.encoding = IMAGE_QOI565;
+	image.data = data;
+
+	/* Drawn on the LCD as the raw pixels, decoded in buffers of the DMA */
+	SpiMockInit(LCD_DC);
+	ILI9341Init(SPI_1, LCD_DC, LCD_RST);
+	SpiMockReset();
+	ILI9341DrawPicture(X, Y, WIDTH, HEIGHT, raw);
+	KeepDrawn();
+	ILI9341DrawImage(X, Y, &image);
+	CHECK(SameAsDrawn() && count->pixels == PIXELS);
+	CHECK(SpiMockPixel(X - 1, Y) == ILI9341_WHITE && SpiMockPixel(X + WIDTH, Y + HEIGHT - 1) == ILI9341_WHITE);
+
+	/* Through a framebuffer that holds part of it, the rest is drawn on the LCD */
+	ILI9341Fill(ILI9341_WHITE);
+	CHECK(ILI9341FramebufferInit(0, Y + 10, ILI9341_WIDTH, 50) == 1);
+	ILI9341DrawImage(X, Y, &image);
+	ILI9341Flush();
+	CHECK(SameAsDrawn());
+
+	/* All in the framebuffer, nothing is sent before the flush */
+	ILI9341Fill(ILI9341_WHITE);
+	CHECK(ILI9341FramebufferInit(X, Y, WIDTH, HEIGHT) == 1);
+	SpiMockReset();
+	ILI9341DrawImage(X, Y, &image);
+	CHECK(count->pixels == 0);
+	ILI9341Flush();
+	CHECK(SameAsDrawn());
+	ILI9341FramebufferDeInit();
+
+	ILI9341DeInit();
+
+	printf(failed ? "%d checks failed\n" : "All checks passed\n", failed);
+	return failed ? 1 : 0;
+}
+
+/*==================[end of file]============================================*/
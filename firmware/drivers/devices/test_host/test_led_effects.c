@@ -0,0 +1,136 @@
+/**
+ * @file test_led_effects.c
+ * @brief Host test of the LED effects against the colors computed directly for each LED
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "led_effects.h"
+/*==================[macros and definitions]=================================*/
+#define LEDS		150
+#define FRAMES		1000
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failed++; } } while (0)
+/*==================[internal data definition]===============================*/
+static int failed;
+
+/*==================[internal functions definition]==========================*/
+/* Rainbow computed with HSV for every LED, like NeoPixelRainbow() did */
+static void Rainbow(uint32_t *colors, uint16_t first_hue, uint8_t reps){
+	uint16_t i;
+
+	for (i = 0; i < LEDS; i++){
+		colors[i] = LedEffectHSV(first_hue + (i * reps * 65536) / LEDS, 255, 255);
+	}
+}
+
+static double Seconds(void){
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/*==================[external functions definition]==========================*/
+int main(void){
+	uint32_t hue[LED_PALETTE_SIZE], pulse[LED_PALETTE_SIZE];
+	uint32_t colors[LEDS], previous[LEDS], expected[LEDS];
+	const uint32_t stops[] = {0x000000, 0x00FF8040};
+	led_effect_t effect;
+	uint32_t i, lit, sum;
+	double start, hsv_time, palette_time;
+
+	/* Primary colors of the hue circle */
+	CHECK(LedEffectHSV(0, 255, 255) == 0xFF0000);
+	CHECK(LedEffectHSV(65536 / 3, 255, 255) == 0x00FF00);
+	CHECK(LedEffectHSV(2 * 65536 / 3 + 1, 255, 255) == 0x0000FF);
+	CHECK(LedEffectHSV(0, 0, 255) == 0xFFFFFF);
+	CHECK(LedEffectHSV(12345, 255, 0) == 0);
+
+	/* Hue palette, one entry every 256 hues */
+	LedPaletteHue(hue, 255, 255);
+	for (i = 0; i < LED_PALETTE_SIZE; i++){
+		CHECK(hue[i] == LedEffectHSV(i * 256, 255, 255));
+	}
+
+	/* Gradient starts on each color and fades back to the first one */
+	LedPaletteGradient(pulse, stops, 2);
+	CHECK(pulse[0] == stops[0] && pulse[128] == stops[1]);
+	CHECK(pulse[64] == 0x7F4020 && pulse[192] == 0x7F4020);
+	for (i = 1; i < 128; i++){
+		CHECK((pulse[i] >> 16) >= (pulse[i - 1] >> 16));
+	}
+
+	/* Scroll spread over the stripe is the rainbow, with hues rounded to the palette */
+	LedEffectInit(&effect, LED_EFFECT_SCROLL, hue, 0x0100, LED_PALETTE_SIZE * LED_EFFECT_ONE / 50);
+	LedEffectRender(&effect, colors, LEDS, 0);
+	for (i = 0; i < LEDS; i++){
+		CHECK(colors[i] == hue[(i * effect.spread / LED_EFFECT_ONE) & 0xFF]);
+	}
+
+	/* One entry per LED and per frame: each frame is the previous one shifted */
+	LedEffectInit(&effect, LED_EFFECT_SCROLL, hue, LED_EFFECT_ONE, LED_EFFECT_ONE);
+	LedEffectRender(&effect, previous, LEDS, 0);
+	LedEffectRender(&effect, colors, LEDS, 1);
+	CHECK(memcmp(colors, previous + 1, (LEDS - 1) * sizeof(uint32_t)) == 0);
+	/* Several frames at once land where one by one would */
+	LedEffectRender(&effect, previous, LEDS, 5);
+	for (i = 0; i < 5; i++){
+		LedEffectRender(&effect, colors, LEDS, 1);
+	}
+	LedEffectRender(&effect, expected, LEDS, 0);
+	effect.phase -= 5 * LED_EFFECT_ONE;
+	LedEffectRender(&effect, colors, LEDS, 0);
+	CHECK(memcmp(expected, previous, sizeof(expected)) != 0);
+	CHECK(memcmp(colors, previous, sizeof(colors)) == 0);
+
+	/* Pulse: every LED of the same palette entry */
+	LedEffectInit(&effect, LED_EFFECT_PULSE, pulse, 0x0400, 0);
+	LedEffectRender(&effect, colors, LEDS, 32);
+	for (i = 0; i < LEDS; i++){
+		CHECK(colors[i] == pulse[128]);
+	}
+
+	/* Comet: full color head, tail fading backwards, wrapping around the stripe */
+	LedEffectInit(&effect, LED_EFFECT_COMET, pulse, LED_EFFECT_ONE, 8 * LED_EFFECT_ONE);
+	for (i = 0; i < LED_PALETTE_SIZE; i++){
+		pulse[i] = (i * 0x010101) & 0xFFFFFF;
+	}
+	LedEffectRender(&effect, colors, LEDS, 2);
+	CHECK(colors[2] == pulse[255]);
+	CHECK(colors[1] < colors[2] && colors[0] < colors[1] && colors[LEDS - 1] < colors[0]);
+	for (lit = 0, i = 0; i < LEDS; i++){
+		lit += (colors[i] != pulse[0]);
+	}
+	CHECK(lit == 8);
+	CHECK(colors[3] == pulse[0] && colors[LEDS - 6] == pulse[0]);
+
+	/* Time of a rainbow frame with HSV per LED and with the palette */
+	start = Seconds();
+	for (sum = 0, i = 0; i < FRAMES; i++){
+		Rainbow(expected, i * 256, 3);
+		sum += expected[i % LEDS];
+	}
+	hsv_time = Seconds() - start;
+	LedEffectInit(&effect, LED_EFFECT_SCROLL, hue, LED_EFFECT_ONE, 3 * LED_PALETTE_SIZE * LED_EFFECT_ONE / LEDS);
+	start = Seconds();
+	for (i = 0; i < FRAMES; i++){
+		LedEffectRender(&effect, colors, LEDS, 1);
+		sum -= colors[i % LEDS];
+	}
+	palette_time = Seconds() - start;
+	printf("rainbow %d LEDs: HSV %.2f us, palette %.2f us per frame (%08X)\n", LEDS,
+		hsv_time * 1e6 / FRAMES, palette_time * 1e6 / FRAMES, sum);
+
+	printf(failed ? "%d checks failed\n" : "All checks passed\n", failed);
+	return failed ? 1 : 0;
+}
+
+/*==================[end of file]============================================*/
@@ -0,0 +1,180 @@
+/**
+ * @file test_widget.c
+ * @brief Host test of the widget layer: pixels sent on each update and pixel colors
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdio.h>
+#include <string.h>
+#include "widget.h"
+/*==================[macros and definitions]=================================*/
+#define WIDTH		240
+#define HEIGHT		320
+#define WHITE		0xFFFF
+#define BLACK		0x0000
+#define BLUE		0x001F
+#define GREY		0xC618
+#define RED			0xF800
+#define PLOT_WIDTH	100
+#define PLOT_HEIGHT	50
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failed++; } } while (0)
+/*==================[internal data definition]===============================*/
+static uint16_t panel[WIDTH * HEIGHT];	/*!< Host display, RGB565 */
+static uint32_t windows;				/*!< Areas sent since the last reset */
+static uint32_t pixels;					/*!< Pixels sent since the last reset */
+static int failed;
+
+/*==================[internal functions definition]==========================*/
+static void Output(const fb_rect_t *rect, const uint16_t *data, void *param){
+	int16_t x, y;
+
+	for (y = rect->y0; y <= rect->y1; y++){
+		for (x = rect->x0; x <= rect->x1; x++){
+			/* Rendered pixels are high byte first */
+			uint16_t p = *data++;
+			panel[y * WIDTH + x] = (uint16_t)(p << 8 | p >> 8);
+		}
+	}
+	windows++;
+	pixels += (rect->x1 - rect->x0 + 1) * (rect->y1 - rect->y0 + 1);
+}
+
+static void Reset(void){
+	windows = 0;
+	pixels = 0;
+}
+
+static uint16_t Pixel(int16_t x, int16_t y){
+	return panel[y * WIDTH + x];
+}
+
+/*==================[external functions definition]==========================*/
+int main(void){
+	widget_screen_t screen;
+	widget_t bar, gauge, plot, label;
+	uint8_t samples[PLOT_WIDTH];
+	uint32_t sent;
+	int16_t x, y;
+	int ink;
+
+	memset(panel, 0, sizeof(panel));
+	WidgetScreenInit(&screen, WIDTH, HEIGHT, WHITE, Output, NULL);
+	WidgetBarInit(&bar, 10, 10, 200, 20, 0, 100, BLUE, GREY);
+	WidgetGaugeInit(&gauge, 10, 40, 101, 51, 0, 100, RED, GREY);
+	WidgetPlotInit(&plot, 10, 100, PLOT_WIDTH, PLOT_HEIGHT, samples, 0, 100, BLACK, WHITE);
+	WidgetLabelInit(&label, 10, 160, 200, 22, &font_22, BLACK, WHITE);
+	WidgetAdd(&screen, &bar);
+	WidgetAdd(&screen, &gauge);
+	WidgetAdd(&screen, &plot);
+	WidgetAdd(&screen, &label);
+
+	/* First render sends each widget once */
+	Reset();
+	sent = WidgetRender(&screen);
+	CHECK(sent == pixels);
+	CHECK(Pixel(10, 10) == GREY);
+	CHECK(Pixel(209, 29) == GREY);
+	CHECK(Pixel(0, 0) == 0);
+	printf("initial: %u pixels in %u windows\n", pixels, windows);
+
+	/* Nothing changed, nothing sent */
+	Reset();
+	CHECK(WidgetRender(&screen) == 0);
+	WidgetSetValue(&bar, 0);
+	WidgetSetText(&label, "");
+	CHECK(WidgetRender(&screen) == 0);
+	CHECK(windows == 0);
+
+	/* Bar: only the columns between both ends, 50% of 200 px by 20 rows */
+	Reset();
+	WidgetSetValue(&bar, 50);
+	CHECK(WidgetRender(&screen) == 100 * 20);
+	CHECK(Pixel(10, 10) == BLUE && Pixel(109, 29) == BLUE && Pixel(110, 10) == GREY);
+	Reset();
+	WidgetSetValue(&bar, 45);
+	CHECK(WidgetRender(&screen) == 10 * 20);
+	CHECK(Pixel(99, 15) == BLUE && Pixel(100, 15) == GREY);
+	printf("bar 50 -> 45: %u pixels in %u windows\n", pixels, windows);
+
+	/* Values out of range are limited */
+	Reset();
+	WidgetSetValue(&bar, 1000);
+	CHECK(WidgetRender(&screen) == 110 * 20);
+	CHECK(Pixel(209, 29) == BLUE);
+
+	/* Gauge: needle at min points left, then straight up */
+	CHECK(Pixel(10, 90) == RED && Pixel(60, 40) == GREY);
+	Reset();
+	WidgetSetValue(&gauge, 50);
+	sent = WidgetRender(&screen);
+	CHECK(sent > 0 && sent < 101 * 51);
+	CHECK(Pixel(60, 40) == RED && Pixel(10, 90) == GREY);
+	printf("gauge 0 -> 50: %u pixels in %u windows\n", pixels, windows);
+
+	/* Plot: each sample sends its column and the cleared next one */
+	Reset();
+	WidgetSetValue(&plot, 100);
+	CHECK(WidgetRender(&screen) == 2 * PLOT_HEIGHT);
+	CHECK(Pixel(10, 100) == BLACK);
+	Reset();
+	WidgetSetValue(&plot, 0);
+	CHECK(WidgetRender(&screen) == 2 * PLOT_HEIGHT);
+	/* Second column joins top and bottom */
+	for (y = 100; y < 100 + PLOT_HEIGHT; y++){
+		CHECK(Pixel(11, y) == BLACK);
+	}
+	CHECK(Pixel(12, 120) == WHITE);
+	/* Several samples before a render are merged */
+	Reset();
+	for (x = 0; x < 10; x++){
+		WidgetSetValue(&plot, 50);
+	}
+	CHECK(WidgetRender(&screen) == 11 * PLOT_HEIGHT);
+	CHECK(windows == 1);
+	printf("plot 10 samples: %u pixels in %u windows\n", pixels, windows);
+	/* Wrap around sends the last and first columns */
+	for (x = 12; x < PLOT_WIDTH - 1; x++){
+		WidgetSetValue(&plot, 50);
+	}
+	WidgetRender(&screen);
+	Reset();
+	WidgetSetValue(&plot, 50);
+	CHECK(WidgetRender(&screen) == 2 * PLOT_HEIGHT);
+	CHECK(windows == 2);
+	CHECK(plot.cursor == 0);
+
+	/* Label: the same text isn't sent again */
+	Reset();
+	WidgetSetText(&label, "Hello");
+	CHECK(WidgetRender(&screen) == 200 * 22);
+	ink = 0;
+	for (y = 160; y < 182; y++){
+		for (x = 10; x < 210; x++){
+			ink += (Pixel(x, y) == BLACK);
+		}
+	}
+	CHECK(ink > 0);
+	Reset();
+	WidgetSetText(&label, "Hello");
+	CHECK(WidgetRender(&screen) == 0);
+
+	/* Bands: a full screen area is rendered in pieces of the band buffer */
+	Reset();
+	WidgetInvalidate(&label);
+	WidgetInvalidate(&bar);
+	sent = WidgetRender(&screen);
+	CHECK(sent == pixels);
+	CHECK(windows > 1);
+	CHECK(Pixel(10, 10) == BLUE);
+
+	printf(failed ? "%d checks failed\n" : "All checks passed\n", failed);
+	return failed ? 1 : 0;
+}
+
+/*==================[end of file]============================================*/
@@ -0,0 +1,189 @@
+/**
+ * @file test_ws2812b.c
+ * @brief Host test of the WS2812B encoder: packed frames against the datasheet waveform, brightness table and parallel stripes
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdio.h>
+#include <string.h>
+#include "ws2812b_encoder.h"
+/*==================[macros and definitions]=================================*/
+#define NS_PER_TICK	(1000000000 / WS2812B_RESOLUTION)
+#define LEDS		4
+#define SYMBOLS		(LEDS * WS2812B_LED_BYTES * 8 + 1)	/* Frame of LEDS LEDs and the reset */
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failed++; } } while (0)
+/*==================[internal data definition]===============================*/
+static int failed;
+
+/*==================[internal functions definition]==========================*/
+/* Datasheet times in ns, each one +-150 ns */
+static int InRange(uint32_t ticks, uint32_t ns){
+	return ticks * NS_PER_TICK + 150 >= ns && ticks * NS_PER_TICK <= ns + 150;
+}
+
+/* Bits sent by a waveform, checking the times of each one */
+static uint32_t Decode(const rmt_symbol_t *symbols, uint32_t count, uint8_t *bytes){
+	uint32_t i;
+	uint16_t high, low;
+
+	memset(bytes, 0, count / 8);
+	for (i = 0; i < count; i++){
+		high = symbols[i] & RMT_DURATION_MAX;
+		low = (symbols[i] >> 16) & RMT_DURATION_MAX;
+		/* High first, then low */
+		CHECK((symbols[i] >> 15 & 1) == 1 && (symbols[i] >> 31) == 0);
+		if (high > low){
+			CHECK(InRange(high, 800) && InRange(low, 450));
+			bytes[i / 8] |= 0x80 >> (i % 8);
+		}
+		else{
+			CHECK(InRange(high, 400) && InRange(low, 850));
+		}
+	}
+	return count / 8;
+}
+
+/* Waveform sent by the RMT bytes encoder and the reset symbol after it: bit0 or
+bit1 symbol of each bit, most significant first */
+static uint32_t Expand(const uint8_t *bytes, uint32_t count, rmt_symbol_t *symbols){
+	uint32_t i;
+
+	for (i = 0; i < count * 8; i++){
+		symbols[i] = (bytes[i / 8] >> (7 - i % 8) & 1) ? WS2812B_BIT_1_SYMBOL : WS2812B_BIT_0_SYMBOL;
+	}
+	symbols[i++] = WS2812B_RESET_SYMBOL;
+	return i;
+}
+
+/*==================[external functions definition]==========================*/
+int main(void){
+	const uint8_t frame[LEDS * WS2812B_LED_BYTES] = {0x00, 0xFF, 0xA5, 0x01, 0x80, 0x7E, 0x12, 0x34, 0x56, 0xFE, 0x0F, 0xF0};
+	rmt_symbol_t symbols[SYMBOLS + 1];
+	uint32_t colors[LEDS], strip_colors[WS2812B_PARALLEL_STRIPS][LEDS];
+	const uint32_t *strips[WS2812B_PARALLEL_STRIPS];
+	uint8_t words[WS2812B_PARALLEL_WORDS(LEDS)], bytes[8], transposed[8];
+	uint32_t s, k;
+	uint8_t lut[256], gamma[256], decoded[sizeof(frame)], packed[sizeof(frame)];
+	uint32_t count, i;
+	rmt_symbol_t reset;
+
+	/* Symbols of 0x00 and 0xFF */
+	count = Expand(frame, 2, symbols);
+	CHECK(count == 2 * 8 + 1);
+	for (i = 0; i < 8; i++){
+		CHECK(symbols[i] == RMT_SYMBOL(1, 4, 0, 8));
+		CHECK(symbols[8 + i] == RMT_SYMBOL(1, 8, 0, 4));
+	}
+
+	/* Bytes without table are kept, the waveform sends them most significant bit first */
+	for (i = 0; i < 256; i++){
+		lut[i] = i;
+	}
+	CHECK(ws2812bPackBytes(frame, sizeof(frame), lut, packed) == sizeof(frame));
+	CHECK(memcmp(packed, frame, sizeof(frame)) == 0);
+	symbols[SYMBOLS] = 0xDEADBEEF;
+	count = Expand(packed, sizeof(packed), symbols);
+	CHECK(count == SYMBOLS);
+	CHECK(symbols[SYMBOLS] == 0xDEADBEEF);
+	CHECK(Decode(symbols, count - 1, decoded) == sizeof(frame));
+	CHECK(memcmp(decoded, frame, sizeof(frame)) == 0);
+
+	/* Frame ends low for more than the 50 us reset */
+	reset = symbols[count - 1];
+	CHECK((reset >> 15 & 1) == 0 && (reset >> 31) == 0);
+	CHECK(((reset & RMT_DURATION_MAX) + (reset >> 16 & RMT_DURATION_MAX)) * NS_PER_TICK >= 50000);
+
+	/* Table applied to every byte */
+	for (i = 0; i < 256; i++){
+		lut[i] = 255 - i;
+	}
+	ws2812bPackBytes(frame, sizeof(frame), lut, packed);
+	count = Expand(packed, sizeof(packed), symbols);
+	Decode(symbols, count - 1, decoded);
+	for (i = 0; i < sizeof(frame); i++){
+		CHECK(decoded[i] == 255 - frame[i]);
+	}
+
+	/* Empty frame is only the reset */
+	CHECK(ws2812bPackBytes(frame, 0, lut, packed) == 0);
+	CHECK(Expand(packed, 0, symbols) == 1);
+
+	/* 24 bits colors are sent green, red, blue */
+	for (i = 0; i < LEDS; i++){
+		colors[i] = frame[i * 3 + 1] << 16 | frame[i * 3] << 8 | frame[i * 3 + 2];
+	}
+	ws2812bBuildLut(NULL, WS2812B_MAX_BRIGHT, lut);
+	for (i = 0; i < 256; i++){
+		CHECK(lut[i] == i);
+	}
+	CHECK(ws2812bPackColors(colors, LEDS, lut, packed) == sizeof(frame));
+	CHECK(memcmp(packed, frame, sizeof(frame)) == 0);
+
+	/* Brightness first, then gamma */
+	for (i = 0; i < 256; i++){
+		gamma[i] = (i * i) / 255;
+	}
+	ws2812bBuildLut(gamma, 128, lut);
+	CHECK(lut[0] == 0 && lut[255] == gamma[128] && lut[100] == gamma[50]);
+	ws2812bBuildLut(gamma, 0, lut);
+	CHECK(lut[255] == 0);
+	ws2812bBuildLut(gamma, WS2812B_MAX_BRIGHT, lut);
+	ws2812bPackColors(colors, LEDS, lut, packed);
+	count = Expand(packed, sizeof(packed), symbols);
+	Decode(symbols, count - 1, decoded);
+	for (i = 0; i < sizeof(frame); i++){
+		CHECK(decoded[i] == gamma[frame[i]]);
+	}
+
+	/* Colors and bytes of the same frame are packed the same */
+	ws2812bBuildLut(gamma, 100, lut);
+	ws2812bPackColors(colors, LEDS, lut, decoded);
+	ws2812bPackBytes(frame, sizeof(frame), lut, packed);
+	CHECK(memcmp(decoded, packed, sizeof(frame)) == 0);
+
+	/* Transposition against bit by bit, for every bit of every stripe */
+	for (i = 0; i < 256; i++){
+		for (s = 0; s < 8; s++){
+			bytes[s] = (uint8_t)(i * 37 + s * 101 + (i >> 3) * s);
+		}
+		bytes[i % 8] = 1 << (i % 8);
+		ws2812bTranspose(bytes, transposed);
+		for (k = 0; k < 8; k++){
+			for (s = 0; s < 8; s++){
+				CHECK((transposed[k] >> s & 1) == (bytes[s] >> (7 - k) & 1));
+			}
+		}
+	}
+
+	/* Each bit of a parallel frame sends the same bytes as each stripe alone */
+	for (s = 0; s < WS2812B_PARALLEL_STRIPS; s++){
+		for (i = 0; i < LEDS; i++){
+			strip_colors[s][i] = colors[(i + s) % LEDS] ^ (s * 0x030507);
+		}
+		strips[s] = strip_colors[s];
+	}
+	strips[5] = NULL;
+	ws2812bBuildLut(gamma, 200, lut);
+	count = ws2812bEncodeParallel(strips, 7, LEDS, lut, words);
+	CHECK(count == WS2812B_PARALLEL_WORDS(LEDS));
+	for (s = 0; s < WS2812B_PARALLEL_STRIPS; s++){
+		memset(decoded, 0, sizeof(decoded));
+		if (strips[s] != NULL && s < 7){
+			ws2812bPackColors(strips[s], LEDS, lut, decoded);
+		}
+		for (i = 0; i < count; i++){
+			CHECK((words[i] >> s & 1) == (decoded[i / 8] >> (7 - i % 8) & 1));
+		}
+	}
+
+	printf(failed ? "%d checks failed\n" : "All checks passed\n", failed);
+	return failed ? 1 : 0;
+}
+
+/*==================[end of file]============================================*/
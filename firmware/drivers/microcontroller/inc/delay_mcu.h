@@ -14,6 +14,10 @@
  * @note All delays will block the current RTOS task, with the exception of 
  * DelayUs with usec < 50.
  *
+ * @note Short delays use a software timer of the calling task (see timer_mcu.h) and
+ * wait on a binary semaphore in its stack: several tasks can wait at the same time.
+ * Task notifications are not used, the task keeps its own.
+ *
  * @author Albano Peñalva
  *
  * @section changelog
@@ -21,6 +25,8 @@
  * |   Date	    | Description                                    						|
  * |:----------:|:----------------------------------------------------------------------|
  * | 20/10/2023 | Document creation		                         						|
+ * | 19/10/2026 | Timer shared with timer_mcu, task notifications instead of semaphore	|
+ * | 19/10/2026 | Binary semaphore per delay, task notifications left to the task		|
  * 
  **/
 
@@ -0,0 +1,129 @@
+#ifndef EVENT_MCU_H
+#define EVENT_MCU_H
+
+/** \addtogroup Drivers_Programable Drivers Programable
+ ** @{ */
+/** \addtogroup Drivers_Microcontroller Drivers microcontroller
+ ** @{ */
+/** \addtogroup Event Event
+ ** @{ */
+
+/** \brief Events posted from ISRs and handled in a task.
+ *
+ * ISRs post small events (source, timestamp, value) with EventPostFromISR() to a
+ * lock-free ring of their core (see event_ring.h). One handler task, woken by a
+ * direct task notification, takes all the pending events at once and calls the
+ * handler set for each source. Posting asks for a context switch when the handler
+ * task has a higher priority than the interrupted one, so it runs as soon as the
+ * ISR ends.
+ *
+ * @note EventPostCallback() has the signature of the driver callbacks (func_p of
+ * timer_mcu, gpio_mcu, spi_mcu...): with the source as parameter, any driver ISR
+ * posts an event with no extra code.
+ * @code
+ * void TimerHandler(const event_t *event, void *param){
+ *     // Task context: can block, print, use any driver
+ * }
+ * EventInit();
+ * EventHandlerSet(EVENT_SOURCE_USER, TimerHandler, NULL);
+ * timer_config_t timer = {TIMER_A, 1000, EventPostCallback, EVENT_PARAM(EVENT_SOURCE_USER)};
+ * TimerInit(&timer);
+ * TimerStart(TIMER_A);
+ * @endcode
+ *
+ * @note EventGetStats() reports the events dropped because the ring was full and
+ * the longest time from post to handling, the same way for every source.
+ *
+ * @author Albano Peñalva
+ *
+ * @section changelog
+ *
+ * |   Date	    | Description                                    						|
+ * |:----------:|:----------------------------------------------------------------------|
+ * | 19/10/2026 | Document creation		                         						|
+ *
+ **/
+
+/*==================[inclusions]=============================================*/
+#include <stdbool.h>
+#include <stdint.h>
+#include "event_ring.h"
+/*==================[macros]=================================================*/
+#define EVENT_SOURCES		32		/*!< Number of sources */
+#define EVENT_SOURCE_USER	16		/*!< First source free for applications, lower ones are for drivers */
+#define EVENT_TASK_PRIO		20		/*!< Priority of the handler task, above application tasks */
+#define EVENT_TASK_STACK	3072	/*!< Stack of the handler task */
+
+/**
+ * @brief Parameter of EventPostCallback() for a source
+ */
+#define EVENT_PARAM(source)	((void *)(uintptr_t)(source))
+/*==================[typedef]================================================*/
+/**
+ * @brief Function that handles the events of a source, called from the handler task
+ *
+ * @param event Event
+ * @param param Parameter given to EventHandlerSet()
+ */
+typedef void (*event_handler_t)(const event_t *event, void *param);
+
+/**
+ * @brief Dispatcher statistics
+ */
+typedef struct {
+	uint32_t posted;			/*!< Events posted */
+	uint32_t dropped;			/*!< Events lost, the ring was full */
+	uint32_t handled;			/*!< Events handled */
+	uint32_t max_latency;		/*!< Longest time from post to handler (us) */
+	uint32_t max_batch;			/*!< Most events handled in one wake-up */
+} event_stats_t;
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/**
+ * @brief Dispatcher initialization, creates the handler task
+ *
+ */
+void EventInit(void);
+
+/**
+ * @brief Set the function that handles the events of a source
+ *
+ * @param source Source, below EVENT_SOURCES
+ * @param handler Handler, NULL to ignore the source
+ * @param param Parameter of handler
+ */
+void EventHandlerSet(uint8_t source, event_handler_t handler, void *param);
+
+/**
+ * @brief Post an event from an ISR
+ *
+ * @note Placed in IRAM, it requests the context switch to the handler task
+ * (portYIELD_FROM_ISR()) when needed.
+ *
+ * @param source Source, below EVENT_SOURCES
+ * @param value Source dependent value
+ * @return false if the event was dropped
+ */
+bool EventPostFromISR(uint8_t source, uint32_t value);
+
+/**
+ * @brief Post an event with value 0, with the signature of the driver callbacks
+ *
+ * @param param Source, EVENT_PARAM(source)
+ */
+void EventPostCallback(void *param);
+
+/**
+ * @brief Read the dispatcher statistics
+ *
+ * @param stats Statistics since EventInit()
+ */
+void EventGetStats(event_stats_t *stats);
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+#endif
+
+/*==================[end of file]============================================*/
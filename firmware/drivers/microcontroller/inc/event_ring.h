@@ -0,0 +1,98 @@
+#ifndef EVENT_RING_H
+#define EVENT_RING_H
+
+/** \addtogroup Drivers_Programable Drivers Programable
+ ** @{ */
+/** \addtogroup Drivers_Microcontroller Drivers microcontroller
+ ** @{ */
+/** \addtogroup Event Event
+ ** @{ */
+
+/** \brief Lock-free ring of events, many producers (ISRs) and one consumer (a task).
+ *
+ * Each slot has a sequence number telling if it is free or holds an event for
+ * the current lap. A producer reserves a slot with one compare-and-swap on the
+ * head and publishes it by writing its sequence: an ISR interrupting another
+ * one in the middle of a post takes the next slot, the consumer waits for the
+ * first one to be published. Events are copied in and out, there is no lock and
+ * no interrupt is disabled.
+ *
+ * @note This module doesn't depend on the hardware, it can be compiled and tested
+ * on a host computer (see microcontroller/test_host).
+ *
+ * @author Albano Peñalva
+ *
+ * @section changelog
+ *
+ * |   Date	    | Description                                    						|
+ * |:----------:|:----------------------------------------------------------------------|
+ * | 19/10/2026 | Document creation		                         						|
+ *
+ **/
+
+/*==================[inclusions]=============================================*/
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+/*==================[macros]=================================================*/
+#define EVENT_RING_SIZE		64		/*!< Events per ring, power of 2 */
+/*==================[typedef]================================================*/
+/**
+ * @brief Event, posted from an ISR
+ */
+typedef struct {
+	uint8_t source;				/*!< Event source, see EventHandlerSet() */
+	uint32_t timestamp;			/*!< Time it was posted (us) */
+	uint32_t value;				/*!< Source dependent value */
+} event_t;
+
+/**
+ * @brief Ring slot
+ */
+typedef struct {
+	atomic_uint_fast32_t sequence;	/*!< Position it can be written at, plus 1 once written */
+	event_t event;					/*!< Event */
+} event_slot_t;
+
+/**
+ * @brief Ring of events
+ */
+typedef struct {
+	event_slot_t slots[EVENT_RING_SIZE];	/*!< Events */
+	atomic_uint_fast32_t head;				/*!< Next position to write */
+	uint32_t tail;							/*!< Next position to read, only used by the consumer */
+} event_ring_t;
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/**
+ * @brief Initializes an empty ring
+ *
+ * @param ring Ring
+ */
+void EventRingInit(event_ring_t *ring);
+
+/**
+ * @brief Copies an event to the ring, from any producer
+ *
+ * @param ring Ring
+ * @param event Event
+ * @return false if the ring is full, the event is dropped
+ */
+bool EventRingPush(event_ring_t *ring, const event_t *event);
+
+/**
+ * @brief Copies the oldest event out of the ring, only from the consumer
+ *
+ * @param ring Ring
+ * @param event Event
+ * @return false if there are no events published
+ */
+bool EventRingPop(event_ring_t *ring, event_t *event);
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+#endif
+
+/*==================[end of file]============================================*/
@@ -8,6 +8,9 @@
  ** @{ */
 
 /** \brief GPIO driver to use gpio ouputs with faster functions than gpio_mcu.
+ *
+ * Pins are grouped in a dedicated GPIO bundle and written together from the CPU
+ * in a few cycles, bit i of the value is the level of pin_list[i].
  * 
  * @author Albano Peñalva
  *
@@ -16,6 +19,7 @@
  * |   Date	    | Description                                    						|
  * |:----------:|:----------------------------------------------------------------------|
  * | 20/11/2023 | Document creation		                         						|
+ * | 19/10/2026 | All bundle pins written, write placed in IRAM							|
  * 
  **/
 
@@ -24,6 +28,7 @@
 #include <stdint.h>
 #include "gpio_mcu.h"
 /*==================[macros]=================================================*/
+#define GPIO_FAST_MAX_PINS	16		/*!< Pins of a bundle */
 
 /*==================[typedef]================================================*/
 
@@ -32,17 +37,19 @@
 /*==================[external functions declaration]=========================*/
 
 /**
- * @brief 
+ * @brief Configures the pins as outputs of a dedicated GPIO bundle
  * 
- * @param pin_list 
- * @param pin_qty 
+ * @param pin_list Pins, pin_list[i] is written by bit i of the value
+ * @param pin_qty Number of pins, up to GPIO_FAST_MAX_PINS
  */
 void GPIOFastInit(gpio_t *pin_list, uint8_t pin_qty);
 
 /**
- * @brief 
+ * @brief Sets the level of all the pins at once
+ * 
+ * @note Placed in IRAM, it can be called with interrupts disabled in timing critical loops.
  * 
- * @param value 
+ * @param value Bit i is the level of pin_list[i]
  */
 void GPIOFastWrite(uint16_t value);
 
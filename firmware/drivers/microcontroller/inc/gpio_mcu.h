@@ -26,6 +26,7 @@
  * |   Date	    | Description                                    						|
  * |:----------:|:----------------------------------------------------------------------|
  * | 23/10/2023 | Document creation		                         						|
+ * | 19/10/2026 | Interruption on both edges												|
  * 
  **/
 
@@ -134,6 +135,17 @@ bool GPIORead(gpio_t pin);
  */
 void GPIOActivInt(gpio_t pin, void *ptr_int_func, bool edge, void *args);
 
+/**
+ * @brief Configure GPIO input interruption on both edges
+ * 
+ * @note The callback can read the new level with GPIORead().
+ * 
+ * @param pin GPIO number
+ * @param ptr_int_func Pointer to callback function
+ * @param args 
+ */
+void GPIOActivIntAnyEdge(gpio_t pin, void *ptr_int_func, void *args);
+
 /**
  * @brief Configure an input glitch filter to a GPIO
  * 
@@ -0,0 +1,126 @@
+#ifndef RMT_MCU_H
+#define RMT_MCU_H
+/** \addtogroup Drivers_Programable Drivers Programable
+ ** @{ */
+/** \addtogroup Drivers_Microcontroller Drivers microcontroller
+ ** @{ */
+/** \addtogroup RMT RMT
+ ** @{ */
+
+/** @brief RMT transmitter driver for ESP-EDU board
+ *
+ * This driver sends waveforms described as a list of symbols (two levels and
+ * their durations) with the RMT peripheral. Timing is generated by hardware,
+ * the CPU is free during the transfer and interrupts don't change it.
+ *
+ * @note Symbols are copied to the RMT memory by the driver while they are sent,
+ * they must remain unchanged until RMTWait() returns. On chips with RMT DMA
+ * (ESP32-S3) the copy is done by DMA.
+ *
+ * @note Outputs configured with the symbols of a 0 and a 1 bit can also send bytes
+ * with RMTWriteBytes(): the RMT bytes encoder expands each bit into its symbol
+ * while the transfer runs, so only the bytes are kept in RAM.
+ *
+ * @author Albano Peñalva
+ * 
+ * @section changelog
+ *
+ * |   Date	    | Description                                    |
+ * |:----------:|:-----------------------------------------------|
+ * | 19/10/2026 | Document creation		                         |
+ * | 19/10/2026 | Bytes expanded to symbols by the bytes encoder |
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdint.h>
+#include "gpio_mcu.h"
+/*==================[macros]=================================================*/
+#define RMT_DURATION_MAX	0x7FFF		/*!< Longest duration of a level, in ticks */
+
+/**
+ * @brief Builds a symbol: level0 during duration0 ticks, then level1 during duration1 ticks
+ */
+#define RMT_SYMBOL(level0, duration0, level1, duration1) \
+	((uint32_t)(duration0) | (uint32_t)(level0) << 15 | (uint32_t)(duration1) << 16 | (uint32_t)(level1) << 31)
+/*==================[typedef]================================================*/
+/**
+ * @brief RMT outputs
+ */
+typedef enum rmt_out {
+	RMT_TX_0,		/**< RMT output 1 */
+	RMT_TX_1		/**< RMT output 2 */
+} rmt_out_t;
+
+/**
+ * @brief Two levels and their durations, same bit layout as the RMT memory
+ */
+typedef uint32_t rmt_symbol_t;
+
+/**
+ * @brief RMT output configuration structure
+ */
+typedef struct {
+	rmt_out_t out;					/*!< RMT output */
+	gpio_t pin;						/*!< GPIO pin number */
+	uint32_t resolution;			/*!< Ticks per second */
+	void *func_p;					/*!< Pointer to function called from ISR when a transfer ends, NULL if none */
+	void *param_p;					/*!< Pointer to callback parameter */
+	rmt_symbol_t bit0;				/*!< Symbol of a 0 bit for RMTWriteBytes(), 0 if bytes aren't sent */
+	rmt_symbol_t bit1;				/*!< Symbol of a 1 bit for RMTWriteBytes() */
+} rmt_mcu_config_t;
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/**
+ * @brief RMT output initialization
+ * 
+ * @note The output stays low between transfers.
+ * 
+ * @param rmt Structure with the output configuration
+ * @return uint8_t 1 when success, 0 when fails
+ */
+uint8_t RMTInit(rmt_mcu_config_t *rmt);
+
+/**
+ * @brief Starts sending symbols, without waiting for the transfer to end
+ * 
+ * @param out RMT output
+ * @param symbols Symbols, must remain unchanged until RMTWait() returns
+ * @param count Number of symbols
+ */
+void RMTWrite(rmt_out_t out, const rmt_symbol_t *symbols, uint32_t count);
+
+/**
+ * @brief Starts sending bytes, most significant bit first, without waiting for the transfer to end
+ * 
+ * @note Each bit is sent as the bit0 or bit1 symbol of the output configuration.
+ * Transfers started by RMTWrite() and RMTWriteBytes() are sent in order.
+ * 
+ * @param out RMT output, configured with bit0 and bit1 symbols
+ * @param bytes Bytes, must remain unchanged until RMTWait() returns
+ * @param count Number of bytes
+ */
+void RMTWriteBytes(rmt_out_t out, const uint8_t *bytes, uint32_t count);
+
+/**
+ * @brief Waits until every started transfer has ended
+ * 
+ * @param out RMT output
+ */
+void RMTWait(rmt_out_t out);
+
+/**
+ * @brief RMT output de-initialization
+ * 
+ * @param out RMT output
+ * @return uint8_t 1 when success, 0 when fails
+ */
+uint8_t RMTDeInit(rmt_out_t out);
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+#endif /* RMT_MCU_H */
+
+/*==================[end of file]============================================*/
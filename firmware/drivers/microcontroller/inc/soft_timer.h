@@ -0,0 +1,155 @@
+#ifndef SOFT_TIMER_H
+#define SOFT_TIMER_H
+
+/** \addtogroup Drivers_Programable Drivers Programable
+ ** @{ */
+/** \addtogroup Drivers_Microcontroller Drivers microcontroller
+ ** @{ */
+/** \addtogroup Timer Timer
+ ** @{ */
+
+/** \brief Software timers queue, ordered by expiration time.
+ *
+ * Timers are kept in a binary min-heap of pointers, the first one to expire on
+ * top: starting or stopping a timer is O(log n), the next expiration is read in
+ * O(1). Times are absolute, in us, 64 bits (they don't wrap around).
+ *
+ * The queue doesn't allocate memory nor read any clock: the caller gives it the
+ * heap array (SoftTimerQueueResize()) and the current time (SoftTimerRun()), so
+ * it can be tested on a host computer with a simulated clock (see
+ * microcontroller/test_host). timer_mcu.h runs it on a hardware timer.
+ *
+ * @author Albano Peñalva
+ *
+ * @section changelog
+ *
+ * |   Date	    | Description                                    						|
+ * |:----------:|:----------------------------------------------------------------------|
+ * | 19/10/2026 | Document creation		                         						|
+ * | 19/10/2026 | Expired timers can be taken without calling them						|
+ *
+ **/
+
+/*==================[inclusions]=============================================*/
+#include <stdbool.h>
+#include <stdint.h>
+/*==================[macros]=================================================*/
+#define SOFT_TIMER_IDLE		0xFFFF		/*!< Heap position of a timer not queued */
+/*==================[typedef]================================================*/
+/**
+ * @brief Software timer
+ */
+typedef struct {
+	uint64_t expiry;			/*!< Expiration time (us) */
+	uint32_t period;			/*!< Period (us), 0 for one-shot */
+	void (*func_p)(void *);		/*!< Function called when the timer expires */
+	void *param_p;				/*!< Parameter of func_p */
+	uint16_t index;				/*!< Position in the heap, SOFT_TIMER_IDLE if not queued */
+} soft_timer_t;
+
+/**
+ * @brief Queue of running timers
+ */
+typedef struct {
+	soft_timer_t **heap;		/*!< Running timers, heap[0] expires first */
+	uint16_t count;				/*!< Running timers */
+	uint16_t size;				/*!< Heap capacity */
+} soft_timer_queue_t;
+/*==================[external data declaration]==============================*/
+
+/*==================[external functions declaration]=========================*/
+/**
+ * @brief Initializes an empty queue
+ *
+ * @param queue Queue
+ * @param heap Memory for size timer pointers
+ * @param size Maximum number of running timers
+ */
+void SoftTimerQueueInit(soft_timer_queue_t *queue, soft_timer_t **heap, uint16_t size);
+
+/**
+ * @brief Moves the queue to a new heap array
+ *
+ * @param queue Queue
+ * @param heap Memory for size timer pointers, at least the running timers
+ * @param size New maximum number of running timers
+ * @return soft_timer_t** Previous heap array, to be freed by the caller. NULL if size is too small.
+ */
+soft_timer_t ** SoftTimerQueueResize(soft_timer_queue_t *queue, soft_timer_t **heap, uint16_t size);
+
+/**
+ * @brief Initializes a stopped timer
+ *
+ * @param timer Timer
+ * @param func_p Function called when the timer expires
+ * @param param_p Parameter of func_p
+ */
+void SoftTimerInit(soft_timer_t *timer, void (*func_p)(void *), void *param_p);
+
+/**
+ * @brief Starts a timer, or restarts it if it was running
+ *
+ * @param queue Queue
+ * @param timer Timer
+ * @param expiry Expiration time (us)
+ * @param period Period (us) after the first expiration, 0 for one-shot
+ * @return true if the timer is the first to expire, false if not or if the queue is full
+ */
+bool SoftTimerStart(soft_timer_queue_t *queue, soft_timer_t *timer, uint64_t expiry, uint32_t period);
+
+/**
+ * @brief Stops a timer, if it was running
+ *
+ * @param queue Queue
+ * @param timer Timer
+ */
+void SoftTimerStop(soft_timer_queue_t *queue, soft_timer_t *timer);
+
+/**
+ * @brief Checks if a timer is running
+ *
+ * @param timer Timer
+ * @return true if it is in a queue
+ */
+bool SoftTimerRunning(const soft_timer_t *timer);
+
+/**
+ * @brief Gets the expiration time of the first timer
+ *
+ * @param queue Queue
+ * @param expiry Expiration time (us)
+ * @return false if no timer is running
+ */
+bool SoftTimerNext(const soft_timer_queue_t *queue, uint64_t *expiry);
+
+/**
+ * @brief Takes the first expired timer, without calling its function
+ *
+ * @note Periodic timers are started again for their next period, as SoftTimerRun()
+ * does. The caller can then call the function outside of its critical section.
+ *
+ * @param queue Queue
+ * @param now Current time (us)
+ * @return soft_timer_t* Expired timer, NULL if none expired
+ */
+soft_timer_t * SoftTimerPop(soft_timer_queue_t *queue, uint64_t now);
+
+/**
+ * @brief Calls the functions of the expired timers, in expiration order
+ *
+ * @note Periodic timers are started again before their function is called (it can
+ * stop or restart them) and keep their phase: if several periods were missed the
+ * function is called once.
+ *
+ * @param queue Queue
+ * @param now Current time (us)
+ * @return uint32_t Number of functions called
+ */
+uint32_t SoftTimerRun(soft_timer_queue_t *queue, uint64_t now);
+
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+/** @} doxygen end group definition */
+#endif
+
+/*==================[end of file]============================================*/
@@ -21,12 +21,14 @@
  * |   Date	    | Description                                    						|
  * |:----------:|:----------------------------------------------------------------------|
  * | 09/02/2024 | Document creation		                         						|
+ * | 19/10/2026 | Persistent device handles and queued write transactions				|
  * 
  **/
 /*==================[inclusions]=============================================*/
 #include <stdbool.h>
 #include <stdint.h>
 /*==================[macros]=================================================*/
+#define SPI_QUEUE_SIZE	8		/*!< Maximum number of queued transactions per device */
 
 /*==================[typedef]================================================*/
 
@@ -68,6 +70,8 @@ typedef struct{
 	transfer_mode_t transfer_mode;	/*!< Transfer mode */
 	void *func_p;					/*!< Pointer to callback function for transaction end */
 	void *param_p;					/*!< Pointer to callback parameter */
+	void *pre_func_p;				/*!< Pointer to callback function called before each transaction, receives the transaction user data */
+	void *post_func_p;				/*!< Pointer to callback function called after each transaction, receives the transaction user data */
 } spi_mcu_config_t;
 /*==================[external data declaration]==============================*/
 
@@ -75,6 +79,9 @@ typedef struct{
 /**
  * @brief Initialize SPI module with the corresponding configuration
  * 
+ * @note The device is added to the bus once and its handle is kept until SpiDeInit(). 
+ * Calling it again on an initialized device re-configures it.
+ * 
  * @param spi Structure with the module configuration
  * @return uint8_t 
  */
@@ -108,6 +115,36 @@ void SpiWrite(spi_dev_t device, uint8_t * tx_buffer, uint32_t tx_buffer_size);
  */
 void SpiReadWrite(spi_dev_t device, uint8_t * tx_buffer, uint8_t * rx_buffer, uint32_t buffer_size);
 
+/**
+ * @brief Queue a write transaction on SPI port without waiting for it to end
+ * 
+ * @note Up to SPI_QUEUE_SIZE transactions can be in flight, when the queue is full 
+ * the oldest one is waited for. Buffers of up to 4 bytes are copied into the 
+ * transaction, longer ones must remain unchanged until SpiWaitQueue() returns.
+ * 
+ * @param device SPI device to write to
+ * @param tx_buffer pointer to buffer where data is stored
+ * @param tx_buffer_size numbers of bytes to write
+ * @param user data passed to the pre and post transaction callbacks
+ * @return uint32_t number of the transaction, to be used with SpiWaitTransaction()
+ */
+uint32_t SpiQueueWrite(spi_dev_t device, const uint8_t * tx_buffer, uint32_t tx_buffer_size, void * user);
+
+/**
+ * @brief Wait until a queued transaction, and every one queued before it, have ended
+ *
+ * @param device SPI device
+ * @param transaction number returned by SpiQueueWrite()
+ */
+void SpiWaitTransaction(spi_dev_t device, uint32_t transaction);
+
+/**
+ * @brief Wait until all queued transactions of a device have ended
+ * 
+ * @param device SPI device
+ */
+void SpiWaitQueue(spi_dev_t device);
+
 /**
  * @brief De-Initialize SPI module with the corresponding configuration
  * 
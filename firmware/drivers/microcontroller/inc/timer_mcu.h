@@ -9,6 +9,20 @@
  ** @{ */
 
 /** \brief Timer driver for the ESP-EDU Board.
+ *
+ * @note All timers run on a single hardware timer, counting us since the first
+ * one was initialized. Software timers (soft_timer.h) are kept ordered by
+ * expiration and the hardware alarm is set, one-shot, at the first one: any
+ * number of periodic or one-shot timers can be used (TimerSoftInit()).
+ * TIMER_A, TIMER_B and TIMER_C are software timers with a count of their own.
+ *
+ * @note Timer functions are called from the timer ISR, in expiration order.
+ * They must be short and placed in IRAM (IRAM_ATTR).
+ * @code
+ * soft_timer_t blink;
+ * TimerSoftInit(&blink, BlinkFunc, NULL);
+ * TimerSoftStart(&blink, 0, 500000);		// Every 500 ms from now
+ * @endcode
  * 
  * @author Albano Peñalva
  *
@@ -17,11 +31,15 @@
  * |   Date	    | Description                                    						|
  * |:----------:|:----------------------------------------------------------------------|
  * | 20/10/2023 | Document creation		                         						|
+ * | 19/10/2026 | Any number of software timers on one hardware timer					|
+ * | 19/10/2026 | Timer functions called outside of the lock, TimerYieldFromISR()		|
  * 
  **/
 
 /*==================[inclusions]=============================================*/
+#include <stdbool.h>
 #include "stdint.h"
+#include "soft_timer.h"
 /*==================[macros]=================================================*/
 
 /*==================[typedef]================================================*/
@@ -98,6 +116,66 @@ void TimerReset(timer_mcu_t timer);
  */
 void TimerUpdatePeriod(timer_mcu_t timer, uint32_t period);
 
+/**
+ * @brief Software timer initialization
+ *
+ * @note Call it once per timer, not from an ISR: it reserves the memory the timer
+ * needs to run. Timers are stopped after init.
+ *
+ * @param timer Timer, it must exist while it runs
+ * @param func_p Function called when the timer expires, from the timer ISR
+ * @param param_p Parameter of func_p
+ * @return false if there isn't memory for one more timer
+ */
+bool TimerSoftInit(soft_timer_t *timer, void (*func_p)(void *), void *param_p);
+
+/**
+ * @brief Software timer release
+ *
+ * @note Stops the timer and gives back what TimerSoftInit() reserved, so timers
+ * on the stack can be initialized on each use.
+ *
+ * @param timer Timer
+ */
+void TimerSoftDeInit(soft_timer_t *timer);
+
+/**
+ * @brief Start a software timer, or restart it if it was running
+ *
+ * @note It can be called from timer functions.
+ *
+ * @param timer Timer
+ * @param delay Time to the first expiration (in us)
+ * @param period Time between the next expirations (in us), 0 to expire once
+ * @return false if the timer couldn't be started (not initialized with TimerSoftInit())
+ */
+bool TimerSoftStart(soft_timer_t *timer, uint32_t delay, uint32_t period);
+
+/**
+ * @brief Asks for a context switch when the timer ISR ends
+ *
+ * @note Call it from a timer function that wakes a task with a FreeRTOS
+ * ...FromISR() function, with the value it gave to pxHigherPriorityTaskWoken.
+ * Timer functions are called outside of the driver critical section.
+ *
+ * @param woken true if a task of higher priority than the running one was woken
+ */
+void TimerYieldFromISR(bool woken);
+
+/**
+ * @brief Stop a software timer
+ *
+ * @param timer Timer
+ */
+void TimerSoftStop(soft_timer_t *timer);
+
+/**
+ * @brief Read the time base of all timers
+ *
+ * @return Time since the first timer was initialized (in us)
+ */
+uint64_t TimerNow(void);
+
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
 /** @} doxygen end group definition */
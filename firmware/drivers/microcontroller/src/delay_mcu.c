@@ -11,31 +11,67 @@
 
 /*==================[inclusions]=============================================*/
 #include "delay_mcu.h"
-#include "driver/gptimer.h"
+#include "timer_mcu.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/semphr.h"
 #include "esp_rom_sys.h"
+#include "esp_attr.h"
 /*==================[macros and definitions]=================================*/
-#define US_RESOLUTION_HZ	1000000	/*!< 1usec */
 #define MSEC				1000	/*!< 1msec = 1000usec */
 #define SEC					1000000	/*!< 1sec = 1000msec */
-#define MIN_US				50	    /*!< minimun delay in usec to use gptimer */
+#define MIN_US				50	    /*!< minimun delay in usec to use the timer */
 #define MIN_MS				100	    /*!< minimun delay in msec to use vTaskDelay */
 /*==================[internal data declaration]==============================*/
-SemaphoreHandle_t xDelaySemaphore = NULL;
 /*==================[internal functions declaration]=========================*/
-static bool IRAM_ATTR delay_isr(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_data){
-	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-	gptimer_stop(timer);
-	xSemaphoreGiveFromISR(xDelaySemaphore, &xHigherPriorityTaskWoken);
-	return (xHigherPriorityTaskWoken == pdTRUE);
-}
+/**
+ * @brief Wakes the waiting task, called from the timer ISR
+ *
+ * @param param Semaphore the task waits on
+ */
+static void IRAM_ATTR DelayWake(void *param);
+
+/**
+ * @brief Blocks the calling task for a time, with a software timer of its own
+ *
+ * @param usec Delay in us
+ */
+static void DelayWait(uint32_t usec);
+
 /*==================[internal data definition]===============================*/
 
 /*==================[external data definition]===============================*/
 
 /*==================[internal functions definition]==========================*/
+static void IRAM_ATTR DelayWake(void *param){
+	BaseType_t task_woken = pdFALSE;
+
+	xSemaphoreGiveFromISR((SemaphoreHandle_t)param, &task_woken);
+	/* Timer ISR asks for a context switch when it ends */
+	TimerYieldFromISR(task_woken == pdTRUE);
+}
+
+static void DelayWait(uint32_t usec){
+	/* Binary semaphore of this delay only, the task's notifications are left alone */
+	StaticSemaphore_t wait_buffer;
+	SemaphoreHandle_t wait = xSemaphoreCreateBinaryStatic(&wait_buffer);
+	soft_timer_t timer;
+
+	if (!TimerSoftInit(&timer, DelayWake, wait)){
+		vSemaphoreDelete(wait);
+		esp_rom_delay_us(usec);
+		return;
+	}
+	if (!TimerSoftStart(&timer, usec, 0)){
+		TimerSoftDeInit(&timer);
+		vSemaphoreDelete(wait);
+		esp_rom_delay_us(usec);
+		return;
+	}
+	xSemaphoreTake(wait, portMAX_DELAY);
+	TimerSoftDeInit(&timer);
+	vSemaphoreDelete(wait);
+}
 
 /*==================[external functions definition]==========================*/
 void DelaySec(uint16_t sec){
@@ -43,35 +79,10 @@ void DelaySec(uint16_t sec){
 }
 
 void DelayMs(uint16_t msec){
-    // If the delay is too short, use the ESP32's internal timer
-    if(msec<=MIN_MS){ 
-        if(xDelaySemaphore == NULL){
-            xDelaySemaphore = xSemaphoreCreateBinary();
-            gptimer_handle_t delay_timer = NULL;
-            gptimer_config_t delay_timer_config = {
-                .clk_src = GPTIMER_CLK_SRC_DEFAULT,
-                .direction = GPTIMER_COUNT_UP,
-                .resolution_hz = US_RESOLUTION_HZ,
-            };
-            gptimer_new_timer(&delay_timer_config, &delay_timer);
-            gptimer_event_callbacks_t delay_alarm = {
-                .on_alarm = delay_isr,
-            };
-            gptimer_register_event_callbacks(delay_timer, &delay_alarm, NULL);
-            gptimer_enable(delay_timer);
-            gptimer_alarm_config_t alarm_config = {
-                .alarm_count = msec*MSEC, 
-            };
-            gptimer_set_alarm_action(delay_timer, &alarm_config);
-            gptimer_start(delay_timer);
-            if(xDelaySemaphore != NULL){
-                xSemaphoreTake(xDelaySemaphore, portMAX_DELAY);
-                xDelaySemaphore = NULL;
-            }
-            gptimer_disable(delay_timer);
-            gptimer_del_timer(delay_timer);
-        }
-    }else{       
+    if(msec<=MIN_MS){
+        /* If the delay is too short, use a timer */
+        DelayWait((uint32_t)msec * MSEC);
+    }else{
         // If the delay is longer than the minimum delay, use vTaskDelay
         vTaskDelay(msec / portTICK_PERIOD_MS);
     }
@@ -82,34 +93,9 @@ void DelayUs(uint16_t usec){
         /* If the delay is too short, use the ROM delay function */
         esp_rom_delay_us(usec);
     }else{
-        /* If the delay is longer than the minimum, use the ESP32's internal timer */
-        if(xDelaySemaphore == NULL){
-	        xDelaySemaphore = xSemaphoreCreateBinary();
-            gptimer_handle_t delay_timer = NULL;
-            gptimer_config_t delay_timer_config = {
-                .clk_src = GPTIMER_CLK_SRC_DEFAULT,
-                .direction = GPTIMER_COUNT_UP,
-                .resolution_hz = US_RESOLUTION_HZ,
-            };
-            gptimer_new_timer(&delay_timer_config, &delay_timer);
-            gptimer_event_callbacks_t delay_alarm = {
-                .on_alarm = delay_isr,
-            };
-            gptimer_register_event_callbacks(delay_timer, &delay_alarm, NULL);
-            gptimer_enable(delay_timer);
-            gptimer_alarm_config_t alarm_config = {
-                .alarm_count = usec, 
-            };
-            gptimer_set_alarm_action(delay_timer, &alarm_config);
-            gptimer_start(delay_timer);
-            if(xDelaySemaphore != NULL){
-                /* Wait for the timer to finish */
-                xSemaphoreTake(xDelaySemaphore, portMAX_DELAY);
-                xDelaySemaphore = NULL;
-            }
-            gptimer_disable(delay_timer);
-            gptimer_del_timer(delay_timer);
-        }
+        /* If the delay is longer than the minimum, use a timer */
+        DelayWait(usec);
     }
 }
 
+/*==================[end of file]============================================*/
@@ -0,0 +1,135 @@
+/**
+ * @file event_mcu.c
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include "event_mcu.h"
+#include <stddef.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_attr.h"
+#include "esp_cpu.h"
+#include "esp_timer.h"
+/*==================[macros and definitions]=================================*/
+#define EVENT_RINGS		portNUM_PROCESSORS	/*!< One ring per core, ISRs of a core only post to its ring */
+/*==================[internal data declaration]==============================*/
+/**
+ * @brief Handler of a source
+ */
+typedef struct {
+	event_handler_t handler;	/*!< Function, NULL if none */
+	void *param;				/*!< Parameter of handler */
+} event_source_t;
+
+static event_ring_t event_rings[EVENT_RINGS];
+static event_source_t event_sources[EVENT_SOURCES];
+static TaskHandle_t event_task_handle = NULL;		/*!< Handler task */
+static atomic_uint_fast32_t event_posted;			/*!< Counted from ISRs */
+static atomic_uint_fast32_t event_dropped;			/*!< Counted from ISRs */
+static event_stats_t event_stats;					/*!< Counted by the handler task */
+/*==================[internal functions declaration]=========================*/
+/**
+ * @brief Handler task: on each notification handles all the pending events
+ *
+ * @param param Not used
+ */
+static void EventTask(void *param);
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static void EventTask(void *param){
+	event_source_t *source;
+	event_t event;
+	uint32_t batch, latency;
+	uint8_t ring;
+
+	while (true){
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+		/* Events posted while these are handled are taken in the same batch */
+		batch = 0;
+		for (ring = 0; ring < EVENT_RINGS; ring++){
+			while (EventRingPop(&event_rings[ring], &event)){
+				latency = (uint32_t)esp_timer_get_time() - event.timestamp;
+				if (latency > event_stats.max_latency){
+					event_stats.max_latency = latency;
+				}
+				source = &event_sources[event.source];
+				if (source->handler != NULL){
+					source->handler(&event, source->param);
+				}
+				batch++;
+			}
+		}
+		event_stats.handled += batch;
+		if (batch > event_stats.max_batch){
+			event_stats.max_batch = batch;
+		}
+	}
+}
+
+/*==================[external functions definition]==========================*/
+void EventInit(void){
+	uint8_t ring;
+
+	if (event_task_handle != NULL){
+		return;
+	}
+	for (ring = 0; ring < EVENT_RINGS; ring++){
+		EventRingInit(&event_rings[ring]);
+	}
+	atomic_init(&event_posted, 0);
+	atomic_init(&event_dropped, 0);
+	xTaskCreate(EventTask, "event_task", EVENT_TASK_STACK, NULL, EVENT_TASK_PRIO, &event_task_handle);
+}
+
+void EventHandlerSet(uint8_t source, event_handler_t handler, void *param){
+	if (source >= EVENT_SOURCES){
+		return;
+	}
+	/* Parameter first, the task may read the source meanwhile */
+	event_sources[source].handler = NULL;
+	event_sources[source].param = param;
+	event_sources[source].handler = handler;
+}
+
+bool IRAM_ATTR EventPostFromISR(uint8_t source, uint32_t value){
+	BaseType_t task_woken = pdFALSE;
+	event_t event = {
+		.source = source,
+		.timestamp = (uint32_t)esp_timer_get_time(),
+		.value = value,
+	};
+
+	if (source >= EVENT_SOURCES || event_task_handle == NULL ||
+		!EventRingPush(&event_rings[esp_cpu_get_core_id()], &event)){
+		atomic_fetch_add_explicit(&event_dropped, 1, memory_order_relaxed);
+		return false;
+	}
+	atomic_fetch_add_explicit(&event_posted, 1, memory_order_relaxed);
+	vTaskNotifyGiveFromISR(event_task_handle, &task_woken);
+	/* Switch to the handler task when the ISR ends, not at the next tick */
+	portYIELD_FROM_ISR(task_woken);
+	return true;
+}
+
+void IRAM_ATTR EventPostCallback(void *param){
+	EventPostFromISR((uint8_t)(uintptr_t)param, 0);
+}
+
+void EventGetStats(event_stats_t *stats){
+	*stats = event_stats;
+	stats->posted = atomic_load(&event_posted);
+	stats->dropped = atomic_load(&event_dropped);
+}
+
+/*==================[end of file]============================================*/
@@ -0,0 +1,78 @@
+/**
+ * @file event_ring.c
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include "event_ring.h"
+/*==================[macros and definitions]=================================*/
+#define RING_MASK	(EVENT_RING_SIZE - 1)
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+
+/*==================[external functions definition]==========================*/
+void EventRingInit(event_ring_t *ring){
+	uint32_t i;
+
+	for (i = 0; i < EVENT_RING_SIZE; i++){
+		atomic_init(&ring->slots[i].sequence, i);
+	}
+	atomic_init(&ring->head, 0);
+	ring->tail = 0;
+}
+
+bool EventRingPush(event_ring_t *ring, const event_t *event){
+	uint_fast32_t position = atomic_load_explicit(&ring->head, memory_order_relaxed);
+	event_slot_t *slot;
+	int32_t lap;
+
+	while (true){
+		slot = &ring->slots[position & RING_MASK];
+		lap = (int32_t)(uint32_t)(atomic_load_explicit(&slot->sequence, memory_order_acquire) - position);
+		if (lap == 0){
+			/* Free for this position: reserve it, or retry if another producer did */
+			if (atomic_compare_exchange_weak_explicit(&ring->head, &position, position + 1,
+					memory_order_relaxed, memory_order_relaxed)){
+				break;
+			}
+		}
+		else if (lap < 0){
+			/* Not read yet since the last lap */
+			return false;
+		}
+		else{
+			position = atomic_load_explicit(&ring->head, memory_order_relaxed);
+		}
+	}
+	slot->event = *event;
+	atomic_store_explicit(&slot->sequence, position + 1, memory_order_release);
+	return true;
+}
+
+bool EventRingPop(event_ring_t *ring, event_t *event){
+	event_slot_t *slot = &ring->slots[ring->tail & RING_MASK];
+
+	if ((uint32_t)atomic_load_explicit(&slot->sequence, memory_order_acquire) != (uint32_t)(ring->tail + 1)){
+		return false;
+	}
+	*event = slot->event;
+	/* Free for the next lap */
+	atomic_store_explicit(&slot->sequence, ring->tail + EVENT_RING_SIZE, memory_order_release);
+	ring->tail++;
+	return true;
+}
+
+/*==================[end of file]============================================*/
@@ -16,11 +16,15 @@
 #include <string.h>
 #include "driver/gpio.h"
 #include "driver/dedic_gpio.h"
+#include "hal/dedic_gpio_cpu_ll.h"
+#include "esp_attr.h"
 /*==================[macros and definitions]=================================*/
 
 /*==================[internal data declaration]==============================*/
 dedic_gpio_bundle_handle_t bundleA = NULL;
-int bundleA_gpios[16];
+int bundleA_gpios[GPIO_FAST_MAX_PINS];
+static uint32_t bundleA_mask = 0;		/*!< CPU output channels of the bundle */
+static uint32_t bundleA_offset = 0;		/*!< First CPU output channel of the bundle */
 /*==================[internal functions declaration]=========================*/
 
 /*==================[internal data definition]===============================*/
@@ -32,7 +36,13 @@ int bundleA_gpios[16];
 /*==================[external functions definition]==========================*/
 
 void GPIOFastInit(gpio_t *pin_list, uint8_t pin_qty){
-    memcpy(bundleA_gpios, pin_list, pin_qty);
+    if (pin_qty > GPIO_FAST_MAX_PINS) {
+        pin_qty = GPIO_FAST_MAX_PINS;
+    }
+    /* gpio_t and int may have different sizes, pins are copied one by one */
+    for (int i = 0; i < pin_qty; i++) {
+        bundleA_gpios[i] = pin_list[i];
+    }
     gpio_config_t io_conf = {
         .mode = GPIO_MODE_OUTPUT,
     };
@@ -49,10 +59,13 @@ void GPIOFastInit(gpio_t *pin_list, uint8_t pin_qty){
         },
     };
     ESP_ERROR_CHECK(dedic_gpio_new_bundle(&bundleA_config, &bundleA));
+    ESP_ERROR_CHECK(dedic_gpio_get_out_offset(bundleA, &bundleA_offset));
+    bundleA_mask = ((1UL << pin_qty) - 1) << bundleA_offset;
 }
 
-void GPIOFastWrite(uint16_t value){
-    dedic_gpio_bundle_write(bundleA, 0xFF, value);
+void IRAM_ATTR GPIOFastWrite(uint16_t value){
+    /* Same as dedic_gpio_bundle_write(), without the call */
+    dedic_gpio_cpu_ll_write_mask(bundleA_mask, (uint32_t)value << bundleA_offset);
 }
 
 /*==================[end of file]============================================*/
\ No newline at end of file
@@ -26,6 +26,14 @@ typedef struct{
 /*==================[internal data declaration]==============================*/
 
 /*==================[internal functions declaration]=========================*/
+/**
+ * @brief Adds a GPIO interruption callback, installs the ISR service on first use
+ * 
+ * @param pin GPIO number
+ * @param ptr_int_func Pointer to callback function
+ * @param args 
+ */
+static void GPIOIsrAdd(gpio_t pin, void *ptr_int_func, void *args);
 
 /*==================[internal data definition]===============================*/
 digital_io_t gpio_list[GPIO_QTY] = {
@@ -62,6 +70,14 @@ gpio_flex_glitch_filter_config_t filter_config = {
 /*==================[external data definition]===============================*/
 
 /*==================[internal functions definition]==========================*/
+static void GPIOIsrAdd(gpio_t pin, void *ptr_int_func, void *args){
+	static bool isr_service_installed = false;
+	if(!isr_service_installed){	
+		gpio_install_isr_service(0);
+		isr_service_installed = true;
+	}
+    gpio_isr_handler_add(gpio_list[pin].pin, ptr_int_func, (void *)args);	
+}
 
 /*==================[external functions definition]==========================*/
 void GPIOInit(gpio_t pin, io_t io){
@@ -103,17 +119,17 @@ bool GPIORead(gpio_t pin){
 }
 
 void GPIOActivInt(gpio_t pin, void *ptr_int_func, bool edge, void *args){
-	static bool isr_service_installed = false;
 	if(edge){
 		gpio_set_intr_type(gpio_list[pin].pin, GPIO_INTR_POSEDGE);
 	} else{
 		gpio_set_intr_type(gpio_list[pin].pin, GPIO_INTR_NEGEDGE);
 	}
-	if(!isr_service_installed){	
-		gpio_install_isr_service(0);
-		isr_service_installed = true;
-	}
-    gpio_isr_handler_add(gpio_list[pin].pin, ptr_int_func, (void *)args);	
+	GPIOIsrAdd(pin, ptr_int_func, args);
+}
+
+void GPIOActivIntAnyEdge(gpio_t pin, void *ptr_int_func, void *args){
+	gpio_set_intr_type(gpio_list[pin].pin, GPIO_INTR_ANYEDGE);
+	GPIOIsrAdd(pin, ptr_int_func, args);
 }
 
 void GPIOInputFilter(gpio_t pin){
@@ -0,0 +1,139 @@
+/**
+ * @file rmt_mcu.c
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief 
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+/*==================[inclusions]=============================================*/
+#include "rmt_mcu.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include "driver/rmt_tx.h"
+#include "esp_attr.h"
+#include "soc/soc_caps.h"
+/*==================[macros and definitions]=================================*/
+#define RMT_OUTPUTS			2		/*!< Number of RMT outputs */
+#define RMT_QUEUE_SIZE		4		/*!< Transfers that can be started before the first one ends */
+#if SOC_RMT_SUPPORT_DMA
+#define RMT_MEM_SYMBOLS		1024	/*!< DMA buffer, in symbols */
+#else
+#define RMT_MEM_SYMBOLS		SOC_RMT_MEM_WORDS_PER_CHANNEL	/*!< RMT memory block, refilled by the driver ISR */
+#endif
+/*==================[internal data declaration]==============================*/
+static rmt_channel_handle_t rmt_channel[RMT_OUTPUTS];		/*!< Channel of each output */
+static rmt_encoder_handle_t rmt_encoder[RMT_OUTPUTS];		/*!< Copy encoder of each output */
+static rmt_encoder_handle_t rmt_bytes_encoder[RMT_OUTPUTS];	/*!< Bytes encoder of each output, NULL if none */
+static void (*rmt_isr_p[RMT_OUTPUTS])(void*);				/*!< Transfer end callbacks */
+static void *rmt_user_data[RMT_OUTPUTS];					/*!< Transfer end callbacks parameter */
+/*==================[internal functions declaration]=========================*/
+/**
+ * @brief Called from RMT ISR when a transfer ends
+ * 
+ * @param channel RMT channel
+ * @param edata Event data
+ * @param user_ctx RMT output
+ * @return false, no task was woken
+ */
+static bool IRAM_ATTR RMTDone(rmt_channel_handle_t channel, const rmt_tx_done_event_data_t *edata, void *user_ctx);
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static bool IRAM_ATTR RMTDone(rmt_channel_handle_t channel, const rmt_tx_done_event_data_t *edata, void *user_ctx){
+	rmt_out_t out = (rmt_out_t)user_ctx;
+
+	if (rmt_isr_p[out] != NULL){
+		rmt_isr_p[out](rmt_user_data[out]);
+	}
+	return false;
+}
+
+/*==================[external functions definition]==========================*/
+uint8_t RMTInit(rmt_mcu_config_t *rmt){
+	rmt_tx_channel_config_t channel_cfg = {
+		.gpio_num = rmt->pin,
+		.clk_src = RMT_CLK_SRC_DEFAULT,
+		.resolution_hz = rmt->resolution,
+		.mem_block_symbols = RMT_MEM_SYMBOLS,
+		.trans_queue_depth = RMT_QUEUE_SIZE,
+#if SOC_RMT_SUPPORT_DMA
+		.flags.with_dma = true,
+#endif
+	};
+	rmt_copy_encoder_config_t encoder_cfg = {};
+	rmt_bytes_encoder_config_t bytes_cfg = {
+		.bit0.val = rmt->bit0,
+		.bit1.val = rmt->bit1,
+		.flags.msb_first = true,
+	};
+	rmt_tx_event_callbacks_t callbacks = {
+		.on_trans_done = RMTDone,
+	};
+
+	/* Initializing again re-configures the output */
+	if (rmt_channel[rmt->out] != NULL){
+		RMTDeInit(rmt->out);
+	}
+	rmt_isr_p[rmt->out] = rmt->func_p;
+	rmt_user_data[rmt->out] = rmt->param_p;
+	if (rmt_new_tx_channel(&channel_cfg, &rmt_channel[rmt->out]) != ESP_OK){
+		rmt_channel[rmt->out] = NULL;
+		return 0;
+	}
+	rmt_new_copy_encoder(&encoder_cfg, &rmt_encoder[rmt->out]);
+	if (rmt->bit0 != 0 && rmt_new_bytes_encoder(&bytes_cfg, &rmt_bytes_encoder[rmt->out]) != ESP_OK){
+		rmt_bytes_encoder[rmt->out] = NULL;
+	}
+	rmt_tx_register_event_callbacks(rmt_channel[rmt->out], &callbacks, (void *)rmt->out);
+	rmt_enable(rmt_channel[rmt->out]);
+	return 1;
+}
+
+void RMTWrite(rmt_out_t out, const rmt_symbol_t *symbols, uint32_t count){
+	rmt_transmit_config_t transmit_cfg = {
+		.loop_count = 0,
+	};
+
+	rmt_transmit(rmt_channel[out], rmt_encoder[out], symbols, count * sizeof(rmt_symbol_t), &transmit_cfg);
+}
+
+void RMTWriteBytes(rmt_out_t out, const uint8_t *bytes, uint32_t count){
+	rmt_transmit_config_t transmit_cfg = {
+		.loop_count = 0,
+	};
+
+	if (rmt_bytes_encoder[out] == NULL){
+		return;
+	}
+	rmt_transmit(rmt_channel[out], rmt_bytes_encoder[out], bytes, count, &transmit_cfg);
+}
+
+void RMTWait(rmt_out_t out){
+	rmt_tx_wait_all_done(rmt_channel[out], -1);
+}
+
+uint8_t RMTDeInit(rmt_out_t out){
+	if (rmt_channel[out] == NULL){
+		return 0;
+	}
+	RMTWait(out);
+	rmt_disable(rmt_channel[out]);
+	rmt_del_channel(rmt_channel[out]);
+	rmt_del_encoder(rmt_encoder[out]);
+	if (rmt_bytes_encoder[out] != NULL){
+		rmt_del_encoder(rmt_bytes_encoder[out]);
+	}
+	rmt_channel[out] = NULL;
+	rmt_encoder[out] = NULL;
+	rmt_bytes_encoder[out] = NULL;
+	return 1;
+}
+
+/*==================[end of file]============================================*/
@@ -0,0 +1,188 @@
+/**
+ * @file soft_timer.c
+ * @author Albano Peñalva (albano.penalva@uner.edu.ar)
+ * @brief
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include "soft_timer.h"
+#include <stddef.h>
+/*==================[macros and definitions]=================================*/
+#define PARENT(i)	(((i) - 1) / 2)
+#define LEFT(i)		(2 * (i) + 1)
+/*==================[internal data declaration]==============================*/
+
+/*==================[internal functions declaration]=========================*/
+/**
+ * @brief Places a timer at a heap position
+ */
+static inline void Place(soft_timer_queue_t *queue, soft_timer_t *timer, uint16_t index);
+
+/**
+ * @brief Moves the timer at index up while it expires before its parent
+ */
+static void SiftUp(soft_timer_queue_t *queue, uint16_t index);
+
+/**
+ * @brief Moves the timer at index down while a child expires before it
+ */
+static void SiftDown(soft_timer_queue_t *queue, uint16_t index);
+
+/**
+ * @brief Removes the timer at index
+ */
+static void Remove(soft_timer_queue_t *queue, uint16_t index);
+
+/*==================[internal data definition]===============================*/
+
+/*==================[external data definition]===============================*/
+
+/*==================[internal functions definition]==========================*/
+static inline void Place(soft_timer_queue_t *queue, soft_timer_t *timer, uint16_t index){
+	queue->heap[index] = timer;
+	timer->index = index;
+}
+
+static void SiftUp(soft_timer_queue_t *queue, uint16_t index){
+	soft_timer_t *timer = queue->heap[index];
+
+	while (index > 0 && timer->expiry < queue->heap[PARENT(index)]->expiry){
+		Place(queue, queue->heap[PARENT(index)], index);
+		index = PARENT(index);
+	}
+	Place(queue, timer, index);
+}
+
+static void SiftDown(soft_timer_queue_t *queue, uint16_t index){
+	soft_timer_t *timer = queue->heap[index];
+	uint16_t child;
+
+	while ((child = LEFT(index)) < queue->count){
+		/* Earliest child */
+		if (child + 1 < queue->count && queue->heap[child + 1]->expiry < queue->heap[child]->expiry){
+			child++;
+		}
+		if (queue->heap[child]->expiry >= timer->expiry){
+			break;
+		}
+		Place(queue, queue->heap[child], index);
+		index = child;
+	}
+	Place(queue, timer, index);
+}
+
+static void Remove(soft_timer_queue_t *queue, uint16_t index){
+	soft_timer_t *last = queue->heap[--queue->count];
+
+	queue->heap[index]->index = SOFT_TIMER_IDLE;
+	if (index < queue->count){
+		/* Last timer takes the place, it may go either way */
+		Place(queue, last, index);
+		SiftUp(queue, index);
+		SiftDown(queue, last->index);
+	}
+}
+
+/*==================[external functions definition]==========================*/
+void SoftTimerQueueInit(soft_timer_queue_t *queue, soft_timer_t **heap, uint16_t size){
+	queue->heap = heap;
+	queue->count = 0;
+	queue->size = size;
+}
+
+soft_timer_t ** SoftTimerQueueResize(soft_timer_queue_t *queue, soft_timer_t **heap, uint16_t size){
+	soft_timer_t **previous = queue->heap;
+	uint16_t i;
+
+	if (size < queue->count){
+		return NULL;
+	}
+	for (i = 0; i < queue->count; i++){
+		heap[i] = previous[i];
+	}
+	queue->heap = heap;
+	queue->size = size;
+	return previous;
+}
+
+void SoftTimerInit(soft_timer_t *timer, void (*func_p)(void *), void *param_p){
+	timer->expiry = 0;
+	timer->period = 0;
+	timer->func_p = func_p;
+	timer->param_p = param_p;
+	timer->index = SOFT_TIMER_IDLE;
+}
+
+bool SoftTimerStart(soft_timer_queue_t *queue, soft_timer_t *timer, uint64_t expiry, uint32_t period){
+	timer->period = period;
+	timer->expiry = expiry;
+	if (timer->index != SOFT_TIMER_IDLE){
+		SiftUp(queue, timer->index);
+		SiftDown(queue, timer->index);
+	}
+	else{
+		if (queue->count >= queue->size){
+			return false;
+		}
+		Place(queue, timer, queue->count++);
+		SiftUp(queue, timer->index);
+	}
+	return timer->index == 0;
+}
+
+void SoftTimerStop(soft_timer_queue_t *queue, soft_timer_t *timer){
+	if (timer->index != SOFT_TIMER_IDLE){
+		Remove(queue, timer->index);
+	}
+}
+
+bool SoftTimerRunning(const soft_timer_t *timer){
+	return timer->index != SOFT_TIMER_IDLE;
+}
+
+bool SoftTimerNext(const soft_timer_queue_t *queue, uint64_t *expiry){
+	if (queue->count == 0){
+		return false;
+	}
+	*expiry = queue->heap[0]->expiry;
+	return true;
+}
+
+soft_timer_t * SoftTimerPop(soft_timer_queue_t *queue, uint64_t now){
+	soft_timer_t *timer;
+
+	if (queue->count == 0 || queue->heap[0]->expiry > now){
+		return NULL;
+	}
+	timer = queue->heap[0];
+	if (timer->period > 0){
+		/* Next period after now, same phase */
+		timer->expiry += timer->period;
+		if (timer->expiry <= now){
+			timer->expiry += ((now - timer->expiry) / timer->period + 1) * timer->period;
+		}
+		SiftDown(queue, 0);
+	}
+	else{
+		Remove(queue, 0);
+	}
+	return timer;
+}
+
+uint32_t SoftTimerRun(soft_timer_queue_t *queue, uint64_t now){
+	soft_timer_t *timer;
+	uint32_t calls = 0;
+
+	while ((timer = SoftTimerPop(queue, now)) != NULL){
+		timer->func_p(timer->param_p);
+		calls++;
+	}
+	return calls;
+}
+
+/*==================[end of file]============================================*/
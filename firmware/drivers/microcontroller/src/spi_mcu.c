@@ -22,6 +22,17 @@
 #define PIN_NUM_CS1		GPIO_19	/*!<  */
 #define PIN_NUM_CS2		GPIO_18	/*!<  */
 #define PIN_NUM_CS3		GPIO_9	/*!<  */
+#define SPI_DEVICES		3		/*!< Number of devices on the bus */
+#define SPI_TXDATA_SIZE	4		/*!< Bytes that fit inside the transaction itself */
+/*==================[typedef]================================================*/
+/**
+ * @brief Ring of transaction descriptors for queued writes
+ */
+typedef struct {
+	spi_transaction_t trans[SPI_QUEUE_SIZE];	/*!< Descriptors, must live until the transaction ends */
+	uint32_t queued;							/*!< Number of transactions queued */
+	uint32_t done;								/*!< Number of transactions ended */
+} spi_queue_t;
 /*==================[internal data declaration]==============================*/
 spi_device_handle_t spi_1, spi_2, spi_3;
 const spi_bus_config_t bus_cfg = {
@@ -39,15 +50,58 @@ void (*spi_3_isr_p)(void*);	/*!<  */
 void *spi_1_user_data;	    /*!<  */
 void *spi_2_user_data;	    /*!<  */
 void *spi_3_user_data;	    /*!<  */
+void (*spi_1_pre_isr_p)(void*);	/*!<  */
+void (*spi_2_pre_isr_p)(void*);	/*!<  */
+void (*spi_3_pre_isr_p)(void*);	/*!<  */
+void (*spi_1_post_isr_p)(void*);	/*!<  */
+void (*spi_2_post_isr_p)(void*);	/*!<  */
+void (*spi_3_post_isr_p)(void*);	/*!<  */
+static bool spi_added[SPI_DEVICES];			/*!< Device already added to the bus */
+static spi_queue_t spi_queue[SPI_DEVICES];	/*!< Queued transactions of each device */
 /*==================[internal functions declaration]=========================*/
 static void IRAM_ATTR spi_1_isr(spi_transaction_t *t){
-	spi_1_isr_p(spi_1_user_data);
+	if(transfer_mode_1 == SPI_INTERRUPT && spi_1_isr_p != NULL){
+		spi_1_isr_p(spi_1_user_data);
+	}
+	if(spi_1_post_isr_p != NULL){
+		spi_1_post_isr_p(t->user);
+	}
 }
 static void IRAM_ATTR spi_2_isr(spi_transaction_t *t){
-	spi_2_isr_p(spi_2_user_data);
+	if(transfer_mode_2 == SPI_INTERRUPT && spi_2_isr_p != NULL){
+		spi_2_isr_p(spi_2_user_data);
+	}
+	if(spi_2_post_isr_p != NULL){
+		spi_2_post_isr_p(t->user);
+	}
 }
 static void IRAM_ATTR spi_3_isr(spi_transaction_t *t){
-	spi_3_isr_p(spi_3_user_data);
+	if(transfer_mode_3 == SPI_INTERRUPT && spi_3_isr_p != NULL){
+		spi_3_isr_p(spi_3_user_data);
+	}
+	if(spi_3_post_isr_p != NULL){
+		spi_3_post_isr_p(t->user);
+	}
+}
+static void IRAM_ATTR spi_1_pre_isr(spi_transaction_t *t){
+	spi_1_pre_isr_p(t->user);
+}
+static void IRAM_ATTR spi_2_pre_isr(spi_transaction_t *t){
+	spi_2_pre_isr_p(t->user);
+}
+static void IRAM_ATTR spi_3_pre_isr(spi_transaction_t *t){
+	spi_3_pre_isr_p(t->user);
+}
+static spi_device_handle_t SpiHandle(spi_dev_t device){
+    switch(device){
+        case SPI_1:
+            return spi_1;
+        case SPI_2:
+            return spi_2;
+        case SPI_3:
+            return spi_3;
+    }
+    return NULL;
 }
 /*==================[internal data definition]===============================*/
 
@@ -61,48 +115,69 @@ uint8_t SpiInit(spi_mcu_config_t* spi){
     if(!spi_initialized){
 	    spi_bus_initialize(SPI2_HOST, &bus_cfg, SPI_DMA_CH_AUTO);
         spi_initialized = true;
+    }
+    /* Re-configuration of a device already on the bus */
+    if(spi_added[spi->device]){
+        SpiDeInit(spi->device);
     }
 	spi_device_interface_config_t dev_cfg = {
         .clock_speed_hz = spi->bitrate,     	
         .mode = spi->clk_mode,                  
-        .queue_size = 8,                        
+        .queue_size = SPI_QUEUE_SIZE,                        
     };
     switch(spi->device){
         case SPI_1:
             dev_cfg.spics_io_num = PIN_NUM_CS1;
             transfer_mode_1 = spi->transfer_mode;
-            if(transfer_mode_1 == SPI_INTERRUPT){
+            if(transfer_mode_1 == SPI_INTERRUPT || spi->post_func_p != NULL){
                 dev_cfg.post_cb = spi_1_isr;
             } 
+            if(spi->pre_func_p != NULL){
+                dev_cfg.pre_cb = spi_1_pre_isr;
+            }
             spi_bus_add_device(SPI2_HOST, &dev_cfg, &spi_1);
             spi_1_isr_p = spi->func_p;
             spi_1_user_data = spi->param_p;
+            spi_1_pre_isr_p = spi->pre_func_p;
+            spi_1_post_isr_p = spi->post_func_p;
             break;
         case SPI_2:
             dev_cfg.spics_io_num = PIN_NUM_CS2;
-            if(transfer_mode_2 == SPI_INTERRUPT){
+            transfer_mode_2 = spi->transfer_mode;
+            if(transfer_mode_2 == SPI_INTERRUPT || spi->post_func_p != NULL){
                 dev_cfg.post_cb = spi_2_isr;
             } 
-            transfer_mode_1 = spi->transfer_mode;
+            if(spi->pre_func_p != NULL){
+                dev_cfg.pre_cb = spi_2_pre_isr;
+            }
             spi_bus_add_device(SPI2_HOST, &dev_cfg, &spi_2);
             spi_2_isr_p = spi->func_p;
             spi_2_user_data = spi->param_p;
+            spi_2_pre_isr_p = spi->pre_func_p;
+            spi_2_post_isr_p = spi->post_func_p;
             break;
         case SPI_3:
             dev_cfg.spics_io_num = PIN_NUM_CS3;
-            if(transfer_mode_3 == SPI_INTERRUPT){
+            transfer_mode_3 = spi->transfer_mode;
+            if(transfer_mode_3 == SPI_INTERRUPT || spi->post_func_p != NULL){
                 dev_cfg.post_cb = spi_3_isr;
             } 
-            transfer_mode_1 = spi->transfer_mode;
+            if(spi->pre_func_p != NULL){
+                dev_cfg.pre_cb = spi_3_pre_isr;
+            }
             spi_bus_add_device(SPI2_HOST, &dev_cfg, &spi_3);
             spi_3_isr_p = spi->func_p;
             spi_3_user_data = spi->param_p;
+            spi_3_pre_isr_p = spi->pre_func_p;
+            spi_3_post_isr_p = spi->post_func_p;
             break;
     }
+    spi_added[spi->device] = true;
     return 0;
 }
 
 void SpiRead(spi_dev_t device, uint8_t * rx_buffer, uint32_t rx_buffer_size){
+    SpiWaitQueue(device);           // Queued transactions must end before a polling one
     spi_transaction_t t;
     memset(&t, 0, sizeof(t));       // Zero out the transaction
     t.length = rx_buffer_size * 8;  // tx_buffer_size is in bytes, transaction length is in bits.
@@ -143,6 +218,7 @@ void SpiRead(spi_dev_t device, uint8_t * rx_buffer, uint32_t rx_buffer_size){
 }
 
 void SpiWrite(spi_dev_t device, uint8_t * tx_buffer, uint32_t tx_buffer_size){
+    SpiWaitQueue(device);           // Queued transactions must end before a polling one
     spi_transaction_t t;
     memset(&t, 0, sizeof(t));       // Zero out the transaction
     t.length = tx_buffer_size * 8;  // tx_buffer_size is in bytes, transaction length is in bits.
@@ -182,6 +258,7 @@ void SpiWrite(spi_dev_t device, uint8_t * tx_buffer, uint32_t tx_buffer_size){
 }
 
 void SpiReadWrite(spi_dev_t device, uint8_t * tx_buffer, uint8_t * rx_buffer, uint32_t buffer_size){
+    SpiWaitQueue(device);           // Queued transactions must end before a polling one
     spi_transaction_t t;
     memset(&t, 0, sizeof(t));       // Zero out the transaction
     t.length = buffer_size * 8;     // tx_buffer_size is in bytes, transaction length is in bits.
@@ -222,7 +299,48 @@ void SpiReadWrite(spi_dev_t device, uint8_t * tx_buffer, uint8_t * rx_buffer, ui
     }
 }
 
+uint32_t SpiQueueWrite(spi_dev_t device, const uint8_t * tx_buffer, uint32_t tx_buffer_size, void * user){
+    spi_queue_t *queue = &spi_queue[device];
+    spi_transaction_t *t;
+    /* Reuse the oldest descriptor when all of them are in flight */
+    SpiWaitTransaction(device, queue->queued - SPI_QUEUE_SIZE + 1);
+    t = &queue->trans[queue->queued % SPI_QUEUE_SIZE];
+    memset(t, 0, sizeof(spi_transaction_t));
+    t->length = tx_buffer_size * 8;     // tx_buffer_size is in bytes, transaction length is in bits.
+    t->user = user;
+    if(tx_buffer_size <= SPI_TXDATA_SIZE){
+        /* Short commands and parameters are copied, so caller buffer can be reused */
+        t->flags = SPI_TRANS_USE_TXDATA;
+        memcpy(t->tx_data, tx_buffer, tx_buffer_size);
+    } else{
+        t->tx_buffer = tx_buffer;
+    }
+    spi_device_queue_trans(SpiHandle(device), t, portMAX_DELAY);
+    queue->queued++;
+    return queue->queued;
+}
+
+void SpiWaitTransaction(spi_dev_t device, uint32_t transaction){
+    spi_queue_t *queue = &spi_queue[device];
+    spi_transaction_t *done;
+    /* Transactions end in the same order they were queued */
+    while((int32_t)(transaction - queue->done) > 0 && queue->done != queue->queued){
+        spi_device_get_trans_result(SpiHandle(device), &done, portMAX_DELAY);
+        queue->done++;
+    }
+}
+
+void SpiWaitQueue(spi_dev_t device){
+    SpiWaitTransaction(device, spi_queue[device].queued);
+}
+
 uint8_t SpiDeInit(spi_dev_t device){
+    if(!spi_added[device]){
+        return 0;
+    }
+    SpiWaitQueue(device);
+    spi_bus_remove_device(SpiHandle(device));
+    spi_added[device] = false;
     return 0;
 }
 
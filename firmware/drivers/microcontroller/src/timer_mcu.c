@@ -1,29 +1,50 @@
 /**
  * @file timer_mcu.c
  * @author Albano Peñalva (albano.penalva@uner.edu.ar)
- * @brief 
+ * @brief
  * @version 0.1
  * @date 2023-10-20
- * 
+ *
  * @copyright Copyright (c) 2023
- * 
+ *
  */
 
 /*==================[inclusions]=============================================*/
 #include "timer_mcu.h"
+#include <stdlib.h>
 #include "driver/gptimer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "esp_attr.h"
 /*==================[macros and definitions]=================================*/
 #define US_RESOLUTION_HZ	1000000	/*!< 1usec */
-#define RESET_COUNT_VALUE	0		/*!< Reset timer count to 0 */
+#define TIMERS_QTY			3		/*!< TIMER_A, TIMER_B and TIMER_C */
+#define HEAP_INITIAL_SIZE	8		/*!< Running timers before the heap is allocated */
+#define ALARM_MIN_LEAD		5		/*!< Minimum time from now to the alarm (us), covers the time to set it */
 /*==================[internal data declaration]==============================*/
-gptimer_handle_t timer_a = NULL;	/*!< Handle for timer A */	
-gptimer_handle_t timer_b = NULL;	/*!< Handle for timer B */			
-gptimer_handle_t timer_c = NULL;	/*!< Handle for timer C */	
+/**
+ * @brief TIMER_A, TIMER_B and TIMER_C state
+ */
+typedef struct {
+	soft_timer_t soft;		/*!< Software timer of the alarm */
+	void (*func_p)(void*);	/*!< Callback function */
+	void *param_p;			/*!< Callback function parameter */
+	uint32_t period;		/*!< Period (in us) */
+	uint64_t start;			/*!< Time the count was 0 (us) */
+	uint32_t paused;		/*!< Count while stopped (us) */
+	bool running;			/*!< Counting */
+} timer_channel_t;
+
+static gptimer_handle_t timer_service = NULL;		/*!< Only hardware timer, free running */
+static portMUX_TYPE timer_lock = portMUX_INITIALIZER_UNLOCKED;
+static soft_timer_queue_t timer_queue;				/*!< Running software timers */
+static soft_timer_t *timer_heap_initial[HEAP_INITIAL_SIZE];
+static uint16_t timer_registered = 0;				/*!< Software timers initialized */
+static timer_channel_t timer_channels[TIMERS_QTY];
+static volatile bool timer_woken = false;			/*!< A timer function woke a task, switch when the ISR ends */
 /**
  * @brief Configuration for the timer
- * 
+ *
  * @details The configuration for the timer specifies the clock source,
  *          count direction, and resolution in Hz.
  */
@@ -32,160 +53,292 @@ const gptimer_config_t timer_config = {
     .direction = GPTIMER_COUNT_UP,		/*!< Count up */
     .resolution_hz = US_RESOLUTION_HZ,	/*!< Resolution in Hz */
 };
-void (*timer_a_isr_p)(void*);	        /*!< Pointer to the ISR function for timer A */	
-void (*timer_b_isr_p)(void*);	        /*!< Pointer to the ISR function for timer B */	
-void (*timer_c_isr_p)(void*);	        /*!< Pointer to the ISR function for timer C */	
+/*==================[internal functions declaration]=========================*/
+/**
+ * @brief Creates and starts the hardware timer, on first use
+ */
+static void TimerServiceInit(void);
 
+/**
+ * @brief Sets the alarm at the first expiration, disables it if no timer is running
+ *
+ * @note Called with timer_lock taken
+ */
+static void IRAM_ATTR TimerServiceArm(void);
 
-void *timer_a_user_data;	            /*!< User data for timer A */	
-void *timer_b_user_data;	            /*!< User data for timer B */	
-void *timer_c_user_data;	            /*!< User data for timer C */	
+/**
+ * @brief Alarm ISR: runs the expired timers and sets the next alarm
+ *
+ * @return true if a timer function woke a task (TimerYieldFromISR())
+ */
+static bool IRAM_ATTR TimerServiceIsr(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_data);
+
+/**
+ * @brief Starts the software timer of a channel at the end of its period
+ *
+ * @note Called with timer_lock taken
+ */
+static void IRAM_ATTR TimerChannelSchedule(timer_channel_t *channel, uint64_t now);
+
+/**
+ * @brief Software timer function of TIMER_A, TIMER_B and TIMER_C: the count starts again
+ *
+ * @param param Channel
+ */
+static void IRAM_ATTR TimerChannelAlarm(void *param);
 
-gptimer_alarm_config_t alarm_config_a;  /*!< Configuration for alarm A */
-gptimer_alarm_config_t alarm_config_b;	/*!< Configuration for alarm B */
-gptimer_alarm_config_t alarm_config_c;	/*!< Configuration for alarm C */
-/*==================[internal functions declaration]=========================*/
-static bool IRAM_ATTR timer_a_isr(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_data){
-	timer_a_isr_p(timer_a_user_data);
-	return true;
-}
-static bool IRAM_ATTR timer_b_isr(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_data){
-	timer_b_isr_p(timer_b_user_data);
-	return true;
-}
-static bool IRAM_ATTR timer_c_isr(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_data){
-	timer_c_isr_p(timer_c_user_data);
-	return true;
-}
 /*==================[internal data definition]===============================*/
 
 /*==================[external data definition]===============================*/
 
 /*==================[internal functions definition]==========================*/
+static void TimerServiceInit(void){
+	gptimer_event_callbacks_t alarm = {
+		.on_alarm = TimerServiceIsr,
+	};
+	uint8_t i;
+
+	if (timer_service != NULL){
+		return;
+	}
+	SoftTimerQueueInit(&timer_queue, timer_heap_initial, HEAP_INITIAL_SIZE);
+	for (i = 0; i < TIMERS_QTY; i++){
+		SoftTimerInit(&timer_channels[i].soft, TimerChannelAlarm, &timer_channels[i]);
+	}
+	timer_registered = TIMERS_QTY;
+	gptimer_new_timer(&timer_config, &timer_service);
+	gptimer_register_event_callbacks(timer_service, &alarm, NULL);
+	gptimer_enable(timer_service);
+	gptimer_start(timer_service);
+}
+
+static void IRAM_ATTR TimerServiceArm(void){
+	gptimer_alarm_config_t alarm_config = {
+		.flags.auto_reload_on_alarm = false,
+	};
+	uint64_t next, now;
+
+	if (!SoftTimerNext(&timer_queue, &next)){
+		gptimer_set_alarm_action(timer_service, NULL);
+		return;
+	}
+	/* An alarm already passed would never trigger */
+	gptimer_get_raw_count(timer_service, &now);
+	alarm_config.alarm_count = (next > now + ALARM_MIN_LEAD) ? next : now + ALARM_MIN_LEAD;
+	gptimer_set_alarm_action(timer_service, &alarm_config);
+}
+
+static bool IRAM_ATTR TimerServiceIsr(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_data){
+	soft_timer_t *expired;
+	void (*func_p)(void*);
+	void *param_p;
+	uint64_t now;
+
+	timer_woken = false;
+	while (true){
+		portENTER_CRITICAL_ISR(&timer_lock);
+		/* Timers expired while the functions were called run now */
+		gptimer_get_raw_count(timer, &now);
+		expired = SoftTimerPop(&timer_queue, now);
+		if (expired == NULL){
+			TimerServiceArm();
+			portEXIT_CRITICAL_ISR(&timer_lock);
+			break;
+		}
+		func_p = expired->func_p;
+		param_p = expired->param_p;
+		portEXIT_CRITICAL_ISR(&timer_lock);
+		/* Functions run with the lock free, they can start and stop timers */
+		func_p(param_p);
+	}
+	return timer_woken;
+}
+
+static void IRAM_ATTR TimerChannelSchedule(timer_channel_t *channel, uint64_t now){
+	uint64_t expiry = channel->start + channel->period;
+
+	if (SoftTimerStart(&timer_queue, &channel->soft, (expiry > now) ? expiry : now, channel->period)){
+		TimerServiceArm();
+	}
+}
+
+static void IRAM_ATTR TimerChannelAlarm(void *param){
+	timer_channel_t *channel = param;
+	void (*func_p)(void*);
+	void *param_p;
+
+	portENTER_CRITICAL_ISR(&timer_lock);
+	/* The soft timer already holds the next period */
+	channel->start = channel->soft.expiry - channel->period;
+	func_p = channel->func_p;
+	param_p = channel->param_p;
+	portEXIT_CRITICAL_ISR(&timer_lock);
+	if (func_p != NULL){
+		func_p(param_p);
+		/* TIMER_A, TIMER_B and TIMER_C functions notify their tasks without
+		pxHigherPriorityTaskWoken, the switch is asked for as it always was */
+		timer_woken = true;
+	}
+}
 
 /*==================[external functions definition]==========================*/
 void TimerInit(timer_config_t *timer_ini){
-	switch(timer_ini->timer){
-	 	case TIMER_A:
-			timer_a_isr_p = timer_ini->func_p;
-			timer_a_user_data = timer_ini->param_p;
-	 		gptimer_new_timer(&timer_config, &timer_a);
-			alarm_config_a.alarm_count = timer_ini->period; 
-			alarm_config_a.reload_count = RESET_COUNT_VALUE;
-			alarm_config_a.flags.auto_reload_on_alarm = true;
-			gptimer_set_alarm_action(timer_a, &alarm_config_a);
-			gptimer_event_callbacks_t alarm_a = {
-				.on_alarm = timer_a_isr,
-			};
-			gptimer_register_event_callbacks(timer_a, &alarm_a, NULL);
-			gptimer_enable(timer_a);
-	 	break;
-
-	 	case TIMER_B:
-			timer_b_isr_p = timer_ini->func_p;
-			timer_b_user_data = timer_ini->param_p;
-	 		gptimer_new_timer(&timer_config, &timer_b);
-			alarm_config_b.alarm_count = timer_ini->period; 
-			alarm_config_b.reload_count = RESET_COUNT_VALUE;
-			alarm_config_b.flags.auto_reload_on_alarm = true;
-			gptimer_set_alarm_action(timer_b, &alarm_config_b);
-			gptimer_event_callbacks_t alarm_b = {
-				.on_alarm = timer_b_isr,
-			};
-			gptimer_register_event_callbacks(timer_b, &alarm_b, NULL);
-			gptimer_enable(timer_b);
-	 	break;
-
-	 	case TIMER_C:
-			timer_c_isr_p = timer_ini->func_p;
-			timer_c_user_data = timer_ini->param_p;
-	 		gptimer_new_timer(&timer_config, &timer_c);
-			alarm_config_c.alarm_count = timer_ini->period; 
-			alarm_config_c.reload_count = RESET_COUNT_VALUE;
-			alarm_config_c.flags.auto_reload_on_alarm = true;
-			gptimer_set_alarm_action(timer_c, &alarm_config_c);
-			gptimer_event_callbacks_t alarm_c = {
-				.on_alarm = timer_c_isr,
-			};
-			gptimer_register_event_callbacks(timer_c, &alarm_c, NULL);
-			gptimer_enable(timer_c);
-	 	break;
-	}
+	timer_channel_t *channel = &timer_channels[timer_ini->timer];
+
+	TimerServiceInit();
+	portENTER_CRITICAL_SAFE(&timer_lock);
+	SoftTimerStop(&timer_queue, &channel->soft);
+	channel->func_p = timer_ini->func_p;
+	channel->param_p = timer_ini->param_p;
+	channel->period = timer_ini->period;
+	channel->paused = 0;
+	channel->running = false;
+	portEXIT_CRITICAL_SAFE(&timer_lock);
 }
 
 void TimerStart(timer_mcu_t timer){
-	switch(timer){
-	 	case TIMER_A:
-	 		gptimer_start(timer_a);
-		break;
-	 	case TIMER_B:
-	 		gptimer_start(timer_b);
-		break;
-	 	case TIMER_C:
-	 		gptimer_start(timer_c);
-		break;
+	timer_channel_t *channel = &timer_channels[timer];
+	uint64_t now = TimerNow();
+
+	portENTER_CRITICAL_SAFE(&timer_lock);
+	if (!channel->running){
+		/* Count goes on from where it was stopped */
+		channel->start = now - channel->paused;
+		channel->running = true;
+		TimerChannelSchedule(channel, now);
 	}
+	portEXIT_CRITICAL_SAFE(&timer_lock);
 }
 
 uint32_t TimerRead(timer_mcu_t timer){
-	uint64_t raw_count = 0;
-	switch(timer){
-	 	case TIMER_A:
-	 		gptimer_get_raw_count(timer_a, &raw_count);
-	 	break;
-	 	case TIMER_B:
-	 		gptimer_get_raw_count(timer_b, &raw_count);
-	 	break;
-	 	case TIMER_C:
-	 		gptimer_get_raw_count(timer_c, &raw_count);
-	 	break;
-	}
-	return raw_count;
+	timer_channel_t *channel = &timer_channels[timer];
+	uint64_t now = TimerNow();
+	uint32_t count;
+
+	portENTER_CRITICAL_SAFE(&timer_lock);
+	count = channel->running ? now - channel->start : channel->paused;
+	portEXIT_CRITICAL_SAFE(&timer_lock);
+	return count;
 }
 
 void TimerStop(timer_mcu_t timer){
-	switch(timer){
-	 	case TIMER_A:
-	 		gptimer_stop(timer_a);
-	 	break;
-	 	case TIMER_B:
-	 		gptimer_stop(timer_b);
-	 	break;
-	 	case TIMER_C:
-	 		gptimer_stop(timer_c);
-	 	break;
+	timer_channel_t *channel = &timer_channels[timer];
+	uint64_t now = TimerNow();
+
+	portENTER_CRITICAL_SAFE(&timer_lock);
+	if (channel->running){
+		channel->paused = now - channel->start;
+		channel->running = false;
+		SoftTimerStop(&timer_queue, &channel->soft);
 	}
+	portEXIT_CRITICAL_SAFE(&timer_lock);
 }
 
 void TimerReset(timer_mcu_t timer){
-	switch(timer){
-	 	case TIMER_A:
-			gptimer_set_raw_count(timer_a, RESET_COUNT_VALUE);
-	 	break;
-	 	case TIMER_B:
-			gptimer_set_raw_count(timer_b, RESET_COUNT_VALUE);
-	 	break;
-	 	case TIMER_C:
-			gptimer_set_raw_count(timer_c, RESET_COUNT_VALUE);
-	 	break;
+	timer_channel_t *channel = &timer_channels[timer];
+	uint64_t now = TimerNow();
+
+	portENTER_CRITICAL_SAFE(&timer_lock);
+	channel->paused = 0;
+	if (channel->running){
+		channel->start = now;
+		TimerChannelSchedule(channel, now);
 	}
+	portEXIT_CRITICAL_SAFE(&timer_lock);
 }
 
 void TimerUpdatePeriod(timer_mcu_t timer, uint32_t period){
-	switch(timer){
-	 	case TIMER_A:
-			alarm_config_a.alarm_count = period;
-			gptimer_set_alarm_action(timer_a, &alarm_config_a);
-	 	break;
-	 	case TIMER_B:
-			alarm_config_b.alarm_count = period;
-			gptimer_set_alarm_action(timer_b, &alarm_config_b);
-	 	break;
-	 	case TIMER_C:
-			alarm_config_c.alarm_count = period;
-			gptimer_set_alarm_action(timer_c, &alarm_config_c);
-	 	break;
+	timer_channel_t *channel = &timer_channels[timer];
+	uint64_t now = TimerNow();
+
+	portENTER_CRITICAL_SAFE(&timer_lock);
+	channel->period = period;
+	if (channel->running){
+		TimerChannelSchedule(channel, now);
 	}
+	portEXIT_CRITICAL_SAFE(&timer_lock);
+}
+
+bool TimerSoftInit(soft_timer_t *timer, void (*func_p)(void *), void *param_p){
+	soft_timer_t **heap = NULL, **previous = NULL;
+	uint32_t size = 0;
+	bool registered = false;
+
+	TimerServiceInit();
+	SoftTimerInit(timer, func_p, param_p);
+	/* Heap grows here, so starting timers never allocates (it can be done from ISRs).
+	Checked again under the lock: other tasks may register timers meanwhile */
+	while (!registered){
+		portENTER_CRITICAL_SAFE(&timer_lock);
+		if (timer_registered < timer_queue.size){
+			registered = true;
+		}
+		else if (heap != NULL && size > timer_queue.size){
+			previous = SoftTimerQueueResize(&timer_queue, heap, size);
+			heap = NULL;
+			registered = true;
+		}
+		else{
+			size = timer_queue.size * 2;
+		}
+		if (registered){
+			timer_registered++;
+		}
+		portEXIT_CRITICAL_SAFE(&timer_lock);
+		if (!registered){
+			free(heap);
+			heap = (size < SOFT_TIMER_IDLE) ? malloc(size * sizeof(soft_timer_t *)) : NULL;
+			if (heap == NULL){
+				return false;
+			}
+		}
+	}
+	/* Not used if the heap already grew */
+	free(heap);
+	if (previous != timer_heap_initial){
+		free(previous);
+	}
+	return true;
+}
+
+void TimerSoftDeInit(soft_timer_t *timer){
+	portENTER_CRITICAL_SAFE(&timer_lock);
+	SoftTimerStop(&timer_queue, timer);
+	timer_registered--;
+	portEXIT_CRITICAL_SAFE(&timer_lock);
+}
+
+bool TimerSoftStart(soft_timer_t *timer, uint32_t delay, uint32_t period){
+	uint64_t now = TimerNow();
+	bool running;
+
+	portENTER_CRITICAL_SAFE(&timer_lock);
+	if (SoftTimerStart(&timer_queue, timer, now + delay, period)){
+		TimerServiceArm();
+	}
+	/* Only a timer not initialized with TimerSoftInit() may find the queue full */
+	running = SoftTimerRunning(timer);
+	portEXIT_CRITICAL_SAFE(&timer_lock);
+	return running;
+}
+
+void IRAM_ATTR TimerYieldFromISR(bool woken){
+	if (woken){
+		timer_woken = true;
+	}
+}
+
+void TimerSoftStop(soft_timer_t *timer){
+	portENTER_CRITICAL_SAFE(&timer_lock);
+	SoftTimerStop(&timer_queue, timer);
+	portEXIT_CRITICAL_SAFE(&timer_lock);
+}
+
+uint64_t IRAM_ATTR TimerNow(void){
+	uint64_t now = 0;
+
+	gptimer_get_raw_count(timer_service, &now);
+	return now;
 }
 
 /*==================[end of file]============================================*/
@@ -0,0 +1,99 @@
+/**
+ * @file test_event_ring.c
+ * @brief Host test of the event ring, alone and with producers on several threads
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+#include "event_ring.h"
+/*==================[macros and definitions]=================================*/
+#define PRODUCERS	4
+#define EVENTS		200000
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failed++; } } while (0)
+/*==================[internal data definition]===============================*/
+static int failed;
+static event_ring_t ring;
+static atomic_uint retries;
+
+/*==================[internal functions definition]==========================*/
+/* Posts EVENTS events numbered from 0, retrying while the ring is full */
+static void * Producer(void *param){
+	event_t event = {.source = (uint8_t)(uintptr_t)param};
+	uint32_t i;
+
+	for (i = 0; i < EVENTS; i++){
+		event.value = i;
+		event.timestamp = ~i;
+		while (!EventRingPush(&ring, &event)){
+			atomic_fetch_add(&retries, 1);
+			sched_yield();
+		}
+	}
+	return NULL;
+}
+
+/*==================[external functions definition]==========================*/
+int main(void){
+	pthread_t threads[PRODUCERS];
+	uint32_t next[PRODUCERS] = {0};
+	uint32_t i, received;
+	event_t event;
+
+	/* One producer: first in, first out, full after EVENT_RING_SIZE */
+	EventRingInit(&ring);
+	CHECK(!EventRingPop(&ring, &event));
+	for (i = 0; i < EVENT_RING_SIZE; i++){
+		event.source = 1;
+		event.value = i;
+		CHECK(EventRingPush(&ring, &event));
+	}
+	CHECK(!EventRingPush(&ring, &event));
+	for (i = 0; i < EVENT_RING_SIZE / 2; i++){
+		CHECK(EventRingPop(&ring, &event) && event.value == i);
+	}
+	/* Wraps around */
+	for (i = 0; i < EVENT_RING_SIZE / 2; i++){
+		event.value = EVENT_RING_SIZE + i;
+		CHECK(EventRingPush(&ring, &event));
+	}
+	for (i = EVENT_RING_SIZE / 2; i < EVENT_RING_SIZE * 3 / 2; i++){
+		CHECK(EventRingPop(&ring, &event) && event.value == i);
+	}
+	CHECK(!EventRingPop(&ring, &event));
+
+	/* Several producers: every event arrives once, in order for each producer */
+	EventRingInit(&ring);
+	for (i = 0; i < PRODUCERS; i++){
+		pthread_create(&threads[i], NULL, Producer, (void *)(uintptr_t)i);
+	}
+	for (received = 0; received < PRODUCERS * EVENTS && failed < 10; ){
+		if (EventRingPop(&ring, &event)){
+			CHECK(event.source < PRODUCERS && event.value == next[event.source]);
+			CHECK(event.timestamp == ~event.value);
+			next[event.source] = event.value + 1;
+			received++;
+		}
+		else{
+			sched_yield();
+		}
+	}
+	for (i = 0; i < PRODUCERS; i++){
+		pthread_join(threads[i], NULL);
+		CHECK(next[i] == EVENTS);
+	}
+	CHECK(!EventRingPop(&ring, &event));
+	printf("%u events from %d threads, %u pushes retried on full ring\n", received, PRODUCERS, atomic_load(&retries));
+
+	printf(failed ? "%d checks failed\n" : "All checks passed\n", failed);
+	return failed ? 1 : 0;
+}
+
+/*==================[end of file]============================================*/
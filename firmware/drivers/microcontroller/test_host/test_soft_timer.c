@@ -0,0 +1,153 @@
+/**
+ * @file test_soft_timer.c
+ * @brief Host test of the software timers queue with a simulated clock
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+/*==================[inclusions]=============================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include "soft_timer.h"
+/*==================[macros and definitions]=================================*/
+#define TIMERS		1000
+#define STEPS		200000
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failed++; } } while (0)
+/*==================[internal data definition]===============================*/
+static int failed;
+static uint64_t now;					/* Simulated clock (us) */
+static soft_timer_queue_t queue;
+static soft_timer_t *heap[TIMERS];
+static soft_timer_t timers[TIMERS];
+static uint64_t expected[TIMERS];		/* Next expiration, 0 if stopped */
+static uint32_t calls[TIMERS];
+
+/*==================[internal functions definition]==========================*/
+/* Each timer is called at the expected time, one-shots stop, some timers restart others */
+static void Expired(void *param){
+	uint32_t i = (uintptr_t)param;
+	uint32_t other = (i * 7 + 3) % TIMERS;
+
+	CHECK(expected[i] == now);
+	calls[i]++;
+	expected[i] = timers[i].period ? now + timers[i].period : 0;
+	CHECK(SoftTimerRunning(&timers[i]) == (timers[i].period > 0));
+	if (i % 5 == 0){
+		SoftTimerStop(&queue, &timers[other]);
+		expected[other] = 0;
+	}
+	else if (i % 5 == 1){
+		SoftTimerStart(&queue, &timers[other], now + 1 + other, (other % 3) ? other * 11 + 1 : 0);
+		expected[other] = now + 1 + other;
+	}
+}
+
+/* Every timer expires after its parent, positions match */
+static int HeapValid(void){
+	uint16_t i;
+
+	for (i = 0; i < queue.count; i++){
+		if (queue.heap[i]->index != i || (i > 0 && queue.heap[i]->expiry < queue.heap[(i - 1) / 2]->expiry)){
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/*==================[external functions definition]==========================*/
+int main(void){
+	soft_timer_t *small[4], **previous;
+	soft_timer_t lone;
+	uint64_t next, first, total = 0;
+	uint32_t i, step, running;
+
+	srand(1);
+	SoftTimerQueueInit(&queue, small, 4);
+	for (i = 0; i < TIMERS; i++){
+		SoftTimerInit(&timers[i], Expired, (void *)(uintptr_t)i);
+		CHECK(!SoftTimerRunning(&timers[i]));
+	}
+	CHECK(!SoftTimerNext(&queue, &next));
+
+	/* Full queue refuses timers until it is moved to a bigger heap */
+	for (i = 0; i < 4; i++){
+		SoftTimerStart(&queue, &timers[i], 1000 - i, 0);
+	}
+	CHECK(!SoftTimerStart(&queue, &timers[4], 1, 0) && !SoftTimerRunning(&timers[4]));
+	CHECK(SoftTimerQueueResize(&queue, heap, 2) == NULL);
+	previous = SoftTimerQueueResize(&queue, heap, TIMERS);
+	CHECK(previous == small && queue.count == 4 && HeapValid());
+	CHECK(SoftTimerStart(&queue, &timers[4], 1, 0));
+	CHECK(SoftTimerNext(&queue, &next) && next == 1);
+	for (i = 0; i < 5; i++){
+		SoftTimerStop(&queue, &timers[i]);
+	}
+	CHECK(queue.count == 0);
+
+	/* Random periodic and one-shot timers */
+	for (i = 0; i < TIMERS; i++){
+		expected[i] = 1 + rand() % 100000;
+		SoftTimerStart(&queue, &timers[i], expected[i], (i % 4) ? 1 + rand() % 50000 : 0);
+	}
+	CHECK(HeapValid());
+	for (step = 0; step < STEPS && SoftTimerNext(&queue, &next); step++){
+		/* Clock jumps to the first expiration, as the hardware alarm does */
+		CHECK(next > now);
+		now = next;
+		total += SoftTimerRun(&queue, now);
+		running = 0;
+		first = UINT64_MAX;
+		for (i = 0; i < TIMERS; i++){
+			if (expected[i]){
+				CHECK(expected[i] > now && expected[i] == timers[i].expiry);
+				first = (expected[i] < first) ? expected[i] : first;
+				running++;
+			}
+		}
+		CHECK(running == queue.count && HeapValid());
+		CHECK(!SoftTimerNext(&queue, &next) || next == first);
+		if (failed > 10){
+			break;
+		}
+	}
+	CHECK(total > STEPS);
+	printf("%lu calls in %u alarms, %u timers still running\n", (unsigned long)total, step, queue.count);
+
+	/* Missed periods: called once, next expiration keeps the phase */
+	SoftTimerInit(&lone, Expired, (void *)(uintptr_t)0);
+	SoftTimerQueueInit(&queue, heap, TIMERS);
+	SoftTimerStart(&queue, &lone, 1000, 300);
+	calls[0] = 0;
+	expected[0] = now = 1000;
+	CHECK(SoftTimerRun(&queue, 999) == 0);
+	CHECK(SoftTimerRun(&queue, 1000) == 1 && lone.expiry == 1300);
+	expected[0] = now = 2000;
+	lone.expiry = 2000;
+	CHECK(SoftTimerRun(&queue, 2000 + 950) == 1 && lone.expiry == 3200);
+
+	/* Pop takes the expired timers in order without calling them */
+	SoftTimerInit(&timers[2], Expired, (void *)(uintptr_t)2);
+	SoftTimerStart(&queue, &timers[2], 3000, 0);
+	calls[0] = calls[2] = 0;
+	CHECK(SoftTimerPop(&queue, 2999) == NULL);
+	CHECK(SoftTimerPop(&queue, 3300) == &timers[2] && !SoftTimerRunning(&timers[2]));
+	CHECK(SoftTimerPop(&queue, 3300) == &lone && lone.expiry == 3500);
+	CHECK(SoftTimerPop(&queue, 3300) == NULL && calls[0] == 0 && calls[2] == 0);
+
+	/* Restarting a running timer moves it */
+	SoftTimerInit(&timers[1], Expired, (void *)(uintptr_t)1);
+	SoftTimerStart(&queue, &timers[1], 5000, 0);
+	CHECK(SoftTimerStart(&queue, &timers[1], 100, 0) && queue.count == 2);
+	SoftTimerStop(&queue, &lone);
+	SoftTimerStop(&queue, &lone);
+	CHECK(queue.count == 1 && queue.heap[0] == &timers[1]);
+
+	printf(failed ? "%d checks failed\n" : "All checks passed\n", failed);
+	return failed ? 1 : 0;
+}
+
+/*==================[end of file]============================================*/
@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+"""Converts a TTF/OTF or BDF font to the anti-aliased 4 bits per pixel format (FONT_4BPP).
+
+Characters from ' ' to '~' are rendered in cells of the character advance width and
+the font height (ascent + descent). Each pixel stores its coverage, 0 (background)
+to 15 (foreground), two pixels per byte, high nibble first. Each row starts on a new
+byte and char_info_t.offset points to the first row of each character.
+
+TTF/OTF fonts need Pillow (pip install pillow). BDF fonts are read directly, their
+pixels are 0 or 15, useful to keep the same drawing path for bitmap fonts.
+
+Usage:
+    font_4bpp.py <font.ttf|font.otf> <name> <pixel size> [output.c]
+    font_4bpp.py <font.bdf> <name> [output.c]
+
+    font_4bpp.py DejaVuSans.ttf dejavu24 24 > dejavu24.c
+
+The output defines <name>_data, <name>_info and a Font_t <name> ready to be used
+with the ILI9341 drawing functions.
+"""
+
+import sys
+
+FIRST_CHAR = 32
+LAST_CHAR = 126
+ALPHA_MAX = 15
+
+
+def render_ttf(path, size):
+    """Coverage (0 to 255) rows of each character and font height."""
+    try:
+        from PIL import Image, ImageDraw, ImageFont
+    except ImportError:
+        sys.exit('TTF fonts need Pillow: pip install pillow')
+    font = ImageFont.truetype(path, size)
+    ascent, descent = font.getmetrics()
+    height = ascent + descent
+    glyphs = []
+    for code in range(FIRST_CHAR, LAST_CHAR + 1):
+        width = max(1, int(round(font.getlength(chr(code)))))
+        image = Image.new('L', (width, height), 0)
+        ImageDraw.Draw(image).text((0, 0), chr(code), fill=255, font=font)
+        pixels = list(image.tobytes())
+        glyphs.append((width, [pixels[row * width:(row + 1) * width] for row in range(height)]))
+    return glyphs, height
+
+
+def render_bdf(path):
+    """Coverage (0 or 255) rows of each character and font height."""
+    ascent = descent = None
+    chars = {}
+    lines = iter(open(path, encoding='latin-1').read().splitlines())
+    for line in lines:
+        words = line.split()
+        if not words:
+            continue
+        if words[0] == 'FONT_ASCENT':
+            ascent = int(words[1])
+        elif words[0] == 'FONT_DESCENT':
+            descent = int(words[1])
+        elif words[0] == 'STARTCHAR':
+            code = advance = bbx = None
+            rows = []
+            for line in lines:
+                words = line.split()
+                if words[0] == 'ENCODING':
+                    code = int(words[1])
+                elif words[0] == 'DWIDTH':
+                    advance = int(words[1])
+                elif words[0] == 'BBX':
+                    bbx = [int(w) for w in words[1:5]]
+                elif words[0] == 'BITMAP':
+                    for line in lines:
+                        if line.startswith('ENDCHAR'):
+                            break
+                        rows.append(int(line, 16) << (4 * ((bbx[0] + 7) // 8 * 2 - len(line))))
+                    break
+            chars[code] = (advance, bbx, rows)
+    if ascent is None or descent is None:
+        sys.exit('FONT_ASCENT and FONT_DESCENT properties not found')
+    height = ascent + descent
+    glyphs = []
+    for code in range(FIRST_CHAR, LAST_CHAR + 1):
+        if code not in chars:
+            sys.exit('character %r not in font' % chr(code))
+        advance, (bw, bh, bx, by), rows = chars[code]
+        bits = (bw + 7) // 8 * 8
+        cell = [[0] * advance for _ in range(height)]
+        top = ascent - (bh + by)
+        for r, value in enumerate(rows):
+            for c in range(bw):
+                x, y = bx + c, top + r
+                if 0 <= x < advance and 0 <= y < height and value >> (bits - 1 - c) & 1:
+                    cell[y][x] = 255
+        glyphs.append((advance, cell))
+    return glyphs, height
+
+
+def pack(rows):
+    """4 bit coverage, two pixels per byte, each row on new bytes."""
+    data = []
+    for row in rows:
+        levels = [(p * ALPHA_MAX + 127) // 255 for p in row]
+        if len(levels) % 2:
+            levels.append(0)
+        data += [levels[i] << 4 | levels[i + 1] for i in range(0, len(levels), 2)]
+    return data
+
+
+def main():
+    if len(sys.argv) < 3:
+        sys.exit(__doc__)
+    path, name = sys.argv[1], sys.argv[2]
+    if path.lower().endswith('.bdf'):
+        glyphs, height = render_bdf(path)
+        args = sys.argv[3:]
+    else:
+        if len(sys.argv) < 4:
+            sys.exit(__doc__)
+        glyphs, height = render_ttf(path, int(sys.argv[3]))
+        args = sys.argv[4:]
+    out = open(args[0], 'w') if args else sys.stdout
+
+    data = []
+    info = []
+    lines = []
+    for i, (width, rows) in enumerate(glyphs):
+        if width > 255:
+            sys.exit('%r is wider than 255 pixels' % chr(FIRST_CHAR + i))
+        glyph = pack(rows)
+        info.append((width, len(data)))
+        lines.append('\t/* @%d \'%s\' (%d pixels wide) */' % (len(data), chr(FIRST_CHAR + i), width))
+        row_bytes = (width + 1) // 2
+        for j in range(0, len(glyph), row_bytes):
+            lines.append('\t' + ' '.join('0x%02X,' % b for b in glyph[j:j + row_bytes]))
+        data += glyph
+    if len(data) > 0xFFFF:
+        sys.exit('%s doesn\'t fit uint16_t offsets, use a smaller size' % name)
+
+    out.write('/**\n * @brief %d pixels height data array, 4 bits per pixel.\n */\n' % height)
+    out.write('const uint8_t %s_data[] = {\n%s\n};\n\n' % (name, '\n'.join(lines)))
+    out.write('/**\n * @brief %d pixels height info array.\n */\n' % height)
+    out.write('char_info_t %s_info[] = {\n' % name)
+    for i, (width, offset) in enumerate(info):
+        out.write('\t{%d, %d}, \t\t/* %s */\n' % (width, offset, chr(FIRST_CHAR + i)))
+    out.write('};\n\n')
+    out.write('Font_t %s = {\n\t%d,\n\t%s_info,\n\t%s_data,\n\tFONT_4BPP\n};\n' % (name, height, name, name))
+
+
+if __name__ == '__main__':
+    main()
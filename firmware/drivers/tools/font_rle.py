@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+"""Converts a 1 bit per pixel font of fonts.c to the run-length encoded format (FONT_RLE).
+
+Each glyph is read row by row as a single stream of pixels. Runs of background and
+foreground pixels alternate, starting with background (it may be 0 pixels long).
+Every run is stored in 4 bit values, high nibble first: 0 to 14 ends the run,
+15 adds 15 pixels and the run continues on the next nibble. Each glyph starts on a
+new byte, char_info_t.offset points to it.
+
+Usage:
+    font_rle.py <fonts.c> <font name> [output.c]
+
+    font_rle.py ../devices/src/fonts.c font59 > font59_rle.c
+
+The output defines <font name>_rle_data, <font name>_rle_info and a Font_t
+<font name>_rle ready to be used with the ILI9341 drawing functions.
+"""
+
+import re
+import sys
+
+RLE_CONTINUE = 15
+
+
+def parse_font(source, name):
+    """Gets data bytes, (width, offset) of each character and height of a font."""
+    match = re.search(r'const uint8_t %s_data\[\] = \{(.*?)\n\};' % name, source, re.S)
+    if match is None:
+        sys.exit('%s_data not found' % name)
+    data = [int(x, 16) for x in re.findall(r'0x[0-9A-Fa-f]{2}', re.sub(r'//.*', '', match.group(1)))]
+    match = re.search(r'char_info_t %s_info\[\] = \{(.*?)\n\};' % name, source, re.S)
+    if match is None:
+        sys.exit('%s_info not found' % name)
+    info = [(int(w), int(o)) for w, o in re.findall(r'\{(\d+),\s*(\d+)\}', match.group(1))]
+    match = re.search(r'Font_t \w+ = \{\s*(\d+),\s*%s_info,' % name, source)
+    if match is None:
+        sys.exit('Font_t using %s_info not found' % name)
+    return data, info, int(match.group(1))
+
+
+def glyph_pixels(data, offset, width, height):
+    """Pixels of a glyph, row by row, 1 for foreground."""
+    row_bytes = (width + 7) // 8
+    return [(data[offset + row * row_bytes + col // 8] >> (7 - col % 8)) & 1
+            for row in range(height) for col in range(width)]
+
+
+def encode(pixels):
+    """Nibble run-length encoding of a glyph."""
+    nibbles = []
+    color = 0
+    run = 0
+    for pixel in pixels + [None]:
+        if pixel == color:
+            run += 1
+            continue
+        while run >= RLE_CONTINUE:
+            nibbles.append(RLE_CONTINUE)
+            run -= RLE_CONTINUE
+        nibbles.append(run)
+        color ^= 1
+        run = 1
+    if len(nibbles) % 2:
+        nibbles.append(0)
+    return [nibbles[i] << 4 | nibbles[i + 1] for i in range(0, len(nibbles), 2)]
+
+
+def main():
+    if len(sys.argv) < 3:
+        sys.exit(__doc__)
+    source = open(sys.argv[1], encoding='utf-8').read()
+    name = sys.argv[2]
+    out = open(sys.argv[3], 'w') if len(sys.argv) > 3 else sys.stdout
+
+    data, info, height = parse_font(source, name)
+    rle = []
+    rle_info = []
+    lines = []
+    for i, (width, offset) in enumerate(info):
+        glyph = encode(glyph_pixels(data, offset, width, height))
+        rle_info.append((width, len(rle)))
+        lines.append('\t/* @%d \'%s\' (%d pixels wide) */' % (len(rle), chr(ord(' ') + i), width))
+        for j in range(0, len(glyph), 12):
+            lines.append('\t' + ' '.join('0x%02X,' % b for b in glyph[j:j + 12]))
+        rle += glyph
+    if len(rle) > 0xFFFF:
+        sys.exit('%s doesn\'t fit uint16_t offsets' % name)
+
+    out.write('/**\n * @brief %d pixels height data array, run-length encoded (%d bytes, %d before).\n */\n'
+              % (height, len(rle), len(data)))
+    out.write('const uint8_t %s_rle_data[] = {\n%s\n};\n\n' % (name, '\n'.join(lines)))
+    out.write('/**\n * @brief %d pixels height info array, run-length encoded.\n */\n' % height)
+    out.write('char_info_t %s_rle_info[] = {\n' % name)
+    for i, (width, offset) in enumerate(rle_info):
+        out.write('\t{%d, %d}, \t\t/* %s */\n' % (width, offset, chr(ord(' ') + i)))
+    out.write('};\n\n')
+    out.write('Font_t %s_rle = {\n\t%d,\n\t%s_rle_info,\n\t%s_rle_data,\n\tFONT_RLE\n};\n'
+              % (name, height, name, name))
+
+
+if __name__ == '__main__':
+    main()
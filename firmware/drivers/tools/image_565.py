@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+"""Converts an image to a compressed RGB565 image_t (IMAGE_QOI565) for ILI9341DrawImage().
+
+The format is described in devices/inc/image.h.
+
+Usage:
+    image_565.py <image.png|.bmp|.jpg> <name> [output.c]
+    image_565.py --array <file.c> <array name> <width> <height> <name> [output.c]
+
+    image_565.py logo.png logo > logo.c
+    image_565.py --array ../devices/src/esp_edu_pic.c picture 240 320 esp_edu_pic > esp_edu_pic_qoi.c
+
+Images need Pillow (pip install pillow). --array reads a raw RGB565 array (2 bytes
+per pixel, high byte first) as used by ILI9341DrawPicture().
+"""
+
+import re
+import sys
+
+INDEX_SIZE = 64
+OP_INDEX = 0x00
+OP_DIFF = 0x40
+OP_LUMA = 0x80
+OP_RUN = 0xC0
+OP_RGB = 0xFE
+MAX_RUN = 62
+
+
+def read_image(path):
+    """RGB565 pixels, width and height of an image file."""
+    try:
+        from PIL import Image
+    except ImportError:
+        sys.exit('Images need Pillow: pip install pillow')
+    image = Image.open(path).convert('RGB')
+    rgb = image.tobytes()
+    pixels = [(rgb[i] >> 3) << 11 | (rgb[i + 1] >> 2) << 5 | (rgb[i + 2] >> 3) for i in range(0, len(rgb), 3)]
+    return pixels, image.width, image.height
+
+
+def read_array(path, name, width, height):
+    """RGB565 pixels of a raw array defined in a C file."""
+    match = re.search(r'%s\[\]\s*=\s*\{(.*?)\}' % name, open(path).read(), re.S)
+    if match is None:
+        sys.exit('%s not found' % name)
+    data = [int(x, 16) for x in re.findall(r'0x([0-9A-Fa-f]{2})', match.group(1))]
+    if len(data) != width * height * 2:
+        sys.exit('%s has %d bytes, %dx%d needs %d' % (name, len(data), width, height, width * height * 2))
+    return [data[i] << 8 | data[i + 1] for i in range(0, len(data), 2)]
+
+
+def channels(color):
+    return color >> 11, (color >> 5) & 0x3F, color & 0x1F
+
+
+def index_of(color):
+    red, green, blue = channels(color)
+    return (3 * red + 5 * green + 7 * blue) % INDEX_SIZE
+
+
+def encode(pixels):
+    """IMAGE_QOI565 bytes of a list of RGB565 pixels."""
+    out = []
+    index = [0] * INDEX_SIZE
+    previous = 0
+    run = 0
+    for color in pixels:
+        if color == previous:
+            run += 1
+            if run == MAX_RUN:
+                out.append(OP_RUN | (run - 1))
+                run = 0
+            continue
+        if run:
+            out.append(OP_RUN | (run - 1))
+            run = 0
+        position = index_of(color)
+        if index[position] == color:
+            out.append(OP_INDEX | position)
+        else:
+            index[position] = color
+            red, green, blue = (a - b for a, b in zip(channels(color), channels(previous)))
+            red_green = red - (green >> 1)
+            blue_green = blue - (green >> 1)
+            if -2 <= red <= 1 and -2 <= green <= 1 and -2 <= blue <= 1:
+                out.append(OP_DIFF | (red + 2) << 4 | (green + 2) << 2 | (blue + 2))
+            elif -32 <= green <= 31 and -8 <= red_green <= 7 and -8 <= blue_green <= 7:
+                out += [OP_LUMA | (green + 32), (red_green + 8) << 4 | (blue_green + 8)]
+            else:
+                out += [OP_RGB, color >> 8, color & 0xFF]
+        previous = color
+    if run:
+        out.append(OP_RUN | (run - 1))
+    return out
+
+
+def main():
+    args = sys.argv[1:]
+    if len(args) >= 5 and args[0] == '--array':
+        width, height = int(args[3]), int(args[4])
+        pixels = read_array(args[1], args[2], width, height)
+        args = args[5:]
+    elif len(args) >= 2 and not args[0].startswith('--'):
+        pixels, width, height = read_image(args[0])
+        args = args[1:]
+    else:
+        sys.exit(__doc__)
+    name = args[0]
+    out = open(args[1], 'w') if len(args) > 1 else sys.stdout
+
+    data = encode(pixels)
+    out.write('#include "image.h"\n\n')
+    out.write('/**\n * @brief %dx%d image, compressed (%d bytes, %d as RGB565).\n */\n'
+              % (width, height, len(data), width * height * 2))
+    out.write('static const uint8_t %s_data[] = {\n' % name)
+    for i in range(0, len(data), 16):
+        out.write('\t' + ' '.join('0x%02X,' % b for b in data[i:i + 16]) + '\n')
+    out.write('};\n\n')
+    out.write('const image_t %s = {\n\t%d,\n\t%d,\n\tIMAGE_QOI565,\n\t%s_data\n};\n' % (name, width, height, name))
+
+
+if __name__ == '__main__':
+    main()
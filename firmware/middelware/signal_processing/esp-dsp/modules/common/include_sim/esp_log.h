@@ -17,8 +17,14 @@
 #ifndef _esp_log_h_
 #define _esp_log_h_
 
+#include <stdio.h>
 #include <stdlib.h>
 
-#define ESP_LOGD
+// Logs are not printed, but the format and the arguments are still checked
+#define ESP_LOG_NONE(tag, format, ...) do { if (0) printf("%s: " format, tag, ##__VA_ARGS__); } while (0)
+#define ESP_LOGD(tag, format, ...) ESP_LOG_NONE(tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) ESP_LOG_NONE(tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) ESP_LOG_NONE(tag, format, ##__VA_ARGS__)
+#define ESP_LOGE(tag, format, ...) ESP_LOG_NONE(tag, format, ##__VA_ARGS__)
 
 #endif // _esp_log_h_
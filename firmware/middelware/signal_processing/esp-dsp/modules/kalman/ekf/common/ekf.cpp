@@ -13,17 +13,47 @@
 // limitations under the License.
 
 #include "ekf.h"
+#include "dspm_mult.h"
 #include <float.h>
 
+ekf::Workspace::Workspace(int x, int w) : fP(x, x),
+    GQ(x, w),
+    Xlast(x, 1),
+    K1(x, 1),
+    K2(x, 1),
+    K3(x, 1),
+    K4(x, 1),
+    Xdot(x, 1)
+{
+    this->F_row = new int[x + 1];
+    this->F_col = new int[x * x];
+    this->F_val = new float[x * x];
+    this->G_row = new int[x + 1];
+    this->G_col = new int[x * w];
+    this->G_val = new float[x * w];
+}
+
+ekf::Workspace::~Workspace()
+{
+    delete[] this->F_row;
+    delete[] this->F_col;
+    delete[] this->F_val;
+    delete[] this->G_row;
+    delete[] this->G_col;
+    delete[] this->G_val;
+}
+
 ekf::ekf(int x, int w) : NUMX(x),
     NUMW(w),
-    X(*new dspm::Mat(x, 1)),
+    X(x, 1),
 
-    F(*new dspm::Mat(x, x)),
-    G(*new dspm::Mat(x, w)),
-    P(*new dspm::Mat(x, x)),
-    Q(*new dspm::Mat(w, w))
+    F(x, x),
+    G(x, w),
+    P(x, x),
+    Q(w, w),
+    ws(x, w)
 {
+    this->update_mode = UPDATE_SEQUENTIAL;
 
     this->P *= 0;
     this->Q *= 0;
@@ -31,7 +61,7 @@ ekf::ekf(int x, int w) : NUMX(x),
     this->X.data[0] = 1; // direction to 0
     this->HP = new float[this->NUMX];
     this->Km = new float[this->NUMX];
-    for (size_t i = 0; i < this->NUMX; i++) {
+    for (int i = 0; i < this->NUMX; i++) {
         this->HP[i] = 0;
         this->Km[i] = 0;
     }
@@ -39,14 +69,8 @@ ekf::ekf(int x, int w) : NUMX(x),
 
 ekf::~ekf()
 {
-    delete &X;
-    delete &F;
-    delete &G;
-    delete &P;
-    delete &Q;
-
-    delete this->HP;
-    delete this->Km;
+    delete[] this->HP;
+    delete[] this->Km;
 }
 
 void ekf::Process(float *u, float dt)
@@ -60,21 +84,35 @@ void ekf::RungeKutta(dspm::Mat &x, float *U, float dt)
 {
 
     float dt2 = dt / 2.0f;
+    float dt6 = dt / 6.0f;
+    dspm::Mat &Xlast = ws.Xlast;
+    dspm::Mat &K1 = ws.K1;
+    dspm::Mat &K2 = ws.K2;
+    dspm::Mat &K3 = ws.K3;
+    dspm::Mat &K4 = ws.K4;
+
+    Xlast = x;          // make a working copy
+    StateXdot(x, U, K1); // k1 = f(x, u)
+    for (int i = 0; i < this->NUMX; i++) {
+        x.data[i] = Xlast.data[i] + K1.data[i] * dt2;
+    }
 
-    dspm::Mat Xlast = x;          // make a working copy
-    dspm::Mat K1 = StateXdot(x, U); // k1 = f(x, u)
-    x = Xlast + (K1 * dt2);
-
-    dspm::Mat K2 = StateXdot(x, U); // k2 = f(x + 0.5*dT*k1, u)
-    x = Xlast + K2 * dt2;
+    StateXdot(x, U, K2); // k2 = f(x + 0.5*dT*k1, u)
+    for (int i = 0; i < this->NUMX; i++) {
+        x.data[i] = Xlast.data[i] + K2.data[i] * dt2;
+    }
 
-    dspm::Mat K3 = StateXdot(x, U); // k3 = f(x + 0.5*dT*k2, u)
-    x = Xlast + K3 * dt;
+    StateXdot(x, U, K3); // k3 = f(x + 0.5*dT*k2, u)
+    for (int i = 0; i < this->NUMX; i++) {
+        x.data[i] = Xlast.data[i] + K3.data[i] * dt;
+    }
 
-    dspm::Mat K4 = StateXdot(x, U); // k4 = f(x + dT * k3, u)
+    StateXdot(x, U, K4); // k4 = f(x + dT * k3, u)
 
     // Xnew = X + dT * (k1 + 2 * k2 + 2 * k3 + k4) / 6
-    x = Xlast + (K1 + 2.0f * K2 + 2.0f * K3 + K4) * (dt / 6.0f);
+    for (int i = 0; i < this->NUMX; i++) {
+        x.data[i] = Xlast.data[i] + (K1.data[i] + 2.0f * K2.data[i] + 2.0f * K3.data[i] + K4.data[i]) * dt6;
+    }
 }
 
 dspm::Mat ekf::SkewSym4x4(float w[3])
@@ -135,7 +173,99 @@ dspm::Mat ekf::qProduct(float *q)
     return result;
 }
 
+// Collect non zero elements of matrix M row by row (compressed sparse rows)
+static void ekf_sparse_rows(const dspm::Mat &M, int *row_start, int *col, float *val)
+{
+    int count = 0;
+    for (int i = 0; i < M.rows; i++) {
+        row_start[i] = count;
+        for (int j = 0; j < M.cols; j++) {
+            if (M(i, j) != 0) {
+                col[count] = j;
+                val[count] = M(i, j);
+                count++;
+            }
+        }
+    }
+    row_start[M.rows] = count;
+}
+
 void ekf::CovariancePrediction(float dt)
+{
+    dspm::Mat &fP = ws.fP;
+    int N = this->NUMX;
+
+    // fP = (I + F*dt)*P = P + dt*F*P, only non zero elements of F are used
+    ekf_sparse_rows(F, ws.F_row, ws.F_col, ws.F_val);
+    fP = P;
+    for (int i = 0; i < N; i++) {
+        for (int n = ws.F_row[i]; n < ws.F_row[i + 1]; n++) {
+            float f = ws.F_val[n] * dt;
+            float *p_row = &P(ws.F_col[n], 0);
+            float *fp_row = &fP(i, 0);
+            for (int j = 0; j < N; j++) {
+                fp_row[j] += f * p_row[j];
+            }
+        }
+    }
+
+    // P = fP*(I + F*dt)', the result is symmetric, so only upper triangle is calculated
+    for (int i = 0; i < N; i++) {
+        for (int j = i; j < N; j++) {
+            float acc = 0;
+            for (int n = ws.F_row[j]; n < ws.F_row[j + 1]; n++) {
+                acc += ws.F_val[n] * fP(i, ws.F_col[n]);
+            }
+            P(i, j) = fP(i, j) + acc * dt;
+        }
+    }
+
+    // P += dt^2*G*Q*G', upper triangle
+    bool Q_diagonal = true;
+    for (int i = 0; i < this->NUMW; i++) {
+        for (int j = 0; j < this->NUMW; j++) {
+            if ((i != j) && (Q(i, j) != 0)) {
+                Q_diagonal = false;
+            }
+        }
+    }
+    float dt2 = dt * dt;
+    if (Q_diagonal) {
+        ekf_sparse_rows(G, ws.G_row, ws.G_col, ws.G_val);
+        for (int n = 0; n < ws.G_row[N]; n++) {
+            ws.G_val[n] *= Q(ws.G_col[n], ws.G_col[n]);
+        }
+        for (int i = 0; i < N; i++) {
+            for (int j = i; j < N; j++) {
+                float acc = 0;
+                for (int n = ws.G_row[i]; n < ws.G_row[i + 1]; n++) {
+                    acc += ws.G_val[n] * G(j, ws.G_col[n]);
+                }
+                P(i, j) += dt2 * acc;
+            }
+        }
+    } else {
+        dspm_mult_f32(G.data, Q.data, ws.GQ.data, N, this->NUMW, this->NUMW);
+        for (int i = 0; i < N; i++) {
+            for (int j = i; j < N; j++) {
+                float acc = 0;
+                for (int k = 0; k < this->NUMW; k++) {
+                    acc += ws.GQ(i, k) * G(j, k);
+                }
+                P(i, j) += dt2 * acc;
+            }
+        }
+    }
+
+    // Copy upper triangle to lower
+    for (int i = 1; i < N; i++) {
+        for (int j = 0; j < i; j++) {
+            P(i, j) = P(j, i);
+        }
+    }
+}
+
+void ekf::CovariancePredictionRef(float dt)
 {
     dspm::Mat f = this->F * dt;
 
@@ -148,8 +278,6 @@ void ekf::CovariancePrediction(float dt)
 void ekf::Update(dspm::Mat &H, float *measured, float *expected, float *R)
 {
     float HPHR, Error;
-    dspm::Mat Y(measured, H.rows, 1);
-    dspm::Mat Z(expected, H.rows, 1);
 
     for (int m = 0; m < H.rows; m++) {
         for (int j = 0; j < this->NUMX; j++) {
@@ -177,7 +305,7 @@ void ekf::Update(dspm::Mat &H, float *measured, float *expected, float *R)
             }
         }
 
-        Error = Y(m, 0) - Z(m, 0);
+        Error = measured[m] - expected[m];
         for (int i = 0; i < this->NUMX; i++) {
             // Find X(m)= X(m-1) + K*Error
             X(i, 0) = X(i, 0) + Km[i] * Error;
@@ -189,7 +317,7 @@ void ekf::UpdateRef(dspm::Mat &H, float *measured, float *expected, float *R)
 {
     dspm::Mat h_t = H.t();
     dspm::Mat S = H * P * h_t; // +diag(R);
-    for (size_t i = 0; i < H.rows; i++) {
+    for (int i = 0; i < H.rows; i++) {
         S(i, i) += R[i];
     }
 
@@ -205,25 +333,104 @@ void ekf::UpdateRef(dspm::Mat &H, float *measured, float *expected, float *R)
     this->X += (K * Err);
 }
 
+void ekf::UpdateJoseph(dspm::Mat &H, float *measured, float *expected, float *R)
+{
+    float S, Error;
+
+    for (int m = 0; m < H.rows; m++) {
+        // HP = h*P, where h - row m of H
+        for (int j = 0; j < this->NUMX; j++) {
+            HP[j] = 0;
+        }
+        for (int k = 0; k < this->NUMX; k++) {
+            float h = H(m, k);
+            if (h == 0) {
+                continue;
+            }
+            for (int j = 0; j < this->NUMX; j++) {
+                HP[j] += h * P(k, j);
+            }
+        }
+        // S = h*P*h' + R
+        S = R[m];
+        for (int k = 0; k < this->NUMX; k++) {
+            S += HP[k] * H(m, k);
+        }
+        float invS = 1.0f / S;
+        for (int k = 0; k < this->NUMX; k++) {
+            Km[k] = HP[k] * invS; // K = P*h'/S
+        }
+        // AP = (I - K*h)*P = P - K*HP, rank-1 correction
+        dspm::Mat &AP = ws.fP;
+        for (int i = 0; i < this->NUMX; i++) {
+            for (int j = 0; j < this->NUMX; j++) {
+                AP(i, j) = P(i, j) - Km[i] * HP[j];
+            }
+        }
+        // HP is not needed anymore, it keeps APh = AP*h'
+        for (int i = 0; i < this->NUMX; i++) {
+            float acc = 0;
+            for (int k = 0; k < this->NUMX; k++) {
+                float h = H(m, k);
+                if (h != 0) {
+                    acc += AP(i, k) * h;
+                }
+            }
+            HP[i] = acc;
+        }
+        // P = AP*(I - K*h)' + K*R*K' = AP - APh*K' + R*K*K'
+        // the result is symmetric, so only upper triangle is calculated
+        for (int i = 0; i < this->NUMX; i++) {
+            for (int j = i; j < this->NUMX; j++) {
+                P(i, j) = P(j, i) = AP(i, j) - HP[i] * Km[j] + R[m] * Km[i] * Km[j];
+            }
+        }
+
+        Error = measured[m] - expected[m];
+        for (int i = 0; i < this->NUMX; i++) {
+            X(i, 0) = X(i, 0) + Km[i] * Error;
+        }
+    }
+}
+
+void ekf::UpdateMeasurement(dspm::Mat &H, float *measured, float *expected, float *R)
+{
+    switch (this->update_mode) {
+    case UPDATE_JOSEPH:
+        this->UpdateJoseph(H, measured, expected, R);
+        break;
+    case UPDATE_REF:
+        this->UpdateRef(H, measured, expected, R);
+        break;
+    default:
+        this->Update(H, measured, expected, R);
+        break;
+    }
+}
+
 dspm::Mat ekf::quat2rotm(float q[4])
+{
+    dspm::Mat Rm(3, 3);
+    quat2rotm(q, Rm.data);
+    return Rm;
+}
+
+void ekf::quat2rotm(const float q[4], float *Rm)
 {
     float q0 = q[0];
     float q1 = q[1];
     float q2 = q[2];
     float q3 = q[3];
-    dspm::Mat Rm(3, 3);
-
-    Rm(0, 0) = q0 * q0 + q1 * q1 - q2 * q2 - q3 * q3;
-    Rm(1, 0) = 2.0f * (q1 * q2 + q0 * q3);
-    Rm(2, 0) = 2.0f * (q1 * q3 - q0 * q2);
-    Rm(0, 1) = 2.0f * (q1 * q2 - q0 * q3);
-    Rm(1, 1) = (q0 * q0 - q1 * q1 + q2 * q2 - q3 * q3);
-    Rm(2, 1) = 2.0f * (q2 * q3 + q0 * q1);
-    Rm(0, 2) = 2.0f * (q1 * q3 + q0 * q2);
-    Rm(1, 2) = 2.0f * (q2 * q3 - q0 * q1);
-    Rm(2, 2) = (q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3);
 
-    return Rm;
+    Rm[0] = q0 * q0 + q1 * q1 - q2 * q2 - q3 * q3;
+    Rm[3] = 2.0f * (q1 * q2 + q0 * q3);
+    Rm[6] = 2.0f * (q1 * q3 - q0 * q2);
+    Rm[1] = 2.0f * (q1 * q2 - q0 * q3);
+    Rm[4] = (q0 * q0 - q1 * q1 + q2 * q2 - q3 * q3);
+    Rm[7] = 2.0f * (q2 * q3 + q0 * q1);
+    Rm[2] = 2.0f * (q1 * q3 + q0 * q2);
+    Rm[5] = 2.0f * (q2 * q3 - q0 * q1);
+    Rm[8] = (q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3);
 }
 
 dspm::Mat ekf::quat2eul(const float q[4])
@@ -388,28 +595,45 @@ dspm::Mat ekf::dFdq(dspm::Mat &vector, dspm::Mat &q)
 dspm::Mat ekf::dFdq_inv(dspm::Mat &vector, dspm::Mat &q)
 {
     dspm::Mat result(3, 4);
-    result(0, 0) = q.data[0] * vector.data[0] + q.data[3] * vector.data[1] - q.data[2] * vector.data[2];
-    result(0, 1) = q.data[1] * vector.data[0] + q.data[2] * vector.data[1] + q.data[3] * vector.data[2];
-    result(0, 2) = -q.data[2] * vector.data[0] + q.data[1] * vector.data[1] - q.data[0] * vector.data[2];
-    result(0, 3) = -q.data[3] * vector.data[0] + q.data[0] * vector.data[1] + q.data[1] * vector.data[2];
-
-    result(1, 0) = -q.data[3] * vector.data[0] + q.data[0] * vector.data[1] + q.data[1] * vector.data[2];
-    result(1, 1) = q.data[2] * vector.data[0] - q.data[1] * vector.data[1] + q.data[0] * vector.data[2];
-    result(1, 2) = q.data[1] * vector.data[0] + q.data[2] * vector.data[1] + q.data[3] * vector.data[2];
-    result(1, 3) = -q.data[0] * vector.data[0] - q.data[3] * vector.data[1] + q.data[2] * vector.data[2];
-
-    result(2, 0) = q.data[2] * vector.data[0] - q.data[1] * vector.data[1] + q.data[0] * vector.data[2];
-    result(2, 1) = q.data[3] * vector.data[0] - q.data[0] * vector.data[1] - q.data[1] * vector.data[2];
-    result(2, 2) = q.data[0] * vector.data[0] + q.data[3] * vector.data[1] - q.data[2] * vector.data[2];
-    result(2, 3) = q.data[1] * vector.data[0] + q.data[2] * vector.data[1] + q.data[3] * vector.data[2];
-
-    result *= 2;
+    dFdq_inv(vector.data, q.data, result.data, result.stride);
     return result;
 }
 
+void ekf::dFdq_inv(const float *v, const float *q, float *result, int stride)
+{
+    float *r0 = result;
+    float *r1 = result + stride;
+    float *r2 = result + 2 * stride;
+
+    r0[0] = 2 * (q[0] * v[0] + q[3] * v[1] - q[2] * v[2]);
+    r0[1] = 2 * (q[1] * v[0] + q[2] * v[1] + q[3] * v[2]);
+    r0[2] = 2 * (-q[2] * v[0] + q[1] * v[1] - q[0] * v[2]);
+    r0[3] = 2 * (-q[3] * v[0] + q[0] * v[1] + q[1] * v[2]);
+
+    r1[0] = 2 * (-q[3] * v[0] + q[0] * v[1] + q[1] * v[2]);
+    r1[1] = 2 * (q[2] * v[0] - q[1] * v[1] + q[0] * v[2]);
+    r1[2] = 2 * (q[1] * v[0] + q[2] * v[1] + q[3] * v[2]);
+    r1[3] = 2 * (-q[0] * v[0] - q[3] * v[1] + q[2] * v[2]);
+
+    r2[0] = 2 * (q[2] * v[0] - q[1] * v[1] + q[0] * v[2]);
+    r2[1] = 2 * (q[3] * v[0] - q[0] * v[1] - q[1] * v[2]);
+    r2[2] = 2 * (q[0] * v[0] + q[3] * v[1] - q[2] * v[2]);
+    r2[3] = 2 * (q[1] * v[0] + q[2] * v[1] + q[3] * v[2]);
+}
+
 dspm::Mat ekf::StateXdot(dspm::Mat &x, float *u)
 {
     dspm::Mat U(u, this->G.cols, 1);
     dspm::Mat Xdot = (this->F * x + this->G * U);
     return Xdot;
 }
+
+void ekf::StateXdot(dspm::Mat &x, float *u, dspm::Mat &xdot)
+{
+    // xdot = F*x + G*u, G*u is calculated to ws.Xdot
+    dspm_mult_f32(this->F.data, x.data, xdot.data, this->NUMX, this->NUMX, 1);
+    dspm_mult_f32(this->G.data, u, ws.Xdot.data, this->NUMX, this->NUMW, 1);
+    for (int i = 0; i < this->NUMX; i++) {
+        xdot.data[i] += ws.Xdot.data[i];
+    }
+}
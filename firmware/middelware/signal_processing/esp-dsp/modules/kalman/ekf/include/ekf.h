@@ -70,26 +70,65 @@ public:
     /**
      * System state vector
     */
-    dspm::Mat &X;
+    dspm::Mat X;
 
     /**
      * Linearized system matrices F, where x[n] = F*x[n-1] + G*u + W
     */
-    dspm::Mat &F;
+    dspm::Mat F;
     /**
      * Linearized system matrices G, where x[n] = F*x[n-1] + G*u + W
     */
-    dspm::Mat &G;
+    dspm::Mat G;
 
     /**
     * Covariance matrix and state vector
     */
-    dspm::Mat &P;
+    dspm::Mat P;
 
     /**
      * Input noise and measurement noise variances
     */
-    dspm::Mat &Q;
+    dspm::Mat Q;
+
+    /**
+     * Buffers for intermediate results of Process() and Update().
+     * All matrices are allocated once in the constructor, so a filter step
+     * does not allocate or free memory.
+    */
+    struct Workspace {
+        /**
+         * Allocate workspace for the filter.
+         * @param[in] x: amount of states in EKF
+         * @param[in] w: amount of control measurements and noise inputs
+        */
+        Workspace(int x, int w);
+        ~Workspace();
+
+        dspm::Mat fP;       /*!< Product (I + F*dt)*P, or (I - K*h)*P in UpdateJoseph(), [x]x[x]*/
+        dspm::Mat GQ;       /*!< Product G*Q for non diagonal Q, [x]x[w]*/
+        dspm::Mat Xlast;    /*!< State vector before Runge-Kutta step, [x]x[1]*/
+        dspm::Mat K1;       /*!< Runge-Kutta derivative k1, [x]x[1]*/
+        dspm::Mat K2;       /*!< Runge-Kutta derivative k2, [x]x[1]*/
+        dspm::Mat K3;       /*!< Runge-Kutta derivative k3, [x]x[1]*/
+        dspm::Mat K4;       /*!< Runge-Kutta derivative k4, [x]x[1]*/
+        dspm::Mat Xdot;     /*!< Result of the Fx + Gu product, [x]x[1]*/
+
+        int *F_row;         /*!< Non zero elements of F: start of each row, [x+1]*/
+        int *F_col;         /*!< Non zero elements of F: column indexes, [x*x]*/
+        float *F_val;       /*!< Non zero elements of F: values, [x*x]*/
+        int *G_row;         /*!< Non zero elements of G: start of each row, [x+1]*/
+        int *G_col;         /*!< Non zero elements of G: column indexes, [x*w]*/
+        float *G_val;       /*!< Non zero elements of G multiplied by Q diagonal, [x*w]*/
+    private:
+        Workspace(const Workspace &);
+        Workspace &operator=(const Workspace &);
+    };
+
+    /**
+     * Workspace for intermediate calculations
+    */
+    Workspace ws;
 
     /**
      * Runge-Kutta state update method.
@@ -112,6 +151,16 @@ public:
      *      - derivative of input vector x and u
      */
     virtual dspm::Mat StateXdot(dspm::Mat &x, float *u);
+
+    /**
+     * Derivative of state vector X, stored to the preallocated matrix.
+     * Used by RungeKutta(). The default implementation calculates F*x + G*u
+     * without temporary matrices, a nonlinear model overrides both overloads.
+     * @param[in] x: state vector
+     * @param[in] u: control measurement
+     * @param[out] xdot: derivative of input vector x and u, [NUMX]x[1]
+     */
+    virtual void StateXdot(dspm::Mat &x, float *u, dspm::Mat &xdot);
     /**
      * Calculation of system state matrices F and G
      * @param[in] x: state vector
@@ -129,6 +178,15 @@ public:
      */
     virtual void CovariancePrediction(float dt);
 
+    /**
+     * Calculates covariance prediction matrix P with dense matrix products.
+     * This method just as a reference for research purpose.
+     * CovariancePrediction() produce the same result, but calculate only upper
+     * triangle of symmetric P and skip zero elements of F and G.
+     * @param[in] dt: time interval from last update
+     */
+    void CovariancePredictionRef(float dt);
+
     /**
      * Update of current state by measured values.
      * Optimized method for non correlated values
@@ -150,6 +208,45 @@ public:
      */
     virtual void UpdateRef(dspm::Mat &H, float *measured, float *expected, float *R);
 
+    /**
+     * Update of current state by measured values.
+     * Measurements are processed one by one as scalars, so no matrix inversion is needed.
+     * The covariance matrix P is updated in Joseph form
+     * P = (I - K*h)*P*(I - K*h)' + K*R*K', calculated as rank-1 corrections:
+     * AP = P - K*(h*P), then P = AP - (AP*h')*K' + R*K*K'. It keeps P symmetric
+     * and positive when K has rounding errors, with [x]x[x] operations for each
+     * measurement.
+     * Valid for non correlated values (diagonal R).
+     * @param[in] H: derivative matrix
+     * @param[in] measured: array of measured values
+     * @param[in] expected: array of expected values
+     * @param[in] R: measurement noise covariance values
+     */
+    virtual void UpdateJoseph(dspm::Mat &H, float *measured, float *expected, float *R);
+
+    /**
+     * Measurement update methods
+     */
+    typedef enum {
+        UPDATE_SEQUENTIAL = 0,  /*!< Update(): scalar updates, P = P - K*H*P */
+        UPDATE_JOSEPH = 1,      /*!< UpdateJoseph(): scalar updates in Joseph form */
+        UPDATE_REF = 2,         /*!< UpdateRef(): matrix update with pseudo inverse */
+    } update_mode_t;
+
+    /**
+     * Method used by UpdateMeasurement(). Default is UPDATE_SEQUENTIAL.
+     */
+    update_mode_t update_mode;
+
+    /**
+     * Update of current state by measured values with method selected by update_mode.
+     * @param[in] H: derivative matrix
+     * @param[in] measured: array of measured values
+     * @param[in] expected: array of expected values
+     * @param[in] R: measurement noise covariance values
+     */
+    void UpdateMeasurement(dspm::Mat &H, float *measured, float *expected, float *R);
+
     /**
      * Matrix for intermidieve calculations
     */
@@ -170,6 +267,13 @@ public:
      */
     static dspm::Mat quat2rotm(float q[4]);
 
+    /**
+     * Convert quaternion to rotation matrix without allocation.
+     * @param[in] q: quaternion
+     * @param[out] Rm: row-major rotation matrix 3x3
+     */
+    static void quat2rotm(const float q[4], float *Rm);
+
     /**
      * Convert rotation matrix to quaternion.
      * @param[in] R: rotation matrix
@@ -225,6 +329,15 @@ public:
      */
     static dspm::Mat dFdq_inv(dspm::Mat &vector, dspm::Mat &quat);
 
+    /**
+     * Df/dq: Derivative of vector by inverted quaternion, without allocation.
+     * @param[in] vector: input vector 3x1
+     * @param[in] quat: quaternion 4x1
+     * @param[out] result: destination of the 3x4 derivative matrix
+     * @param[in] stride: row stride of the destination
+     */
+    static void dFdq_inv(const float *vector, const float *quat, float *result, int stride);
+
     /**
      * Make skew-symmetric matrix of vector.
      * @param[in] w: source vector
@@ -16,7 +16,8 @@
 
 ekf_imu13states::ekf_imu13states() : ekf(13, 18),
     mag0(3, 1),
-    accel0(3, 1)
+    accel0(3, 1),
+    Hm(10, 13)
 {
     this->NUMU = 3;
 }
@@ -51,53 +52,77 @@ void ekf_imu13states::Init()
 }
 
 dspm::Mat ekf_imu13states::StateXdot(dspm::Mat &x, float *u)
+{
+    dspm::Mat Xdot(this->NUMX, 1);
+    StateXdot(x, u, Xdot);
+    return Xdot;
+}
+
+void ekf_imu13states::StateXdot(dspm::Mat &x, float *u, dspm::Mat &xdot)
 {
     float wx = u[0] - x(4, 0); // subtract the biases on gyros
     float wy = u[1] - x(5, 0);
     float wz = u[2] - x(6, 0);
-
-    float w[] = {wx, wy, wz};
-    dspm::Mat q = dspm::Mat(x.data, 4, 1);
-
-    // qdot = Q * w
-    dspm::Mat Omega = 0.5 * SkewSym4x4(w);
-    dspm::Mat qdot = Omega * q;
-    dspm::Mat Xdot(this->NUMX, 1);
-    Xdot *= 0;
-    Xdot.Copy(qdot, 0, 0);
+    float *q = x.data;
+
+    // qdot = 0.5 * SkewSym4x4(w) * q
+    xdot.clear();
+    xdot.data[0] = 0.5f * (-wx * q[1] - wy * q[2] - wz * q[3]);
+    xdot.data[1] = 0.5f * (wx * q[0] + wz * q[2] - wy * q[3]);
+    xdot.data[2] = 0.5f * (wy * q[0] - wz * q[1] + wx * q[3]);
+    xdot.data[3] = 0.5f * (wz * q[0] + wy * q[1] - wx * q[2]);
     // dwbias = 0
     // dMang_Ampl = 0
     // dMang_offset = 0
-    return Xdot;
 }
 
 void ekf_imu13states::LinearizeFG(dspm::Mat &x, float *u)
 {
     float w[3] = {(u[0] - x(4, 0)), (u[1] - x(5, 0)), (u[2] - x(6, 0))}; // subtract the biases on gyros
-    // float w[3] = {u[0], u[1], u[2]}; // subtract the biases on gyros
-
-    this->F *= 0; // Initialize F and G matrixes.
-    this->G *= 0;
-
-    // dqdot / dq - skey matrix
-    F.Copy(0.5 * ekf::SkewSym4x4(w), 0, 0);
-
-    // dqdot/dvector
-    dspm::Mat dq = -0.5 * qProduct(x.data);
-    dspm::Mat dq_q = dq.Get(0, 4, 1, 3);
-
-    // dqdot / dnw
-    G.Copy(dq_q, 0, 0);
-    // dqdot / dwbias
-    F.Copy(dq_q, 0, 4);
-
-    dspm::Mat rotm = -1 * this->quat2rotm(x.data); // Convert quat to rotation matrix
+    float *q = x.data;
+
+    this->F.clear(); // Initialize F and G matrixes.
+    this->G.clear();
+
+    // dqdot / dq - skey matrix, 0.5 * SkewSym4x4(w)
+    F(0, 1) = -0.5f * w[0];
+    F(0, 2) = -0.5f * w[1];
+    F(0, 3) = -0.5f * w[2];
+    F(1, 0) = 0.5f * w[0];
+    F(1, 2) = 0.5f * w[2];
+    F(1, 3) = -0.5f * w[1];
+    F(2, 0) = 0.5f * w[1];
+    F(2, 1) = -0.5f * w[2];
+    F(2, 3) = 0.5f * w[0];
+    F(3, 0) = 0.5f * w[2];
+    F(3, 1) = 0.5f * w[1];
+    F(3, 2) = -0.5f * w[0];
+
+    // dqdot/dvector, columns 1..3 of -0.5 * qProduct(q)
+    float dq_q[4][3] = {
+        { 0.5f * q[1],  0.5f * q[2],  0.5f * q[3]},
+        {-0.5f * q[0],  0.5f * q[3], -0.5f * q[2]},
+        {-0.5f * q[3], -0.5f * q[0],  0.5f * q[1]},
+        { 0.5f * q[2], -0.5f * q[1], -0.5f * q[0]},
+    };
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 3; j++) {
+            G(i, j) = dq_q[i][j];     // dqdot / dnw
+            F(i, j + 4) = dq_q[i][j]; // dqdot / dwbias
+        }
+    }
 
-    G.Copy(rotm, 7, 6);
-    G.Copy(dspm::Mat::eye(3), 4, 3);   // random noise wbias
-    G.Copy(dspm::Mat::eye(3), 7, 12);  // random noise magnetometer amplitude
-    G.Copy(dspm::Mat::eye(3), 10, 9);  // magnetometer offset constant
-    G.Copy(dspm::Mat::eye(3), 10, 15); // random noise offset constant
+    float rotm[9];
+    this->quat2rotm(q, rotm); // Convert quat to rotation matrix
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            G(i + 7, j + 6) = -rotm[i * 3 + j];
+        }
+        G(i + 4, i + 3) = 1;    // random noise wbias
+        G(i + 7, i + 12) = 1;   // random noise magnetometer amplitude
+        G(i + 10, i + 9) = 1;   // magnetometer offset constant
+        G(i + 10, i + 15) = 1;  // random noise offset constant
+    }
 }
 
 void ekf_imu13states::Test()
@@ -108,7 +133,7 @@ void ekf_imu13states::Test()
     }
     printf("Allocate data = %i\n", this->NUMU);
     float *test_u = new float[this->NUMU];
-    for (size_t i = 0; i < this->NUMU; i++) {
+    for (int i = 0; i < this->NUMU; i++) {
         test_u[i] = i;
     }
     dspm::Mat result_StateXdot = StateXdot(test_x, test_u);
@@ -144,7 +169,7 @@ void ekf_imu13states::TestFull(bool enable_att)
     gyro_err *= 1;
 
     std::cout << "Gyro error: " << gyro_err.t() << std::endl;
-    for (size_t n = 1; n < total_N * 3; n++) {
+    for (int n = 1; n < total_N * 3; n++) {
         if ((n % 1000) == 0) {
             std::cout << "Loop " << n << " from " << total_N * 16;
             std::cout << ", State data : " << this->X.t();
@@ -184,110 +209,102 @@ void ekf_imu13states::TestFull(bool enable_att)
     std::cout << "Final State data : " << this->X.t() << std::endl;
 }
 
-void ekf_imu13states::UpdateRefMeasurement(float *accel_data, float *magn_data, float R[6])
+// Fill measurement matrix H and expected magnetometer/accelerometer values for current state
+static void ekf_imu13states_ref_h(ekf_imu13states *ekf13, dspm::Mat &H, float *expected_data, bool magn_states)
 {
-    dspm::Mat quat(this->X.data, 4, 1);
-    dspm::Mat H = 0 * dspm::Mat(6, this->NUMX);
-    dspm::Mat Re = this->quat2rotm(quat.data).t();
-
+    float *quat = ekf13->X.data;
+    float *magn = &ekf13->X.data[7];
+    float *magn_offset = &ekf13->X.data[10];
+    float Rm[9];
+    ekf::quat2rotm(quat, Rm);
+
+    H.clear();
+    if (magn_states) {
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                H(i, j + 7) = Rm[j * 3 + i]; // Re = Rm'
+            }
+            H(i, i + 10) = 1;
+        }
+    }
     // dAccel/dq
-    dspm::Mat dAccel_dq = ekf::dFdq_inv(this->accel0, quat);
-    H.Copy(dAccel_dq, 3, 0);
-
+    ekf::dFdq_inv(ekf13->accel0.data, quat, &H(3, 0), H.stride);
     // dMagn/dq
-    dspm::Mat magn(&this->X.data[7], 3, 1);
-    dspm::Mat magn_offset(&this->X.data[10], 3, 1);
-    dspm::Mat dMagn_dq = ekf::dFdq_inv(magn, quat);
-    H.Copy(dMagn_dq, 0, 0);
+    ekf::dFdq_inv(magn, quat, &H(0, 0), H.stride);
+
+    // expected_magn = Re * magn + magn_offset, expected_accel = Re * accel0
+    for (int i = 0; i < 3; i++) {
+        expected_data[i] = magn_offset[i];
+        expected_data[i + 3] = 0;
+        for (int j = 0; j < 3; j++) {
+            expected_data[i] += Rm[j * 3 + i] * magn[j];
+            expected_data[i + 3] += Rm[j * 3 + i] * ekf13->accel0.data[j];
+        }
+    }
+}
+
+static void ekf_imu13states_normalize_quat(float *q)
+{
+    float inv_norm = 1.0f / sqrtf(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+    for (int i = 0; i < 4; i++) {
+        q[i] *= inv_norm;
+    }
+}
 
-    dspm::Mat expected_magn = Re * magn + magn_offset;
-    dspm::Mat expected_accel = Re * this->accel0;
+void ekf_imu13states::UpdateRefMeasurement(float *accel_data, float *magn_data, float R[6])
+{
+    dspm::Mat H(this->Hm.data, 6, this->NUMX);
 
     float measured_data[6];
     float expected_data[6];
+    ekf_imu13states_ref_h(this, H, expected_data, false);
     for (size_t i = 0; i < 3; i++) {
         measured_data[i] = magn_data[i];
-        expected_data[i] = expected_magn.data[i];
         measured_data[i + 3] = accel_data[i];
-        expected_data[i + 3] = expected_accel.data[i];
     }
 
-    this->Update(H, measured_data, expected_data, R);
-    quat /= quat.norm();
+    this->UpdateMeasurement(H, measured_data, expected_data, R);
+    ekf_imu13states_normalize_quat(this->X.data);
 }
 
 void ekf_imu13states::UpdateRefMeasurementMagn(float *accel_data, float *magn_data, float R[6])
 {
-    dspm::Mat quat(this->X.data, 4, 1);
-    dspm::Mat H = 0 * dspm::Mat(6, this->NUMX);
-    dspm::Mat Re = this->quat2rotm(quat.data).t();
-
-    // We include these two line to update magnetometer initial state
-    H.Copy(Re, 0, 7);
-    H.Copy(dspm::Mat::eye(3), 0, 10);
-
-    // dAccel/dq
-    dspm::Mat dAccel_dq = ekf::dFdq_inv(this->accel0, quat);
-    H.Copy(dAccel_dq, 3, 0);
-
-    // dMagn/dq
-    dspm::Mat magn(&this->X.data[7], 3, 1);
-    dspm::Mat magn_offset(&this->X.data[10], 3, 1);
-    dspm::Mat dMagn_dq = ekf::dFdq_inv(magn, quat);
-    H.Copy(dMagn_dq, 0, 0);
-
-    dspm::Mat expected_magn = Re * magn + magn_offset;
-    dspm::Mat expected_accel = Re * this->accel0;
+    dspm::Mat H(this->Hm.data, 6, this->NUMX);
 
     float measured_data[6];
     float expected_data[6];
+    // We include magnetometer states to update magnetometer initial state
+    ekf_imu13states_ref_h(this, H, expected_data, true);
     for (size_t i = 0; i < 3; i++) {
         measured_data[i] = magn_data[i];
-        expected_data[i] = expected_magn.data[i];
         measured_data[i + 3] = accel_data[i];
-        expected_data[i + 3] = expected_accel.data[i];
     }
 
-    this->Update(H, measured_data, expected_data, R);
-    quat /= quat.norm();
+    this->UpdateMeasurement(H, measured_data, expected_data, R);
+    ekf_imu13states_normalize_quat(this->X.data);
 }
 
 void ekf_imu13states::UpdateRefMeasurement(float *accel_data, float *magn_data, float *attitude, float R[10])
 {
-    dspm::Mat quat(this->X.data, 4, 1);
-    dspm::Mat H = 0 * dspm::Mat(10, this->NUMX);
-    dspm::Mat Re = this->quat2rotm(quat.data).t();
-
-    H.Copy(Re, 0, 7);
-    H.Copy(dspm::Mat::eye(3), 0, 10);
-    // dAccel/dq
-    dspm::Mat dAccel_dq = ekf::dFdq_inv(this->accel0, quat);
-    H.Copy(dAccel_dq, 3, 0);
-    // dMagn/dq
-    dspm::Mat magn(&this->X.data[7], 3, 1);
-    dspm::Mat magn_offset(&this->X.data[10], 3, 1);
-    dspm::Mat dMagn_dq = ekf::dFdq_inv(magn, quat);
-    H.Copy(dMagn_dq, 0, 0);
-
-    // dq/dq
-    H.Copy(dspm::Mat::eye(4), 6, 1);
-
-    dspm::Mat expected_magn = Re * magn + magn_offset;
-    dspm::Mat expected_accel = Re * this->accel0;
+    dspm::Mat H(this->Hm.data, 10, this->NUMX);
 
     float measured_data[10];
     float expected_data[10];
+    ekf_imu13states_ref_h(this, H, expected_data, true);
+    // dq/dq
+    for (size_t i = 0; i < 4; i++) {
+        H(i + 6, i + 1) = 1;
+    }
+
     for (size_t i = 0; i < 3; i++) {
         measured_data[i] = magn_data[i];
-        expected_data[i] = expected_magn.data[i];
         measured_data[i + 3] = accel_data[i];
-        expected_data[i + 3] = expected_accel.data[i];
     }
     for (size_t i = 0; i < 4; i++) {
         measured_data[i + 6] = attitude[i];
         expected_data[i + 6] = this->X.data[i];
     }
 
-    this->Update(H, measured_data, expected_data, R);
-    quat /= quat.norm();
+    this->UpdateMeasurement(H, measured_data, expected_data, R);
+    ekf_imu13states_normalize_quat(this->X.data);
 }
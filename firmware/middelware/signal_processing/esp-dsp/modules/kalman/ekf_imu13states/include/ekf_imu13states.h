@@ -37,6 +37,7 @@ public:
     // Method calculates Xdot values depends on U
     // U - gyroscope values in radian per seconds (rad/sec)
     virtual dspm::Mat StateXdot(dspm::Mat &x, float *u);
+    virtual void StateXdot(dspm::Mat &x, float *u, dspm::Mat &xdot);
     virtual void LinearizeFG(dspm::Mat &x, float *u);
 
     /**
@@ -64,6 +65,11 @@ public:
     */
     int NUMU;
 
+    /**
+    * Buffer for measurement derivative matrix H, up to 10 measurements.
+    */
+    dspm::Mat Hm;
+
     /**
      * Update part of system state by reference measurements accelerometer and magnetometer.
      * Only attitude and gyro bias will be updated.
@@ -58,3 +58,28 @@ TEST_CASE("ekf_imu13states functionality gyro and magn", "[dspm]")
     printf("Expected result = %i, calculated result = %i\n", 200, (int)(1000 * ekf13->X.data[5] + 0.5));
     printf("Expected result = %i, calculated result = %i\n", 300, (int)(1000 * ekf13->X.data[6] + 0.5));
 }
+
+TEST_CASE("ekf_imu13states Joseph form update vs reference update", "[dspm]")
+{
+    ekf_imu13states *ekf_ref = new  ekf_imu13states();
+    ekf_ref->Init();
+    ekf_ref->update_mode = ekf::UPDATE_REF;
+    unsigned int start_b = xthal_get_ccount();
+    ekf_ref->TestFull(false);
+    unsigned int end_b = xthal_get_ccount();
+    ESP_LOGI(TAG, "UpdateRef total time %i (K cycles)", (end_b - start_b) / 1000);
+
+    ekf_imu13states *ekf_joseph = new  ekf_imu13states();
+    ekf_joseph->Init();
+    ekf_joseph->update_mode = ekf::UPDATE_JOSEPH;
+    start_b = xthal_get_ccount();
+    ekf_joseph->TestFull(false);
+    end_b = xthal_get_ccount();
+    ESP_LOGI(TAG, "UpdateJoseph total time %i (K cycles)", (end_b - start_b) / 1000);
+
+    for (int i = 0; i < 7; i++) {
+        TEST_ASSERT_LESS_THAN(10, (int)(1000 * abs(ekf_ref->X.data[i] - ekf_joseph->X.data[i])));
+    }
+    delete ekf_ref;
+    delete ekf_joseph;
+}
@@ -0,0 +1,16 @@
+#include <stdlib.h>
+#include <stdio.h>
+
+int test_ekf_step();
+int test_ekf_covariance();
+int test_ekf_update();
+
+int main(void)
+{
+    printf("main starts!\n");
+    int result = test_ekf_step();
+    result |= test_ekf_covariance();
+    result |= test_ekf_update();
+    printf("Test done\n");
+    return result;
+}
@@ -0,0 +1,113 @@
+// Copyright 2018-2019 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "ekf_imu13states.h"
+
+static double time_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Multiply-accumulate operations of the dense reference: f*P, fP*f', G*Q, GQ*G'
+static int dense_macs(int x, int w)
+{
+    return x * x * x + x * x * x + x * w * w + x * w * x;
+}
+
+// Multiply-accumulate operations of the symmetric sparse path for current F and G
+static int sparse_macs(ekf *filter)
+{
+    int x = filter->NUMX;
+    int macs = 0;
+    for (int i = 0; i < x; i++) {
+        int f_nz = 0;
+        int g_nz = 0;
+        for (int k = 0; k < x; k++) {
+            f_nz += (filter->F(i, k) != 0);
+        }
+        for (int k = 0; k < filter->NUMW; k++) {
+            g_nz += (filter->G(i, k) != 0);
+        }
+        macs += f_nz * x;           // F*P
+        macs += f_nz * (i + 1);     // fP*f', upper triangle
+        macs += g_nz * (x - i);     // G*Q*G', upper triangle
+    }
+    return macs;
+}
+
+int test_ekf_covariance()
+{
+    const int repeat_count = 20000;
+    float dt = 0.01;
+    float gyro[3] = {0.3, -0.2, 0.1};
+
+    ekf_imu13states *ekf13 = new ekf_imu13states();
+    ekf13->Init();
+    ekf13->X.data[4] = 0.01;
+    ekf13->LinearizeFG(ekf13->X, gyro);
+
+    int N = ekf13->NUMX;
+    dspm::Mat P0(N, N);
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j <= i; j++) {
+            P0(i, j) = P0(j, i) = (i == j) ? 1.0f + i * 0.1f : 0.01f * (i + j);
+        }
+    }
+
+    ekf13->P = P0;
+    ekf13->CovariancePredictionRef(dt);
+    dspm::Mat P_ref = ekf13->P;
+    ekf13->P = P0;
+    ekf13->CovariancePrediction(dt);
+
+    float max_err = 0;
+    for (int i = 0; i < N * N; i++) {
+        float err = fabsf(ekf13->P.data[i] - P_ref.data[i]);
+        max_err = err > max_err ? err : max_err;
+    }
+
+    double start = time_sec();
+    for (int i = 0; i < repeat_count; i++) {
+        ekf13->P = P0;
+        ekf13->CovariancePredictionRef(dt);
+    }
+    double ref_time = (time_sec() - start) / repeat_count;
+
+    start = time_sec();
+    for (int i = 0; i < repeat_count; i++) {
+        ekf13->P = P0;
+        ekf13->CovariancePrediction(dt);
+    }
+    double opt_time = (time_sec() - start) / repeat_count;
+
+    printf("CovariancePredictionRef: %i MAC, %f us\n", dense_macs(N, ekf13->NUMW), ref_time * 1e6);
+    printf("CovariancePrediction:    %i MAC, %f us\n", sparse_macs(ekf13), opt_time * 1e6);
+    printf("Max difference: %g\n", max_err);
+    delete ekf13;
+
+    if (max_err > 1e-5) {
+        printf("Test Fail! Covariance prediction differs from reference.\n");
+        return 1;
+    }
+    printf("Test Pass!\n");
+    return 0;
+}
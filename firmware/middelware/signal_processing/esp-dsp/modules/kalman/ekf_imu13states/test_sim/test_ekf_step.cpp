@@ -0,0 +1,168 @@
+// Copyright 2018-2019 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <new>
+#include <algorithm>
+
+#include "ekf_imu13states.h"
+
+// Interposed allocator: counts every heap request made through malloc/calloc/realloc,
+// new and new[] are served by malloc
+static long alloc_count = 0;
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t n, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size)
+{
+    alloc_count++;
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t n, size_t size)
+{
+    alloc_count++;
+    return __libc_calloc(n, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    alloc_count++;
+    return __libc_realloc(ptr, size);
+}
+}
+
+void *operator new(size_t size)
+{
+    void *ptr = malloc(size ? size : 1);
+    if (ptr == NULL) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void *ptr, size_t size) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void *ptr, size_t size) noexcept
+{
+    free(ptr);
+}
+
+static double time_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Simulated sensor data: slow rotation, constant gyro bias
+static void sensor_data(int n, float *gyro, float *accel, float *magn)
+{
+    float t = n * 0.01f;
+    gyro[0] = 0.3f * sinf(t) + 0.1f;
+    gyro[1] = 0.2f * cosf(t) + 0.2f;
+    gyro[2] = 0.1f * sinf(0.5f * t) + 0.3f;
+    accel[0] = 0.1f * sinf(t);
+    accel[1] = 0.1f * cosf(t);
+    accel[2] = sqrtf(1 - accel[0] * accel[0] - accel[1] * accel[1]);
+    magn[0] = cosf(0.2f * t);
+    magn[1] = sinf(0.2f * t);
+    magn[2] = 0;
+}
+
+int test_ekf_step()
+{
+    const int total_N = 20000;
+    float dt = 0.01;
+    float R[10];
+    for (size_t i = 0; i < 10; i++) {
+        R[i] = 0.01;
+    }
+    float gyro[3], accel[3], magn[3];
+
+    ekf_imu13states *ekf13 = new ekf_imu13states();
+    ekf13->Init();
+
+    long process_allocs = 0;
+    long update_allocs = 0;
+    double start = time_sec();
+    for (int n = 0; n < total_N; n++) {
+        sensor_data(n, gyro, accel, magn);
+        long before = alloc_count;
+        ekf13->Process(gyro, dt);
+        process_allocs += alloc_count - before;
+
+        before = alloc_count;
+        ekf13->UpdateRefMeasurement(accel, magn, R);
+        update_allocs += alloc_count - before;
+    }
+    double total = time_sec() - start;
+
+    printf("Process():              %f allocations per step\n", (float)process_allocs / total_N);
+    printf("UpdateRefMeasurement(): %f allocations per step\n", (float)update_allocs / total_N);
+    printf("Performance: %i steps/sec (%f us per step)\n", (int)(total_N / total), 1e6 * total / total_N);
+    printf("State data : %f %f %f\n", ekf13->X.data[4], ekf13->X.data[5], ekf13->X.data[6]);
+
+    // Default F*x + G*u derivative, with F and G of the last step
+    float u[18];
+    for (int i = 0; i < 18; i++) {
+        u[i] = 0.1f * (i + 1);
+    }
+    dspm::Mat xdot(ekf13->NUMX, 1);
+    dspm::Mat expected = ekf13->ekf::StateXdot(ekf13->X, u);
+    long before = alloc_count;
+    ekf13->ekf::StateXdot(ekf13->X, u, xdot);
+    long xdot_allocs = alloc_count - before;
+    float xdot_diff = 0;
+    for (int i = 0; i < ekf13->NUMX; i++) {
+        xdot_diff = std::max(xdot_diff, fabsf(xdot.data[i] - expected.data[i]));
+    }
+    printf("StateXdot():            %li allocations, difference %f\n", xdot_allocs, xdot_diff);
+    delete ekf13;
+
+    if ((process_allocs != 0) || (update_allocs != 0) || (xdot_allocs != 0)) {
+        printf("Test Fail! The EKF step should not use heap memory.\n");
+        return 1;
+    }
+    if (xdot_diff > 1e-5f) {
+        printf("Test Fail! StateXdot differs from F*x + G*u.\n");
+        return 1;
+    }
+    printf("Test Pass!\n");
+    return 0;
+}
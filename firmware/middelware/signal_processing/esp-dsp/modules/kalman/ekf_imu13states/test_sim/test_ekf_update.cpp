@@ -0,0 +1,102 @@
+// Copyright 2018-2019 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include "ekf_imu13states.h"
+
+static double time_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Run TestFull() trajectory with selected update method, return execution time
+static double run_full(ekf::update_mode_t mode, bool enable_att, float *state)
+{
+    ekf_imu13states *ekf13 = new ekf_imu13states();
+    ekf13->Init();
+    ekf13->update_mode = mode;
+    double start = time_sec();
+    ekf13->TestFull(enable_att);
+    double total = time_sec() - start;
+    for (int i = 0; i < ekf13->NUMX; i++) {
+        state[i] = ekf13->X.data[i];
+    }
+    delete ekf13;
+    return total;
+}
+
+// Latency of one 6 values update by accelerometer and magnetometer
+static double update_latency(ekf::update_mode_t mode)
+{
+    const int repeat_count = 20000;
+    float accel[3] = {0.1, 0.2, 0.97};
+    float magn[3] = {0.9, 0.1, 0.1};
+    float R[6] = {0.01, 0.01, 0.01, 0.01, 0.01, 0.01};
+    ekf_imu13states *ekf13 = new ekf_imu13states();
+    ekf13->Init();
+    ekf13->update_mode = mode;
+    dspm::Mat P0 = ekf13->P;
+    dspm::Mat X0 = ekf13->X;
+    double start = time_sec();
+    for (int i = 0; i < repeat_count; i++) {
+        ekf13->P = P0;
+        ekf13->X = X0;
+        ekf13->UpdateRefMeasurement(accel, magn, R);
+    }
+    double total = (time_sec() - start) / repeat_count;
+    delete ekf13;
+    return total;
+}
+
+int test_ekf_update()
+{
+    int result = 0;
+    float state_ref[13];
+    float state_joseph[13];
+    for (int att = 0; att < 2; att++) {
+        double ref_time = run_full(ekf::UPDATE_REF, att, state_ref);
+        double joseph_time = run_full(ekf::UPDATE_JOSEPH, att, state_joseph);
+        float max_err = 0;
+        for (int i = 0; i < 7; i++) {
+            float err = fabsf(state_ref[i] - state_joseph[i]);
+            max_err = err > max_err ? err : max_err;
+        }
+        printf("TestFull(%i): UpdateRef %f s, UpdateJoseph %f s, max quaternion/bias difference %f\n",
+               att, ref_time, joseph_time, max_err);
+        if (max_err > 0.01) {
+            printf("Test Fail! UpdateJoseph result differs from UpdateRef.\n");
+            result = 1;
+        }
+    }
+    double ref_latency = update_latency(ekf::UPDATE_REF);
+    double joseph_latency = update_latency(ekf::UPDATE_JOSEPH);
+    printf("UpdateRefMeasurement latency: UpdateRef %f us, Update %f us, UpdateJoseph %f us\n",
+           ref_latency * 1e6,
+           update_latency(ekf::UPDATE_SEQUENTIAL) * 1e6,
+           joseph_latency * 1e6);
+    if (joseph_latency >= ref_latency) {
+        printf("Test Fail! UpdateJoseph is not faster than UpdateRef.\n");
+        result = 1;
+    }
+    if (result == 0) {
+        printf("Test Pass!\n");
+    }
+    return result;
+}
@@ -412,6 +412,8 @@ public:
      * @brief   Solve the matrix
      *
      * Solve matrix. Find roots for the matrix A*x = b
+     * Symmetric positive definite matrices are solved by Cholesky decomposition,
+     * other by Gaussian elimination.
      *
      * @param[in] A: matrix [N]x[N] with input coefficients
      * @param[in] b: vector [N]x[1] with result values
@@ -499,12 +501,72 @@ public:
 
     /**
      * Find pseudo inverse matrix
+     * Symmetric positive definite matrices are inverted by Cholesky decomposition.
      *
      * @return
      *      - inverse matrix
      */
     Mat pinv();
 
+    /**
+     * @brief   In-place Cholesky decomposition
+     *
+     * Decomposition of symmetric positive definite matrix A = L*L'.
+     * Only lower triangle of the matrix is used. The matrix is replaced by L,
+     * upper triangle is filled with 0.
+     *
+     * @return
+     *      - true on success
+     *      - false if matrix is not square or not positive definite
+     */
+    bool cholesky();
+
+    /**
+     * @brief   In-place LDL' decomposition
+     *
+     * Decomposition of symmetric matrix A = L*D*L', where L is unit lower triangular
+     * and D is diagonal. Only lower triangle of the matrix is used. The matrix is replaced
+     * by L below diagonal and D on diagonal, upper triangle is filled with 0.
+     * No square roots are needed, and matrix could be indefinite.
+     *
+     * @return
+     *      - true on success
+     *      - false if matrix is not square or has zero pivot
+     */
+    bool ldlt();
+
+    /**
+     * @brief   Forward substitution
+     *
+     * Solve L*x = b for every column of b, the result replaces b.
+     *
+     * @param[in] L: lower triangular matrix [N]x[N]
+     * @param[inout] b: matrix [N]x[K] with right sides, replaced by result
+     * @param[in] unit_diag: diagonal of L is 1 and not stored (LDL' factor)
+     */
+    static void solveLower(const Mat &L, Mat &b, bool unit_diag = false);
+
+    /**
+     * @brief   Backward substitution with transposed lower triangular matrix
+     *
+     * Solve L'*x = b for every column of b, the result replaces b.
+     *
+     * @param[in] L: lower triangular matrix [N]x[N]
+     * @param[inout] b: matrix [N]x[K] with right sides, replaced by result
+     * @param[in] unit_diag: diagonal of L is 1 and not stored (LDL' factor)
+     */
+    static void solveLowerT(const Mat &L, Mat &b, bool unit_diag = false);
+
+    /**
+     * @brief   Check matrix symmetry
+     *
+     * @param[in] rel_tol: max relative difference between A[i][j] and A[j][i]
+     *
+     * @return
+     *      - true if matrix is square and symmetric
+     */
+    bool isSymmetric(float rel_tol = 1e-5);
+
     /**
      * Find determinant
      * @param[in] n: element number in first row
@@ -520,6 +582,72 @@ private:
     void allocate(); // Allocate buffer
     Mat expHelper(const Mat &m, int num);
 };
+/**
+ * @brief   Cached factorization of symmetric matrix
+ *
+ * The class keeps Cholesky (L*L') or LDL' decomposition of a symmetric matrix.
+ * Memory is allocated once in constructor, so the matrix could be factorized
+ * and the system solved many times without heap allocations.
+ */
+class Cholesky {
+public:
+    /**
+     * Constructor allocate internal buffer.
+     * @param[in] size: size of the square matrix
+     * @param[in] ldl: use LDL' decomposition instead of L*L'
+     */
+    Cholesky(int size, bool ldl = false);
+
+    /**
+     * Factorize matrix. Only lower triangle of A is used.
+     * @param[in] A: symmetric matrix [size]x[size]
+     *
+     * @return
+     *      - true on success
+     *      - false if size is wrong or matrix could not be factorized
+     */
+    bool factorize(const Mat &A);
+
+    /**
+     * Solve A*x = b with factorized matrix, the result replaces b.
+     * @param[inout] b: matrix [size]x[K] with right sides
+     *
+     * @return
+     *      - true on success
+     *      - false if there is no valid factorization or size is wrong
+     */
+    bool solveInPlace(Mat &b) const;
+
+    /**
+     * Solve A*x = b with factorized matrix.
+     * @param[in] b: matrix [size]x[K] with right sides
+     *
+     * @return
+     *      - matrix [size]x[K] with roots
+     */
+    Mat solve(const Mat &b) const;
+
+    /**
+     * Find the inverse of factorized matrix
+     *
+     * @return
+     *      - inverse matrix
+     */
+    Mat inverse() const;
+
+    /**
+     * Find determinant of factorized matrix
+     *
+     * @return
+     *      - determinant value
+     */
+    float det() const;
+
+    Mat L;      /*!< Factor L, for LDL' D is stored on the diagonal*/
+    bool ldl;   /*!< LDL' decomposition is used*/
+    bool valid; /*!< Factorization is done and valid*/
+};
+
 /**
  * Print matrix to the standard iostream.
  * @param[in] os: output stream
@@ -172,7 +172,7 @@ void Mat::Copy(const Mat &src, int row_pos, int col_pos)
         return;
     }
 
-    for (size_t r = 0; r < src.rows; r++) {
+    for (int r = 0; r < src.rows; r++) {
         memcpy(&this->data[(r + row_pos) * this->stride + col_pos], &src.data[r * src.cols], src.cols * sizeof(float));
     }
 }
@@ -215,7 +215,7 @@ Mat Mat::Get(int row_start, int row_size, int col_start, int col_size)
         return result;
     }
 
-    for (size_t r = 0; r < result.rows; r++) {
+    for (int r = 0; r < result.rows; r++) {
         memcpy(&result.data[r * result.cols], &this->data[(r + row_start) * this->stride + col_start], result.cols * sizeof(float));
     }
     return result;
@@ -465,6 +465,13 @@ float Mat::norm(void)
 
 Mat Mat::solve(Mat A, Mat b)
 {
+    if (A.isSymmetric()) {
+        Cholesky chol(A.rows);
+        if (chol.factorize(A)) {
+            return chol.solve(b);
+        }
+    }
+
     // Gaussian elimination
     for (int i = 0; i < A.rows; ++i) {
         if (A(i, i) == 0) {
@@ -704,6 +711,13 @@ Mat Mat::rowReduceFromGaussian()
 
 Mat Mat::pinv()
 {
+    if (this->isSymmetric()) {
+        Cholesky chol(this->rows);
+        if (chol.factorize(*this)) {
+            return chol.inverse();
+        }
+    }
+
     Mat I = Mat::eye(this->rows);
     Mat AI = Mat::augment(*this, I);
     Mat U = AI.gaussianEliminate();
@@ -818,6 +832,182 @@ Mat Mat::inverse()
     return result;
 }
 
+bool Mat::cholesky()
+{
+    if (this->rows != this->cols) {
+        return false;
+    }
+    Mat &A = *this;
+    for (int j = 0; j < this->rows; j++) {
+        float sum = A(j, j);
+        for (int k = 0; k < j; k++) {
+            sum -= A(j, k) * A(j, k);
+        }
+        if (!(sum > 0)) {
+            // not positive definite
+            return false;
+        }
+        float l_jj = sqrtf(sum);
+        float inv_l_jj = 1 / l_jj;
+        A(j, j) = l_jj;
+        for (int i = j + 1; i < this->rows; i++) {
+            sum = A(i, j);
+            for (int k = 0; k < j; k++) {
+                sum -= A(i, k) * A(j, k);
+            }
+            A(i, j) = sum * inv_l_jj;
+        }
+    }
+    for (int i = 0; i < this->rows; i++) {
+        for (int j = i + 1; j < this->cols; j++) {
+            A(i, j) = 0;
+        }
+    }
+    return true;
+}
+
+bool Mat::ldlt()
+{
+    if (this->rows != this->cols) {
+        return false;
+    }
+    Mat &A = *this;
+    for (int j = 0; j < this->rows; j++) {
+        float d = A(j, j);
+        for (int k = 0; k < j; k++) {
+            d -= A(j, k) * A(j, k) * A(k, k);
+        }
+        if (d == 0) {
+            // zero pivot
+            return false;
+        }
+        A(j, j) = d;
+        float inv_d = 1 / d;
+        for (int i = j + 1; i < this->rows; i++) {
+            float sum = A(i, j);
+            for (int k = 0; k < j; k++) {
+                sum -= A(i, k) * A(j, k) * A(k, k);
+            }
+            A(i, j) = sum * inv_d;
+        }
+    }
+    for (int i = 0; i < this->rows; i++) {
+        for (int j = i + 1; j < this->cols; j++) {
+            A(i, j) = 0;
+        }
+    }
+    return true;
+}
+
+void Mat::solveLower(const Mat &L, Mat &b, bool unit_diag)
+{
+    for (int c = 0; c < b.cols; c++) {
+        for (int i = 0; i < L.rows; i++) {
+            float sum = b(i, c);
+            for (int k = 0; k < i; k++) {
+                sum -= L(i, k) * b(k, c);
+            }
+            b(i, c) = unit_diag ? sum : sum / L(i, i);
+        }
+    }
+}
+
+void Mat::solveLowerT(const Mat &L, Mat &b, bool unit_diag)
+{
+    for (int c = 0; c < b.cols; c++) {
+        for (int i = L.rows - 1; i >= 0; i--) {
+            float sum = b(i, c);
+            for (int k = i + 1; k < L.rows; k++) {
+                sum -= L(k, i) * b(k, c);
+            }
+            b(i, c) = unit_diag ? sum : sum / L(i, i);
+        }
+    }
+}
+
+bool Mat::isSymmetric(float rel_tol)
+{
+    if (this->rows != this->cols) {
+        return false;
+    }
+    for (int i = 0; i < this->rows; i++) {
+        for (int j = i + 1; j < this->cols; j++) {
+            float a = (*this)(i, j);
+            float b = (*this)(j, i);
+            if (fabsf(a - b) > rel_tol * (fabsf(a) + fabsf(b))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+Cholesky::Cholesky(int size, bool ldl) : L(size, size)
+{
+    this->ldl = ldl;
+    this->valid = false;
+}
+
+bool Cholesky::factorize(const Mat &A)
+{
+    this->valid = false;
+    if ((A.rows != this->L.rows) || (A.cols != this->L.cols)) {
+        ESP_LOGW("Mat", "Cholesky::factorize Error: matrix size %dx%d, expected %dx%d", A.rows, A.cols, this->L.rows, this->L.cols);
+        return false;
+    }
+    for (int i = 0; i < A.rows; i++) {
+        for (int j = 0; j <= i; j++) {
+            this->L(i, j) = A(i, j);
+        }
+    }
+    this->valid = this->ldl ? this->L.ldlt() : this->L.cholesky();
+    return this->valid;
+}
+
+bool Cholesky::solveInPlace(Mat &b) const
+{
+    if ((false == this->valid) || (b.rows != this->L.rows)) {
+        return false;
+    }
+    Mat::solveLower(this->L, b, this->ldl);
+    if (this->ldl) {
+        for (int i = 0; i < b.rows; i++) {
+            float inv_d = 1 / this->L(i, i);
+            for (int c = 0; c < b.cols; c++) {
+                b(i, c) *= inv_d;
+            }
+        }
+    }
+    Mat::solveLowerT(this->L, b, this->ldl);
+    return true;
+}
+
+Mat Cholesky::solve(const Mat &b) const
+{
+    Mat x(b.rows, b.cols);
+    x = b;
+    if (false == this->solveInPlace(x)) {
+        ESP_LOGW("Mat", "Cholesky::solve Error: no valid factorization for %dx%d matrix", b.rows, b.cols);
+    }
+    return x;
+}
+
+Mat Cholesky::inverse() const
+{
+    Mat result = Mat::eye(this->L.rows);
+    this->solveInPlace(result);
+    return result;
+}
+
+float Cholesky::det() const
+{
+    float D = 1;
+    for (int i = 0; i < this->L.rows; i++) {
+        D *= this->ldl ? this->L(i, i) : this->L(i, i) * this->L(i, i);
+    }
+    return D;
+}
+
 void Mat::allocate()
 {
     this->ext_buff = false;
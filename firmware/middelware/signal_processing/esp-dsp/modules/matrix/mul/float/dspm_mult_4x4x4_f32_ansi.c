@@ -0,0 +1,30 @@
+// Copyright 2018-2023 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dspm_mult.h"
+
+esp_err_t dspm_mult_4x4x4_f32_ansi(const float *A, const float *B, float *C)
+{
+    for (int i = 0; i < 4; i++) {
+        const float a0 = A[i * 4 + 0];
+        const float a1 = A[i * 4 + 1];
+        const float a2 = A[i * 4 + 2];
+        const float a3 = A[i * 4 + 3];
+        C[i * 4 + 0] = a0 * B[0] + a1 * B[4] + a2 * B[8] + a3 * B[12];
+        C[i * 4 + 1] = a0 * B[1] + a1 * B[5] + a2 * B[9] + a3 * B[13];
+        C[i * 4 + 2] = a0 * B[2] + a1 * B[6] + a2 * B[10] + a3 * B[14];
+        C[i * 4 + 3] = a0 * B[3] + a1 * B[7] + a2 * B[11] + a3 * B[15];
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,66 @@
+// Copyright 2018-2023 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dspm_mult.h"
+
+// C(m,k) = A(m,n)*Bt(k,n)'
+// c(i,j) = sum(a(i,s)*bt(j,s)) , s=1..n
+// Both operands are read along rows, every element of C is a dot product
+// of two continuous vectors. 2x2 block of C is calculated at once.
+esp_err_t dspm_mult_bt_f32_ansi(const float *A, const float *Bt, float *C, int m, int n, int k)
+{
+    int i = 0;
+    for (; i + 2 <= m; i += 2) {
+        const float *a0 = &A[i * n];
+        const float *a1 = a0 + n;
+        int j = 0;
+        for (; j + 2 <= k; j += 2) {
+            const float *b0 = &Bt[j * n];
+            const float *b1 = b0 + n;
+            float c00 = 0, c01 = 0, c10 = 0, c11 = 0;
+            for (int s = 0; s < n; s++) {
+                c00 += a0[s] * b0[s];
+                c01 += a0[s] * b1[s];
+                c10 += a1[s] * b0[s];
+                c11 += a1[s] * b1[s];
+            }
+            C[i * k + j] = c00;
+            C[i * k + j + 1] = c01;
+            C[(i + 1) * k + j] = c10;
+            C[(i + 1) * k + j + 1] = c11;
+        }
+        for (; j < k; j++) {
+            const float *b0 = &Bt[j * n];
+            float c00 = 0, c10 = 0;
+            for (int s = 0; s < n; s++) {
+                c00 += a0[s] * b0[s];
+                c10 += a1[s] * b0[s];
+            }
+            C[i * k + j] = c00;
+            C[(i + 1) * k + j] = c10;
+        }
+    }
+    for (; i < m; i++) {
+        const float *a0 = &A[i * n];
+        for (int j = 0; j < k; j++) {
+            const float *b0 = &Bt[j * n];
+            float c00 = 0;
+            for (int s = 0; s < n; s++) {
+                c00 += a0[s] * b0[s];
+            }
+            C[i * k + j] = c00;
+        }
+    }
+    return ESP_OK;
+}
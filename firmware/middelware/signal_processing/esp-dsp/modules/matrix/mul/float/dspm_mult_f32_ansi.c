@@ -12,20 +12,67 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-
+#include <string.h>
 #include "dsps_dotprod.h"
 #include "dspm_mult.h"
 
+// Size of the tile of B matrix: rows (n direction) x cols (k direction).
+// 64x64 floats = 16 KB, so the tile stays in cache while all rows of A pass over it.
+#define DSPM_MULT_TILE_N 64
+#define DSPM_MULT_TILE_K 64
+
 // Matrinx A(m,n), m - amount or rows, n - amount of columns
 // C(m,k) = A(m,n)*B(n,k)
 // c(i,j) = sum(a(i,s)*b(s,j)) , s=1..n
+//
+// The B matrix is processed by tiles, and four rows of C are accumulated at once,
+// so every loaded row of B is used four times. Inner loop goes along rows of B and C,
+// that makes memory access sequential. Sum order for every c(i,j) is s=1..n,
+// the same as for straightforward implementation.
 esp_err_t dspm_mult_f32_ansi(const float *A, const float *B, float *C, int m, int n, int k)
 {
-    for (int i = 0 ; i < m ; i++) {
-        for (int j = 0 ; j < k ; j++) {
-            C[i * k + j] = A[i * n] * B[j];
-            for (int s = 1; s < n ; s++) {
-                C[i * k + j] += A[i * n + s] * B[s * k + j];
+    if ((m == 3) && (n == 3) && (k == 3)) {
+        return dspm_mult_3x3x3_f32_ansi(A, B, C);
+    }
+    if ((m == 4) && (n == 4) && (k == 4)) {
+        return dspm_mult_4x4x4_f32_ansi(A, B, C);
+    }
+
+    memset(C, 0, m * k * sizeof(float));
+    for (int j0 = 0; j0 < k; j0 += DSPM_MULT_TILE_K) {
+        int j1 = (j0 + DSPM_MULT_TILE_K) < k ? (j0 + DSPM_MULT_TILE_K) : k;
+        for (int s0 = 0; s0 < n; s0 += DSPM_MULT_TILE_N) {
+            int s1 = (s0 + DSPM_MULT_TILE_N) < n ? (s0 + DSPM_MULT_TILE_N) : n;
+            int i = 0;
+            for (; i + 4 <= m; i += 4) {
+                float *c0 = &C[i * k];
+                float *c1 = c0 + k;
+                float *c2 = c1 + k;
+                float *c3 = c2 + k;
+                for (int s = s0; s < s1; s++) {
+                    const float a0 = A[i * n + s];
+                    const float a1 = A[(i + 1) * n + s];
+                    const float a2 = A[(i + 2) * n + s];
+                    const float a3 = A[(i + 3) * n + s];
+                    const float *b = &B[s * k];
+                    for (int j = j0; j < j1; j++) {
+                        const float b_sj = b[j];
+                        c0[j] += a0 * b_sj;
+                        c1[j] += a1 * b_sj;
+                        c2[j] += a2 * b_sj;
+                        c3[j] += a3 * b_sj;
+                    }
+                }
+            }
+            for (; i < m; i++) {
+                float *c0 = &C[i * k];
+                for (int s = s0; s < s1; s++) {
+                    const float a0 = A[i * n + s];
+                    const float *b = &B[s * k];
+                    for (int j = j0; j < j1; j++) {
+                        c0[j] += a0 * b[j];
+                    }
+                }
             }
         }
     }
@@ -77,6 +77,21 @@ esp_err_t dspm_mult_3x3x1_f32_ae32(const float *A, const float *B, float *C);
  */
 esp_err_t dspm_mult_3x3x3_f32_ae32(const float *A, const float *B, float *C);
 
+/**
+ * @brief   Matrix multiplication A[3x3]xB[3x3]
+ *
+ * Matrix multiplication for two square 3x3 floating point matrices: C[3][3] = A[3][3] * B[3][3]
+ * The extension (_ansi) use ANSI C and could be compiled and run on any platform.
+ * dspm_mult_f32_ansi() calls it for 3x3x3 matrices.
+ *
+ * @param[in] A  input matrix A[3][3]
+ * @param[in] B  input matrix B[3][3]
+ * @param C  result matrix C[3][3]
+ * @return
+ *      - ESP_OK on success
+ */
+esp_err_t dspm_mult_3x3x3_f32_ansi(const float *A, const float *B, float *C);
+
 /**
  * @brief   Matrix multiplication A[4x4]xB[4x1]
  *
@@ -108,6 +123,40 @@ esp_err_t dspm_mult_4x4x1_f32_ae32(const float *A, const float *B, float *C);
  */
 esp_err_t dspm_mult_4x4x4_f32_ae32(const float *A, const float *B, float *C);
 
+/**
+ * @brief   Matrix multiplication A[4x4]xB[4x4]
+ *
+ * Matrix multiplication for two square 4x4 floating point matrices: C[4][4] = A[4][4] * B[4][4]
+ * The extension (_ansi) use ANSI C and could be compiled and run on any platform.
+ * dspm_mult_f32_ansi() calls it for 4x4x4 matrices.
+ *
+ * @param[in] A  input matrix A[4][4]
+ * @param[in] B  input matrix B[4][4]
+ * @param C  result matrix C[4][4]
+ * @return
+ *      - ESP_OK on success
+ */
+esp_err_t dspm_mult_4x4x4_f32_ansi(const float *A, const float *B, float *C);
+
+/**
+ * @brief   Matrix multiplication with transposed B
+ *
+ * Matrix multiplication for two floating point matrices, where B is stored transposed:
+ * C[m][k] = A[m][n] * Bt[k][n]'
+ * Both matrices are read along the rows, so no transpose copy is needed for products like A*B'.
+ * The extension (_ansi) use ANSI C and could be compiled and run on any platform.
+ *
+ * @param[in] A  input matrix A[m][n]
+ * @param[in] Bt  input matrix Bt[k][n], transposed B
+ * @param C  result matrix C[m][k]
+ * @param[in] m  matrix dimension
+ * @param[in] n  matrix dimension
+ * @param[in] k  matrix dimension
+ * @return
+ *      - ESP_OK on success
+ */
+esp_err_t dspm_mult_bt_f32_ansi(const float *A, const float *Bt, float *C, int m, int n, int k);
+
 /**@{*/
 /**
  * @brief   Matrix multiplication 16 bit signeg int
@@ -192,7 +241,7 @@ esp_err_t dspm_mult_ex_f32_aes3(const float *A, const float *B, float *C, int m,
 #if (dspm_mult_3x3x3_f32_ae32_enabled == 1)
 #define dspm_mult_3x3x3_f32(A,B,C) dspm_mult_3x3x3_f32_ae32(A,B,C)
 #else
-#define dspm_mult_3x3x3_f32(A,B,C) dspm_mult_f32_ansi(A,B,B,3,3,3);
+#define dspm_mult_3x3x3_f32(A,B,C) dspm_mult_3x3x3_f32_ansi(A,B,C)
 #endif
 #if (dspm_mult_4x4x1_f32_ae32_enabled == 1)
 #define dspm_mult_4x4x1_f32(A,B,C) dspm_mult_4x4x1_f32_ae32(A,B,C)
@@ -205,8 +254,9 @@ esp_err_t dspm_mult_ex_f32_aes3(const float *A, const float *B, float *C, int m,
 #elif (dspm_mult_4x4x4_f32_ae32_enabled == 1)
 #define dspm_mult_4x4x4_f32 dspm_mult_4x4x4_f32_ae32
 #else
-#define dspm_mult_4x4x4_f32(A,B,C) dspm_mult_f32_ansi(A,B,C, 4, 4, 4)
+#define dspm_mult_4x4x4_f32(A,B,C) dspm_mult_4x4x4_f32_ansi(A,B,C)
 #endif
+#define dspm_mult_bt_f32 dspm_mult_bt_f32_ansi
 
 #else
 #define dspm_mult_s16 dspm_mult_s16_ansi
@@ -214,8 +264,10 @@ esp_err_t dspm_mult_ex_f32_aes3(const float *A, const float *B, float *C, int m,
 #define dspm_mult_3x3x1_f32(A,B,C) dspm_mult_f32_ansi(A,B,C, 3, 3, 1)
 #define dsps_sub_f32 dsps_sub_f32_ansi
 #define dsps_add_f32 dsps_add_f32_ansi
-#define dspm_mult_4x4x4_f32(A,B,C) dspm_mult_f32_ansi(A,B,C, 4, 4, 4)
+#define dspm_mult_3x3x3_f32(A,B,C) dspm_mult_3x3x3_f32_ansi(A,B,C)
+#define dspm_mult_4x4x4_f32(A,B,C) dspm_mult_4x4x4_f32_ansi(A,B,C)
 #define dspm_mult_ex_f32 dspm_mult_ex_f32_ansi
+#define dspm_mult_bt_f32 dspm_mult_bt_f32_ansi
 #endif // CONFIG_DSP_OPTIMIZED
 
 
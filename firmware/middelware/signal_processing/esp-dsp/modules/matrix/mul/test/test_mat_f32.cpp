@@ -257,3 +257,55 @@ TEST_CASE("Mat class operators", "[dspm]")
 
     delete[] check_array;
 }
+
+TEST_CASE("Mat class Cholesky and LDL solve", "[dspm]")
+{
+    // Symmetric positive definite matrix, the shape of an EKF innovation covariance
+    float data_a[16] = {4, 2, 0.4, 0.2,
+                        2, 5, 1, 0.5,
+                        0.4, 1, 3, 0.3,
+                        0.2, 0.5, 0.3, 2
+                       };
+    float data_b[4] = {1, -2, 3, 0.5};
+    dspm::Mat A(data_a, 4, 4);
+    dspm::Mat b(data_b, 4, 1);
+    TEST_ASSERT_TRUE(A.isSymmetric());
+
+    for (int ldl = 0 ; ldl < 2 ; ldl++) {
+        dspm::Cholesky chol(4, ldl);
+        TEST_ASSERT_TRUE(chol.factorize(A));
+        dspm::Mat x = chol.solve(b);
+        dspm::Mat residual = A * x - b;
+        std::cout << (ldl ? "LDL" : "Cholesky") << " solve: " << x.t();
+        for (int i = 0 ; i < 4 ; i++) {
+            if (std::abs(residual(i, 0)) > 1e-5) {
+                TEST_ASSERT_MESSAGE (false, "Error in Cholesky solve!\n");
+            }
+        }
+
+        // Factor is reused for several right hand sides
+        dspm::Mat A_inv = chol.inverse();
+        dspm::Mat I = A * A_inv;
+        for (int i = 0 ; i < 4 ; i++) {
+            for (int j = 0 ; j < 4 ; j++) {
+                if (std::abs(I(i, j) - (i == j ? 1 : 0)) > 1e-5) {
+                    TEST_ASSERT_MESSAGE (false, "Error in Cholesky inverse!\n");
+                }
+            }
+        }
+    }
+
+    dspm::Mat x = dspm::Mat::solve(A, b);
+    dspm::Mat residual = A * x - b;
+    for (int i = 0 ; i < 4 ; i++) {
+        if (std::abs(residual(i, 0)) > 1e-5) {
+            TEST_ASSERT_MESSAGE (false, "Error in solve() with symmetric matrix!\n");
+        }
+    }
+
+    // Indefinite matrix is rejected by Cholesky
+    float data_c[4] = {1, 2, 2, 1};
+    dspm::Mat C(data_c, 2, 2);
+    dspm::Cholesky chol(2);
+    TEST_ASSERT_FALSE(chol.factorize(C));
+}
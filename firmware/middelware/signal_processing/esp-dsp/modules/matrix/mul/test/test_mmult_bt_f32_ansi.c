@@ -0,0 +1,109 @@
+// Copyright 2018-2023 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string.h>
+#include <stdlib.h>
+#include "unity.h"
+#include "esp_dsp.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dspm_mult.h"
+#include "esp_attr.h"
+#include "dsp_tests.h"
+
+static const char *TAG = "dspm_mult_bt_f32_ansi";
+
+// Reference multiplication, c(i,j) = sum(a(i,s)*b(s,j)) , s=1..n
+static void mult_ref(const float *A, const float *B, float *C, int m, int n, int k)
+{
+    for (int i = 0 ; i < m ; i++) {
+        for (int j = 0 ; j < k ; j++) {
+            C[i * k + j] = 0;
+            for (int s = 0 ; s < n ; s++) {
+                C[i * k + j] += A[i * n + s] * B[s * k + j];
+            }
+        }
+    }
+}
+
+TEST_CASE("dspm_mult_f32_ansi tiled functionality", "[dspm]")
+{
+    const int sizes[][3] = {{3, 3, 3}, {4, 4, 4}, {5, 67, 9}, {66, 70, 65}, {129, 3, 130}};
+    for (int t = 0; t < sizeof(sizes) / sizeof(sizes[0]); t++) {
+        int m = sizes[t][0];
+        int n = sizes[t][1];
+        int k = sizes[t][2];
+        float *A = (float *)malloc(m * n * sizeof(float));
+        float *B = (float *)malloc(n * k * sizeof(float));
+        float *C = (float *)malloc(m * k * sizeof(float));
+        float *C_compare = (float *)malloc(m * k * sizeof(float));
+        for (int i = 0 ; i < m * n; i++) {
+            A[i] = (i % 17) - 8;
+        }
+        for (int i = 0 ; i < n * k; i++) {
+            B[i] = (i % 13) - 6;
+        }
+        mult_ref(A, B, C_compare, m, n, k);
+        dspm_mult_f32_ansi(A, B, C, m, n, k);
+        for (int i = 0 ; i < m * k ; i++) {
+            if (C_compare[i] != C[i]) {
+                ESP_LOGE(TAG, "%ix%ix%i [%i] calc=%f, expected =%f", m, n, k, i, C[i], C_compare[i]);
+                TEST_ASSERT_EQUAL(C_compare[i], C[i]);
+            }
+        }
+        free(A);
+        free(B);
+        free(C);
+        free(C_compare);
+    }
+}
+
+TEST_CASE("dspm_mult_bt_f32_ansi functionality", "[dspm]")
+{
+    for (int m = 1 ; m < 8 ; m++) {
+        for (int n = 1; n < 8 ; n++) {
+            for (int k = 1; k < 8 ; k++) {
+                float A[m][n];
+                float B[n][k];
+                float Bt[k][n];
+                float C[m][k];
+                float C_compare[m][k];
+
+                for (int i = 0 ; i < m ; i++) {
+                    for (int j = 0 ; j < n ; j++) {
+                        A[i][j] = i * n + j;
+                    }
+                }
+                for (int i = 0 ; i < n ; i++) {
+                    for (int j = 0 ; j < k ; j++) {
+                        B[i][j] = i * k + j;
+                        Bt[j][i] = B[i][j];
+                    }
+                }
+                mult_ref((float *)A, (float *)B, (float *)C_compare, m, n, k);
+                dspm_mult_bt_f32_ansi((float *)A, (float *)Bt, (float *)C, m, n, k);
+
+                for (int i = 0 ; i < m ; i++) {
+                    for (int j = 0 ; j < k ; j++) {
+                        if (C_compare[i][j] != C[i][j]) {
+                            ESP_LOGE(TAG, "[%i][%i] calc=%f, expected =%f", i, j, C[i][j], C_compare[i][j]);
+                            TEST_ASSERT_EQUAL(C_compare[i][j], C[i][j]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
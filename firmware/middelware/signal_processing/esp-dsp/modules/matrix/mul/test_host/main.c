@@ -0,0 +1,14 @@
+#include <stdlib.h>
+#include <stdio.h>
+
+int test_mmult_bench();
+int test_mat_chol_bench();
+
+int main(void)
+{
+    printf("main starts!\n");
+    int result = test_mmult_bench();
+    result |= test_mat_chol_bench();
+    printf("Test done\n");
+    return result;
+}
@@ -0,0 +1,135 @@
+// Copyright 2018-2023 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include "mat.h"
+
+using dspm::Mat;
+
+static double time_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Symmetric positive definite test matrix, like EKF covariance S = H*P*H' + R
+static Mat spd_matrix(int N)
+{
+    Mat B(N, N);
+    for (int i = 0; i < N * N; i++) {
+        B.data[i] = sinf(i * 1.3f + N);
+    }
+    Mat A = B * B.t();
+    for (int i = 0; i < N; i++) {
+        A(i, i) += 0.5f;
+    }
+    return A;
+}
+
+// Gauss-Jordan inverse, the generic path of pinv()
+static Mat gauss_jordan_inverse(Mat &A)
+{
+    Mat AI = Mat::augment(A, Mat::eye(A.rows));
+    Mat U = AI.gaussianEliminate();
+    Mat IAInverse = U.rowReduceFromGaussian();
+    return IAInverse.Get(0, A.rows, A.cols, A.cols);
+}
+
+static float inverse_error(Mat &A, Mat &A_inv)
+{
+    Mat I = A * A_inv;
+    float err = 0;
+    for (int i = 0; i < A.rows; i++) {
+        for (int j = 0; j < A.cols; j++) {
+            err = fmaxf(err, fabsf(I(i, j) - (i == j ? 1 : 0)));
+        }
+    }
+    return err;
+}
+
+extern "C" int test_mat_chol_bench()
+{
+    int result = 0;
+    printf("  N   inverse(),us  Gauss-Jordan,us  Cholesky inv,us  Cholesky solve,us  cached solve,us  error\n");
+    for (int N = 3; N <= 20; N++) {
+        Mat A = spd_matrix(N);
+        Mat b(N, 1);
+        for (int i = 0; i < N; i++) {
+            b(i, 0) = i + 1;
+        }
+        int repeat_count = 20000 / (N * N) + 1;
+
+        // Cofactor expansion grows as N!, so it is measured for small sizes only
+        double inv_time = 0;
+        if (N <= 7) {
+            double start = time_sec();
+            for (int i = 0; i < repeat_count; i++) {
+                Mat A_inv = A.inverse();
+            }
+            inv_time = (time_sec() - start) / repeat_count;
+        }
+
+        double start = time_sec();
+        for (int i = 0; i < repeat_count; i++) {
+            Mat A_inv = gauss_jordan_inverse(A);
+        }
+        double gj_time = (time_sec() - start) / repeat_count;
+
+        dspm::Cholesky chol(N);
+        start = time_sec();
+        for (int i = 0; i < repeat_count; i++) {
+            chol.factorize(A);
+            Mat A_inv = chol.inverse();
+        }
+        double chol_inv_time = (time_sec() - start) / repeat_count;
+
+        Mat x(N, 1);
+        start = time_sec();
+        for (int i = 0; i < repeat_count; i++) {
+            chol.factorize(A);
+            x = b;
+            chol.solveInPlace(x);
+        }
+        double chol_solve_time = (time_sec() - start) / repeat_count;
+
+        start = time_sec();
+        for (int i = 0; i < repeat_count; i++) {
+            x = b;
+            chol.solveInPlace(x);
+        }
+        double cached_time = (time_sec() - start) / repeat_count;
+
+        Mat A_inv = chol.inverse();
+        float err = inverse_error(A, A_inv);
+        if (inv_time > 0) {
+            printf("%3i %14.3f", N, inv_time * 1e6);
+        } else {
+            printf("%3i %14s", N, "-");
+        }
+        printf(" %16.3f %16.3f %18.3f %16.3f  %g\n", gj_time * 1e6, chol_inv_time * 1e6, chol_solve_time * 1e6, cached_time * 1e6, err);
+        if (err > 1e-3) {
+            printf("Error: Cholesky inverse error %g for %ix%i\n", err, N, N);
+            result = 1;
+        }
+    }
+    if (result == 0) {
+        printf("Test Pass!\n");
+    }
+    return result;
+}
@@ -0,0 +1,109 @@
+// Copyright 2018-2023 Espressif Systems (Shanghai) PTE LTD
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "dspm_mult.h"
+
+// Straightforward triple loop, the previous dspm_mult_f32_ansi implementation
+static void mult_naive(const float *A, const float *B, float *C, int m, int n, int k)
+{
+    for (int i = 0 ; i < m ; i++) {
+        for (int j = 0 ; j < k ; j++) {
+            C[i * k + j] = A[i * n] * B[j];
+            for (int s = 1; s < n ; s++) {
+                C[i * k + j] += A[i * n + s] * B[s * k + j];
+            }
+        }
+    }
+}
+
+static double time_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int test_mmult_bench()
+{
+    const int sizes[] = {3, 4, 8, 13, 16, 32, 64, 128};
+    int result = 0;
+    printf("  size     naive,us     tiled,us  transposed,us\n");
+    for (int t = 0; t < sizeof(sizes) / sizeof(sizes[0]); t++) {
+        int N = sizes[t];
+        float *A = (float *)malloc(N * N * sizeof(float));
+        float *B = (float *)malloc(N * N * sizeof(float));
+        float *Bt = (float *)malloc(N * N * sizeof(float));
+        float *C = (float *)malloc(N * N * sizeof(float));
+        float *C_compare = (float *)malloc(N * N * sizeof(float));
+        for (int i = 0; i < N * N; i++) {
+            A[i] = (float)((i * 7) % 19) / 19 - 0.5f;
+            B[i] = (float)((i * 5) % 23) / 23 - 0.5f;
+        }
+        for (int i = 0; i < N; i++) {
+            for (int j = 0; j < N; j++) {
+                Bt[j * N + i] = B[i * N + j];
+            }
+        }
+        int repeat_count = 1 + (1 << 24) / (N * N * N);
+
+        double start = time_sec();
+        for (int i = 0; i < repeat_count; i++) {
+            mult_naive(A, B, C_compare, N, N, N);
+        }
+        double naive_time = (time_sec() - start) / repeat_count;
+
+        start = time_sec();
+        for (int i = 0; i < repeat_count; i++) {
+            dspm_mult_f32_ansi(A, B, C, N, N, N);
+        }
+        double tiled_time = (time_sec() - start) / repeat_count;
+        for (int i = 0; i < N * N; i++) {
+            if (C[i] != C_compare[i]) {
+                printf("Error dspm_mult_f32_ansi %ix%i [%i] calc=%f, expected =%f\n", N, N, i, C[i], C_compare[i]);
+                result = 1;
+                break;
+            }
+        }
+
+        start = time_sec();
+        for (int i = 0; i < repeat_count; i++) {
+            dspm_mult_bt_f32_ansi(A, Bt, C, N, N, N);
+        }
+        double bt_time = (time_sec() - start) / repeat_count;
+        for (int i = 0; i < N * N; i++) {
+            if (fabsf(C[i] - C_compare[i]) > 1e-4f * N) {
+                printf("Error dspm_mult_bt_f32_ansi %ix%i [%i] calc=%f, expected =%f\n", N, N, i, C[i], C_compare[i]);
+                result = 1;
+                break;
+            }
+        }
+
+        printf("%3ix%-3i %12.3f %12.3f %12.3f\n", N, N, naive_time * 1e6, tiled_time * 1e6, bt_time * 1e6);
+        free(A);
+        free(B);
+        free(Bt);
+        free(C);
+        free(C_compare);
+    }
+    if (result == 0) {
+        printf("Test Pass!\n");
+    }
+    return result;
+}